@@ -0,0 +1,14 @@
+CREATE TABLE IF NOT EXISTS fingerprint_cache (
+  url TEXT NOT NULL,
+  inode INTEGER NOT NULL DEFAULT 0,
+  filesize INTEGER NOT NULL DEFAULT -1,
+  mtime INTEGER NOT NULL DEFAULT -1,
+  audio_hash TEXT NOT NULL,
+  fingerprint TEXT NOT NULL
+);
+
+CREATE UNIQUE INDEX IF NOT EXISTS idx_fingerprint_cache_url ON fingerprint_cache (url);
+
+CREATE INDEX IF NOT EXISTS idx_fingerprint_cache_audio_hash ON fingerprint_cache (audio_hash);
+
+UPDATE schema_version SET version=16;
@@ -0,0 +1,11 @@
+CREATE TABLE IF NOT EXISTS lyrics (
+  artist TEXT NOT NULL,
+  album TEXT NOT NULL,
+  title TEXT NOT NULL,
+  provider TEXT NOT NULL DEFAULT '',
+  lyrics TEXT NOT NULL DEFAULT '',
+  time INTEGER NOT NULL DEFAULT 0,
+  PRIMARY KEY (artist, album, title)
+);
+
+UPDATE schema_version SET version=19;
@@ -0,0 +1,8 @@
+CREATE TABLE IF NOT EXISTS collection_sync (
+  songs_table TEXT NOT NULL,
+  album_id TEXT NOT NULL,
+  signature TEXT NOT NULL DEFAULT '',
+  PRIMARY KEY (songs_table, album_id)
+);
+
+UPDATE schema_version SET version=20;
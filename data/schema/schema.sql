@@ -4,7 +4,7 @@ CREATE TABLE IF NOT EXISTS schema_version (
 
 DELETE FROM schema_version;
 
-INSERT INTO schema_version (version) VALUES (15);
+INSERT INTO schema_version (version) VALUES (20);
 
 CREATE TABLE IF NOT EXISTS directories (
   path TEXT NOT NULL,
@@ -531,6 +531,7 @@ CREATE TABLE IF NOT EXISTS playlists (
 CREATE TABLE IF NOT EXISTS playlist_items (
 
   playlist INTEGER NOT NULL,
+  position INTEGER NOT NULL DEFAULT 0,
   type INTEGER NOT NULL DEFAULT 0,
   collection_id INTEGER,
   playlist_url TEXT,
@@ -612,6 +613,15 @@ CREATE TABLE IF NOT EXISTS radio_channels (
   thumbnail_url TEXT
 );
 
+CREATE TABLE IF NOT EXISTS fingerprint_cache (
+  url TEXT NOT NULL,
+  inode INTEGER NOT NULL DEFAULT 0,
+  filesize INTEGER NOT NULL DEFAULT -1,
+  mtime INTEGER NOT NULL DEFAULT -1,
+  audio_hash TEXT NOT NULL,
+  fingerprint TEXT NOT NULL
+);
+
 CREATE INDEX IF NOT EXISTS idx_url ON songs (url);
 
 CREATE INDEX IF NOT EXISTS idx_comp_artist ON songs (compilation_effective, artist);
@@ -624,7 +634,35 @@ CREATE INDEX IF NOT EXISTS idx_album ON songs (album);
 
 CREATE INDEX IF NOT EXISTS idx_title ON songs (title);
 
-CREATE VIEW IF NOT EXISTS duplicated_songs as select artist dup_artist, album dup_album, title dup_title from songs as inner_songs where artist != '' and album != '' and title != '' and unavailable = 0 group by artist, album , title having count(*) > 1;
+CREATE UNIQUE INDEX IF NOT EXISTS idx_fingerprint_cache_url ON fingerprint_cache (url);
+
+CREATE INDEX IF NOT EXISTS idx_fingerprint_cache_audio_hash ON fingerprint_cache (audio_hash);
+
+CREATE INDEX IF NOT EXISTS idx_playlist_items_playlist ON playlist_items (playlist, position);
+
+CREATE TABLE IF NOT EXISTS duplicated_songs (
+  dup_artist TEXT NOT NULL,
+  dup_album TEXT NOT NULL,
+  dup_title TEXT NOT NULL,
+  PRIMARY KEY (dup_artist, dup_album, dup_title)
+);
+
+CREATE TABLE IF NOT EXISTS lyrics (
+  artist TEXT NOT NULL,
+  album TEXT NOT NULL,
+  title TEXT NOT NULL,
+  provider TEXT NOT NULL DEFAULT '',
+  lyrics TEXT NOT NULL DEFAULT '',
+  time INTEGER NOT NULL DEFAULT 0,
+  PRIMARY KEY (artist, album, title)
+);
+
+CREATE TABLE IF NOT EXISTS collection_sync (
+  songs_table TEXT NOT NULL,
+  album_id TEXT NOT NULL,
+  signature TEXT NOT NULL DEFAULT '',
+  PRIMARY KEY (songs_table, album_id)
+);
 
 CREATE VIRTUAL TABLE IF NOT EXISTS songs_fts USING fts5(
 
@@ -24,6 +24,7 @@
 #include <QObject>
 #include <QIODevice>
 #include <QByteArray>
+#include <QString>
 
 #include "tagreaderworker.h"
 
@@ -34,11 +35,16 @@ void TagReaderWorker::MessageArrived(const spb::tagreader::Message &message) {
 
   spb::tagreader::Message reply;
 
-  bool success = HandleMessage(message, reply, &tag_reader_);
-  if (!success) {
+  if (message.has_read_files_request() || message.has_is_media_files_request()) {
+    HandleBatchMessage(message, reply);
+  }
+  else {
+    bool success = HandleMessage(message, reply, &tag_reader_);
+    if (!success) {
 #if defined(USE_TAGLIB)
-    HandleMessage(message, reply, &tag_reader_gme_);
+      HandleMessage(message, reply, &tag_reader_gme_);
 #endif
+    }
   }
 
   SendReply(message, &reply);
@@ -93,3 +99,42 @@ bool TagReaderWorker::HandleMessage(const spb::tagreader::Message &message, spb:
   return false;
 
 }
+
+void TagReaderWorker::HandleBatchMessage(const spb::tagreader::Message &message, spb::tagreader::Message &reply) {
+
+  if (message.has_is_media_files_request()) {
+    spb::tagreader::IsMediaFilesResponse *response = reply.mutable_is_media_files_response();
+    for (const std::string &filename : message.is_media_files_request().filenames()) {
+      response->add_success(IsMediaFile(QStringFromStdString(filename)));
+    }
+  }
+  else if (message.has_read_files_request()) {
+    spb::tagreader::ReadFilesResponse *response = reply.mutable_read_files_response();
+    for (const std::string &filename : message.read_files_request().filenames()) {
+      ReadFile(QStringFromStdString(filename), response->add_metadata());
+    }
+  }
+
+}
+
+bool TagReaderWorker::IsMediaFile(const QString &filename) const {
+
+  bool success = tag_reader_.IsMediaFile(filename);
+#if defined(USE_TAGLIB)
+  if (!success) success = tag_reader_gme_.IsMediaFile(filename);
+#endif
+
+  return success;
+
+}
+
+void TagReaderWorker::ReadFile(const QString &filename, spb::tagreader::SongMetadata *song) const {
+
+  bool success = tag_reader_.ReadFile(filename, song);
+  if (!success) {
+#if defined(USE_TAGLIB)
+    tag_reader_gme_.ReadFile(filename, song);
+#endif
+  }
+
+}
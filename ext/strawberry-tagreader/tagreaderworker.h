@@ -22,6 +22,7 @@
 #include "config.h"
 
 #include <QObject>
+#include <QString>
 
 #include "core/messagehandler.h"
 #if defined(USE_TAGLIB)
@@ -48,6 +49,11 @@ class TagReaderWorker : public AbstractMessageHandler<spb::tagreader::Message> {
  private:
   // Handle message using specific TagReaderBase implementation. Returns true on successful message handle.
   bool HandleMessage(const spb::tagreader::Message &message, spb::tagreader::Message &reply, TagReaderBase* reader);
+  // Handle a batch message, each file falls back to the next TagReaderBase implementation on its own.
+  void HandleBatchMessage(const spb::tagreader::Message &message, spb::tagreader::Message &reply);
+
+  bool IsMediaFile(const QString &filename) const;
+  void ReadFile(const QString &filename, spb::tagreader::SongMetadata *song) const;
 
 #if defined(USE_TAGLIB)
   TagReaderTagLib tag_reader_;
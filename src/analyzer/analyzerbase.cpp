@@ -52,7 +52,7 @@
 
 Analyzer::Base::Base(QWidget *parent, const uint scopeSize)
     : QWidget(parent),
-      fht_(new FHT(scopeSize)),
+      spectrum_(SpectrumEngine::Create(static_cast<int>(scopeSize))),
       engine_(nullptr),
       lastscope_(512),
       new_frame_(false),
@@ -64,7 +64,7 @@ Analyzer::Base::Base(QWidget *parent, const uint scopeSize)
 }
 
 Analyzer::Base::~Base() {
-  delete fht_;
+  delete spectrum_;
 }
 
 void Analyzer::Base::showEvent(QShowEvent*) {
@@ -87,7 +87,7 @@ void Analyzer::Base::ChangeTimeout(const int timeout) {
 
 void Analyzer::Base::transform(Scope &scope) {
 
-  QVector<float> aux(fht_->size());
+  QVector<float> aux(spectrum_->size());
   if (static_cast<unsigned long int>(aux.size()) >= scope.size()) {
     std::copy(scope.begin(), scope.end(), aux.begin());
   }
@@ -95,10 +95,10 @@ void Analyzer::Base::transform(Scope &scope) {
     std::copy(scope.begin(), scope.begin() + aux.size(), aux.begin());
   }
 
-  fht_->logSpectrum(scope.data(), aux.data());
-  fht_->scale(scope.data(), 1.0F / 20);
+  spectrum_->logSpectrum(scope.data(), aux.data());
+  spectrum_->scale(scope.data(), 1.0F / 20);
 
-  scope.resize(fht_->size() / 2);  // second half of values are rubbish
+  scope.resize(spectrum_->size() / 2);  // second half of values are rubbish
 
 }
 
@@ -110,19 +110,17 @@ void Analyzer::Base::paintEvent(QPaintEvent *e) {
   switch (engine_->state()) {
     case Engine::Playing: {
       const Engine::Scope &thescope = engine_->scope(timeout_);
-      int i = 0;
 
-      // convert to mono here - our built in analyzers need mono, but the engines provide interleaved pcm
-      for (uint x = 0; static_cast<int>(x) < fht_->size(); ++x) {
-        lastscope_[x] = static_cast<float>(thescope[i] + thescope[i + 1]) / (2 * (1U << 15U));
-        i += 2;
-      }
+      // Use the newest frames, the engine scope can be larger than the spectrum.
+      lastscope_.resize(spectrum_->size());
+      const Engine::Scope::size_type size = qMin(thescope.size(), lastscope_.size());
+      std::copy(thescope.end() - static_cast<Engine::Scope::difference_type>(size), thescope.end(), lastscope_.begin());
 
       is_playing_ = true;
       transform(lastscope_);
       analyze(p, lastscope_, new_frame_);
 
-      lastscope_.resize(fht_->size());
+      lastscope_.resize(spectrum_->size());
 
       break;
     }
@@ -149,9 +147,9 @@ int Analyzer::Base::resizeExponent(int exp) {
     exp = 9;
   }
 
-  if (exp != fht_->sizeExp()) {
-    delete fht_;
-    fht_ = new FHT(exp);
+  if (exp != spectrum_->sizeExp()) {
+    delete spectrum_;
+    spectrum_ = SpectrumEngine::Create(exp);
   }
   return exp;
 
@@ -180,7 +178,7 @@ int Analyzer::Base::resizeForBands(const int bands) {
   }
 
   resizeExponent(exp);
-  return fht_->size() / 2;
+  return spectrum_->size() / 2;
 
 }
 
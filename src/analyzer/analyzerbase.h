@@ -38,7 +38,7 @@
 #include <QString>
 #include <QPainter>
 
-#include "analyzer/fht.h"
+#include "analyzer/spectrumengine.h"
 #include "engine/engine_fwd.h"
 #include "engine/enginebase.h"
 
@@ -82,7 +82,7 @@ class Base : public QWidget {
 
  protected:
   QBasicTimer timer_;
-  FHT *fht_;
+  SpectrumEngine *spectrum_;
   EngineBase *engine_;
   Scope lastscope_;
 
@@ -34,7 +34,7 @@
 #include <QColor>
 
 #include "analyzerbase.h"
-#include "fht.h"
+#include "spectrumengine.h"
 
 const int BlockAnalyzer::kHeight = 2;
 const int BlockAnalyzer::kWidth = 4;
@@ -128,8 +128,8 @@ void BlockAnalyzer::transform(Analyzer::Scope &s) {
 
   for (uint x = 0; x < s.size(); ++x) s[x] *= 2;
 
-  fht_->spectrum(s.data());
-  fht_->scale(s.data(), 1.0F / 20);
+  spectrum_->spectrum(s.data());
+  spectrum_->scale(s.data(), 1.0F / 20);
 
   // the second half is pretty dull, so only show it if the user has a large analyzer by setting to scope_.size() if large we prevent interpolation of large analyzers, this is good!
   s.resize(scope_.size() <= kMaxColumns / 2 ? kMaxColumns / 2 : scope_.size());
@@ -34,7 +34,7 @@
 
 #include "engine/engine_fwd.h"
 #include "engine/enginebase.h"
-#include "fht.h"
+#include "spectrumengine.h"
 #include "analyzerbase.h"
 
 using Analyzer::Scope;
@@ -101,8 +101,8 @@ void BoomAnalyzer::resizeEvent(QResizeEvent *e) {
 
 void BoomAnalyzer::transform(Scope &s) {
 
-  fht_->spectrum(s.data());
-  fht_->scale(s.data(), 1.0F / 50);
+  spectrum_->spectrum(s.data());
+  spectrum_->scale(s.data(), 1.0F / 50);
 
   s.resize(scope_.size() <= static_cast<quint64>(kMaxBandCount) / 2 ? kMaxBandCount / 2 : scope_.size());
 
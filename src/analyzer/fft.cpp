@@ -0,0 +1,172 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2021, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "fft.h"
+
+#include <cmath>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define FFT_SSE2
+#  include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#  define FFT_NEON
+#  include <arm_neon.h>
+#endif
+
+FFT::FFT(const int exp2, const Window window) : SpectrumEngine(exp2), half_(num_ / 2) {
+
+  if (half_ == 0) return;
+
+  re_.resize(half_);
+  im_.resize(half_);
+
+  // The even values go to the real part and the odd values to the imaginary part, in bit reversed order.
+  int bits = 0;
+  while ((1 << bits) < half_) ++bits;
+  bit_reverse_.resize(half_);
+  for (int i = 0; i < half_; ++i) {
+    int reversed = 0;
+    for (int b = 0; b < bits; ++b) {
+      if (i & (1 << b)) reversed |= 1 << (bits - 1 - b);
+    }
+    bit_reverse_[i] = reversed;
+  }
+
+  // Stage with butterflies of length len uses len / 2 twiddle factors, starting at len / 2 - 1.
+  stage_re_.reserve(half_);
+  stage_im_.reserve(half_);
+  for (int len = 2; len <= half_; len <<= 1) {
+    for (int j = 0; j < len / 2; ++j) {
+      const double angle = -2.0 * M_PI * static_cast<double>(j) / static_cast<double>(len);
+      stage_re_.push_back(static_cast<float>(cos(angle)));
+      stage_im_.push_back(static_cast<float>(sin(angle)));
+    }
+  }
+
+  split_re_.resize(half_);
+  split_im_.resize(half_);
+  for (int k = 0; k < half_; ++k) {
+    const double angle = -2.0 * M_PI * static_cast<double>(k) / static_cast<double>(num_);
+    split_re_[k] = static_cast<float>(cos(angle));
+    split_im_[k] = static_cast<float>(sin(angle));
+  }
+
+  if (window == Window::Hann) {
+    window_.resize(num_);
+    for (int i = 0; i < num_; ++i) {
+      window_[i] = static_cast<float>(0.5 * (1.0 - cos(2.0 * M_PI * static_cast<double>(i) / static_cast<double>(num_))));
+    }
+  }
+
+}
+
+FFT::~FFT() = default;
+
+void FFT::power2(float *p) {
+
+  if (half_ == 0) return;
+
+  if (window_.empty()) {
+    for (int i = 0; i < half_; ++i) {
+      re_[bit_reverse_[i]] = p[i * 2];
+      im_[bit_reverse_[i]] = p[i * 2 + 1];
+    }
+  }
+  else {
+    for (int i = 0; i < half_; ++i) {
+      re_[bit_reverse_[i]] = p[i * 2] * window_[i * 2];
+      im_[bit_reverse_[i]] = p[i * 2 + 1] * window_[i * 2 + 1];
+    }
+  }
+
+  Transform();
+
+  // Split the spectrum of the packed complex values into the spectrum of the real values.
+  for (int k = 0; k < half_; ++k) {
+    const int c = (half_ - k) & (half_ - 1);
+    const float even_re = (re_[k] + re_[c]) * 0.5F;
+    const float even_im = (im_[k] - im_[c]) * 0.5F;
+    const float odd_re = (im_[k] + im_[c]) * 0.5F;
+    const float odd_im = (re_[c] - re_[k]) * 0.5F;
+    const float x_re = even_re + split_re_[k] * odd_re - split_im_[k] * odd_im;
+    const float x_im = even_im + split_re_[k] * odd_im + split_im_[k] * odd_re;
+    p[k] = 2.0F * (x_re * x_re + x_im * x_im);
+  }
+
+}
+
+void FFT::Transform() {
+
+  float *re = re_.data();
+  float *im = im_.data();
+
+  for (int len = 2; len <= half_; len <<= 1) {
+    const int half = len / 2;
+    const float *w_re = stage_re_.data() + half - 1;
+    const float *w_im = stage_im_.data() + half - 1;
+    for (int start = 0; start < half_; start += len) {
+      float *a_re = re + start;
+      float *a_im = im + start;
+      float *b_re = a_re + half;
+      float *b_im = a_im + half;
+      int j = 0;
+#if defined(FFT_SSE2)
+      for (; j + 4 <= half; j += 4) {
+        const __m128 wr = _mm_loadu_ps(w_re + j);
+        const __m128 wi = _mm_loadu_ps(w_im + j);
+        const __m128 br = _mm_loadu_ps(b_re + j);
+        const __m128 bi = _mm_loadu_ps(b_im + j);
+        const __m128 ar = _mm_loadu_ps(a_re + j);
+        const __m128 ai = _mm_loadu_ps(a_im + j);
+        const __m128 tr = _mm_sub_ps(_mm_mul_ps(wr, br), _mm_mul_ps(wi, bi));
+        const __m128 ti = _mm_add_ps(_mm_mul_ps(wr, bi), _mm_mul_ps(wi, br));
+        _mm_storeu_ps(b_re + j, _mm_sub_ps(ar, tr));
+        _mm_storeu_ps(b_im + j, _mm_sub_ps(ai, ti));
+        _mm_storeu_ps(a_re + j, _mm_add_ps(ar, tr));
+        _mm_storeu_ps(a_im + j, _mm_add_ps(ai, ti));
+      }
+#elif defined(FFT_NEON)
+      for (; j + 4 <= half; j += 4) {
+        const float32x4_t wr = vld1q_f32(w_re + j);
+        const float32x4_t wi = vld1q_f32(w_im + j);
+        const float32x4_t br = vld1q_f32(b_re + j);
+        const float32x4_t bi = vld1q_f32(b_im + j);
+        const float32x4_t ar = vld1q_f32(a_re + j);
+        const float32x4_t ai = vld1q_f32(a_im + j);
+        const float32x4_t tr = vsubq_f32(vmulq_f32(wr, br), vmulq_f32(wi, bi));
+        const float32x4_t ti = vaddq_f32(vmulq_f32(wr, bi), vmulq_f32(wi, br));
+        vst1q_f32(b_re + j, vsubq_f32(ar, tr));
+        vst1q_f32(b_im + j, vsubq_f32(ai, ti));
+        vst1q_f32(a_re + j, vaddq_f32(ar, tr));
+        vst1q_f32(a_im + j, vaddq_f32(ai, ti));
+      }
+#endif
+      for (; j < half; ++j) {
+        const float tr = w_re[j] * b_re[j] - w_im[j] * b_im[j];
+        const float ti = w_re[j] * b_im[j] + w_im[j] * b_re[j];
+        b_re[j] = a_re[j] - tr;
+        b_im[j] = a_im[j] - ti;
+        a_re[j] += tr;
+        a_im[j] += ti;
+      }
+    }
+  }
+
+}
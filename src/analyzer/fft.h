@@ -0,0 +1,62 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2021, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef FFT_H
+#define FFT_H
+
+#include <vector>
+
+#include "spectrumengine.h"
+
+/**
+ * Real FFT with a precomputed plan.
+ * The @f$2^n@f$ real values are packed into @f$2^{n-1}@f$ complex values, transformed by an
+ * iterative radix-2 FFT and split into the spectrum of the real values again.
+ * The bit reversal, the twiddle factors of every stage and the window are calculated in the constructor,
+ * and the butterflies use SSE2 or NEON when available.
+ */
+class FFT : public SpectrumEngine {
+ public:
+  explicit FFT(const int exp2, const Window window = Window::None);
+  ~FFT() override;
+
+  void power2(float*) override;
+
+ private:
+  void Transform();
+
+ private:
+  const int half_;
+
+  std::vector<int> bit_reverse_;
+  std::vector<float> window_;
+
+  // Twiddle factors for each stage, stored one stage after the other.
+  std::vector<float> stage_re_;
+  std::vector<float> stage_im_;
+
+  // Twiddle factors to split the complex spectrum into the real spectrum.
+  std::vector<float> split_re_;
+  std::vector<float> split_im_;
+
+  std::vector<float> re_;
+  std::vector<float> im_;
+};
+
+#endif  // FFT_H
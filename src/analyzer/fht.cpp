@@ -28,7 +28,7 @@
 #include <QVector>
 #include <QtMath>
 
-FHT::FHT(uint n) : num_((n < 3) ? 0 : 1 << n), exp2_((n < 3) ? static_cast<int>(-1) : static_cast<int>(n)) {
+FHT::FHT(uint n) : SpectrumEngine(static_cast<int>(n)) {
 
   if (n > 3) {
     buf_vector_.resize(num_);
@@ -40,12 +40,8 @@ FHT::FHT(uint n) : num_((n < 3) ? 0 : 1 << n), exp2_((n < 3) ? static_cast<int>(
 
 FHT::~FHT() = default;
 
-int FHT::sizeExp() const { return exp2_; }
-int FHT::size() const { return num_; }
-
 float *FHT::buf_() { return buf_vector_.data(); }
 float *FHT::tab_() { return tab_vector_.data(); }
-int *FHT::log_() { return log_vector_.data(); }
 
 void FHT::makeCasTable(void) {
 
@@ -63,67 +59,6 @@ void FHT::makeCasTable(void) {
 
 }
 
-void FHT::scale(float *p, float d) const {
-  for (int i = 0; i < (num_ / 2); i++) *p++ *= d;
-}
-
-void FHT::ewma(float *d, float *s, float w) const {
-  for (int i = 0; i < (num_ / 2); i++, d++, s++) *d = *d * w + *s * (1 - w);
-}
-
-void FHT::logSpectrum(float *out, float *p) {
-
-  int n = num_ / 2, i = 0, k = 0, *r = nullptr;
-  if (log_vector_.size() < n) {
-    log_vector_.resize(n);
-    float f = static_cast<float>(n) / static_cast<float>(log10(static_cast<double>(n)));
-    for (i = 0, r = log_(); i < n; i++, r++) {
-      int j = static_cast<int>(rint(log10(i + 1.0) * f));
-      *r = j >= n ? n - 1 : j;
-    }
-  }
-  semiLogSpectrum(p);
-  *out++ = *p = *p / 100;
-  for (k = i = 1, r = log_(); i < n; i++) {
-    int j = *r++;
-    if (i == j) {
-      *out++ = p[i];
-    }
-    else {
-      float base = p[k - 1];
-      float step = (p[j] - base) / static_cast<float>(j - (k - 1));
-      for (float corr = 0; k <= j; k++, corr += step) *out++ = base + corr;
-    }
-  }
-
-}
-
-void FHT::semiLogSpectrum(float *p) {
-
-  power2(p);
-  for (int i = 0; i < (num_ / 2); i++, p++) {
-    float e = 10.0F * static_cast<float>(log10(sqrt(*p / static_cast<float>(2))));
-    *p = e < 0 ? 0 : e;
-  }
-
-}
-
-void FHT::spectrum(float *p) {
-
-  power2(p);
-  for (int i = 0; i < (num_ / 2); i++, p++) {
-    *p = static_cast<float>(sqrt(*p / 2));
-  }
-
-}
-
-void FHT::power(float *p) {
-
-  power2(p);
-  for (int i = 0; i < (num_ / 2); i++) *p++ /= 2;
-
-}
-
 void FHT::power2(float *p) {
 
   _transform(p, num_, 0);
@@ -25,6 +25,8 @@
 
 #include <QVector>
 
+#include "spectrumengine.h"
+
 /**
  * Implementation of the Hartley Transform after Bracewell's discrete
  * algorithm. The algorithm is subject to US patent No. 4,646,256 (1987)
@@ -33,17 +35,12 @@
  *
  * [1] Computer in Physics, Vol. 9, No. 4, Jul/Aug 1995 pp 373-379
  */
-class FHT {
-  const int num_;
-  const int exp2_;
-
+class FHT : public SpectrumEngine {
   QVector<float> buf_vector_;
   QVector<float> tab_vector_;
-  QVector<int> log_vector_;
 
   float *buf_();
   float *tab_();
-  int *log_();
 
   /**
    * Create a table of "cas" (cosine and sine) values.
@@ -65,54 +62,13 @@ class FHT {
   */
   explicit FHT(uint);
 
-  ~FHT();
-  int sizeExp() const;
-  int size() const;
-  void scale(float*, float) const;
-
-  /**
-   * Exponentially Weighted Moving Average (EWMA) filter.
-   * @param d is the filtered data.
-   * @param s is fresh input.
-   * @param w is the weighting factor.
-   */
-  void ewma(float *d, float *s, float w) const;
-
-  /**
-   * Logarithmic audio spectrum. Maps semi-logarithmic spectrum
-   * to logarithmic frequency scale, interpolates missing values.
-   * A logarithmic index map is calculated at the first run only.
-   * @param p is the input array.
-   * @param out is the spectrum.
-   */
-  void logSpectrum(float *out, float *p);
-
-  /**
-   * Semi-logarithmic audio spectrum.
-   */
-  void semiLogSpectrum(float*);
-
-  /**
-   * Fourier spectrum.
-   */
-  void spectrum(float*);
-
-  /**
-   * Calculates a mathematically correct FFT power spectrum.
-   * If further scaling is applied later, use power2 instead
-   * and factor the 0.5 in the final scaling factor.
-   * @see FHT::power2()
-   */
-  void power(float*);
+  ~FHT() override;
 
   /**
    * Calculates an FFT power spectrum with doubled values as a
-   * result. The values need to be multiplied by 0.5 to be exact.
-   * Note that you only get @f$2^{n-1}@f$ power values for a data set
-   * of @f$2^n@f$ input values. This is the fastest transform.
-   * @see FHT::power()
+   * result, using the Hartley transform.
    */
-  void power2(float*);
+  void power2(float*) override;
 
   /**
    * Discrete Hartley transform of data sets with 8 values.
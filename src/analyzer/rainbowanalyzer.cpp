@@ -38,7 +38,7 @@
 #include <QSize>
 #include <QTimerEvent>
 
-#include "fht.h"
+#include "spectrumengine.h"
 #include "analyzerbase.h"
 
 using Analyzer::Scope;
@@ -81,7 +81,7 @@ Rainbow::RainbowAnalyzer::RainbowAnalyzer(const RainbowType rbtype, QWidget *par
 
 }
 
-void Rainbow::RainbowAnalyzer::transform(Scope &s) { fht_->spectrum(s.data()); }
+void Rainbow::RainbowAnalyzer::transform(Scope &s) { spectrum_->spectrum(s.data()); }
 
 void Rainbow::RainbowAnalyzer::timerEvent(QTimerEvent *e) {
 
@@ -86,12 +86,12 @@ void Sonogram::analyze(QPainter &p, const Analyzer::Scope &s, bool new_frame) {
 
 void Sonogram::transform(Analyzer::Scope &scope) {
 
-  fht_->power2(scope.data());
-  fht_->scale(scope.data(), 1.0 / 256);
-  scope.resize(fht_->size() / 2);
+  spectrum_->power2(scope.data());
+  spectrum_->scale(scope.data(), 1.0 / 256);
+  scope.resize(spectrum_->size() / 2);
 
 }
 
 void Sonogram::demo(QPainter &p) {
-  analyze(p, Analyzer::Scope(fht_->size(), 0), new_frame_);
+  analyze(p, Analyzer::Scope(spectrum_->size(), 0), new_frame_);
 }
@@ -0,0 +1,97 @@
+/*
+   Strawberry Music Player
+   This file was part of Clementine.
+   Copyright 2004, Melchior FRANZ <mfranz@kde.org>
+   Copyright 2010, 2014, John Maguire <john.maguire@gmail.com>
+   Copyright 2014, Krzysztof Sobiecki <sobkas@gmail.com>
+   Copyright 2017, Santiago Gil
+
+   Strawberry is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   Strawberry is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "spectrumengine.h"
+
+#include <cmath>
+#include <vector>
+
+#include "fft.h"
+
+SpectrumEngine::SpectrumEngine(const int exp2) : num_((exp2 < 3) ? 0 : 1 << exp2), exp2_((exp2 < 3) ? -1 : exp2) {}
+
+SpectrumEngine::~SpectrumEngine() = default;
+
+SpectrumEngine *SpectrumEngine::Create(const int exp2, const Window window) {
+  return new FFT(exp2, window);
+}
+
+void SpectrumEngine::scale(float *p, float d) const {
+  for (int i = 0; i < (num_ / 2); i++) *p++ *= d;
+}
+
+void SpectrumEngine::ewma(float *d, float *s, float w) const {
+  for (int i = 0; i < (num_ / 2); i++, d++, s++) *d = *d * w + *s * (1 - w);
+}
+
+void SpectrumEngine::logSpectrum(float *out, float *p) {
+
+  int n = num_ / 2, i = 0, k = 0, *r = nullptr;
+  if (static_cast<int>(log_vector_.size()) < n) {
+    log_vector_.resize(n);
+    float f = static_cast<float>(n) / static_cast<float>(log10(static_cast<double>(n)));
+    for (i = 0, r = log_vector_.data(); i < n; i++, r++) {
+      int j = static_cast<int>(rint(log10(i + 1.0) * f));
+      *r = j >= n ? n - 1 : j;
+    }
+  }
+  semiLogSpectrum(p);
+  *out++ = *p = *p / 100;
+  for (k = i = 1, r = log_vector_.data(); i < n; i++) {
+    int j = *r++;
+    if (i == j) {
+      *out++ = p[i];
+    }
+    else {
+      float base = p[k - 1];
+      float step = (p[j] - base) / static_cast<float>(j - (k - 1));
+      for (float corr = 0; k <= j; k++, corr += step) *out++ = base + corr;
+    }
+  }
+
+}
+
+void SpectrumEngine::semiLogSpectrum(float *p) {
+
+  power2(p);
+  for (int i = 0; i < (num_ / 2); i++, p++) {
+    float e = 10.0F * static_cast<float>(log10(sqrt(*p / static_cast<float>(2))));
+    *p = e < 0 ? 0 : e;
+  }
+
+}
+
+void SpectrumEngine::spectrum(float *p) {
+
+  power2(p);
+  for (int i = 0; i < (num_ / 2); i++, p++) {
+    *p = static_cast<float>(sqrt(*p / 2));
+  }
+
+}
+
+void SpectrumEngine::power(float *p) {
+
+  power2(p);
+  for (int i = 0; i < (num_ / 2); i++) *p++ /= 2;
+
+}
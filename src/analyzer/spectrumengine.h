@@ -0,0 +1,104 @@
+/*
+   Strawberry Music Player
+   This file was part of Clementine.
+   Copyright 2004, Melchior FRANZ <mfranz@kde.org>
+   Copyright 2010, 2014, John Maguire <john.maguire@gmail.com>
+   Copyright 2014, Krzysztof Sobiecki <sobkas@gmail.com>
+   Copyright 2017, Santiago Gil
+
+   Strawberry is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   Strawberry is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SPECTRUMENGINE_H
+#define SPECTRUMENGINE_H
+
+#include <vector>
+
+/**
+ * Spectrum of data sets with @f$2^n@f$ real numbers, shared by the analyzers.
+ * Implementations only provide power2(), the other spectrums are derived from it.
+ */
+class SpectrumEngine {
+ public:
+  enum class Window {
+    None,
+    Hann
+  };
+
+  virtual ~SpectrumEngine();
+
+  /**
+   * Creates the default engine, which is the FFT.
+   */
+  static SpectrumEngine *Create(const int exp2, const Window window = Window::None);
+
+  int sizeExp() const { return exp2_; }
+  int size() const { return num_; }
+
+  void scale(float*, float) const;
+
+  /**
+   * Exponentially Weighted Moving Average (EWMA) filter.
+   * @param d is the filtered data.
+   * @param s is fresh input.
+   * @param w is the weighting factor.
+   */
+  void ewma(float *d, float *s, float w) const;
+
+  /**
+   * Logarithmic audio spectrum. Maps semi-logarithmic spectrum
+   * to logarithmic frequency scale, interpolates missing values.
+   * A logarithmic index map is calculated at the first run only.
+   * @param p is the input array.
+   * @param out is the spectrum.
+   */
+  void logSpectrum(float *out, float *p);
+
+  /**
+   * Semi-logarithmic audio spectrum.
+   */
+  void semiLogSpectrum(float*);
+
+  /**
+   * Fourier spectrum.
+   */
+  void spectrum(float*);
+
+  /**
+   * Calculates a mathematically correct FFT power spectrum.
+   * If further scaling is applied later, use power2 instead
+   * and factor the 0.5 in the final scaling factor.
+   * @see power2()
+   */
+  void power(float*);
+
+  /**
+   * Calculates an FFT power spectrum with doubled values as a
+   * result. The values need to be multiplied by 0.5 to be exact.
+   * Note that you only get @f$2^{n-1}@f$ power values for a data set
+   * of @f$2^n@f$ input values.
+   */
+  virtual void power2(float*) = 0;
+
+ protected:
+  explicit SpectrumEngine(const int exp2);
+
+  const int num_;
+  const int exp2_;
+
+ private:
+  std::vector<int> log_vector_;
+};
+
+#endif  // SPECTRUMENGINE_H
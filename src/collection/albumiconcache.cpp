@@ -0,0 +1,395 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2021, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <QtGlobal>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QByteArray>
+#include <QString>
+#include <QList>
+#include <QPair>
+#include <QImage>
+
+#include "core/logging.h"
+#include "albumiconcache.h"
+
+// The pack file starts with the magic and version, followed by the records.
+// Each record is a header of 4 32 bit integers: key size, width, height and bytes per line,
+// the UTF-8 key padded to 4 bytes, and the pixels.
+// A record with a width of 0 removes the key.
+// Integers are stored in host byte order, a file from a different byte order is discarded because the magic won't match.
+const quint32 AlbumIconCache::kMagic = 0x53424943;  // SBIC
+const quint32 AlbumIconCache::kVersion = 1;
+
+namespace {
+
+constexpr qint64 kFileHeaderSize = 2 * sizeof(quint32);
+constexpr qint64 kRecordHeaderSize = 4 * sizeof(quint32);
+constexpr quint32 kMaxKeySize = 4096;
+constexpr qint32 kMaxIconSize = 4096;
+
+qint64 PaddedKeySize(const qint64 key_size) {
+  return (key_size + 3) & ~static_cast<qint64>(3);
+}
+
+}  // namespace
+
+AlbumIconCache::AlbumIconCache(const QString &filename)
+    : file_(filename),
+      map_(nullptr),
+      map_size_(0),
+      live_size_(0),
+      maximum_size_(0) {
+
+  if (Open()) {
+    Load();
+  }
+
+}
+
+AlbumIconCache::~AlbumIconCache() {
+  Close();
+}
+
+void AlbumIconCache::set_maximum_size(const qint64 maximum_size) {
+
+  maximum_size_ = maximum_size;
+  if (maximum_size_ > 0 && file_.isOpen() && file_.size() > maximum_size_) {
+    CompactTo(maximum_size_ * 3 / 4);
+  }
+
+}
+
+bool AlbumIconCache::Open() {
+
+  QDir().mkpath(QFileInfo(file_.fileName()).path());
+
+  if (!file_.open(QIODevice::ReadWrite | QIODevice::Unbuffered)) {
+    qLog(Error) << "Unable to open album icon cache" << file_.fileName() << file_.errorString();
+    return false;
+  }
+
+  return true;
+
+}
+
+void AlbumIconCache::Close() {
+
+  if (map_) {
+    file_.unmap(map_);
+    map_ = nullptr;
+  }
+  map_size_ = 0;
+  if (file_.isOpen()) file_.close();
+
+}
+
+bool AlbumIconCache::Map() {
+
+  if (!file_.isOpen()) return false;
+
+  if (map_) {
+    file_.unmap(map_);
+    map_ = nullptr;
+  }
+  map_size_ = 0;
+
+  file_.flush();
+  const qint64 size = file_.size();
+  if (size <= 0) return false;
+
+  map_ = file_.map(0, size);
+  if (!map_) {
+    qLog(Error) << "Unable to map album icon cache" << file_.fileName() << file_.errorString();
+    return false;
+  }
+  map_size_ = size;
+
+  return true;
+
+}
+
+void AlbumIconCache::Load() {
+
+  entries_.clear();
+  live_size_ = 0;
+
+  if (!Map() || map_size_ < kFileHeaderSize) {
+    Clear();
+    return;
+  }
+
+  quint32 magic = 0;
+  quint32 version = 0;
+  memcpy(&magic, map_, sizeof(magic));
+  memcpy(&version, map_ + sizeof(magic), sizeof(version));
+  if (magic != kMagic || version != kVersion) {
+    qLog(Debug) << "Discarding album icon cache" << file_.fileName() << "with version" << version;
+    Clear();
+    return;
+  }
+
+  qint64 offset = kFileHeaderSize;
+  while (offset + kRecordHeaderSize <= map_size_) {
+    quint32 key_size = 0;
+    qint32 header[3] = { 0, 0, 0 };
+    memcpy(&key_size, map_ + offset, sizeof(key_size));
+    memcpy(header, map_ + offset + sizeof(key_size), sizeof(header));
+    const qint32 width = header[0];
+    const qint32 height = header[1];
+    const qint32 bytes_per_line = header[2];
+    if (key_size == 0 || key_size > kMaxKeySize || width < 0 || width > kMaxIconSize || height < 0 || height > kMaxIconSize || bytes_per_line < width * 4) break;
+
+    Entry entry;
+    entry.offset = offset + kRecordHeaderSize + PaddedKeySize(key_size);
+    entry.width = width;
+    entry.height = height;
+    entry.bytes_per_line = bytes_per_line;
+    if (entry.offset + entry.data_size() > map_size_) break;
+
+    const QString key = QString::fromUtf8(reinterpret_cast<const char*>(map_ + offset + kRecordHeaderSize), static_cast<int>(key_size));
+    if (entries_.contains(key)) {
+      live_size_ -= kRecordHeaderSize + PaddedKeySize(key_size) + entries_[key].data_size();
+      entries_.remove(key);
+    }
+    if (width > 0 && height > 0) {
+      entries_.insert(key, entry);
+      live_size_ += kRecordHeaderSize + PaddedKeySize(key_size) + entry.data_size();
+    }
+
+    offset = entry.offset + entry.data_size();
+  }
+
+  // Drop a partly written record at the end, ie.: after a crash.
+  if (offset < map_size_) {
+    qLog(Debug) << "Truncating album icon cache" << file_.fileName() << "at" << offset;
+    file_.unmap(map_);
+    map_ = nullptr;
+    map_size_ = 0;
+    file_.resize(offset);
+  }
+
+  // Compact if most of the file is removed or replaced icons.
+  if (file_.size() > 1024 * 1024 && live_size_ < file_.size() / 2) {
+    Compact();
+  }
+
+}
+
+bool AlbumIconCache::WriteHeader(QFile *file) {
+
+  const quint32 header[2] = { kMagic, kVersion };
+  return file->write(reinterpret_cast<const char*>(header), sizeof(header)) == static_cast<qint64>(sizeof(header));
+
+}
+
+bool AlbumIconCache::WriteRecord(QFile *file, const QString &key, const qint32 width, const qint32 height, const qint32 bytes_per_line, const uchar *data, Entry *entry) {
+
+  const QByteArray key_data = key.toUtf8();
+  if (key_data.isEmpty() || key_data.size() > static_cast<int>(kMaxKeySize)) return false;
+
+  const quint32 key_size = static_cast<quint32>(key_data.size());
+  const qint32 header[3] = { width, height, bytes_per_line };
+
+  QByteArray record;
+  record.reserve(static_cast<int>(kRecordHeaderSize + PaddedKeySize(key_size)));
+  record.append(reinterpret_cast<const char*>(&key_size), sizeof(key_size));
+  record.append(reinterpret_cast<const char*>(header), sizeof(header));
+  record.append(key_data);
+  record.append(static_cast<int>(PaddedKeySize(key_size) - key_size), '\0');
+
+  const qint64 offset = file->size();
+  if (!file->seek(offset)) return false;
+  if (file->write(record) != record.size()) return false;
+
+  const qint64 data_size = static_cast<qint64>(height) * bytes_per_line;
+  if (data_size > 0 && file->write(reinterpret_cast<const char*>(data), data_size) != data_size) return false;
+
+  if (entry) {
+    entry->offset = offset + record.size();
+    entry->width = width;
+    entry->height = height;
+    entry->bytes_per_line = bytes_per_line;
+  }
+
+  return true;
+
+}
+
+QImage AlbumIconCache::Image(const QString &key) {
+
+  QHash<QString, Entry>::const_iterator it = entries_.constFind(key);
+  if (it == entries_.constEnd()) return QImage();
+
+  const Entry &entry = it.value();
+  // Icons written since the file was mapped need a new mapping.
+  if (entry.offset + entry.data_size() > map_size_ && (!Map() || entry.offset + entry.data_size() > map_size_)) return QImage();
+
+  // Copy, the mapping is replaced when the file grows.
+  return QImage(map_ + entry.offset, entry.width, entry.height, entry.bytes_per_line, QImage::Format_ARGB32_Premultiplied).copy();
+
+}
+
+bool AlbumIconCache::Insert(const QString &key, const QImage &image) {
+
+  if (!file_.isOpen() || image.isNull() || image.width() > kMaxIconSize || image.height() > kMaxIconSize) return false;
+
+  const QImage pixels = image.format() == QImage::Format_ARGB32_Premultiplied ? image : image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+
+  Entry entry;
+  const qint64 offset = file_.size();
+  if (!WriteRecord(&file_, key, pixels.width(), pixels.height(), static_cast<qint32>(pixels.bytesPerLine()), pixels.constBits(), &entry)) {
+    qLog(Error) << "Unable to write album icon cache" << file_.fileName() << file_.errorString();
+    file_.resize(offset);
+    return false;
+  }
+
+  const qint64 padded_key_size = entry.offset - offset - kRecordHeaderSize;
+  if (entries_.contains(key)) {
+    live_size_ -= kRecordHeaderSize + padded_key_size + entries_[key].data_size();
+  }
+  entries_.insert(key, entry);
+  live_size_ += kRecordHeaderSize + padded_key_size + entry.data_size();
+
+  if (maximum_size_ > 0 && file_.size() > maximum_size_) {
+    CompactTo(maximum_size_ * 3 / 4);
+  }
+
+  return true;
+
+}
+
+void AlbumIconCache::Remove(const QString &key) {
+
+  if (!file_.isOpen() || !entries_.contains(key)) return;
+
+  const Entry entry = entries_.take(key);
+  live_size_ -= kRecordHeaderSize + PaddedKeySize(key.toUtf8().size()) + entry.data_size();
+
+  const qint64 offset = file_.size();
+  if (!WriteRecord(&file_, key, 0, 0, 0, nullptr, nullptr)) {
+    qLog(Error) << "Unable to write album icon cache" << file_.fileName() << file_.errorString();
+    file_.resize(offset);
+  }
+
+}
+
+void AlbumIconCache::Clear() {
+
+  if (map_) {
+    file_.unmap(map_);
+    map_ = nullptr;
+  }
+  map_size_ = 0;
+  entries_.clear();
+  live_size_ = 0;
+
+  if (!file_.isOpen()) return;
+
+  if (!file_.resize(0) || !file_.seek(0) || !WriteHeader(&file_)) {
+    qLog(Error) << "Unable to reset album icon cache" << file_.fileName() << file_.errorString();
+  }
+  file_.flush();
+
+}
+
+void AlbumIconCache::Compact() {
+  CompactTo(0);
+}
+
+void AlbumIconCache::CompactTo(const qint64 target_size) {
+
+  if (!file_.isOpen()) return;
+  if (!entries_.isEmpty() && !Map()) return;
+
+  // Keep the newest icons, they're written last.
+  QList<QPair<QString, Entry>> entries;
+  entries.reserve(static_cast<int>(entries_.count()));
+  for (QHash<QString, Entry>::const_iterator it = entries_.constBegin(); it != entries_.constEnd(); ++it) {
+    entries << qMakePair(it.key(), it.value());
+  }
+  std::sort(entries.begin(), entries.end(), [](const QPair<QString, Entry> &a, const QPair<QString, Entry> &b) { return a.second.offset < b.second.offset; });
+
+  qint64 live_size = live_size_;
+  int first = 0;
+  if (target_size > 0) {
+    while (first < entries.count() && live_size + kFileHeaderSize > target_size) {
+      live_size -= kRecordHeaderSize + PaddedKeySize(entries[first].first.toUtf8().size()) + entries[first].second.data_size();
+      ++first;
+    }
+  }
+
+  const QString filename = file_.fileName();
+  QFile compacted(filename + ".tmp");
+  if (!compacted.open(QIODevice::ReadWrite | QIODevice::Truncate) || !WriteHeader(&compacted)) {
+    qLog(Error) << "Unable to compact album icon cache" << compacted.fileName() << compacted.errorString();
+    compacted.remove();
+    return;
+  }
+
+  QHash<QString, Entry> compacted_entries;
+  compacted_entries.reserve(entries.count() - first);
+  for (int i = first; i < entries.count(); ++i) {
+    const QString &key = entries[i].first;
+    const Entry &entry = entries[i].second;
+    Entry compacted_entry;
+    if (!WriteRecord(&compacted, key, entry.width, entry.height, entry.bytes_per_line, map_ + entry.offset, &compacted_entry)) {
+      qLog(Error) << "Unable to compact album icon cache" << compacted.fileName() << compacted.errorString();
+      compacted.remove();
+      return;
+    }
+    compacted_entries.insert(key, compacted_entry);
+  }
+  compacted.close();
+
+  Close();
+  if (!QFile::remove(filename)) {
+    // The old file is still intact, keep using it.
+    qLog(Error) << "Unable to replace album icon cache" << filename;
+    compacted.remove();
+    if (Open()) Map();
+    return;
+  }
+  const bool renamed = compacted.rename(filename);
+  file_.setFileName(filename);
+  if (!renamed) {
+    qLog(Error) << "Unable to replace album icon cache" << filename << compacted.errorString();
+    compacted.remove();
+    if (Open()) Clear();
+    return;
+  }
+  if (!Open()) {
+    entries_.clear();
+    live_size_ = 0;
+    return;
+  }
+
+  qLog(Debug) << "Compacted album icon cache from" << entries.count() << "to" << compacted_entries.count() << "icons";
+
+  entries_ = compacted_entries;
+  live_size_ = live_size;
+  Map();
+
+}
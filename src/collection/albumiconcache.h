@@ -0,0 +1,94 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2021, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef ALBUMICONCACHE_H
+#define ALBUMICONCACHE_H
+
+#include "config.h"
+
+#include <QtGlobal>
+#include <QHash>
+#include <QString>
+#include <QFile>
+#include <QImage>
+
+// Disk cache for the collection album icons.
+// Icons are stored as raw premultiplied ARGB32 pixels in a single append-only pack file which is memory mapped,
+// so loading an icon is a copy out of the mapping instead of decoding an image file.
+// The index of keys to offsets is built by scanning the pack file when it's opened.
+// Removed and replaced icons are left in the file until it's compacted.
+class AlbumIconCache {
+ public:
+  explicit AlbumIconCache(const QString &filename);
+  ~AlbumIconCache();
+
+  static const quint32 kMagic;
+  static const quint32 kVersion;
+
+  QString filename() const { return file_.fileName(); }
+
+  // Size of the pack file in bytes.
+  qint64 size() const { return file_.size(); }
+
+  int count() const { return static_cast<int>(entries_.count()); }
+
+  // When the pack file grows beyond this, it's compacted and the oldest icons are dropped. 0 means no limit.
+  qint64 maximum_size() const { return maximum_size_; }
+  void set_maximum_size(const qint64 maximum_size);
+
+  bool Contains(const QString &key) const { return entries_.contains(key); }
+
+  // Returns a null image if the key is not in the cache.
+  QImage Image(const QString &key);
+
+  bool Insert(const QString &key, const QImage &image);
+  void Remove(const QString &key);
+  void Clear();
+
+  // Rewrites the pack file with only the current icons.
+  void Compact();
+
+ private:
+  struct Entry {
+    Entry() : offset(0), width(0), height(0), bytes_per_line(0) {}
+    qint64 offset;
+    qint32 width;
+    qint32 height;
+    qint32 bytes_per_line;
+    qint64 data_size() const { return static_cast<qint64>(height) * bytes_per_line; }
+  };
+
+  bool Open();
+  void Close();
+  void Load();
+  bool Map();
+  bool WriteHeader(QFile *file);
+  bool WriteRecord(QFile *file, const QString &key, const qint32 width, const qint32 height, const qint32 bytes_per_line, const uchar *data, Entry *entry);
+  void CompactTo(const qint64 target_size);
+
+ private:
+  QFile file_;
+  uchar *map_;
+  qint64 map_size_;
+  QHash<QString, Entry> entries_;
+  qint64 live_size_;
+  qint64 maximum_size_;
+};
+
+#endif  // ALBUMICONCACHE_H
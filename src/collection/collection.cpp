@@ -49,6 +49,7 @@ const char *SCollection::kSongsTable = "songs";
 const char *SCollection::kFtsTable = "songs_fts";
 const char *SCollection::kDirsTable = "directories";
 const char *SCollection::kSubdirsTable = "subdirectories";
+const char *SCollection::kDuplicatesTable = "duplicated_songs";
 
 SCollection::SCollection(Application *app, QObject *parent)
     : QObject(parent),
@@ -69,7 +70,7 @@ SCollection::SCollection(Application *app, QObject *parent)
   backend()->moveToThread(app->database()->thread());
   qLog(Debug) << backend_ << "moved to thread" << app->database()->thread();
 
-  backend_->Init(app->database(), app->task_manager(), Song::Source_Collection, kSongsTable, kFtsTable, kDirsTable, kSubdirsTable);
+  backend_->Init(app->database(), app->task_manager(), Song::Source_Collection, kSongsTable, kFtsTable, kDirsTable, kSubdirsTable, kDuplicatesTable);
 
   model_ = new CollectionModel(backend_, app_, this);
 
@@ -119,6 +120,7 @@ void SCollection::Init() {
 
   QObject::connect(watcher_, &CollectionWatcher::NewOrUpdatedSongs, backend_, &CollectionBackend::AddOrUpdateSongs);
   QObject::connect(watcher_, &CollectionWatcher::SongsMTimeUpdated, backend_, &CollectionBackend::UpdateMTimesOnly);
+  QObject::connect(watcher_, &CollectionWatcher::SongsFingerprintUpdated, backend_, &CollectionBackend::UpdateFingerprints);
   QObject::connect(watcher_, &CollectionWatcher::SongsDeleted, backend_, &CollectionBackend::DeleteSongs);
   QObject::connect(watcher_, &CollectionWatcher::SongsUnavailable, backend_, &CollectionBackend::MarkSongsUnavailable);
   QObject::connect(watcher_, &CollectionWatcher::SongsReadded, backend_, &CollectionBackend::MarkSongsUnavailable);
@@ -50,6 +50,7 @@ class SCollection : public QObject {
   static const char *kFtsTable;
   static const char *kDirsTable;
   static const char *kSubdirsTable;
+  static const char *kDuplicatesTable;
 
   void Init();
   void Exit();
@@ -30,6 +30,7 @@
 #include <QMutex>
 #include <QSet>
 #include <QMap>
+#include <QHash>
 #include <QVector>
 #include <QVariant>
 #include <QByteArray>
@@ -38,6 +39,7 @@
 #include <QUrl>
 #include <QFileInfo>
 #include <QDateTime>
+#include <QElapsedTimer>
 #include <QRegularExpression>
 #include <QSqlDatabase>
 #include <QSqlQuery>
@@ -56,6 +58,9 @@
 #include "collectionquery.h"
 #include "collectiontask.h"
 
+const int CollectionBackend::kMaxIdsPerQuery = 500;
+const char *CollectionBackend::kFingerprintCacheTable = "fingerprint_cache";
+
 CollectionBackend::CollectionBackend(QObject *parent)
     : CollectionBackendInterface(parent),
       db_(nullptr),
@@ -67,7 +72,7 @@ CollectionBackend::CollectionBackend(QObject *parent)
 
 }
 
-void CollectionBackend::Init(Database *db, TaskManager *task_manager, const Song::Source source, const QString &songs_table, const QString &fts_table, const QString &dirs_table, const QString &subdirs_table) {
+void CollectionBackend::Init(Database *db, TaskManager *task_manager, const Song::Source source, const QString &songs_table, const QString &fts_table, const QString &dirs_table, const QString &subdirs_table, const QString &duplicates_table) {
 
   db_ = db;
   task_manager_ = task_manager;
@@ -76,6 +81,7 @@ void CollectionBackend::Init(Database *db, TaskManager *task_manager, const Song
   dirs_table_ = dirs_table;
   subdirs_table_ = subdirs_table;
   fts_table_ = fts_table;
+  duplicates_table_ = duplicates_table;
 
 }
 
@@ -512,7 +518,7 @@ void CollectionBackend::AddOrUpdateSubdirs(const CollectionSubdirectoryList &sub
 
 SongList CollectionBackend::GetAllSongs() {
 
-  QMutexLocker l(db_->Mutex());
+  QMutexLocker l(db_->ReadMutex());
   QSqlDatabase db(db_->Connect());
 
   SqlQuery q(db);
@@ -541,139 +547,152 @@ void CollectionBackend::AddOrUpdateSongs(const SongList &songs) {
   QMutexLocker l(db_->Mutex());
   QSqlDatabase db(db_->Connect());
 
+  QElapsedTimer timer;
+  timer.start();
+
   ScopedTransaction transaction(&db);
 
-  SongList added_songs;
-  SongList deleted_songs;
+  // Do a sanity check first - make sure the songs directories still exists
+  // This is to fix a possible race condition when a directory is removed while CollectionWatcher is scanning it.
+  QSet<int> directory_ids;
+  if (!dirs_table_.isEmpty()) {
+    QStringList song_directory_ids;
+    for (const Song &song : songs) {
+      const QString directory_id = QString::number(song.directory_id());
+      if (!song_directory_ids.contains(directory_id)) song_directory_ids << directory_id;
+    }
+    SqlQuery check_dirs(db);
+    check_dirs.prepare(QString("SELECT ROWID FROM %1 WHERE ROWID IN (%2)").arg(dirs_table_, song_directory_ids.join(",")));
+    if (!check_dirs.Exec()) {
+      db_->ReportErrors(check_dirs);
+      return;
+    }
+    while (check_dirs.next()) {
+      directory_ids.insert(check_dirs.value(0).toInt());
+    }
+  }
 
+  // Get the previous song data for all songs up front instead of one query per song
+  QStringList ids;
+  QStringList song_ids;
   for (const Song &song : songs) {
-
-    // Do a sanity check first - make sure the song's directory still exists
-    // This is to fix a possible race condition when a directory is removed while CollectionWatcher is scanning it.
-    if (!dirs_table_.isEmpty()) {
-      SqlQuery check_dir(db);
-      check_dir.prepare(QString("SELECT ROWID FROM %1 WHERE ROWID = :id").arg(dirs_table_));
-      check_dir.BindValue(":id", song.directory_id());
-      if (!check_dir.Exec()) {
-        db_->ReportErrors(check_dir);
-        return;
-      }
-
-      if (!check_dir.next()) continue;
-
+    if (!dirs_table_.isEmpty() && !directory_ids.contains(song.directory_id())) continue;
+    if (song.id() != -1) {
+      ids << QString::number(song.id());
     }
+    else if (!song.song_id().isEmpty()) {
+      song_ids << song.song_id();
+    }
+  }
 
-    if (song.id() != -1) {  // This song exists in the DB.
+  QHash<int, Song> old_songs_by_id;
+  for (qint64 i = 0; i < ids.count(); i += kMaxIdsPerQuery) {
+    const SongList old_songs = GetSongsById(ids.mid(i, kMaxIdsPerQuery), db);
+    for (const Song &old_song : old_songs) {
+      old_songs_by_id.insert(old_song.id(), old_song);
+    }
+  }
 
-      // Get the previous song data first
-      Song old_song(GetSongById(song.id()));
-      if (!old_song.is_valid()) continue;
+  QHash<QString, Song> old_songs_by_song_id;
+  for (qint64 i = 0; i < song_ids.count(); i += kMaxIdsPerQuery) {
+    const SongList old_songs = GetSongsBySongId(song_ids.mid(i, kMaxIdsPerQuery), db);
+    for (const Song &old_song : old_songs) {
+      old_songs_by_song_id.insert(old_song.song_id(), old_song);
+    }
+  }
 
-      // Update
-      {
-        SqlQuery q(db);
-        q.prepare(QString("UPDATE %1 SET " + Song::kUpdateSpec + " WHERE ROWID = :id").arg(songs_table_));
-        song.BindToQuery(&q);
-        q.BindValue(":id", song.id());
-        if (!q.Exec()) {
-          db_->ReportErrors(q);
-          return;
-        }
-      }
+  // Prepare the statements once for the whole transaction
+  SqlQuery update(db);
+  update.prepare(QString("UPDATE %1 SET " + Song::kUpdateSpec + " WHERE ROWID = :id").arg(songs_table_));
+  SqlQuery update_fts(db);
+  update_fts.prepare(QString("UPDATE %1 SET " + Song::kFtsUpdateSpec + " WHERE ROWID = :id").arg(fts_table_));
+  SqlQuery insert(db);
+  insert.prepare(QString("INSERT INTO %1 (" + Song::kColumnSpec + ") VALUES (" + Song::kBindSpec + ")").arg(songs_table_));
+  SqlQuery insert_fts(db);
+  insert_fts.prepare(QString("INSERT INTO %1 (ROWID, " + Song::kFtsColumnSpec + ") VALUES (:id, " + Song::kFtsBindSpec + ")").arg(fts_table_));
 
-      {
-        SqlQuery q(db);
-        q.prepare(QString("UPDATE %1 SET " + Song::kFtsUpdateSpec + " WHERE ROWID = :id").arg(fts_table_));
-        song.BindToFtsQuery(&q);
-        q.BindValue(":id", song.id());
-        if (!q.Exec()) {
-          db_->ReportErrors(q);
-          return;
-        }
-      }
+  SongList added_songs;
+  SongList deleted_songs;
 
-      deleted_songs << old_song;
-      added_songs << song;
+  for (const Song &song : songs) {
 
-      continue;
+    if (!dirs_table_.isEmpty() && !directory_ids.contains(song.directory_id())) continue;
 
+    Song old_song;
+    if (song.id() != -1) {  // This song exists in the DB.
+      old_song = old_songs_by_id.value(song.id());
+      if (!old_song.is_valid()) continue;
     }
     else if (!song.song_id().isEmpty()) {  // Song has a unique id, check if the song exists.
+      old_song = old_songs_by_song_id.value(song.song_id());
+    }
 
-      // Get the previous song data first
-      Song old_song(GetSongBySongId(song.song_id()));
+    if (old_song.is_valid() && old_song.id() != -1) {
 
-      if (old_song.is_valid() && old_song.id() != -1) {
+      Song new_song = song;
+      new_song.set_id(old_song.id());
 
-        Song new_song = song;
-        new_song.set_id(old_song.id());
+      // Update
+      new_song.BindToQuery(&update);
+      update.BindValue(":id", new_song.id());
+      if (!update.Exec()) {
+        db_->ReportErrors(update);
+        return;
+      }
 
-        // Update
-        {
-          SqlQuery q(db);
-          q.prepare(QString("UPDATE %1 SET " + Song::kUpdateSpec + " WHERE ROWID = :id").arg(songs_table_));
-          new_song.BindToQuery(&q);
-          q.BindValue(":id", new_song.id());
-          if (!q.Exec()) {
-            db_->ReportErrors(q);
-            return;
-          }
-        }
+      new_song.BindToFtsQuery(&update_fts);
+      update_fts.BindValue(":id", new_song.id());
+      if (!update_fts.Exec()) {
+        db_->ReportErrors(update_fts);
+        return;
+      }
 
-        {
-          SqlQuery q(db);
-          q.prepare(QString("UPDATE %1 SET " + Song::kFtsUpdateSpec + " WHERE ROWID = :id").arg(fts_table_));
-          new_song.BindToFtsQuery(&q);
-          q.BindValue(":id", new_song.id());
-          if (!q.Exec()) {
-            db_->ReportErrors(q);
-            return;
-          }
-        }
+      deleted_songs << old_song;
+      added_songs << new_song;
 
-        deleted_songs << old_song;
-        added_songs << new_song;
+      continue;
 
-        continue;
-      }
     }
 
     // Create new song
 
-    int id = -1;
-    {  // Insert the row and create a new ID
-      SqlQuery q(db);
-      q.prepare(QString("INSERT INTO %1 (" + Song::kColumnSpec + ") VALUES (" + Song::kBindSpec + ")").arg(songs_table_));
-      song.BindToQuery(&q);
-      if (!q.Exec()) {
-        db_->ReportErrors(q);
-        return;
-      }
-      // Get the new ID
-      id = q.lastInsertId().toInt();
+    song.BindToQuery(&insert);
+    if (!insert.Exec()) {
+      db_->ReportErrors(insert);
+      return;
     }
-
+    // Get the new ID
+    const int id = insert.lastInsertId().toInt();
     if (id == -1) return;
 
-    {  // Add to the FTS index
-      SqlQuery q(db);
-      q.prepare(QString("INSERT INTO %1 (ROWID, " + Song::kFtsColumnSpec + ") VALUES (:id, " + Song::kFtsBindSpec + ")").arg(fts_table_));
-      q.BindValue(":id", id);
-      song.BindToFtsQuery(&q);
-      if (!q.Exec()) {
-        db_->ReportErrors(q);
-        return;
-      }
+    // Add to the FTS index
+    insert_fts.BindValue(":id", id);
+    song.BindToFtsQuery(&insert_fts);
+    if (!insert_fts.Exec()) {
+      db_->ReportErrors(insert_fts);
+      return;
     }
 
     Song song_copy(song);
     song_copy.set_id(id);
     added_songs << song_copy;
 
+    // The same song could be in this list more than once
+    if (!song_copy.song_id().isEmpty()) {
+      old_songs_by_song_id.insert(song_copy.song_id(), song_copy);
+    }
+
   }
 
+  if (!UpdateDuplicates(db, deleted_songs + added_songs)) return;
+
   transaction.Commit();
 
+  const qint64 elapsed = timer.elapsed();
+  const qint64 updated = deleted_songs.count();
+  const qint64 inserted = added_songs.count() - updated;
+  qLog(Debug) << "Inserted" << inserted << "and updated" << updated << "songs in" << elapsed << "ms," << (elapsed > 0 ? (inserted + updated) * 1000 / elapsed : inserted + updated) << "songs per second.";
+
   if (!deleted_songs.isEmpty()) emit SongsDeleted(deleted_songs);
   if (!added_songs.isEmpty()) emit SongsDiscovered(added_songs);
 
@@ -804,6 +823,8 @@ void CollectionBackend::UpdateSongsBySongID(const SongMap &new_songs) {
     }
   }
 
+  if (!UpdateDuplicates(db, deleted_songs + added_songs)) return;
+
   transaction.Commit();
 
   if (!deleted_songs.isEmpty()) emit SongsDeleted(deleted_songs);
@@ -815,6 +836,44 @@ void CollectionBackend::UpdateSongsBySongID(const SongMap &new_songs) {
 
 }
 
+bool CollectionBackend::UpdateDuplicates(QSqlDatabase &db, const SongList &songs) {
+
+  if (duplicates_table_.isEmpty() || songs.isEmpty()) return true;
+
+  // Songs with an empty artist, album or title are never duplicates.
+  QSet<QStringList> keys;
+  for (const Song &song : songs) {
+    if (song.artist().isEmpty() || song.album().isEmpty() || song.title().isEmpty()) continue;
+    keys.insert(QStringList() << song.artist() << song.album() << song.title());
+  }
+  if (keys.isEmpty()) return true;
+
+  SqlQuery remove(db);
+  remove.prepare(QString("DELETE FROM %1 WHERE dup_artist = :artist AND dup_album = :album AND dup_title = :title").arg(duplicates_table_));
+  SqlQuery insert(db);
+  insert.prepare(QString("INSERT INTO %1 (dup_artist, dup_album, dup_title) SELECT artist, album, title FROM %2 WHERE artist = :artist AND album = :album AND title = :title AND unavailable = 0 GROUP BY artist, album, title HAVING COUNT(*) > 1").arg(duplicates_table_, songs_table_));
+
+  for (const QStringList &key : keys) {
+    remove.BindValue(":artist", key[0]);
+    remove.BindValue(":album", key[1]);
+    remove.BindValue(":title", key[2]);
+    if (!remove.Exec()) {
+      db_->ReportErrors(remove);
+      return false;
+    }
+    insert.BindValue(":artist", key[0]);
+    insert.BindValue(":album", key[1]);
+    insert.BindValue(":title", key[2]);
+    if (!insert.Exec()) {
+      db_->ReportErrors(insert);
+      return false;
+    }
+  }
+
+  return true;
+
+}
+
 void CollectionBackend::UpdateMTimesOnly(const SongList &songs) {
 
   QMutexLocker l(db_->Mutex());
@@ -836,6 +895,93 @@ void CollectionBackend::UpdateMTimesOnly(const SongList &songs) {
 
 }
 
+void CollectionBackend::UpdateFingerprints(const SongList &songs) {
+
+  QMutexLocker l(db_->Mutex());
+  QSqlDatabase db(db_->Connect());
+
+  // Match by URL, songs can be fingerprinted before they have an ID, and all CUE sections share the fingerprint of the file.
+  SqlQuery q(db);
+  q.prepare(QString("UPDATE %1 SET fingerprint = :fingerprint WHERE url = :url").arg(songs_table_));
+
+  ScopedTransaction transaction(&db);
+  for (const Song &song : songs) {
+    q.BindStringValue(":fingerprint", song.fingerprint());
+    q.BindUrlValue(":url", song.url());
+    if (!q.Exec()) {
+      db_->ReportErrors(q);
+      return;
+    }
+  }
+  transaction.Commit();
+
+}
+
+QString CollectionBackend::GetCachedFingerprint(const QUrl &url, const quint64 inode, const qint64 filesize, const qint64 mtime) {
+
+  QMutexLocker l(db_->Mutex());
+  QSqlDatabase db(db_->Connect());
+
+  SqlQuery q(db);
+  q.prepare(QString("SELECT fingerprint FROM %1 WHERE url = :url AND inode = :inode AND filesize = :filesize AND mtime = :mtime").arg(kFingerprintCacheTable));
+  q.BindUrlValue(":url", url);
+  q.BindValue(":inode", inode);
+  q.BindValue(":filesize", filesize);
+  q.BindValue(":mtime", mtime);
+  if (!q.Exec()) {
+    db_->ReportErrors(q);
+    return QString();
+  }
+
+  if (q.next()) return q.value(0).toString();
+
+  return QString();
+
+}
+
+QString CollectionBackend::GetCachedFingerprint(const QByteArray &audio_hash) {
+
+  if (audio_hash.isEmpty()) return QString();
+
+  QMutexLocker l(db_->Mutex());
+  QSqlDatabase db(db_->Connect());
+
+  SqlQuery q(db);
+  q.prepare(QString("SELECT fingerprint FROM %1 WHERE audio_hash = :audio_hash").arg(kFingerprintCacheTable));
+  q.BindValue(":audio_hash", QString::fromLatin1(audio_hash));
+  if (!q.Exec()) {
+    db_->ReportErrors(q);
+    return QString();
+  }
+
+  if (q.next()) return q.value(0).toString();
+
+  return QString();
+
+}
+
+void CollectionBackend::AddCachedFingerprint(const QUrl &url, const quint64 inode, const qint64 filesize, const qint64 mtime, const QByteArray &audio_hash, const QString &fingerprint) {
+
+  if (audio_hash.isEmpty() || fingerprint.isEmpty()) return;
+
+  QMutexLocker l(db_->Mutex());
+  QSqlDatabase db(db_->Connect());
+
+  // Only keep the latest entry for each file.
+  SqlQuery q(db);
+  q.prepare(QString("INSERT OR REPLACE INTO %1 (url, inode, filesize, mtime, audio_hash, fingerprint) VALUES (:url, :inode, :filesize, :mtime, :audio_hash, :fingerprint)").arg(kFingerprintCacheTable));
+  q.BindUrlValue(":url", url);
+  q.BindValue(":inode", inode);
+  q.BindValue(":filesize", filesize);
+  q.BindValue(":mtime", mtime);
+  q.BindValue(":audio_hash", QString::fromLatin1(audio_hash));
+  q.BindValue(":fingerprint", fingerprint);
+  if (!q.Exec()) {
+    db_->ReportErrors(q);
+  }
+
+}
+
 void CollectionBackend::DeleteSongs(const SongList &songs) {
 
   QMutexLocker l(db_->Mutex());
@@ -845,6 +991,8 @@ void CollectionBackend::DeleteSongs(const SongList &songs) {
   remove.prepare(QString("DELETE FROM %1 WHERE ROWID = :id").arg(songs_table_));
   SqlQuery remove_fts(db);
   remove_fts.prepare(QString("DELETE FROM %1 WHERE ROWID = :id").arg(fts_table_));
+  SqlQuery remove_fingerprint(db);
+  remove_fingerprint.prepare(QString("DELETE FROM %1 WHERE url = :url").arg(kFingerprintCacheTable));
 
   ScopedTransaction transaction(&db);
   for (const Song &song : songs) {
@@ -859,7 +1007,16 @@ void CollectionBackend::DeleteSongs(const SongList &songs) {
       db_->ReportErrors(remove_fts);
       return;
     }
+
+    if (song.url().isLocalFile()) {
+      remove_fingerprint.BindUrlValue(":url", song.url());
+      if (!remove_fingerprint.Exec()) {
+        db_->ReportErrors(remove_fingerprint);
+        return;
+      }
+    }
   }
+  if (!UpdateDuplicates(db, songs)) return;
   transaction.Commit();
 
   emit SongsDeleted(songs);
@@ -886,6 +1043,7 @@ void CollectionBackend::MarkSongsUnavailable(const SongList &songs, const bool u
       return;
     }
   }
+  if (!UpdateDuplicates(db, songs)) return;
   transaction.Commit();
 
   if (unavailable) {
@@ -903,7 +1061,7 @@ void CollectionBackend::MarkSongsUnavailable(const SongList &songs, const bool u
 
 QStringList CollectionBackend::GetAll(const QString &column, const CollectionFilterOptions &filter_options) {
 
-  QMutexLocker l(db_->Mutex());
+  QMutexLocker l(db_->ReadMutex());
   QSqlDatabase db(db_->Connect());
 
   CollectionQuery query(db, songs_table_, fts_table_, filter_options);
@@ -930,7 +1088,7 @@ QStringList CollectionBackend::GetAllArtists(const CollectionFilterOptions &opt)
 
 QStringList CollectionBackend::GetAllArtistsWithAlbums(const CollectionFilterOptions &opt) {
 
-  QMutexLocker l(db_->Mutex());
+  QMutexLocker l(db_->ReadMutex());
   QSqlDatabase db(db_->Connect());
 
   // Albums with 'albumartist' field set:
@@ -979,7 +1137,7 @@ CollectionBackend::AlbumList CollectionBackend::GetAlbumsByArtist(const QString
 SongList CollectionBackend::GetArtistSongs(const QString &effective_albumartist, const CollectionFilterOptions &opt) {
 
   QSqlDatabase db(db_->Connect());
-  QMutexLocker l(db_->Mutex());
+  QMutexLocker l(db_->ReadMutex());
 
   CollectionQuery query(db, songs_table_, fts_table_, opt);
   query.AddCompilationRequirement(false);
@@ -997,7 +1155,7 @@ SongList CollectionBackend::GetArtistSongs(const QString &effective_albumartist,
 SongList CollectionBackend::GetAlbumSongs(const QString &effective_albumartist, const QString &album, const CollectionFilterOptions &opt) {
 
   QSqlDatabase db(db_->Connect());
-  QMutexLocker l(db_->Mutex());
+  QMutexLocker l(db_->ReadMutex());
 
   CollectionQuery query(db, songs_table_, fts_table_, opt);
   query.AddCompilationRequirement(false);
@@ -1016,7 +1174,7 @@ SongList CollectionBackend::GetAlbumSongs(const QString &effective_albumartist,
 SongList CollectionBackend::GetSongsByAlbum(const QString &album, const CollectionFilterOptions &opt) {
 
   QSqlDatabase db(db_->Connect());
-  QMutexLocker l(db_->Mutex());
+  QMutexLocker l(db_->ReadMutex());
 
   CollectionQuery query(db, songs_table_, fts_table_, opt);
   query.AddCompilationRequirement(false);
@@ -1063,7 +1221,7 @@ bool CollectionBackend::ExecCollectionQuery(CollectionQuery *query, SongMap &son
 
 Song CollectionBackend::GetSongById(const int id) {
 
-  QMutexLocker l(db_->Mutex());
+  QMutexLocker l(db_->ReadMutex());
   QSqlDatabase db(db_->Connect());
   return GetSongById(id, db);
 
@@ -1071,7 +1229,7 @@ Song CollectionBackend::GetSongById(const int id) {
 
 SongList CollectionBackend::GetSongsById(const QList<int> &ids) {
 
-  QMutexLocker l(db_->Mutex());
+  QMutexLocker l(db_->ReadMutex());
   QSqlDatabase db(db_->Connect());
 
   QStringList str_ids;
@@ -1080,13 +1238,17 @@ SongList CollectionBackend::GetSongsById(const QList<int> &ids) {
     str_ids << QString::number(id);
   }
 
-  return GetSongsById(str_ids, db);
+  SongList ret;
+  for (qint64 i = 0; i < str_ids.count(); i += kMaxIdsPerQuery) {
+    ret << GetSongsById(str_ids.mid(i, kMaxIdsPerQuery), db);
+  }
+  return ret;
 
 }
 
 SongList CollectionBackend::GetSongsById(const QStringList &ids) {
 
-  QMutexLocker l(db_->Mutex());
+  QMutexLocker l(db_->ReadMutex());
   QSqlDatabase db(db_->Connect());
 
   return GetSongsById(ids, db);
@@ -1095,7 +1257,7 @@ SongList CollectionBackend::GetSongsById(const QStringList &ids) {
 
 SongList CollectionBackend::GetSongsByForeignId(const QStringList &ids, const QString &table, const QString &column) {
 
-  QMutexLocker l(db_->Mutex());
+  QMutexLocker l(db_->ReadMutex());
   QSqlDatabase db(db_->Connect());
 
   QString in = ids.join(",");
@@ -1150,7 +1312,7 @@ SongList CollectionBackend::GetSongsById(const QStringList &ids, QSqlDatabase &d
 
 Song CollectionBackend::GetSongByUrl(const QUrl &url, const qint64 beginning) {
 
-  QMutexLocker l(db_->Mutex());
+  QMutexLocker l(db_->ReadMutex());
   QSqlDatabase db(db_->Connect());
 
   SqlQuery q(db);
@@ -1180,7 +1342,7 @@ Song CollectionBackend::GetSongByUrl(const QUrl &url, const qint64 beginning) {
 
 SongList CollectionBackend::GetSongsByUrl(const QUrl &url, const bool unavailable) {
 
-  QMutexLocker l(db_->Mutex());
+  QMutexLocker l(db_->ReadMutex());
   QSqlDatabase db(db_->Connect());
 
   SqlQuery q(db);
@@ -1211,7 +1373,7 @@ SongList CollectionBackend::GetSongsByUrl(const QUrl &url, const bool unavailabl
 
 Song CollectionBackend::GetSongBySongId(const QString &song_id) {
 
-  QMutexLocker l(db_->Mutex());
+  QMutexLocker l(db_->ReadMutex());
   QSqlDatabase db(db_->Connect());
   return GetSongBySongId(song_id, db);
 
@@ -1219,7 +1381,7 @@ Song CollectionBackend::GetSongBySongId(const QString &song_id) {
 
 SongList CollectionBackend::GetSongsBySongId(const QStringList &song_ids) {
 
-  QMutexLocker l(db_->Mutex());
+  QMutexLocker l(db_->ReadMutex());
   QSqlDatabase db(db_->Connect());
 
   return GetSongsBySongId(song_ids, db);
@@ -1261,10 +1423,68 @@ SongList CollectionBackend::GetSongsBySongId(const QStringList &song_ids, QSqlDa
 
 }
 
-SongList CollectionBackend::GetSongsByFingerprint(const QString &fingerprint) {
+SyncedAlbumMap CollectionBackend::GetSyncedAlbums() {
+
+  QMutexLocker l(db_->ReadMutex());
+  QSqlDatabase db(db_->Connect());
+
+  SqlQuery q(db);
+  q.prepare("SELECT album_id, signature FROM collection_sync WHERE songs_table = :songs_table");
+  q.BindValue(":songs_table", songs_table_);
+  if (!q.Exec()) {
+    db_->ReportErrors(q);
+    return SyncedAlbumMap();
+  }
+
+  SyncedAlbumMap albums;
+  while (q.next()) {
+    albums.insert(q.value(0).toString(), q.value(1).toString());
+  }
+
+  return albums;
+
+}
+
+void CollectionBackend::SetSyncedAlbumsAsync(const SyncedAlbumMap &albums) {
+  QMetaObject::invokeMethod(this, "SetSyncedAlbums", Qt::QueuedConnection, Q_ARG(SyncedAlbumMap, albums));
+}
+
+void CollectionBackend::SetSyncedAlbums(const SyncedAlbumMap &albums) {
 
   QMutexLocker l(db_->Mutex());
   QSqlDatabase db(db_->Connect());
+  ScopedTransaction t(&db);
+
+  {
+    SqlQuery q(db);
+    q.prepare("DELETE FROM collection_sync WHERE songs_table = :songs_table");
+    q.BindValue(":songs_table", songs_table_);
+    if (!q.Exec()) {
+      db_->ReportErrors(q);
+      return;
+    }
+  }
+
+  SqlQuery q(db);
+  q.prepare("INSERT INTO collection_sync (songs_table, album_id, signature) VALUES (:songs_table, :album_id, :signature)");
+  for (SyncedAlbumMap::const_iterator it = albums.constBegin(); it != albums.constEnd(); ++it) {
+    q.BindValue(":songs_table", songs_table_);
+    q.BindStringValue(":album_id", it.key());
+    q.BindStringValue(":signature", it.value());
+    if (!q.Exec()) {
+      db_->ReportErrors(q);
+      return;
+    }
+  }
+
+  t.Commit();
+
+}
+
+SongList CollectionBackend::GetSongsByFingerprint(const QString &fingerprint) {
+
+  QMutexLocker l(db_->ReadMutex());
+  QSqlDatabase db(db_->Connect());
 
   SqlQuery q(db);
   q.prepare(QString("SELECT ROWID, " + Song::kColumnSpec + " FROM %1 WHERE fingerprint = :fingerprint").arg(songs_table_));
@@ -1292,7 +1512,7 @@ CollectionBackend::AlbumList CollectionBackend::GetCompilationAlbums(const Colle
 
 SongList CollectionBackend::GetCompilationSongs(const QString &album, const CollectionFilterOptions &opt) {
 
-  QMutexLocker l(db_->Mutex());
+  QMutexLocker l(db_->ReadMutex());
   QSqlDatabase db(db_->Connect());
 
   CollectionQuery query(db, songs_table_, fts_table_, opt);
@@ -1429,7 +1649,7 @@ bool CollectionBackend::UpdateCompilations(const QSqlDatabase &db, SongList &del
 
 CollectionBackend::AlbumList CollectionBackend::GetAlbums(const QString &artist, const bool compilation_required, const CollectionFilterOptions &opt) {
 
-  QMutexLocker l(db_->Mutex());
+  QMutexLocker l(db_->ReadMutex());
   QSqlDatabase db(db_->Connect());
 
   CollectionQuery query(db, songs_table_, fts_table_, opt);
@@ -1510,7 +1730,7 @@ CollectionBackend::AlbumList CollectionBackend::GetAlbums(const QString &artist,
 
 CollectionBackend::Album CollectionBackend::GetAlbumArt(const QString &effective_albumartist, const QString &album) {
 
-  QMutexLocker l(db_->Mutex());
+  QMutexLocker l(db_->ReadMutex());
   QSqlDatabase db(db_->Connect());
 
   Album ret;
@@ -1827,6 +2047,25 @@ void CollectionBackend::DeleteAll() {
       }
     }
 
+    if (!duplicates_table_.isEmpty()) {
+      SqlQuery q(db);
+      q.prepare("DELETE FROM " + duplicates_table_);
+      if (!q.Exec()) {
+        db_->ReportErrors(q);
+        return;
+      }
+    }
+
+    {
+      SqlQuery q(db);
+      q.prepare("DELETE FROM collection_sync WHERE songs_table = :songs_table");
+      q.BindValue(":songs_table", songs_table_);
+      if (!q.Exec()) {
+        db_->ReportErrors(q);
+        return;
+      }
+    }
+
     t.Commit();
   }
 
@@ -1836,7 +2075,7 @@ void CollectionBackend::DeleteAll() {
 
 SongList CollectionBackend::SmartPlaylistsFindSongs(const SmartPlaylistSearch &search) {
 
-  QMutexLocker l(db_->Mutex());
+  QMutexLocker l(db_->ReadMutex());
   QSqlDatabase db(db_->Connect());
 
   // Build the query
@@ -1861,6 +2100,26 @@ SongList CollectionBackend::SmartPlaylistsFindSongs(const SmartPlaylistSearch &s
 
 }
 
+SmartPlaylistSampler::CandidateList CollectionBackend::SmartPlaylistsFindCandidates(const SmartPlaylistSearch &search) {
+
+  QMutexLocker l(db_->ReadMutex());
+  QSqlDatabase db(db_->Connect());
+
+  SmartPlaylistSampler::CandidateList ret;
+  SqlQuery query(db);
+  query.prepare(search.ToCandidatesSql(songs_table()));
+  if (!query.Exec()) {
+    db_->ReportErrors(query);
+    return ret;
+  }
+
+  while (query.next()) {
+    ret << SmartPlaylistSampler::Candidate(query.value(0).toInt(), query.value(1).toFloat(), query.value(2).toInt());
+  }
+  return ret;
+
+}
+
 SongList CollectionBackend::SmartPlaylistsGetAllSongs() {
 
   // Get all the songs!
@@ -1870,7 +2129,7 @@ SongList CollectionBackend::SmartPlaylistsGetAllSongs() {
 
 SongList CollectionBackend::GetSongsBy(const QString &artist, const QString &album, const QString &title) {
 
-  QMutexLocker l(db_->Mutex());
+  QMutexLocker l(db_->ReadMutex());
   QSqlDatabase db(db_->Connect());
 
   SongList songs;
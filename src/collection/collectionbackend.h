@@ -30,6 +30,7 @@
 #include <QObject>
 #include <QFileInfo>
 #include <QList>
+#include <QMap>
 #include <QString>
 #include <QStringList>
 #include <QUrl>
@@ -41,12 +42,16 @@
 #include "collectionfilteroptions.h"
 #include "collectionquery.h"
 #include "collectiondirectory.h"
+#include "smartplaylists/smartplaylistsampler.h"
 
 class QThread;
 class TaskManager;
 class Database;
 class SmartPlaylistSearch;
 
+// The albums received by the last sync of an internet service, with a signature to tell if they changed since.
+using SyncedAlbumMap = QMap<QString, QString>;
+
 class CollectionBackendInterface : public QObject {
   Q_OBJECT
 
@@ -135,7 +140,7 @@ class CollectionBackend : public CollectionBackendInterface {
 
   Q_INVOKABLE explicit CollectionBackend(QObject *parent = nullptr);
 
-  void Init(Database *db, TaskManager *task_manager, const Song::Source source, const QString &songs_table, const QString &fts_table, const QString &dirs_table = QString(), const QString &subdirs_table = QString());
+  void Init(Database *db, TaskManager *task_manager, const Song::Source source, const QString &songs_table, const QString &fts_table, const QString &dirs_table = QString(), const QString &subdirs_table = QString(), const QString &duplicates_table = QString());
   void Close();
 
   void ExitAsync();
@@ -150,6 +155,7 @@ class CollectionBackend : public CollectionBackendInterface {
   QString fts_table() const override { return fts_table_; }
   QString dirs_table() const { return dirs_table_; }
   QString subdirs_table() const { return subdirs_table_; }
+  QString duplicates_table() const { return duplicates_table_; }
 
   // Get a list of directories in the collection.  Emits DirectoriesDiscovered.
   void LoadDirectoriesAsync() override;
@@ -207,10 +213,14 @@ class CollectionBackend : public CollectionBackendInterface {
   Song GetSongBySongId(const QString &song_id);
   SongList GetSongsBySongId(const QStringList &song_ids);
 
+  SyncedAlbumMap GetSyncedAlbums();
+  void SetSyncedAlbumsAsync(const SyncedAlbumMap &albums);
+
   SongList GetSongsByFingerprint(const QString &fingerprint) override;
 
   SongList SmartPlaylistsGetAllSongs();
   SongList SmartPlaylistsFindSongs(const SmartPlaylistSearch &search);
+  SmartPlaylistSampler::CandidateList SmartPlaylistsFindCandidates(const SmartPlaylistSearch &search);
 
   void AddOrUpdateSongsAsync(const SongList &songs);
   void UpdateSongsBySongIDAsync(const SongMap &new_songs);
@@ -227,6 +237,12 @@ class CollectionBackend : public CollectionBackendInterface {
   void AddOrUpdateSongs(const SongList &songs);
   void UpdateSongsBySongID(const SongMap &new_songs);
   void UpdateMTimesOnly(const SongList &songs);
+  void UpdateFingerprints(const SongList &songs);
+  void SetSyncedAlbums(const SyncedAlbumMap &albums);
+
+  QString GetCachedFingerprint(const QUrl &url, const quint64 inode, const qint64 filesize, const qint64 mtime);
+  QString GetCachedFingerprint(const QByteArray &audio_hash);
+  void AddCachedFingerprint(const QUrl &url, const quint64 inode, const qint64 filesize, const qint64 mtime, const QByteArray &audio_hash, const QString &fingerprint);
   void DeleteSongs(const SongList &songs);
   void MarkSongsUnavailable(const SongList &songs, const bool unavailable = true);
   void AddOrUpdateSubdirs(const CollectionSubdirectoryList &subdirs);
@@ -291,7 +307,14 @@ class CollectionBackend : public CollectionBackendInterface {
   Song GetSongBySongId(const QString &song_id, QSqlDatabase &db);
   SongList GetSongsBySongId(const QStringList &song_ids, QSqlDatabase &db);
 
+  // Refreshes the duplicate groups of the given songs in the duplicates table, the songs can be the old and new versions.
+  bool UpdateDuplicates(QSqlDatabase &db, const SongList &songs);
+
  private:
+  // Maximum number of IDs in one "IN (...)" list, to stay below SQLite's statement length limit.
+  static const int kMaxIdsPerQuery;
+  static const char *kFingerprintCacheTable;
+
   Database *db_;
   TaskManager *task_manager_;
   Song::Source source_;
@@ -299,6 +322,7 @@ class CollectionBackend : public CollectionBackendInterface {
   QString dirs_table_;
   QString subdirs_table_;
   QString fts_table_;
+  QString duplicates_table_;
   QThread *original_thread_;
 
 };
@@ -31,9 +31,8 @@ class CollectionFilterOptions {
 
   // Filter mode:
   // - use the all songs table
-  // - use the duplicated songs view; by duplicated we mean those songs for which the (artist, album, title) tuple is found more than once in the songs table
+  // - use the duplicated songs table; by duplicated we mean those songs for which the (artist, album, title) tuple is found more than once in the songs table
   // - use the untagged songs view; by untagged we mean those for which at least one of the (artist, album, title) tags is empty
-  // Please note that additional filtering based on FTS table (the filter attribute) won't work in Duplicates and Untagged modes.
   enum FilterMode {
     FilterMode_All,
     FilterMode_Duplicates,
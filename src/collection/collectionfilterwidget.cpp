@@ -459,7 +459,6 @@ void CollectionFilterWidget::SetFilterHint(const QString &hint) {
 void CollectionFilterWidget::SetFilterMode(CollectionFilterOptions::FilterMode filter_mode) {
 
   ui_->search_field->clear();
-  ui_->search_field->setEnabled(filter_mode == CollectionFilterOptions::FilterMode_All);
 
   model_->SetFilterMode(filter_mode);
 
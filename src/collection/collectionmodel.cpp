@@ -50,9 +50,11 @@
 #include <QChar>
 #include <QRegularExpression>
 #include <QPixmapCache>
-#include <QNetworkDiskCache>
+#include <QDir>
 #include <QSettings>
 #include <QStandardPaths>
+#include <QSqlRecord>
+#include <QTimer>
 
 #include "core/application.h"
 #include "core/database.h"
@@ -67,6 +69,7 @@
 #include "collectiondirectorymodel.h"
 #include "collectionitem.h"
 #include "collectionmodel.h"
+#include "albumiconcache.h"
 #include "playlist/playlistmanager.h"
 #include "playlist/songmimedata.h"
 #include "covermanager/albumcoverloader.h"
@@ -74,9 +77,16 @@
 #include "settings/collectionsettingspage.h"
 
 const int CollectionModel::kPrettyCoverSize = 32;
+// The XPM disk cache used before the album icon cache, it's removed on startup.
 const char *CollectionModel::kPixmapDiskCacheDir = "pixmapcache";
+const char *CollectionModel::kIconCacheFile = "albumicons.cache";
+// SQLite allows 500 SELECT statements in a compound statement by default.
+const int CollectionModel::kPopulateBatchSize = 100;
+// SQLite before 3.32 allows 999 bound values in a statement.
+const int CollectionModel::kPopulateMaxBoundValues = 999;
+const int CollectionModel::kFilterUpdateSongsPerItem = 10;
 
-QNetworkDiskCache *CollectionModel::sIconCache = nullptr;
+AlbumIconCache *CollectionModel::sIconCache = nullptr;
 
 CollectionModel::CollectionModel(CollectionBackend *backend, Application *app, QObject *parent)
     : SimpleTreeModel<CollectionItem>(new CollectionItem(this), parent),
@@ -90,14 +100,27 @@ CollectionModel::CollectionModel(CollectionBackend *backend, Application *app, Q
       separate_albums_by_grouping_(false),
       artist_icon_(IconLoader::Load("folder-sound")),
       album_icon_(IconLoader::Load("cdcase")),
+      owns_icon_cache_(false),
       init_task_id_(-1),
       use_pretty_covers_(true),
       show_dividers_(true),
       use_disk_cache_(false),
-      use_lazy_loading_(true) {
+      use_lazy_loading_(true),
+      async_lazy_loading_(false),
+      timer_populate_(new QTimer(this)),
+      next_populate_id_(0),
+      populate_running_(false),
+      reset_id_(0),
+      reset_pending_(false),
+      filter_update_id_(0),
+      filter_song_ids_valid_(false) {
 
   root_->lazy_loaded = true;
 
+  timer_populate_->setSingleShot(true);
+  timer_populate_->setInterval(0);
+  QObject::connect(timer_populate_, &QTimer::timeout, this, &CollectionModel::PopulateQueuedItems);
+
   group_by_[0] = GroupBy_AlbumArtist;
   group_by_[1] = GroupBy_AlbumDisc;
   group_by_[2] = GroupBy_None;
@@ -119,8 +142,11 @@ CollectionModel::CollectionModel(CollectionBackend *backend, Application *app, Q
   }
 
   if (app_ && !sIconCache) {
-    sIconCache = new QNetworkDiskCache(this);
-    sIconCache->setCacheDirectory(QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/" + kPixmapDiskCacheDir);
+    const QString cache_path = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    QDir pixmap_disk_cache_dir(cache_path + "/" + kPixmapDiskCacheDir);
+    if (pixmap_disk_cache_dir.exists()) pixmap_disk_cache_dir.removeRecursively();
+    sIconCache = new AlbumIconCache(cache_path + "/" + kIconCacheFile);
+    owns_icon_cache_ = true;
     QObject::connect(app_, &Application::ClearPixmapDiskCache, this, &CollectionModel::ClearDiskCache);
   }
 
@@ -142,7 +168,14 @@ CollectionModel::CollectionModel(CollectionBackend *backend, Application *app, Q
 }
 
 CollectionModel::~CollectionModel() {
+
   delete root_;
+
+  if (owns_icon_cache_) {
+    delete sIconCache;
+    sIconCache = nullptr;
+  }
+
 }
 
 void CollectionModel::set_pretty_covers(const bool use_pretty_covers) {
@@ -173,7 +206,7 @@ void CollectionModel::ReloadSettings() {
   QPixmapCache::setCacheLimit(static_cast<int>(MaximumCacheSize(&s, CollectionSettingsPage::kSettingsCacheSize, CollectionSettingsPage::kSettingsCacheSizeUnit, CollectionSettingsPage::kSettingsCacheSizeDefault) / 1024));
 
   if (sIconCache) {
-    sIconCache->setMaximumCacheSize(MaximumCacheSize(&s, CollectionSettingsPage::kSettingsDiskCacheSize, CollectionSettingsPage::kSettingsDiskCacheSizeUnit, CollectionSettingsPage::kSettingsDiskCacheSizeDefault));
+    sIconCache->set_maximum_size(MaximumCacheSize(&s, CollectionSettingsPage::kSettingsDiskCacheSize, CollectionSettingsPage::kSettingsDiskCacheSizeUnit, CollectionSettingsPage::kSettingsDiskCacheSizeDefault));
   }
 
   s.endGroup();
@@ -186,6 +219,8 @@ void CollectionModel::ReloadSettings() {
 
 void CollectionModel::Init(const bool async) {
 
+  async_lazy_loading_ = async;
+
   if (async) {
     // Show a loading indicator in the model.
     CollectionItem *loading = new CollectionItem(CollectionItem::Type_LoadingIndicator, root_);
@@ -209,10 +244,21 @@ void CollectionModel::Init(const bool async) {
 
 void CollectionModel::SongsDiscovered(const SongList &songs) {
 
+  SongList matching_songs;
   for (const Song &song : songs) {
-
     // Sanity check to make sure we don't add songs that are outside the user's filter
     if (!filter_options_.Matches(song)) continue;
+    matching_songs << song;
+    if (filter_song_ids_valid_) filter_song_ids_.insert(song.id());
+  }
+
+  AddSongs(matching_songs);
+
+}
+
+void CollectionModel::AddSongs(const SongList &songs) {
+
+  for (const Song &song : songs) {
 
     // Hey, we've already got that one!
     if (song_nodes_.contains(song.id())) continue;
@@ -256,8 +302,15 @@ void CollectionModel::SongsDiscovered(const SongList &songs) {
 
       // If we just created the damn thing then we don't need to continue into it any further because it'll get lazy-loaded properly later.
       if (!container->lazy_loaded && use_lazy_loading_) break;
+
+      // If it's being populated, the song is added when the result is in.
+      if (populating_items_.contains(container)) break;
     }
     if (!container->lazy_loaded && use_lazy_loading_) continue;
+    if (populating_items_.contains(container)) {
+      populating_discovered_songs_ << song;
+      continue;
+    }
 
     // We've gone all the way down to the deepest level and everything was already lazy loaded, so now we have to create the song in the container.
     song_nodes_.insert(song.id(), ItemFromSong(GroupBy_None, separate_albums_by_grouping_, true, false, container, song, -1));
@@ -510,6 +563,8 @@ void CollectionModel::SongsDeleted(const SongList &songs) {
   QSet<CollectionItem*> parents;
   for (const Song &song : songs) {
 
+    filter_song_ids_.remove(song.id());
+
     if (song_nodes_.contains(song.id())) {
       CollectionItem *node = song_nodes_[song.id()];
 
@@ -530,7 +585,12 @@ void CollectionModel::SongsDeleted(const SongList &songs) {
     }
   }
 
-  // Now delete empty parents
+  DeleteEmptyParents(parents);
+
+}
+
+void CollectionModel::DeleteEmptyParents(QSet<CollectionItem*> parents) {
+
   QSet<QString> divider_keys;
   while (!parents.isEmpty()) {
     // Since we are going to remove elements from the container, we need a copy to iterate over.
@@ -559,7 +619,7 @@ void CollectionModel::SongsDeleted(const SongList &songs) {
       // Remove from pixmap cache
       const QString cache_key = AlbumIconPixmapCacheKey(ItemToIndex(node));
       QPixmapCache::remove(cache_key);
-      if (use_disk_cache_ && sIconCache) sIconCache->remove(QUrl(cache_key));
+      if (use_disk_cache_ && sIconCache) sIconCache->Remove(cache_key);
       if (pending_cache_keys_.contains(cache_key)) {
         pending_cache_keys_.remove(cache_key);
       }
@@ -629,13 +689,11 @@ QVariant CollectionModel::AlbumIcon(const QModelIndex &idx) {
 
   // Try to load it from the disk cache
   if (use_disk_cache_ && sIconCache) {
-    std::unique_ptr<QIODevice> cache(sIconCache->data(QUrl(cache_key)));
-    if (cache) {
-      QImage cached_image;
-      if (cached_image.load(cache.get(), "XPM")) {
-        QPixmapCache::insert(cache_key, QPixmap::fromImage(cached_image));
-        return QPixmap::fromImage(cached_image);
-      }
+    const QImage cached_image = sIconCache->Image(cache_key);
+    if (!cached_image.isNull()) {
+      const QPixmap pixmap = QPixmap::fromImage(cached_image);
+      QPixmapCache::insert(cache_key, pixmap);
+      return pixmap;
     }
   }
 
@@ -644,6 +702,12 @@ QVariant CollectionModel::AlbumIcon(const QModelIndex &idx) {
     return no_cover_icon_;
   }
 
+  // Don't block the view on the songs, populate the album in the background and update the icon when the songs are in.
+  if (async_lazy_loading_ && (!item->lazy_loaded || populating_items_.contains(item))) {
+    LazyPopulateAsync(item);
+    return no_cover_icon_;
+  }
+
   // No art is cached and we're not loading it already.  Load art for the first song in the album.
   SongList songs = GetChildSongs(idx);
   if (!songs.isEmpty()) {
@@ -680,18 +744,8 @@ void CollectionModel::AlbumCoverLoaded(const quint64 id, const AlbumCoverLoaderR
   }
 
   // If we have a valid cover not already in the disk cache
-  if (use_disk_cache_ && sIconCache && result.success && !result.image_scaled.isNull()) {
-    std::unique_ptr<QIODevice> cached_img(sIconCache->data(QUrl(cache_key)));
-    if (!cached_img) {
-      QNetworkCacheMetaData item_metadata;
-      item_metadata.setSaveToDisk(true);
-      item_metadata.setUrl(QUrl(cache_key));
-      QIODevice *cache = sIconCache->prepare(item_metadata);
-      if (cache) {
-        result.image_scaled.save(cache, "XPM");
-        sIconCache->insert(cache);
-      }
-    }
+  if (use_disk_cache_ && sIconCache && result.success && !result.image_scaled.isNull() && !sIconCache->Contains(cache_key)) {
+    sIconCache->Insert(cache_key, result.image_scaled);
   }
 
   const QModelIndex idx = ItemToIndex(item);
@@ -773,7 +827,7 @@ QVariant CollectionModel::data(const CollectionItem *item, const int role) const
       return item->metadata.artist();
 
     case Role_Editable:{
-      if (!item->lazy_loaded) {
+      if (!item->lazy_loaded || populating_items_.contains(const_cast<CollectionItem*>(item))) {
         const_cast<CollectionModel*>(this)->LazyPopulate(const_cast<CollectionItem*>(item), true);
       }
 
@@ -851,9 +905,9 @@ CollectionQueryOptions CollectionModel::PrepareQuery(CollectionItem *parent) {
 
 }
 
-CollectionModel::QueryResult CollectionModel::RunQuery(const CollectionFilterOptions &filter_options, const CollectionQueryOptions &query_options) {
+CollectionModel::QueryResult CollectionModel::RunQuery(const CollectionFilterOptions &filter_options, const CollectionQueryOptions &query_options, const bool query_song_ids) {
 
-  QMutexLocker l(backend_->db()->Mutex());
+  QMutexLocker l(backend_->db()->ReadMutex());
 
   QueryResult result;
   {
@@ -880,6 +934,11 @@ CollectionModel::QueryResult CollectionModel::RunQuery(const CollectionFilterOpt
       backend_->ReportErrors(q);
     }
 
+    if (query_song_ids) {
+      result.song_ids = QuerySongIds(db, filter_options);
+      result.song_ids_valid = true;
+    }
+
   }
 
   if (QThread::currentThread() != thread() && QThread::currentThread() != backend_->thread()) {
@@ -916,10 +975,28 @@ void CollectionModel::PostQuery(CollectionItem *parent, const CollectionModel::Q
 
 }
 
+void CollectionModel::LazyPopulate(CollectionItem *item) {
+
+  if (async_lazy_loading_) {
+    LazyPopulateAsync(item);
+  }
+  else {
+    LazyPopulate(item, true);
+  }
+
+}
+
 void CollectionModel::LazyPopulate(CollectionItem *parent, const bool signal) {
 
-  if (parent->lazy_loaded) return;
-  parent->lazy_loaded = true;
+  if (populating_items_.contains(parent)) {
+    // The songs are needed now, so don't wait for the background query, the result is ignored when it's in.
+    populating_items_.remove(parent);
+    RemoveLoadingIndicator(parent, signal);
+  }
+  else {
+    if (parent->lazy_loaded) return;
+    parent->lazy_loaded = true;
+  }
 
   CollectionQueryOptions query_options = PrepareQuery(parent);
   QueryResult result = RunQuery(filter_options_, query_options);
@@ -927,32 +1004,247 @@ void CollectionModel::LazyPopulate(CollectionItem *parent, const bool signal) {
 
 }
 
+void CollectionModel::LazyPopulateAsync(CollectionItem *parent) {
+
+  if (parent->lazy_loaded) return;
+  parent->lazy_loaded = true;
+
+  // Show a loading indicator under the item until the result is in.
+  const int row = static_cast<int>(parent->children.count());
+  beginInsertRows(ItemToIndex(parent), row, row);
+  CollectionItem *loading = new CollectionItem(CollectionItem::Type_LoadingIndicator, parent);
+  loading->display_text = tr("Loading...");
+  loading->lazy_loaded = true;
+  endInsertRows();
+
+  populating_items_.insert(parent, ++next_populate_id_);
+  populate_queue_ << parent;
+
+  // Items expanded together are batched, and while a batch is running the next one is collected.
+  if (!populate_running_ && !timer_populate_->isActive()) {
+    timer_populate_->start();
+  }
+
+}
+
+void CollectionModel::PopulateQueuedItems() {
+
+  if (populate_running_ || populate_queue_.isEmpty()) return;
+
+  QList<CollectionItem*> items;
+  QList<quint64> populate_ids;
+  QList<CollectionQueryOptions> query_options_list;
+  for (CollectionItem *item : std::as_const(populate_queue_)) {
+    // Skip items which were populated synchronously in the meantime.
+    if (!populating_items_.contains(item)) continue;
+    items << item;
+    populate_ids << populating_items_[item];
+    query_options_list << PrepareQuery(item);
+  }
+  populate_queue_.clear();
+
+  if (items.isEmpty()) return;
+
+  populate_running_ = true;
+
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+  QFuture<QList<CollectionModel::QueryResult>> future = QtConcurrent::run(&CollectionModel::RunQueries, this, filter_options_, query_options_list);
+#else
+  QFuture<QList<CollectionModel::QueryResult>> future = QtConcurrent::run(this, &CollectionModel::RunQueries, filter_options_, query_options_list);
+#endif
+  QFutureWatcher<QList<CollectionModel::QueryResult>> *watcher = new QFutureWatcher<QList<CollectionModel::QueryResult>>();
+  QObject::connect(watcher, &QFutureWatcher<QList<CollectionModel::QueryResult>>::finished, this, [this, watcher, items, populate_ids]() {
+    const QList<CollectionModel::QueryResult> results = watcher->result();
+    watcher->deleteLater();
+    PopulateFinished(items, populate_ids, results);
+  });
+  watcher->setFuture(future);
+
+}
+
+QList<CollectionModel::QueryResult> CollectionModel::RunQueries(const CollectionFilterOptions &filter_options, const QList<CollectionQueryOptions> &query_options_list) {
+
+  QMutexLocker l(backend_->db()->ReadMutex());
+
+  QList<QueryResult> results;
+  results.reserve(query_options_list.count());
+  for (int i = 0; i < query_options_list.count(); ++i) {
+    results << QueryResult();
+  }
+
+  {
+
+    QSqlDatabase db(backend_->db()->Connect());
+
+    // Queries for the same kind of children have the same columns and are combined into one statement.
+    QMap<QString, QList<int>> queries_by_column_spec;
+    for (int i = 0; i < query_options_list.count(); ++i) {
+      const CollectionQueryOptions &query_options = query_options_list[i];
+      if (query_options.query_have_compilations() && HasCompilations(db, filter_options, query_options)) {
+        results[i].create_va = true;
+      }
+      queries_by_column_spec[query_options.column_spec()] << i;
+    }
+
+    // The index of the query is added as the last column, so the rows can be given to the right item.
+    auto create_query = [this, &db, &filter_options, &query_options_list](const int index) {
+      const CollectionQueryOptions &query_options = query_options_list[index];
+      std::unique_ptr<CollectionQuery> q = std::make_unique<CollectionQuery>(db, backend_->songs_table(), backend_->fts_table(), filter_options);
+      q->SetColumnSpec(query_options.column_spec() + ", " + QString::number(index));
+      for (const CollectionQueryOptions::Where &where_clauses : query_options.where_clauses()) {
+        q->AddWhere(where_clauses.column, where_clauses.value, where_clauses.op);
+      }
+      q->AddCompilationRequirement(query_options.compilation_requirement());
+      return q;
+    };
+
+    auto read_rows = [&results](CollectionQuery *q) {
+      const int index_column = q->record().count() - 1;
+      while (q->Next()) {
+        const int index = q->Value(index_column).toInt();
+        if (index >= 0 && index < results.count()) {
+          results[index].rows << SqlRow(*q);
+        }
+      }
+    };
+
+    for (const QList<int> &indexes : std::as_const(queries_by_column_spec)) {
+      int start = 0;
+      while (start < indexes.count()) {
+        std::unique_ptr<CollectionQuery> batch_query = create_query(indexes[start]);
+        int end = start + 1;
+        // The batch is limited by the number of statements and the number of bound values SQLite allows in one statement.
+        while (end < indexes.count() && end - start < kPopulateBatchSize) {
+          std::unique_ptr<CollectionQuery> q = create_query(indexes[end]);
+          if (batch_query->bound_values().count() + q->bound_values().count() > kPopulateMaxBoundValues) break;
+          batch_query->AddUnion(*q);
+          ++end;
+        }
+
+        if (batch_query->Exec()) {
+          read_rows(batch_query.get());
+        }
+        else {
+          backend_->ReportErrors(*batch_query);
+          // Run the queries of the batch one by one, so only the items with a failing query are left empty.
+          if (end - start > 1) {
+            for (int j = start; j < end; ++j) {
+              std::unique_ptr<CollectionQuery> q = create_query(indexes[j]);
+              if (q->Exec()) {
+                read_rows(q.get());
+              }
+              else {
+                backend_->ReportErrors(*q);
+              }
+            }
+          }
+        }
+
+        start = end;
+      }
+    }
+
+  }
+
+  if (QThread::currentThread() != thread() && QThread::currentThread() != backend_->thread()) {
+    backend_->db()->Close();
+  }
+
+  return results;
+
+}
+
+void CollectionModel::PopulateFinished(const QList<CollectionItem*> &items, const QList<quint64> &populate_ids, const QList<QueryResult> &results) {
+
+  populate_running_ = false;
+
+  QSet<CollectionItem*> empty_items;
+  for (int i = 0; i < items.count() && i < results.count(); ++i) {
+    CollectionItem *item = items[i];
+    // The item was deleted by a reset, or populated synchronously in the meantime.
+    if (!populating_items_.contains(item) || populating_items_[item] != populate_ids[i]) continue;
+    populating_items_.remove(item);
+
+    RemoveLoadingIndicator(item, true);
+    PostQuery(item, results[i], true);
+
+    // After a filter change, items are populated to check if any songs are left in them, so they can be empty.
+    if (item->children.isEmpty() && item != root_) {
+      empty_items << item;
+      continue;
+    }
+
+    // Album icons are loaded once the songs are in.
+    const QModelIndex idx = ItemToIndex(item);
+    if (idx.isValid()) emit dataChanged(idx, idx);
+  }
+
+  DeleteEmptyParents(empty_items);
+
+  // The filter might have changed since the songs were discovered.
+  if (!populating_discovered_songs_.isEmpty()) {
+    SongList songs;
+    songs.swap(populating_discovered_songs_);
+    SongsDiscovered(songs);
+  }
+
+  if (!populate_queue_.isEmpty()) {
+    timer_populate_->start();
+  }
+
+}
+
+void CollectionModel::RemoveLoadingIndicator(CollectionItem *parent, const bool signal) {
+
+  for (int row = 0; row < parent->children.count(); ++row) {
+    if (parent->children[row]->type == CollectionItem::Type_LoadingIndicator) {
+      if (signal) beginRemoveRows(ItemToIndex(parent), row, row);
+      parent->Delete(row);
+      if (signal) endRemoveRows();
+      return;
+    }
+  }
+
+}
+
 void CollectionModel::ResetAsync() {
 
   CollectionQueryOptions query_options = PrepareQuery(root_);
 
+  // Only the latest reset is used, and it replaces any filter update which is running.
+  const quint64 reset_id = ++reset_id_;
+  reset_pending_ = true;
+  ++filter_update_id_;
+
+  // The matching songs are also kept without a filter, so the tree can be updated with the difference when a filter is set.
 #if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
-  QFuture<CollectionModel::QueryResult> future = QtConcurrent::run(&CollectionModel::RunQuery, this, filter_options_, query_options);
+  QFuture<CollectionModel::QueryResult> future = QtConcurrent::run(&CollectionModel::RunQuery, this, filter_options_, query_options, true);
 #else
-  QFuture<CollectionModel::QueryResult> future = QtConcurrent::run(this, &CollectionModel::RunQuery, filter_options_, query_options);
+  QFuture<CollectionModel::QueryResult> future = QtConcurrent::run(this, &CollectionModel::RunQuery, filter_options_, query_options, true);
 #endif
   QFutureWatcher<CollectionModel::QueryResult> *watcher = new QFutureWatcher<CollectionModel::QueryResult>();
-  QObject::connect(watcher, &QFutureWatcher<CollectionModel::QueryResult>::finished, this, &CollectionModel::ResetAsyncQueryFinished);
+  QObject::connect(watcher, &QFutureWatcher<CollectionModel::QueryResult>::finished, this, [this, watcher, reset_id]() {
+    const CollectionModel::QueryResult result = watcher->result();
+    watcher->deleteLater();
+    ResetAsyncQueryFinished(reset_id, result);
+  });
   watcher->setFuture(future);
 
 }
 
-void CollectionModel::ResetAsyncQueryFinished() {
+void CollectionModel::ResetAsyncQueryFinished(const quint64 reset_id, const QueryResult &result) {
 
-  QFutureWatcher<CollectionModel::QueryResult> *watcher = static_cast<QFutureWatcher<CollectionModel::QueryResult>*>(sender());
-  const struct QueryResult result = watcher->result();
-  watcher->deleteLater();
+  if (reset_id != reset_id_) return;
+  reset_pending_ = false;
 
   BeginReset();
   root_->lazy_loaded = true;
 
   PostQuery(root_, result, false);
 
+  filter_song_ids_ = result.song_ids;
+  filter_song_ids_valid_ = result.song_ids_valid;
+
   if (init_task_id_ != -1) {
     if (app_) {
       app_->task_manager()->SetTaskFinished(init_task_id_);
@@ -975,6 +1267,12 @@ void CollectionModel::BeginReset() {
   divider_nodes_.clear();
   pending_art_.clear();
   pending_cache_keys_.clear();
+  populate_queue_.clear();
+  populating_items_.clear();
+  populating_discovered_songs_.clear();
+  filter_song_ids_.clear();
+  filter_song_ids_valid_ = false;
+  ++filter_update_id_;
 
   root_ = new CollectionItem(this);
   root_->compilation_artist_node_ = nullptr;
@@ -993,6 +1291,179 @@ void CollectionModel::Reset() {
 
 }
 
+QSet<int> CollectionModel::QuerySongIds(const QSqlDatabase &db, const CollectionFilterOptions &filter_options) {
+
+  QSet<int> song_ids;
+
+  CollectionQuery q(db, backend_->songs_table(), backend_->fts_table(), filter_options);
+  q.SetColumnSpec("%songs_table.ROWID");
+  if (!q.Exec()) {
+    backend_->ReportErrors(q);
+    return song_ids;
+  }
+
+  while (q.Next()) {
+    song_ids.insert(q.Value(0).toInt());
+  }
+
+  return song_ids;
+
+}
+
+void CollectionModel::FilterChanged() {
+
+  // The tree can only be updated with the difference when the songs matching the old filter are known.
+  if (!filter_song_ids_valid_ || reset_pending_) {
+    ResetAsync();
+    return;
+  }
+
+  // Items which are being populated use the old filter, populate them again.
+  for (QMap<CollectionItem*, quint64>::iterator it = populating_items_.begin(); it != populating_items_.end(); ++it) {
+    it.value() = ++next_populate_id_;
+    if (!populate_queue_.contains(it.key())) populate_queue_ << it.key();
+  }
+  if (!populate_queue_.isEmpty() && !populate_running_ && !timer_populate_->isActive()) {
+    timer_populate_->start();
+  }
+
+  const quint64 filter_update_id = ++filter_update_id_;
+
+  // A reset only creates the top level items again, but loses the expanded items.
+  // The tree is updated one song at a time, unless many more songs changed than there are items in the tree.
+  const qint64 tree_size = song_nodes_.count() + container_nodes_[0].count() + container_nodes_[1].count() + container_nodes_[2].count() + divider_nodes_.count();
+  const qint64 maximum_changes = kFilterUpdateSongsPerItem * qMax(static_cast<qint64>(1), tree_size);
+
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+  QFuture<CollectionModel::FilterResult> future = QtConcurrent::run(&CollectionModel::RunFilterQuery, this, filter_options_, filter_song_ids_, maximum_changes);
+#else
+  QFuture<CollectionModel::FilterResult> future = QtConcurrent::run(this, &CollectionModel::RunFilterQuery, filter_options_, filter_song_ids_, maximum_changes);
+#endif
+  QFutureWatcher<CollectionModel::FilterResult> *watcher = new QFutureWatcher<CollectionModel::FilterResult>();
+  QObject::connect(watcher, &QFutureWatcher<CollectionModel::FilterResult>::finished, this, [this, watcher, filter_update_id]() {
+    const CollectionModel::FilterResult result = watcher->result();
+    watcher->deleteLater();
+    FilterQueryFinished(filter_update_id, result);
+  });
+  watcher->setFuture(future);
+
+}
+
+CollectionModel::FilterResult CollectionModel::RunFilterQuery(const CollectionFilterOptions &filter_options, const QSet<int> &old_song_ids, const qint64 maximum_changes) {
+
+  FilterResult result;
+
+  {
+    QMutexLocker l(backend_->db()->ReadMutex());
+    QSqlDatabase db(backend_->db()->Connect());
+    result.song_ids = QuerySongIds(db, filter_options);
+  }
+
+  QList<int> added_ids;
+  QList<int> removed_ids;
+  for (const int id : std::as_const(result.song_ids)) {
+    if (!old_song_ids.contains(id)) added_ids << id;
+  }
+  for (const int id : old_song_ids) {
+    if (!result.song_ids.contains(id)) removed_ids << id;
+  }
+
+  // With this many changes, a reset is faster than updating the tree one song at a time.
+  if (added_ids.count() + removed_ids.count() > maximum_changes) {
+    result.reset = true;
+  }
+  else {
+    if (!added_ids.isEmpty()) result.added_songs = backend_->GetSongsById(added_ids);
+    if (!removed_ids.isEmpty()) result.removed_songs = backend_->GetSongsById(removed_ids);
+  }
+
+  if (QThread::currentThread() != thread() && QThread::currentThread() != backend_->thread()) {
+    backend_->db()->Close();
+  }
+
+  return result;
+
+}
+
+void CollectionModel::FilterQueryFinished(const quint64 filter_update_id, const FilterResult &result) {
+
+  // The filter was changed again, or the model was reset.
+  if (filter_update_id != filter_update_id_) return;
+
+  if (result.reset) {
+    ResetAsync();
+    return;
+  }
+
+  filter_song_ids_ = result.song_ids;
+
+  // Remove the songs which don't match anymore, and find the containers which might be empty now.
+  QSet<CollectionItem*> parents;
+  QSet<CollectionItem*> unloaded_containers;
+  for (const Song &song : result.removed_songs) {
+    if (song_nodes_.contains(song.id())) {
+      CollectionItem *node = song_nodes_.take(song.id());
+      if (node->parent != root_) parents << node->parent;
+      beginRemoveRows(ItemToIndex(node->parent), node->row, node->row);
+      node->parent->Delete(node->row);
+      endRemoveRows();
+    }
+    else {
+      // The song is somewhere under a container which is not loaded, it has to be populated to see if there are any songs left in it.
+      CollectionItem *container = SongContainer(song);
+      if (container != root_ && !container->lazy_loaded) {
+        unloaded_containers << container;
+      }
+    }
+  }
+
+  DeleteEmptyParents(parents);
+
+  for (CollectionItem *container : std::as_const(unloaded_containers)) {
+    if (async_lazy_loading_) {
+      LazyPopulateAsync(container);
+    }
+    else {
+      LazyPopulate(container, true);
+      if (container->children.isEmpty()) DeleteEmptyParents(QSet<CollectionItem*>() << container);
+    }
+  }
+
+  AddSongs(result.added_songs);
+
+}
+
+CollectionItem *CollectionModel::SongContainer(const Song &song) const {
+
+  // Walks down the tree the same way as AddSongs() without creating any containers.
+  CollectionItem *container = root_;
+  QString key;
+  for (int i = 0; i < 3; ++i) {
+    const GroupBy group_by = group_by_[i];
+    if (group_by == GroupBy_None) break;
+
+    if (!key.isEmpty()) key.append("-");
+
+    CollectionItem *child = nullptr;
+    if (IsArtistGroupBy(group_by) && song.is_compilation()) {
+      child = container->compilation_artist_node_;
+      if (child) key = child->key;
+    }
+    else {
+      key.append(ContainerKey(group_by, separate_albums_by_grouping_, song));
+      child = container_nodes_[i].value(key, nullptr);
+    }
+
+    if (!child) break;
+    container = child;
+
+    if (!container->lazy_loaded || populating_items_.contains(container)) break;
+  }
+
+  return container;
+
+}
+
 void CollectionModel::SetQueryColumnSpec(const GroupBy group_by, const bool separate_albums_by_grouping, CollectionQueryOptions *query_options) {
 
   // Say what group_by of thing we want to get back from the database.
@@ -1816,7 +2287,7 @@ void CollectionModel::GetChildSongs(CollectionItem *item, QList<QUrl> *urls, Son
 
   switch (item->type) {
     case CollectionItem::Type_Container: {
-      const_cast<CollectionModel*>(this)->LazyPopulate(item);
+      const_cast<CollectionModel*>(this)->LazyPopulate(item, true);
 
       QList<CollectionItem*> children = item->children;
       std::sort(children.begin(), children.end(), std::bind(&CollectionModel::CompareItems, this, std::placeholders::_1, std::placeholders::_2));
@@ -1860,17 +2331,17 @@ SongList CollectionModel::GetChildSongs(const QModelIndex &idx) const {
 
 void CollectionModel::SetFilterMode(CollectionFilterOptions::FilterMode filter_mode) {
   filter_options_.set_filter_mode(filter_mode);
-  ResetAsync();
+  FilterChanged();
 }
 
 void CollectionModel::SetFilterAge(const int filter_age) {
   filter_options_.set_max_age(filter_age);
-  ResetAsync();
+  FilterChanged();
 }
 
 void CollectionModel::SetFilterText(const QString &filter_text) {
   filter_options_.set_filter_text(filter_text);
-  ResetAsync();
+  FilterChanged();
 }
 
 bool CollectionModel::canFetchMore(const QModelIndex &parent) const {
@@ -1944,7 +2415,7 @@ void CollectionModel::TotalAlbumCountUpdatedSlot(const int count) {
 }
 
 void CollectionModel::ClearDiskCache() {
-  if (sIconCache) sIconCache->clear();
+  if (sIconCache) sIconCache->Clear();
 }
 
 void CollectionModel::ExpandAll(CollectionItem *item) const {
@@ -43,7 +43,6 @@
 #include <QImage>
 #include <QIcon>
 #include <QPixmap>
-#include <QNetworkDiskCache>
 
 #include "core/simpletreemodel.h"
 #include "core/song.h"
@@ -53,9 +52,11 @@
 #include "collectionquery.h"
 #include "collectionqueryoptions.h"
 #include "collectionitem.h"
+#include "albumiconcache.h"
 #include "covermanager/albumcoverloaderoptions.h"
 
 class QSettings;
+class QTimer;
 
 class Application;
 class CollectionBackend;
@@ -70,6 +71,10 @@ class CollectionModel : public SimpleTreeModel<CollectionItem> {
 
   static const int kPrettyCoverSize;
   static const char *kPixmapDiskCacheDir;
+  static const char *kIconCacheFile;
+  static const int kPopulateBatchSize;
+  static const int kPopulateMaxBoundValues;
+  static const int kFilterUpdateSongsPerItem;
 
   enum Role {
     Role_Type = Qt::UserRole + 1,
@@ -126,10 +131,13 @@ class CollectionModel : public SimpleTreeModel<CollectionItem> {
   };
 
   struct QueryResult {
-    QueryResult() : create_va(false) {}
+    QueryResult() : create_va(false), song_ids_valid(false) {}
 
     SqlRowList rows;
     bool create_va;
+    // The IDs of all the songs matching the filter, only queried when the model is reset in the background.
+    QSet<int> song_ids;
+    bool song_ids_valid;
   };
 
   CollectionBackend *backend() const { return backend_; }
@@ -178,7 +186,7 @@ class CollectionModel : public SimpleTreeModel<CollectionItem> {
   static QString SortTextForYear(const int year);
   static QString SortTextForBitrate(const int bitrate);
 
-  quint64 icon_cache_disk_size() { return sIconCache->cacheSize(); }
+  quint64 icon_cache_disk_size() { return sIconCache ? sIconCache->size() : 0; }
 
   static bool IsArtistGroupBy(const GroupBy group_by) {
     return group_by == CollectionModel::GroupBy_Artist || group_by == CollectionModel::GroupBy_AlbumArtist;
@@ -187,6 +195,9 @@ class CollectionModel : public SimpleTreeModel<CollectionItem> {
 
   void set_use_lazy_loading(const bool value) { use_lazy_loading_ = value; }
 
+  // Whether nodes expanded in the view are populated in a background thread, this is turned on by Init() and off by Init(false).
+  bool async_lazy_loading() const { return async_lazy_loading_; }
+
   QMap<QString, CollectionItem*> container_nodes(const int i) { return container_nodes_[i]; }
   QList<CollectionItem*> song_nodes() const { return song_nodes_.values(); }
   int divider_nodes_count() const { return divider_nodes_.count(); }
@@ -216,7 +227,7 @@ class CollectionModel : public SimpleTreeModel<CollectionItem> {
   void SongsDiscovered(const SongList &songs);
 
  protected:
-  void LazyPopulate(CollectionItem *item) override { LazyPopulate(item, true); }
+  void LazyPopulate(CollectionItem *item) override;
   void LazyPopulate(CollectionItem *parent, const bool signal);
 
  private slots:
@@ -228,8 +239,8 @@ class CollectionModel : public SimpleTreeModel<CollectionItem> {
   void TotalAlbumCountUpdatedSlot(const int count);
   static void ClearDiskCache();
 
-  // Called after ResetAsync
-  void ResetAsyncQueryFinished();
+  // Runs the queries for the items queued by LazyPopulateAsync
+  void PopulateQueuedItems();
 
   void AlbumCoverLoaded(const quint64 id, const AlbumCoverLoaderResult &result);
 
@@ -237,9 +248,38 @@ class CollectionModel : public SimpleTreeModel<CollectionItem> {
   // Provides some optimizations for loading the list of items in the root.
   // This gets called a lot when filtering the playlist, so it's nice to be able to do it in a background thread.
   CollectionQueryOptions PrepareQuery(CollectionItem *parent);
-  QueryResult RunQuery(const CollectionFilterOptions &filter_options = CollectionFilterOptions(), const CollectionQueryOptions &query_options = CollectionQueryOptions());
+  QueryResult RunQuery(const CollectionFilterOptions &filter_options = CollectionFilterOptions(), const CollectionQueryOptions &query_options = CollectionQueryOptions(), const bool query_song_ids = false);
   void PostQuery(CollectionItem *parent, const QueryResult &result, const bool signal);
 
+  // Called after ResetAsync
+  void ResetAsyncQueryFinished(const quint64 reset_id, const QueryResult &result);
+
+  // Nodes expanded in the view are queued and populated in batches in a background thread.
+  // The queries for a batch are combined into as few statements as possible, and a loading indicator is shown under each node until the rows are in.
+  void LazyPopulateAsync(CollectionItem *parent);
+  QList<QueryResult> RunQueries(const CollectionFilterOptions &filter_options, const QList<CollectionQueryOptions> &query_options_list);
+  void PopulateFinished(const QList<CollectionItem*> &items, const QList<quint64> &populate_ids, const QList<QueryResult> &results);
+  void RemoveLoadingIndicator(CollectionItem *parent, const bool signal);
+
+  // When the filter changes, the songs matching the new filter are compared to the songs matching the old filter,
+  // and only the songs which were added or removed are inserted into or deleted from the tree, so the expanded nodes are kept.
+  struct FilterResult {
+    FilterResult() : reset(false) {}
+    QSet<int> song_ids;
+    SongList added_songs;
+    SongList removed_songs;
+    bool reset;
+  };
+  void FilterChanged();
+  QSet<int> QuerySongIds(const QSqlDatabase &db, const CollectionFilterOptions &filter_options);
+  FilterResult RunFilterQuery(const CollectionFilterOptions &filter_options, const QSet<int> &old_song_ids, const qint64 maximum_changes);
+  void FilterQueryFinished(const quint64 filter_update_id, const FilterResult &result);
+
+  // Returns the deepest container for the song which is in the tree, or the root.
+  CollectionItem *SongContainer(const Song &song) const;
+  void AddSongs(const SongList &songs);
+  void DeleteEmptyParents(QSet<CollectionItem*> parents);
+
   bool HasCompilations(const QSqlDatabase &db, const CollectionFilterOptions &filter_options, const CollectionQueryOptions &query_options);
 
   void BeginReset();
@@ -300,7 +340,8 @@ class CollectionModel : public SimpleTreeModel<CollectionItem> {
   // Used as a generic icon to show when no cover art is found, fixed to the same size as the artwork (32x32)
   QPixmap no_cover_icon_;
 
-  static QNetworkDiskCache *sIconCache;
+  static AlbumIconCache *sIconCache;
+  bool owns_icon_cache_;
 
   int init_task_id_;
 
@@ -308,6 +349,23 @@ class CollectionModel : public SimpleTreeModel<CollectionItem> {
   bool show_dividers_;
   bool use_disk_cache_;
   bool use_lazy_loading_;
+  bool async_lazy_loading_;
+
+  // Items waiting for the next batch, and the items which are queued or being populated keyed to the ID of their request.
+  QTimer *timer_populate_;
+  QList<CollectionItem*> populate_queue_;
+  QMap<CollectionItem*, quint64> populating_items_;
+  quint64 next_populate_id_;
+  bool populate_running_;
+  // Songs discovered in an item while it was being populated, these are added when the result is in.
+  SongList populating_discovered_songs_;
+
+  quint64 reset_id_;
+  bool reset_pending_;
+  quint64 filter_update_id_;
+  // The IDs of the songs matching the current filter, including the songs in items which are not loaded.
+  QSet<int> filter_song_ids_;
+  bool filter_song_ids_valid_;
 
   AlbumCoverLoaderOptions cover_loader_options_;
 
@@ -64,6 +64,14 @@ QVariant CollectionPlaylistItem::DatabaseValue(DatabaseColumn column) const {
 
 }
 
+Song CollectionPlaylistItem::DatabaseSongMetadata() const {
+
+  // Collection songs are only saved by their ID, so this is the same empty song for every item.
+  static const Song database_metadata(Song::Source_Collection);
+  return database_metadata;
+
+}
+
 Song CollectionPlaylistItem::Metadata() const {
 
   if (HasTemporaryMetadata()) return temp_metadata_;
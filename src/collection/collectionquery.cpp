@@ -107,12 +107,7 @@ CollectionQuery::CollectionQuery(const QSqlDatabase &db, const QString &songs_ta
     bound_values_ << cutoff;
   }
 
-  // TODO: Currently you cannot use any FilterMode other than All and FTS at the same time.
-  // Joining songs, duplicated_songs and songs_fts all together takes a huge amount of time.
-  // The query takes about 20 seconds on my machine then. Why?
-  // Untagged mode could work with additional filtering but I'm disabling it just to be consistent
-  // this way filtering is available only in the All mode.
-  // Remember though that when you fix the Duplicates + FTS cooperation, enable the filtering in both Duplicates and Untagged modes.
+  // The duplicated_songs table is maintained by the collection backend, so joining it is a primary key lookup per song, also when joining with FTS.
   duplicates_only_ = filter_options.filter_mode() == CollectionFilterOptions::FilterMode_Duplicates;
 
   if (filter_options.filter_mode() == CollectionFilterOptions::FilterMode_Untagged) {
@@ -180,19 +175,26 @@ void CollectionQuery::AddCompilationRequirement(const bool compilation) {
 
 QString CollectionQuery::GetInnerQuery() const {
   return duplicates_only_
-             ? QString(" INNER JOIN (select * from duplicated_songs) dsongs        "
-                   "ON (%songs_table.artist = dsongs.dup_artist       "
-                   "AND %songs_table.album = dsongs.dup_album     "
-                   "AND %songs_table.title = dsongs.dup_title)    ")
+             ? QString(" INNER JOIN duplicated_songs AS dsongs "
+                       "ON (%songs_table.artist = dsongs.dup_artist "
+                       "AND %songs_table.album = dsongs.dup_album "
+                       "AND %songs_table.title = dsongs.dup_title)")
              : QString();
 }
 
-bool CollectionQuery::Exec() {
+void CollectionQuery::AddUnion(const CollectionQuery &query) {
+
+  union_queries_ << query.GetQuery();
+  bound_values_ << query.bound_values();
+
+}
+
+QString CollectionQuery::GetQuery() const {
 
   QString sql;
 
   if (join_with_fts_) {
-    sql = QString("SELECT %1 FROM %2 INNER JOIN %3 AS fts ON %2.ROWID = fts.ROWID").arg(column_spec_, songs_table_, fts_table_);
+    sql = QString("SELECT %1 FROM %2 INNER JOIN %3 AS fts ON %2.ROWID = fts.ROWID %4").arg(column_spec_, songs_table_, fts_table_, GetInnerQuery());
   }
   else {
     sql = QString("SELECT %1 FROM %2 %3").arg(column_spec_, songs_table_, GetInnerQuery());
@@ -213,6 +215,17 @@ bool CollectionQuery::Exec() {
   sql.replace("%fts_table_noprefix", fts_table_.section('.', -1, -1));
   sql.replace("%fts_table", fts_table_);
 
+  return sql;
+
+}
+
+bool CollectionQuery::Exec() {
+
+  QString sql = GetQuery();
+  for (const QString &union_query : union_queries_) {
+    sql += " UNION ALL " + union_query;
+  }
+
   QSqlQuery::prepare(sql);
 
   // Bind values
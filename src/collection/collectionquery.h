@@ -73,6 +73,13 @@ class CollectionQuery : public QSqlQuery {
   void SetLimit(const int limit) { limit_ = limit; }
   void AddCompilationRequirement(const bool compilation);
 
+  // Adds the statement of the other query to this one with UNION ALL, so they are executed as one statement.
+  // The queries need to have the same number of columns, and this query must be set up before the other queries are added.
+  void AddUnion(const CollectionQuery &query);
+
+  // Returns the SQL statement without the queries added with AddUnion().
+  QString GetQuery() const;
+
  private:
   QString GetInnerQuery() const;
 
@@ -84,6 +91,7 @@ class CollectionQuery : public QSqlQuery {
   QString order_by_;
   QStringList where_clauses_;
   QVariantList bound_values_;
+  QStringList union_queries_;
 
   bool include_unavailable_;
   bool join_with_fts_;
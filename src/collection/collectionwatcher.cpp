@@ -26,6 +26,10 @@
 
 #include <QObject>
 #include <QThread>
+#include <QThreadPool>
+#include <QtConcurrentRun>
+#include <QFuture>
+#include <QFutureWatcher>
 #include <QIODevice>
 #include <QDir>
 #include <QDirIterator>
@@ -44,11 +48,14 @@
 #include <QImage>
 #include <QSettings>
 
+#include "core/database.h"
 #include "core/filesystemwatcherinterface.h"
 #include "core/logging.h"
 #include "core/tagreaderclient.h"
 #include "core/taskmanager.h"
+#include "utilities/fileutils.h"
 #include "utilities/imageutils.h"
+#include "utilities/mimeutils.h"
 #include "utilities/timeconstants.h"
 #include "collectiondirectory.h"
 #include "collectionbackend.h"
@@ -67,6 +74,9 @@
 using namespace std::chrono_literals;
 
 QStringList CollectionWatcher::sValidImages = QStringList() << "jpg" << "png" << "gif" << "jpeg";
+QStringList CollectionWatcher::sNonMediaExtensions = QStringList() << "cue" << "m3u" << "m3u8" << "pls" << "xspf" << "txt" << "nfo" << "log" << "lrc" << "sfv" << "md5" << "ffp" << "accurip" << "pdf" << "db" << "ini" << "url";
+const int CollectionWatcher::kTagReaderBatchSize = 100;
+const int CollectionWatcher::kFingerprintBatchSize = 50;
 
 CollectionWatcher::CollectionWatcher(Song::Source source, QObject *parent)
     : QObject(parent),
@@ -82,11 +92,19 @@ CollectionWatcher::CollectionWatcher(Song::Source source, QObject *parent)
       expire_unavailable_songs_days_(60),
       overwrite_playcount_(false),
       overwrite_rating_(false),
+      parallel_scan_(true),
+      media_file_by_extension_(true),
+      media_file_magic_(false),
       stop_requested_(false),
       abort_requested_(false),
       rescan_in_progress_(false),
       rescan_timer_(new QTimer(this)),
       periodic_scan_timer_(new QTimer(this)),
+      fingerprint_thread_pool_(new QThreadPool(this)),
+      fingerprint_active_(0),
+      fingerprint_task_id_(-1),
+      fingerprint_progress_(0),
+      fingerprint_progress_max_(0),
       rescan_paused_(false),
       total_watches_(0),
       cue_parser_(new CueParser(backend_, this)),
@@ -100,6 +118,8 @@ CollectionWatcher::CollectionWatcher(Song::Source source, QObject *parent)
   periodic_scan_timer_->setInterval(86400 * kMsecPerSec);
   periodic_scan_timer_->setSingleShot(false);
 
+  fingerprint_thread_pool_->setMaxThreadCount(qBound(1, QThread::idealThreadCount() / 2, 4));
+
   QStringList image_formats = ImageUtils::SupportedImageFormats();
   for (const QString &format : image_formats) {
     if (!sValidImages.contains(format)) {
@@ -123,6 +143,8 @@ void CollectionWatcher::Exit() {
   Q_ASSERT(QThread::currentThread() == thread());
 
   Stop();
+  ClearQueuedFingerprints();
+  fingerprint_thread_pool_->waitForDone();
   if (backend_) backend_->Close();
   moveToThread(original_thread_);
   emit ExitFinished();
@@ -154,6 +176,9 @@ void CollectionWatcher::ReloadSettings() {
   expire_unavailable_songs_days_ = s.value("expire_unavailable_songs", 60).toInt();
   overwrite_playcount_ = s.value("overwrite_playcount", false).toBool();
   overwrite_rating_ = s.value("overwrite_rating", false).toBool();
+  parallel_scan_ = s.value("parallel_scan", true).toBool();
+  media_file_by_extension_ = s.value("media_file_by_extension", true).toBool();
+  media_file_magic_ = s.value("media_file_magic", false).toBool();
   s.endGroup();
 
   best_image_filters_.clear();
@@ -253,6 +278,11 @@ void CollectionWatcher::ScanTransaction::CommitNewOrUpdatedSongs() {
     new_songs.clear();
   }
 
+  if (!files_to_fingerprint.isEmpty()) {
+    watcher_->QueueFingerprints(files_to_fingerprint);
+    files_to_fingerprint.clear();
+  }
+
   if (!touched_songs.isEmpty()) {
     emit watcher_->SongsMTimeUpdated(touched_songs);
     touched_songs.clear();
@@ -440,6 +470,7 @@ void CollectionWatcher::ScanSubdirectory(const QString &path, const CollectionSu
 
   QMap<QString, QStringList> album_art;
   QStringList files_on_disk;
+  QStringList files_to_check;
   CollectionSubdirectoryList my_new_subdirs;
 
   // If a directory is moved then only its parent gets a changed notification, so we need to look and see if any of our children don't exist anymore.
@@ -481,20 +512,64 @@ void CollectionWatcher::ScanSubdirectory(const QString &path, const CollectionSu
         album_art[dir_part] << child;
         t->AddToProgress(1);
       }
-      else if (TagReaderClient::Instance()->IsMediaFileBlocking(child)) {
-        files_on_disk << child;
-      }
       else {
-        t->AddToProgress(1);
+        switch (GuessMediaFile(child, ext_part)) {
+          case MediaFileGuess_Yes:
+            files_on_disk << child;
+            break;
+          case MediaFileGuess_No:
+            t->AddToProgress(1);
+            break;
+          case MediaFileGuess_Unknown:
+            files_to_check << child;
+            break;
+        }
       }
     }
   }
 
   if (stop_requested_ || abort_requested_) return;
 
+  files_on_disk << FilterMediaFiles(files_to_check, t);
+
+  if (stop_requested_ || abort_requested_) return;
+
   // Ask the database for a list of files in this directory
   SongList songs_in_db = t->FindSongsInSubdirectory(path);
 
+  // Read the tags of new and modified files in batches, CUE associated files are handled by the CUE parser.
+  QStringList files_to_read;
+  for (const QString &file : std::as_const(files_on_disk)) {
+    if (GetMtimeForCue(CueParser::FindCueFilename(file)) != 0) continue;
+    SongList matching_songs;
+    if (!FindSongsByPath(songs_in_db, file, &matching_songs) || t->ignores_mtime() || matching_songs.first().mtime() != QFileInfo(file).lastModified().toSecsSinceEpoch()) {
+      files_to_read << file;
+    }
+  }
+  ReadSongsOnDisk(files_to_read, t);
+
+  if (stop_requested_ || abort_requested_) return;
+
+  // Files not in the collection by path need their fingerprint now to find songs that were moved, create them concurrently.
+  QHash<QString, QString> new_files_fingerprint;
+#ifdef HAVE_SONGFINGERPRINTING
+  if (song_tracking_) {
+    QStringList new_files;
+    for (const QString &file : std::as_const(files_on_disk)) {
+      SongList matching_songs;
+      if (!FindSongsByPath(songs_in_db, file, &matching_songs)) {
+        new_files << file;
+      }
+    }
+    const QStringList fingerprints = CreateFingerprints(new_files);
+    for (int i = 0; i < new_files.count(); ++i) {
+      new_files_fingerprint.insert(new_files[i], fingerprints[i]);
+    }
+  }
+#endif
+
+  if (stop_requested_ || abort_requested_) return;
+
   QSet<QString> cues_processed;
 
   // Now compare the list from the database with the list of files on disk
@@ -558,17 +633,15 @@ void CollectionWatcher::ScanSubdirectory(const QString &path, const CollectionSu
         qLog(Debug) << file << "is missing fingerprint.";
       }
 
-      // The song's changed or missing fingerprint - create fingerprint and reread the metadata from file.
+      // The song's changed or missing fingerprint - reread the metadata from file.
+      // The song is committed with its current fingerprint, and a new fingerprint is created in the background.
       if (t->ignores_mtime() || changed || missing_fingerprint) {
 
         QString fingerprint;
 #ifdef HAVE_SONGFINGERPRINTING
         if (song_tracking_) {
-          Chromaprinter chromaprinter(file);
-          fingerprint = chromaprinter.CreateFingerprint();
-          if (fingerprint.isEmpty()) {
-            fingerprint = "NONE";
-          }
+          fingerprint = matching_song.fingerprint();
+          t->files_to_fingerprint << file;
         }
 #endif
 
@@ -588,16 +661,7 @@ void CollectionWatcher::ScanSubdirectory(const QString &path, const CollectionSu
 
     }
     else {  // Search the DB by fingerprint.
-      QString fingerprint;
-#ifdef HAVE_SONGFINGERPRINTING
-      if (song_tracking_) {
-        Chromaprinter chromaprinter(file);
-        fingerprint = chromaprinter.CreateFingerprint();
-        if (fingerprint.isEmpty()) {
-          fingerprint = "NONE";
-        }
-      }
-#endif
+      const QString fingerprint = new_files_fingerprint.value(file);
       if (song_tracking_ && !fingerprint.isEmpty() && fingerprint != "NONE" && FindSongsByFingerprint(file, fingerprint, &matching_songs)) {
 
         // The song is in the database and still on disk.
@@ -645,7 +709,7 @@ void CollectionWatcher::ScanSubdirectory(const QString &path, const CollectionSu
       }
       else {  // The song is on disk but not in the DB
 
-        SongList songs = ScanNewFile(file, path, fingerprint, new_cue, &cues_processed);
+        SongList songs = ScanNewFile(file, path, fingerprint, new_cue, &cues_processed, t);
         if (songs.isEmpty()) {
           t->AddToProgress(1);
           continue;
@@ -692,6 +756,9 @@ void CollectionWatcher::ScanSubdirectory(const QString &path, const CollectionSu
     t->deleted_subdirs << updated_subdir;
   }
 
+  // Songs read ahead of time which were not used, ie.: the file was removed in the meantime.
+  t->songs_on_disk.clear();
+
   // Recurse into the new subdirs that we found
   for (const CollectionSubdirectory &my_new_subdir : my_new_subdirs) {
     if (stop_requested_ || abort_requested_) return;
@@ -700,6 +767,90 @@ void CollectionWatcher::ScanSubdirectory(const QString &path, const CollectionSu
 
 }
 
+CollectionWatcher::MediaFileGuess CollectionWatcher::GuessMediaFile(const QString &file, const QString &ext_part) const {
+
+  if (!media_file_by_extension_) return MediaFileGuess_Unknown;
+
+  if (sNonMediaExtensions.contains(ext_part)) return MediaFileGuess_No;
+
+  if (!Song::kAcceptedExtensions.contains(ext_part)) return MediaFileGuess_Unknown;
+
+  if (!media_file_magic_) return MediaFileGuess_Yes;
+
+  // The header doesn't match what we expect, let the tagreader decide.
+  QFile f(file);
+  if (!f.open(QIODevice::ReadOnly)) return MediaFileGuess_Unknown;
+  const QByteArray data = f.read(Utilities::kAudioMagicSize);
+  f.close();
+
+  return Utilities::IsAudioMagic(data) ? MediaFileGuess_Yes : MediaFileGuess_Unknown;
+
+}
+
+QStringList CollectionWatcher::FilterMediaFiles(const QStringList &files, ScanTransaction *t) {
+
+  QStringList media_files;
+
+  const int batch_size = TagReaderBatchSize();
+  for (int i = 0; i < files.count(); i += batch_size) {
+
+    if (stop_requested_ || abort_requested_) break;
+
+    const QStringList batch = files.mid(i, batch_size);
+    const QList<bool> is_media_file = parallel_scan_ ? TagReaderClient::Instance()->IsMediaFilesParallelBlocking(batch) : TagReaderClient::Instance()->IsMediaFilesBlocking(batch);
+    for (int j = 0; j < batch.count(); ++j) {
+      if (is_media_file[j]) {
+        media_files << batch[j];
+      }
+      else {
+        t->AddToProgress(1);
+      }
+    }
+  }
+
+  return media_files;
+
+}
+
+void CollectionWatcher::ReadSongsOnDisk(const QStringList &files, ScanTransaction *t) {
+
+  const int batch_size = TagReaderBatchSize();
+  for (int i = 0; i < files.count(); i += batch_size) {
+
+    if (stop_requested_ || abort_requested_) break;
+
+    const QStringList batch = files.mid(i, batch_size);
+    const SongList songs = parallel_scan_ ? TagReaderClient::Instance()->ReadFilesParallelBlocking(batch, source_) : TagReaderClient::Instance()->ReadFilesBlocking(batch, source_);
+    for (int j = 0; j < batch.count(); ++j) {
+      t->songs_on_disk.insert(batch[j], songs[j]);
+    }
+  }
+
+}
+
+int CollectionWatcher::TagReaderBatchSize() const {
+
+  if (parallel_scan_) {
+    return kTagReaderBatchSize * TagReaderClient::Instance()->worker_count();
+  }
+
+  return kTagReaderBatchSize;
+
+}
+
+Song CollectionWatcher::ReadSongOnDisk(const QString &file, ScanTransaction *t) {
+
+  if (t->songs_on_disk.contains(file)) {
+    return t->songs_on_disk.take(file);
+  }
+
+  Song song(source_);
+  TagReaderClient::Instance()->ReadFileBlocking(file, &song);
+
+  return song;
+
+}
+
 void CollectionWatcher::UpdateCueAssociatedSongs(const QString &file,
                                                  const QString &path,
                                                  const QString &fingerprint,
@@ -769,8 +920,7 @@ void CollectionWatcher::UpdateNonCueAssociatedSong(const QString &file,
     }
   }
 
-  Song song_on_disk(source_);
-  TagReaderClient::Instance()->ReadFileBlocking(file, &song_on_disk);
+  Song song_on_disk = ReadSongOnDisk(file, t);
   if (song_on_disk.is_valid()) {
     song_on_disk.set_source(source_);
     song_on_disk.set_directory_id(t->dir());
@@ -783,7 +933,7 @@ void CollectionWatcher::UpdateNonCueAssociatedSong(const QString &file,
 
 }
 
-SongList CollectionWatcher::ScanNewFile(const QString &file, const QString &path, const QString &fingerprint, const QString &matching_cue, QSet<QString> *cues_processed) {
+SongList CollectionWatcher::ScanNewFile(const QString &file, const QString &path, const QString &fingerprint, const QString &matching_cue, QSet<QString> *cues_processed, ScanTransaction *t) {
 
   SongList songs;
 
@@ -820,8 +970,7 @@ SongList CollectionWatcher::ScanNewFile(const QString &file, const QString &path
     }
   }
   else {  // It's a normal media file
-    Song song(source_);
-    TagReaderClient::Instance()->ReadFileBlocking(file, &song);
+    Song song = ReadSongOnDisk(file, t);
     if (song.is_valid()) {
       song.set_source(source_);
       song.set_fingerprint(fingerprint);
@@ -881,6 +1030,167 @@ void CollectionWatcher::AddChangedSong(const QString &file, const Song &matching
 
 }
 
+CollectionWatcher::FingerprintResult CollectionWatcher::FingerprintFile(CollectionBackend *backend, const QString &file) {
+
+  FingerprintResult result;
+  result.file = file;
+
+  const QFileInfo fileinfo(file);
+  result.inode = Utilities::FileInode(file);
+  result.filesize = fileinfo.size();
+  result.mtime = fileinfo.lastModified().toSecsSinceEpoch();
+
+  result.fingerprint = backend->GetCachedFingerprint(QUrl::fromLocalFile(file), result.inode, result.filesize, result.mtime);
+  if (!result.fingerprint.isEmpty()) {
+    result.cached = true;
+  }
+  else {
+    // The file was changed, moved or copied, but the audio data might still be the same.
+    result.audio_hash = Utilities::AudioDataHash(file);
+    result.fingerprint = backend->GetCachedFingerprint(result.audio_hash);
+  }
+
+  backend->db()->Close();
+
+  if (result.fingerprint.isEmpty()) {
+#ifdef HAVE_SONGFINGERPRINTING
+    Chromaprinter chromaprinter(file);
+    result.fingerprint = chromaprinter.CreateFingerprint();
+    if (result.fingerprint.isEmpty()) result.fingerprint = "NONE";
+#else
+    result.fingerprint = "NONE";
+#endif
+  }
+
+  return result;
+
+}
+
+QStringList CollectionWatcher::CreateFingerprints(const QStringList &files) {
+
+  QList<QFuture<FingerprintResult>> futures;
+  futures.reserve(files.count());
+  for (const QString &file : files) {
+    futures << QtConcurrent::run(fingerprint_thread_pool_, &CollectionWatcher::FingerprintFile, backend_, file);
+  }
+
+  QStringList fingerprints;
+  fingerprints.reserve(files.count());
+  for (QFuture<FingerprintResult> &future : futures) {
+    future.waitForFinished();
+    const FingerprintResult result = future.result();
+    AddCachedFingerprint(result);
+    fingerprints << result.fingerprint;
+  }
+
+  return fingerprints;
+
+}
+
+void CollectionWatcher::AddCachedFingerprint(const FingerprintResult &result) {
+
+  // Don't cache failures, the file might still be being written.
+  // Files found by URL, inode, size and mtime are already in the cache.
+  if (result.cached || result.fingerprint.isEmpty() || result.fingerprint == "NONE") return;
+
+  backend_->AddCachedFingerprint(QUrl::fromLocalFile(result.file), result.inode, result.filesize, result.mtime, result.audio_hash, result.fingerprint);
+
+}
+
+void CollectionWatcher::QueueFingerprints(const QStringList &files) {
+
+  for (const QString &file : files) {
+    if (!fingerprint_queued_files_.contains(file)) {
+      fingerprint_queue_ << file;
+      fingerprint_queued_files_.insert(file);
+      ++fingerprint_progress_max_;
+    }
+  }
+
+  if (fingerprint_task_id_ == -1) {
+    fingerprint_task_id_ = task_manager_->StartTask(tr("Fingerprinting songs"));
+  }
+
+  StartQueuedFingerprints();
+
+}
+
+void CollectionWatcher::StartQueuedFingerprints() {
+
+  // Only keep as many files in the thread pool as it has threads, so the queue can still be cleared.
+  while (!fingerprint_queue_.isEmpty() && fingerprint_active_ < fingerprint_thread_pool_->maxThreadCount()) {
+    if (stop_requested_ || abort_requested_) {
+      fingerprint_queue_.clear();
+      fingerprint_queued_files_.clear();
+      break;
+    }
+    const QString file = fingerprint_queue_.takeFirst();
+    fingerprint_queued_files_.remove(file);
+    ++fingerprint_active_;
+    QFuture<FingerprintResult> future = QtConcurrent::run(fingerprint_thread_pool_, &CollectionWatcher::FingerprintFile, backend_, file);
+    QFutureWatcher<FingerprintResult> *watcher = new QFutureWatcher<FingerprintResult>(this);
+    QObject::connect(watcher, &QFutureWatcher<FingerprintResult>::finished, this, &CollectionWatcher::FingerprintFinished);
+    watcher->setFuture(future);
+  }
+
+  if (fingerprint_queue_.isEmpty() && fingerprint_active_ == 0) {
+    if (!fingerprinted_songs_.isEmpty()) {
+      emit SongsFingerprintUpdated(fingerprinted_songs_);
+      fingerprinted_songs_.clear();
+    }
+    ClearQueuedFingerprints();
+  }
+  else if (fingerprint_task_id_ != -1) {
+    task_manager_->SetTaskProgress(fingerprint_task_id_, fingerprint_progress_, fingerprint_progress_max_);
+  }
+
+}
+
+void CollectionWatcher::FingerprintFinished() {
+
+  QFutureWatcher<FingerprintResult> *watcher = static_cast<QFutureWatcher<FingerprintResult>*>(sender());
+  const FingerprintResult result = watcher->result();
+  watcher->deleteLater();
+
+  --fingerprint_active_;
+
+  AddCachedFingerprint(result);
+  AddFingerprintedSong(result.file, result.fingerprint);
+
+  StartQueuedFingerprints();
+
+}
+
+void CollectionWatcher::AddFingerprintedSong(const QString &file, const QString &fingerprint) {
+
+  Song song;
+  song.set_url(QUrl::fromLocalFile(file));
+  song.set_fingerprint(fingerprint);
+  fingerprinted_songs_ << song;
+  ++fingerprint_progress_;
+
+  if (fingerprinted_songs_.count() >= kFingerprintBatchSize) {
+    emit SongsFingerprintUpdated(fingerprinted_songs_);
+    fingerprinted_songs_.clear();
+  }
+
+}
+
+void CollectionWatcher::ClearQueuedFingerprints() {
+
+  // Songs without a new fingerprint keep their current one, and are picked up by the next scan if it's missing.
+  fingerprint_queue_.clear();
+  fingerprint_queued_files_.clear();
+
+  if (fingerprint_active_ == 0 && fingerprint_task_id_ != -1) {
+    task_manager_->SetTaskFinished(fingerprint_task_id_);
+    fingerprint_task_id_ = -1;
+    fingerprint_progress_ = 0;
+    fingerprint_progress_max_ = 0;
+  }
+
+}
+
 quint64 CollectionWatcher::GetMtimeForCue(const QString &cue_path) {
 
   if (cue_path.isEmpty()) {
@@ -30,6 +30,7 @@
 #include <QMap>
 #include <QMultiMap>
 #include <QSet>
+#include <QByteArray>
 #include <QString>
 #include <QStringList>
 #include <QUrl>
@@ -38,6 +39,7 @@
 #include "core/song.h"
 
 class QThread;
+class QThreadPool;
 class QTimer;
 
 class CollectionBackend;
@@ -71,6 +73,7 @@ class CollectionWatcher : public QObject {
  signals:
   void NewOrUpdatedSongs(SongList);
   void SongsMTimeUpdated(SongList);
+  void SongsFingerprintUpdated(SongList);
   void SongsDeleted(SongList);
   void SongsUnavailable(SongList songs, bool unavailable = true);
   void SongsReadded(SongList songs, bool unavailable = false);
@@ -124,6 +127,12 @@ class CollectionWatcher : public QObject {
     CollectionSubdirectoryList touched_subdirs;
     CollectionSubdirectoryList deleted_subdirs;
 
+    // Tags read ahead of time in batches, consumed by ReadSongOnDisk().
+    QHash<QString, Song> songs_on_disk;
+
+    // Files committed with their old or no fingerprint, which are fingerprinted in the background afterwards.
+    QStringList files_to_fingerprint;
+
     QStringList files_changed_path_;
 
    private:
@@ -159,6 +168,26 @@ class CollectionWatcher : public QObject {
     bool known_subdirs_dirty_;
   };
 
+ private:
+  enum MediaFileGuess {
+    MediaFileGuess_No,
+    MediaFileGuess_Yes,
+    MediaFileGuess_Unknown
+  };
+
+  // The result of FingerprintFile(), with what is needed to add the fingerprint to the cache.
+  struct FingerprintResult {
+    explicit FingerprintResult() : inode(0), filesize(0), mtime(0), cached(false) {}
+    QString file;
+    quint64 inode;
+    qint64 filesize;
+    qint64 mtime;
+    QByteArray audio_hash;
+    QString fingerprint;
+    // Found by URL, inode, size and mtime, so the cache is already up to date.
+    bool cached;
+  };
+
  private slots:
   void ReloadSettings();
   void Exit();
@@ -169,6 +198,7 @@ class CollectionWatcher : public QObject {
   void RescanTracksNow();
   void RescanPathsNow();
   void ScanSubdirectory(const QString &path, const CollectionSubdirectory &subdir, const quint64 files_count, CollectionWatcher::ScanTransaction *t, const bool force_noincremental = false);
+  void FingerprintFinished();
 
  private:
   static bool FindSongsByPath(const SongList &songs, const QString &path, SongList *out);
@@ -190,10 +220,35 @@ class CollectionWatcher : public QObject {
   void UpdateNonCueAssociatedSong(const QString &file, const QString &fingerprint, const SongList &matching_songs, const QUrl &image, const bool cue_deleted, ScanTransaction *t);
   // Scans a single media file that's present on the disk but not yet in the collection.
   // It may result in a multiple files added to the collection when the media file has many sections (like a CUE related media file).
-  SongList ScanNewFile(const QString &file, const QString &path, const QString &fingerprint, const QString &matching_cue, QSet<QString> *cues_processed);
+  SongList ScanNewFile(const QString &file, const QString &path, const QString &fingerprint, const QString &matching_cue, QSet<QString> *cues_processed, ScanTransaction *t);
+
+  // Classifies the file by extension and optionally the header magic without asking the tagreader.
+  // Only files returning MediaFileGuess_Unknown need to be checked by FilterMediaFiles().
+  MediaFileGuess GuessMediaFile(const QString &file, const QString &ext_part) const;
+  // Asks the tagreader which of the files are media files, in batches of kTagReaderBatchSize files per request and worker.
+  QStringList FilterMediaFiles(const QStringList &files, ScanTransaction *t);
+  // Reads tags for all files in batches and stores them in the transaction for ReadSongOnDisk().
+  void ReadSongsOnDisk(const QStringList &files, ScanTransaction *t);
+  int TagReaderBatchSize() const;
+  // Returns the song read ahead of time by ReadSongsOnDisk(), or reads the file if it wasn't.
+  Song ReadSongOnDisk(const QString &file, ScanTransaction *t);
 
   static void AddChangedSong(const QString &file, const Song &matching_song, const Song &new_song, ScanTransaction *t);
 
+  // Looks up the fingerprint cache and creates the fingerprint on a cache miss, this runs on the fingerprint thread pool.
+  // The cache is looked up by URL, inode, size and mtime first, and then by a hash of the audio data,
+  // so files where only the tags were changed are not decoded again.
+  // "NONE" is used as fingerprint when it could not be created.
+  static FingerprintResult FingerprintFile(CollectionBackend *backend, const QString &file);
+  // Creates the fingerprints concurrently on the fingerprint thread pool and waits for all of them.
+  QStringList CreateFingerprints(const QStringList &files);
+  // Creates the fingerprints in the background, the collection is updated in batches through SongsFingerprintUpdated.
+  void QueueFingerprints(const QStringList &files);
+  void StartQueuedFingerprints();
+  void AddFingerprintedSong(const QString &file, const QString &fingerprint);
+  void AddCachedFingerprint(const FingerprintResult &result);
+  void ClearQueuedFingerprints();
+
   quint64 FilesCountForPath(ScanTransaction *t, const QString &path);
   quint64 FilesCountForSubdirs(ScanTransaction *t, const CollectionSubdirectoryList &subdirs, QMap<QString, quint64> &subdir_files_count);
 
@@ -220,6 +275,11 @@ class CollectionWatcher : public QObject {
   int expire_unavailable_songs_days_;
   bool overwrite_playcount_;
   bool overwrite_rating_;
+  // Spread the tag reading of each directory over all tagreader workers.
+  bool parallel_scan_;
+  // Detect media files by extension during the directory walk, and optionally verify them by reading the header magic.
+  bool media_file_by_extension_;
+  bool media_file_magic_;
 
   bool stop_requested_;
   bool abort_requested_;
@@ -228,6 +288,15 @@ class CollectionWatcher : public QObject {
   QMap<int, CollectionDirectory> watched_dirs_;
   QTimer *rescan_timer_;
   QTimer *periodic_scan_timer_;
+
+  QThreadPool *fingerprint_thread_pool_;
+  QStringList fingerprint_queue_;
+  QSet<QString> fingerprint_queued_files_;
+  SongList fingerprinted_songs_;
+  int fingerprint_active_;
+  int fingerprint_task_id_;
+  quint64 fingerprint_progress_;
+  quint64 fingerprint_progress_max_;
   QMap<int, QStringList> rescan_queue_;  // dir id -> list of subdirs to be scanned
   bool rescan_paused_;
 
@@ -236,6 +305,10 @@ class CollectionWatcher : public QObject {
   CueParser *cue_parser_;
 
   static QStringList sValidImages;
+  static QStringList sNonMediaExtensions;
+
+  static const int kTagReaderBatchSize;
+  static const int kFingerprintBatchSize;
 
   SongList song_rescan_queue_;  // Set by UI thread
 
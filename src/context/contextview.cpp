@@ -282,7 +282,7 @@ void ContextView::Init(Application *app, CollectionView *collectionview, AlbumCo
   album_cover_choice_controller_ = album_cover_choice_controller;
 
   widget_album_->Init(this, album_cover_choice_controller_);
-  lyrics_fetcher_ = new LyricsFetcher(app_->lyrics_providers(), this);
+  lyrics_fetcher_ = new LyricsFetcher(app_->lyrics_providers(), app_->database(), this);
 
   QObject::connect(collectionview_, &CollectionView::TotalSongCountUpdated_, this, &ContextView::UpdateNoSong);
   QObject::connect(collectionview_, &CollectionView::TotalArtistCountUpdated_, this, &ContextView::UpdateNoSong);
@@ -349,6 +349,8 @@ void ContextView::ReloadSettings() {
   font_size_normal_ = s.value("font_size_normal", font().pointSizeF()).toReal();
   s.endGroup();
 
+  if (lyrics_fetcher_) lyrics_fetcher_->ReloadSettings();
+
   UpdateFonts();
 
   if (widget_stacked_->currentWidget() == widget_stop_) {
@@ -38,6 +38,7 @@
 #include <QSqlDriver>
 #include <QSqlDatabase>
 #include <QSqlError>
+#include <QSettings>
 #include <QStandardPaths>
 
 #include "core/logging.h"
@@ -48,9 +49,10 @@
 #include "scopedtransaction.h"
 
 const char *Database::kDatabaseFilename = "strawberry.db";
-const int Database::kSchemaVersion = 15;
+const int Database::kSchemaVersion = 20;
 const int Database::kMinSupportedSchemaVersion = 10;
 const char *Database::kMagicAllSongsTables = "%allsongstables";
+const char *Database::kSettingsGroup = "Database";
 
 int Database::sNextConnectionId = 1;
 QMutex Database::sNextConnectionIdMutex;
@@ -64,10 +66,17 @@ Database::Database(Application *app, QObject *parent, const QString &database_na
       injected_database_name_(database_name),
       query_hash_(0),
       startup_schema_version_(-1),
-      original_thread_(nullptr) {
+      original_thread_(nullptr),
+      tuned_connections_(true),
+      wal_mode_(false) {
 
   original_thread_ = thread();
 
+  QSettings s;
+  s.beginGroup(kSettingsGroup);
+  tuned_connections_ = s.value("tuned_connections", true).toBool();
+  s.endGroup();
+
   {
     QMutexLocker l(&sNextConnectionIdMutex);
     connection_id_ = sNextConnectionId++;
@@ -142,6 +151,12 @@ QSqlDatabase Database::Connect() {
     return db;
   }
 
+  // The journal mode is stored in the database file, so it only needs to be set on the first connection.
+  if (startup_schema_version_ == -1) {
+    SetJournalMode(db);
+  }
+  SetConnectionOptions(db);
+
   if (db.tables().count() == 0) {
     // Set up initial schema
     qLog(Info) << "Creating initial database schema";
@@ -212,6 +227,43 @@ void Database::Close() {
 
 }
 
+void Database::SetJournalMode(QSqlDatabase &db) {
+
+  SqlQuery q(db);
+  q.prepare(QString("PRAGMA journal_mode = %1").arg(tuned_connections_ ? "WAL" : "DELETE"));
+  if (!q.Exec() || !q.next()) {
+    qLog(Error) << "Unable to set database journal mode:" << q.lastError();
+    return;
+  }
+
+  // In-memory databases can't use WAL and report "memory".
+  const QString journal_mode = q.value(0).toString();
+  wal_mode_ = journal_mode.compare("wal", Qt::CaseInsensitive) == 0;
+  qLog(Debug) << "Database journal mode is" << journal_mode;
+
+}
+
+void Database::SetConnectionOptions(QSqlDatabase &db) {
+
+  if (!tuned_connections_) return;
+
+  QStringList pragmas = QStringList() << "PRAGMA cache_size = -16384"
+                                      << "PRAGMA mmap_size = 268435456"
+                                      << "PRAGMA temp_store = MEMORY";
+
+  // With WAL, only checkpoints need to sync the database file, commits can't corrupt it on a power loss.
+  if (wal_mode_) pragmas << "PRAGMA synchronous = NORMAL";
+
+  for (const QString &pragma : pragmas) {
+    SqlQuery q(db);
+    q.prepare(pragma);
+    if (!q.Exec()) {
+      qLog(Error) << "Unable to execute" << pragma << q.lastError();
+    }
+  }
+
+}
+
 int Database::SchemaVersion(QSqlDatabase *db) {
 
   // Get the database's schema version
@@ -24,6 +24,8 @@
 
 #include "config.h"
 
+#include <atomic>
+
 #include <sqlite3.h>
 
 #include <QtGlobal>
@@ -64,18 +66,24 @@ class Database : public QObject {
   static const int kMinSupportedSchemaVersion;
   static const char *kDatabaseFilename;
   static const char *kMagicAllSongsTables;
+  static const char *kSettingsGroup;
 
   void ExitAsync();
   QSqlDatabase Connect();
   void Close();
   void ReportErrors(const SqlQuery &query);
 
+  // In WAL mode, queries that only read don't need to wait for the writers, since each thread has it's own connection.
 #if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
   QRecursiveMutex *Mutex() { return &mutex_; }
+  QRecursiveMutex *ReadMutex() { return wal_mode_ ? nullptr : &mutex_; }
 #else
   QMutex *Mutex() { return &mutex_; }
+  QMutex *ReadMutex() { return wal_mode_ ? nullptr : &mutex_; }
 #endif
 
+  bool wal_mode() const { return wal_mode_; }
+
   void RecreateAttachedDb(const QString &database_name);
   void ExecSchemaCommands(QSqlDatabase &db, const QString &schema, int schema_version, bool in_transaction = false);
 
@@ -110,6 +118,8 @@ class Database : public QObject {
   bool IntegrityCheck(const QSqlDatabase &db);
   void BackupFile(const QString &filename);
   static bool OpenDatabase(const QString &filename, sqlite3 **connection);
+  void SetJournalMode(QSqlDatabase &db);
+  void SetConnectionOptions(QSqlDatabase &db);
 
   Application *app_;
 
@@ -141,6 +151,11 @@ class Database : public QObject {
 
   QThread *original_thread_;
 
+  // Use WAL and the tuned connection options, can be turned off with the hidden "tuned_connections" setting.
+  bool tuned_connections_;
+  // Set when connecting, and read by ReadMutex() on all threads.
+  std::atomic<bool> wal_mode_;
+
 };
 
 class MemoryDatabase : public Database {
@@ -88,10 +88,10 @@ bool FilesystemMusicStorage::CopyToStorage(const CopyJob &job) {
       result = false;
     }
     else {
-      result = QFile::copy(src.absoluteFilePath(), dest.absoluteFilePath());
+      result = Utilities::CopyFile(src.absoluteFilePath(), dest.absoluteFilePath(), job.progress_);
     }
     if ((!cover_dest.exists() || job.overwrite_) && !cover_src.filePath().isEmpty() && !cover_dest.filePath().isEmpty()) {
-      QFile::copy(cover_src.absoluteFilePath(), cover_dest.absoluteFilePath());
+      Utilities::CopyFile(cover_src.absoluteFilePath(), cover_dest.absoluteFilePath());
     }
   }
 
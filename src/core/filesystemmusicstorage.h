@@ -40,6 +40,7 @@ class FilesystemMusicStorage : public virtual MusicStorage {
   std::optional<int> collection_directory_id() const override { return collection_directory_id_; }
 
   bool CopyToStorage(const CopyJob &job) override;
+  bool SupportsConcurrentCopies() const override { return true; }
   bool DeleteFromStorage(const DeleteJob &job) override;
 
  private:
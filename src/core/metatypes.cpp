@@ -55,7 +55,9 @@
 #  include "engine/gstenginepipeline.h"
 #endif
 #include "collection/collectiondirectory.h"
+#include "collection/collectionbackend.h"
 #include "playlist/playlistitem.h"
+#include "playlist/playlistbackend.h"
 #include "playlist/playlistsequence.h"
 #include "covermanager/albumcoverloaderresult.h"
 #include "covermanager/albumcoverfetcher.h"
@@ -107,6 +109,7 @@ void RegisterMetaTypes() {
   qRegisterMetaType<SongMap>("SongMap");
   qRegisterMetaType<QList<Song>>("QList<Song>");
   qRegisterMetaType<QMap<QString, Song>>("QMap<QString, Song>");
+  qRegisterMetaType<SyncedAlbumMap>("SyncedAlbumMap");
   qRegisterMetaType<Engine::EngineType>("EngineType");
   qRegisterMetaType<Engine::SimpleMetaBundle>("Engine::SimpleMetaBundle");
   qRegisterMetaType<Engine::State>("Engine::State");
@@ -120,6 +123,7 @@ void RegisterMetaTypes() {
   qRegisterMetaType<PlaylistItemPtr>("PlaylistItemPtr");
   qRegisterMetaType<PlaylistItemList>("PlaylistItemList");
   qRegisterMetaType<QList<PlaylistItemPtr>>("QList<PlaylistItemPtr>");
+  qRegisterMetaType<PlaylistBackend::PlaylistItemChanges>("PlaylistBackend::PlaylistItemChanges");
   qRegisterMetaType<PlaylistSequence::RepeatMode>("PlaylistSequence::RepeatMode");
   qRegisterMetaType<PlaylistSequence::ShuffleMode>("PlaylistSequence::ShuffleMode");
   qRegisterMetaType<AlbumCoverLoaderResult>("AlbumCoverLoaderResult");
@@ -89,6 +89,8 @@ class MusicStorage {
 
   virtual bool StartCopy(QList<Song::FileType> *supported_types) { Q_UNUSED(supported_types); return true; }
   virtual bool CopyToStorage(const CopyJob &job) = 0;
+  // Whether CopyToStorage() can be called from several threads at the same time for copy jobs which don't remove the original.
+  virtual bool SupportsConcurrentCopies() const { return false; }
   virtual void FinishCopy(bool success) { Q_UNUSED(success); }
 
   virtual void StartDelete() {}
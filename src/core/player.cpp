@@ -34,6 +34,7 @@
 #include <QUrl>
 #include <QDateTime>
 #include <QSettings>
+#include <QTimer>
 
 #include "core/logging.h"
 #include "utilities/timeconstants.h"
@@ -69,6 +70,10 @@
 #include "scrobbler/audioscrobbler.h"
 
 const char *Player::kSettingsGroup = "Player";
+const int Player::kPrefetchStreamUrls = 2;
+const int Player::kPrefetchStreamUrlsDelayMsec = 5000;
+const int Player::kStreamUrlLifetimeSec = 3600;
+const int Player::kExpiringStreamUrlLifetimeSec = 300;
 
 Player::Player(Application *app, QObject *parent)
     : PlayerInterface(parent),
@@ -90,7 +95,13 @@ Player::Player(Application *app, QObject *parent)
       greyout_(true),
       menu_previousmode_(BehaviourSettingsPage::PreviousBehaviour_DontRestart),
       seek_step_sec_(10),
-      play_offset_nanosec_(0) {
+      play_offset_nanosec_(0),
+      prefetch_timer_(new QTimer(this)) {
+
+  // Wait a bit after a track change, so skipping through the playlist doesn't resolve every track.
+  prefetch_timer_->setSingleShot(true);
+  prefetch_timer_->setInterval(kPrefetchStreamUrlsDelayMsec);
+  QObject::connect(prefetch_timer_, &QTimer::timeout, this, &Player::PrefetchStreamUrls);
 
   QSettings s;
   s.beginGroup(BackendSettingsPage::kSettingsGroup);
@@ -235,6 +246,15 @@ void Player::SaveVolume() {
 
 void Player::HandleLoadResult(const UrlHandler::LoadResult &result) {
 
+  if (result.type_ != UrlHandler::LoadResult::WillLoadAsynchronously && prefetching_.contains(result.original_url_)) {
+    if (--prefetching_[result.original_url_] <= 0) prefetching_.remove(result.original_url_);
+    if (stream_url_cache_.IsLoading(result.original_url_)) {
+      stream_url_cache_.Add(result, StreamUrlLifetimeMsec(result.original_url_));
+    }
+    // Nothing is waiting for this one, it was resolved ahead of time, or it came in after the prefetch timed out.
+    if (!loading_async_.contains(result.original_url_)) return;
+  }
+
   if (loading_async_.contains(result.original_url_)) {
     loading_async_.removeAll(result.original_url_);
   }
@@ -523,6 +543,7 @@ void Player::UnPause() {
       const quint64 time = QDateTime::currentDateTime().toSecsSinceEpoch() - pause_time_.toSecsSinceEpoch();
       if (time >= 30) {  // Stream URL might be expired.
         qLog(Debug) << "Re-requesting stream URL for" << song.url();
+        stream_url_cache_.Remove(song.url());
         play_offset_nanosec_ = engine_->position_nanosec();
         HandleLoadResult(url_handlers_[song.url().scheme()]->StartLoading(song.url()));
         return;
@@ -554,6 +575,7 @@ void Player::RestartOrPrevious() {
 void Player::Stop(const bool stop_after) {
 
   engine_->Stop(stop_after);
+  prefetch_timer_->stop();
   app_->playlist_manager()->active()->set_current_row(-1);
   current_item_.reset();
   pause_time_ = QDateTime();
@@ -719,6 +741,8 @@ void Player::PlayAt(const int index, const quint64 offset_nanosec, Engine::Track
   current_item_ = app_->playlist_manager()->active()->current_item();
   const QUrl url = current_item_->StreamUrl();
 
+  prefetch_timer_->start();
+
   if (url_handlers_.contains(url.scheme())) {
     // It's already loading
     if (loading_async_.contains(url)) {
@@ -727,7 +751,7 @@ void Player::PlayAt(const int index, const quint64 offset_nanosec, Engine::Track
 
     stream_change_type_ = change;
     autoscroll_ = autoscroll;
-    HandleLoadResult(url_handlers_[url.scheme()]->StartLoading(url));
+    HandleLoadResult(StartLoading(url));
   }
   else {
     qLog(Debug) << "Playing song" << current_item_->Metadata().title() << url << "position" << offset_nanosec;
@@ -881,7 +905,7 @@ void Player::TrackAboutToEnd() {
   if (url_handlers_.contains(url.scheme())) {
     if (loading_async_.contains(url)) return;
     autoscroll_ = Playlist::AutoScroll_Maybe;
-    UrlHandler::LoadResult result = url_handlers_[url.scheme()]->StartLoading(url);
+    UrlHandler::LoadResult result = StartLoading(url);
     switch (result.type_) {
       case UrlHandler::LoadResult::Error:
         emit Error(result.error_);
@@ -922,6 +946,9 @@ void Player::ValidSongRequested(const QUrl &url) {
 
 void Player::InvalidSongRequested(const QUrl &url) {
 
+  // The stream URL might have expired early.
+  stream_url_cache_.Remove(url);
+
   if (greyout_) emit SongChangeRequestProcessed(url, false);
 
   if (!continue_on_error_) {
@@ -959,11 +986,63 @@ void Player::UnregisterUrlHandler(UrlHandler *handler) {
 
   qLog(Info) << "Unregistered URL handler for" << scheme;
   url_handlers_.remove(scheme);
+  stream_url_cache_.Clear();
+  RemovePrefetching(scheme);
   QObject::disconnect(handler, &UrlHandler::destroyed, this, &Player::UrlHandlerDestroyed);
   QObject::disconnect(handler, &UrlHandler::AsyncLoadComplete, this, &Player::HandleLoadResult);
 
 }
 
+UrlHandler::LoadResult Player::StartLoading(const QUrl &url) {
+
+  UrlHandler::LoadResult result;
+  if (stream_url_cache_.Get(url, &result)) {
+    qLog(Debug) << "Using prefetched stream URL for" << url;
+    return result;
+  }
+
+  // It's being prefetched, HandleLoadResult() picks up the result when it's ready.
+  if (stream_url_cache_.IsLoading(url)) {
+    return UrlHandler::LoadResult(url, UrlHandler::LoadResult::WillLoadAsynchronously);
+  }
+
+  return url_handlers_[url.scheme()]->StartLoading(url);
+
+}
+
+qint64 Player::StreamUrlLifetimeMsec(const QUrl &url) {
+
+  const Song song(Song::SourceFromURL(url));
+  return static_cast<qint64>(song.stream_url_can_expire() ? kExpiringStreamUrlLifetimeSec : kStreamUrlLifetimeSec) * 1000;
+
+}
+
+void Player::PrefetchStreamUrls() {
+
+  stream_url_cache_.RemoveExpired();
+
+  Playlist *playlist = app_->playlist_manager()->active();
+  if (!playlist) return;
+
+  const QList<int> rows = playlist->next_rows(kPrefetchStreamUrls);
+  for (const int row : rows) {
+    if (!playlist->has_item_at(row)) continue;
+    const QUrl url = playlist->item_at(row)->StreamUrl();
+    if (!url_handlers_.contains(url.scheme()) || loading_async_.contains(url) || stream_url_cache_.Contains(url)) continue;
+
+    qLog(Debug) << "Prefetching stream URL for" << url;
+    stream_url_cache_.SetLoading(url);
+    UrlHandler::LoadResult result = url_handlers_[url.scheme()]->StartLoading(url);
+    if (result.type_ == UrlHandler::LoadResult::WillLoadAsynchronously) {
+      ++prefetching_[url];
+    }
+    else {
+      stream_url_cache_.Add(result, StreamUrlLifetimeMsec(url));
+    }
+  }
+
+}
+
 const UrlHandler *Player::HandlerForUrl(const QUrl &url) const {
 
   QMap<QString, UrlHandler*>::const_iterator it = url_handlers_.constFind(url.scheme());
@@ -980,6 +1059,22 @@ void Player::UrlHandlerDestroyed(QObject *object) {
   const QString scheme = url_handlers_.key(handler);
   if (!scheme.isEmpty()) {
     url_handlers_.remove(scheme);
+    stream_url_cache_.Clear();
+    RemovePrefetching(scheme);
+  }
+
+}
+
+void Player::RemovePrefetching(const QString &scheme) {
+
+  // The URL handler won't answer these anymore.
+  for (QHash<QUrl, int>::iterator it = prefetching_.begin(); it != prefetching_.end();) {
+    if (it.key().scheme() == scheme) {
+      it = prefetching_.erase(it);
+    }
+    else {
+      ++it;
+    }
   }
 
 }
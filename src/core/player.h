@@ -29,17 +29,21 @@
 #include <QtGlobal>
 #include <QObject>
 #include <QMap>
+#include <QHash>
 #include <QDateTime>
 #include <QString>
 #include <QUrl>
 
 #include "urlhandler.h"
+#include "streamurlcache.h"
 #include "engine/engine_fwd.h"
 #include "engine/enginetype.h"
 #include "playlist/playlist.h"
 #include "playlist/playlistitem.h"
 #include "settings/behavioursettingspage.h"
 
+class QTimer;
+
 class Application;
 class Song;
 class AnalyzerContainer;
@@ -214,13 +218,25 @@ class Player : public PlayerInterface {
   void UrlHandlerDestroyed(QObject *object);
   void HandleLoadResult(const UrlHandler::LoadResult &result);
 
+  void PrefetchStreamUrls();
+
  private:
   // Returns true if we were supposed to stop after this track.
   bool HandleStopAfter(const Playlist::AutoScroll autoscroll);
 
   void UnPause();
 
+  // Uses a prefetched stream URL if there is one, otherwise asks the URL handler.
+  UrlHandler::LoadResult StartLoading(const QUrl &url);
+  static qint64 StreamUrlLifetimeMsec(const QUrl &url);
+  void RemovePrefetching(const QString &scheme);
+
  private:
+  static const int kPrefetchStreamUrls;
+  static const int kPrefetchStreamUrlsDelayMsec;
+  static const int kStreamUrlLifetimeSec;
+  static const int kExpiringStreamUrlLifetimeSec;
+
   Application *app_;
   std::shared_ptr<EngineBase> engine_;
 #ifdef HAVE_GSTREAMER
@@ -251,6 +267,11 @@ class Player : public PlayerInterface {
   QDateTime pause_time_;
   quint64 play_offset_nanosec_;
 
+  StreamUrlCache stream_url_cache_;
+  // Number of prefetch requests each URL handler still has to answer.
+  QHash<QUrl, int> prefetching_;
+  QTimer *prefetch_timer_;
+
 };
 
 #endif  // PLAYER_H
@@ -59,6 +59,7 @@
 #include "sqlquery.h"
 #include "mpris_common.h"
 #include "sqlrow.h"
+#include "stringpool.h"
 #include "tagreadermessages.pb.h"
 
 #define QStringFromStdString(x) QString::fromUtf8((x).data(), (x).size())
@@ -153,7 +154,7 @@ const QStringList Song::kArticles = QStringList() << "the " << "a " << "an ";
 
 const QStringList Song::kAcceptedExtensions = QStringList() << "wav" << "flac" << "wv" << "ogg" << "oga" << "opus" << "spx" << "ape" << "mpc"
                                                             << "mp2" << "mp3" <<  "m4a" << "mp4" << "aac" << "asf" << "asx" << "wma"
-                                                            << "aif << aiff" << "mka" << "tta" << "dsf" << "dsd"
+                                                            << "aif" << "aiff" << "mka" << "tta" << "dsf" << "dsd"
                                                             << "ac3" << "dts" << "spc" << "vgm";
 
 struct Song::Private : public QSharedData {
@@ -948,6 +949,8 @@ void Song::InitFromProtobuf(const spb::tagreader::SongMetadata &pb) {
 
   InitArtManual();
 
+  InternStrings();
+
 }
 
 void Song::ToProtobuf(spb::tagreader::SongMetadata *pb) const {
@@ -1062,6 +1065,8 @@ void Song::InitFromQuery(const SqlRow &q, const bool reliable_metadata) {
 
   InitArtManual();
 
+  InternStrings();
+
 }
 
 void Song::InitFromFilePartial(const QString &filename, const QFileInfo &fileinfo) {
@@ -1103,6 +1108,12 @@ void Song::InitArtAutomatic() {
 
 }
 
+void Song::InternStrings() {
+
+  StringPool::Instance()->Intern({ &d->album_, &d->album_sortable_, &d->artist_, &d->artist_sortable_, &d->albumartist_, &d->albumartist_sortable_, &d->genre_, &d->composer_, &d->performer_, &d->grouping_, &d->comment_, &d->artist_id_, &d->album_id_, &d->cue_path_ }, { &d->art_automatic_, &d->art_manual_ });
+
+}
+
 #ifdef HAVE_LIBGPOD
 void Song::InitFromItdb(Itdb_Track *track, const QString &prefix) {
 
@@ -172,6 +172,10 @@ class Song {
   void InitArtManual();
   void InitArtAutomatic();
 
+  // Shares the strings that are usually the same for many songs, like the artist, album and genre, with other songs through the StringPool.
+  // This is done by InitFromQuery() and InitFromProtobuf().
+  void InternStrings();
+
   bool MergeFromSimpleMetaBundle(const Engine::SimpleMetaBundle &bundle);
 
 #ifdef HAVE_LIBGPOD
@@ -394,6 +398,9 @@ class Song {
   bool IsOnSameAlbum(const Song &other) const;
   bool IsSimilar(const Song &other) const;
 
+  // Returns true if this is an unmodified copy of the other song, ie.: both share the same data.
+  bool IsSameData(const Song &other) const { return d == other.d; }
+
   bool operator==(const Song &other) const;
   bool operator!=(const Song &other) const;
 
@@ -89,17 +89,10 @@ bool SqlQuery::Exec() {
   bool success = exec();
   last_query_ = executedQuery();
 
+  // Only put the bound values into the query text when LastQuery() is called for an error message, since this is called once per row on bulk inserts.
 #if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
-  for (QMap<QString, QVariant>::const_iterator it = bound_values_.constBegin(); it != bound_values_.constEnd(); ++it) {
-    last_query_.replace(it.key(), it.value().toString());
-  }
+  last_bound_values_.swap(bound_values_);
   bound_values_.clear();
-#else
-  QMapIterator<QString, QVariant> it(boundValues());
-  while (it.hasNext()) {
-    it.next();
-    last_query_.replace(it.key(), it.value().toString());
-  }
 #endif
 
   return success;
@@ -108,6 +101,20 @@ bool SqlQuery::Exec() {
 
 QString SqlQuery::LastQuery() const {
 
-  return last_query_;
+  QString last_query = last_query_;
+
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+  for (QMap<QString, QVariant>::const_iterator it = last_bound_values_.constBegin(); it != last_bound_values_.constEnd(); ++it) {
+    last_query.replace(it.key(), it.value().toString());
+  }
+#else
+  QMapIterator<QString, QVariant> it(boundValues());
+  while (it.hasNext()) {
+    it.next();
+    last_query.replace(it.key(), it.value().toString());
+  }
+#endif
+
+  return last_query;
 
 }
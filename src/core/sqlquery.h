@@ -49,6 +49,7 @@ class SqlQuery : public QSqlQuery {
  private:
 #if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
   QMap<QString, QVariant> bound_values_;
+  QMap<QString, QVariant> last_bound_values_;
 #endif
   QString last_query_;
 
@@ -0,0 +1,116 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2021, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <QtGlobal>
+#include <QHash>
+#include <QUrl>
+#include <QDateTime>
+
+#include "urlhandler.h"
+#include "streamurlcache.h"
+
+const qint64 StreamUrlCache::kLoadingTimeoutMsec = 30000;
+
+StreamUrlCache::StreamUrlCache() = default;
+
+void StreamUrlCache::SetLoading(const QUrl &url) {
+
+  results_.remove(url);
+  loading_.insert(url, QDateTime::currentMSecsSinceEpoch() + kLoadingTimeoutMsec);
+
+}
+
+bool StreamUrlCache::IsLoading(const QUrl &url) const {
+
+  QHash<QUrl, qint64>::const_iterator it = loading_.constFind(url);
+  return it != loading_.constEnd() && it.value() > QDateTime::currentMSecsSinceEpoch();
+
+}
+
+void StreamUrlCache::Add(const UrlHandler::LoadResult &result, const qint64 lifetime_msec) {
+
+  loading_.remove(result.original_url_);
+
+  if (result.type_ != UrlHandler::LoadResult::TrackAvailable || !result.stream_url_.isValid()) {
+    results_.remove(result.original_url_);
+    return;
+  }
+
+  results_.insert(result.original_url_, Entry(result, QDateTime::currentMSecsSinceEpoch() + lifetime_msec));
+
+}
+
+bool StreamUrlCache::Contains(const QUrl &url) const {
+
+  if (IsLoading(url)) return true;
+
+  QHash<QUrl, Entry>::const_iterator it = results_.constFind(url);
+  return it != results_.constEnd() && it->expires_msec > QDateTime::currentMSecsSinceEpoch();
+
+}
+
+bool StreamUrlCache::Get(const QUrl &url, UrlHandler::LoadResult *result) const {
+
+  QHash<QUrl, Entry>::const_iterator it = results_.constFind(url);
+  if (it == results_.constEnd() || it->expires_msec <= QDateTime::currentMSecsSinceEpoch()) {
+    return false;
+  }
+
+  *result = it->result;
+  return true;
+
+}
+
+void StreamUrlCache::Remove(const QUrl &url) {
+
+  results_.remove(url);
+  loading_.remove(url);
+
+}
+
+void StreamUrlCache::RemoveExpired() {
+
+  const qint64 now = QDateTime::currentMSecsSinceEpoch();
+  for (QHash<QUrl, Entry>::iterator it = results_.begin(); it != results_.end();) {
+    if (it->expires_msec <= now) {
+      it = results_.erase(it);
+    }
+    else {
+      ++it;
+    }
+  }
+  for (QHash<QUrl, qint64>::iterator it = loading_.begin(); it != loading_.end();) {
+    if (it.value() <= now) {
+      it = loading_.erase(it);
+    }
+    else {
+      ++it;
+    }
+  }
+
+}
+
+void StreamUrlCache::Clear() {
+
+  results_.clear();
+  loading_.clear();
+
+}
@@ -0,0 +1,72 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2021, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef STREAMURLCACHE_H
+#define STREAMURLCACHE_H
+
+#include "config.h"
+
+#include <QtGlobal>
+#include <QHash>
+#include <QUrl>
+
+#include "urlhandler.h"
+
+// Keeps stream URLs which were resolved by a URL handler before the player needed them.
+// Each result is kept until its lifetime runs out, so the same stream URL is used for preloading and playing the track.
+class StreamUrlCache {
+ public:
+  explicit StreamUrlCache();
+
+  // URL handlers which never answer should not block the URL forever.
+  static const qint64 kLoadingTimeoutMsec;
+
+  // Marks a URL as being resolved, the result is passed to Add() later.
+  void SetLoading(const QUrl &url);
+  bool IsLoading(const QUrl &url) const;
+
+  // Stores the result if a track is available, otherwise just forgets about the URL.
+  void Add(const UrlHandler::LoadResult &result, const qint64 lifetime_msec);
+
+  // Returns true if there is a result which is not expired, or the URL is being resolved.
+  bool Contains(const QUrl &url) const;
+
+  // Returns true and sets result if there is a result which is not expired.
+  bool Get(const QUrl &url, UrlHandler::LoadResult *result) const;
+
+  void Remove(const QUrl &url);
+  void RemoveExpired();
+  void Clear();
+
+  int count() const { return static_cast<int>(results_.count()); }
+
+ private:
+  struct Entry {
+    Entry() : expires_msec(0) {}
+    Entry(const UrlHandler::LoadResult &_result, const qint64 _expires_msec) : result(_result), expires_msec(_expires_msec) {}
+    UrlHandler::LoadResult result;
+    qint64 expires_msec;
+  };
+
+  QHash<QUrl, Entry> results_;
+  // URLs being resolved and when to give up on them.
+  QHash<QUrl, qint64> loading_;
+};
+
+#endif  // STREAMURLCACHE_H
@@ -0,0 +1,151 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2021, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <initializer_list>
+
+#include <QtGlobal>
+#include <QMutex>
+#include <QSet>
+#include <QString>
+#include <QUrl>
+
+#include "stringpool.h"
+
+const int StringPool::kMinimumPruneSize = 4096;
+
+StringPool::StringPool() : prune_size_(kMinimumPruneSize) {}
+
+StringPool *StringPool::Instance() {
+
+  // Songs are created on many threads, so the instance is created thread-safe on first use.
+  static StringPool instance;
+  return &instance;
+
+}
+
+QString StringPool::Intern(const QString &str) {
+
+  QMutexLocker l(&mutex_);
+  const QString ret = InternLocked(str);
+  MaybePruneLocked();
+  return ret;
+
+}
+
+QUrl StringPool::Intern(const QUrl &url) {
+
+  QMutexLocker l(&mutex_);
+  const QUrl ret = InternLocked(url);
+  MaybePruneLocked();
+  return ret;
+
+}
+
+void StringPool::Intern(std::initializer_list<QString*> strings, std::initializer_list<QUrl*> urls) {
+
+  QMutexLocker l(&mutex_);
+  for (QString *str : strings) {
+    *str = InternLocked(*str);
+  }
+  for (QUrl *url : urls) {
+    *url = InternLocked(*url);
+  }
+  MaybePruneLocked();
+
+}
+
+int StringPool::string_count() {
+
+  QMutexLocker l(&mutex_);
+  return static_cast<int>(strings_.count());
+
+}
+
+int StringPool::url_count() {
+
+  QMutexLocker l(&mutex_);
+  return static_cast<int>(urls_.count());
+
+}
+
+void StringPool::Prune() {
+
+  QMutexLocker l(&mutex_);
+  PruneLocked();
+
+}
+
+QString StringPool::InternLocked(const QString &str) {
+
+  // Empty strings don't have any data of their own.
+  if (str.isEmpty()) return str;
+
+  QSet<QString>::const_iterator it = strings_.constFind(str);
+  if (it != strings_.constEnd()) return *it;
+
+  strings_.insert(str);
+  return str;
+
+}
+
+QUrl StringPool::InternLocked(const QUrl &url) {
+
+  if (url.isEmpty()) return url;
+
+  QSet<QUrl>::const_iterator it = urls_.constFind(url);
+  if (it != urls_.constEnd()) return *it;
+
+  urls_.insert(url);
+  return url;
+
+}
+
+void StringPool::MaybePruneLocked() {
+
+  if (strings_.count() + urls_.count() < prune_size_) return;
+
+  PruneLocked();
+  prune_size_ = qMax(static_cast<qint64>(kMinimumPruneSize), static_cast<qint64>(strings_.count() + urls_.count()) * 2);
+
+}
+
+void StringPool::PruneLocked() {
+
+  // A detached string is not shared with anything outside of the pool.
+  for (QSet<QString>::iterator it = strings_.begin(); it != strings_.end();) {
+    if (it->isDetached()) {
+      it = strings_.erase(it);
+    }
+    else {
+      ++it;
+    }
+  }
+
+  for (QSet<QUrl>::iterator it = urls_.begin(); it != urls_.end();) {
+    if (it->isDetached()) {
+      it = urls_.erase(it);
+    }
+    else {
+      ++it;
+    }
+  }
+
+}
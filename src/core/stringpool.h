@@ -0,0 +1,71 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2021, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef STRINGPOOL_H
+#define STRINGPOOL_H
+
+#include "config.h"
+
+#include <initializer_list>
+
+#include <QtGlobal>
+#include <QMutex>
+#include <QSet>
+#include <QString>
+#include <QUrl>
+
+// Pool of strings and URLs which are repeated between songs, like the artist, album and genre.
+// Interning a string replaces it with an equal string from the pool, so all songs share one copy of the data.
+// Strings which are no longer used outside of the pool are removed when the pool has doubled in size.
+// This class is thread-safe.
+class StringPool {
+ public:
+  static StringPool *Instance();
+
+  static const int kMinimumPruneSize;
+
+  QString Intern(const QString &str);
+  QUrl Intern(const QUrl &url);
+
+  // Interns all given strings and URLs in place while locking the pool once.
+  void Intern(std::initializer_list<QString*> strings, std::initializer_list<QUrl*> urls);
+
+  int string_count();
+  int url_count();
+
+  // Removes the strings and URLs which are only referenced by the pool.
+  void Prune();
+
+ private:
+  explicit StringPool();
+
+  QString InternLocked(const QString &str);
+  QUrl InternLocked(const QUrl &url);
+  void MaybePruneLocked();
+  void PruneLocked();
+
+  QMutex mutex_;
+  QSet<QString> strings_;
+  QSet<QUrl> urls_;
+  qint64 prune_size_;
+
+  Q_DISABLE_COPY(StringPool)
+};
+
+#endif  // STRINGPOOL_H
@@ -28,6 +28,7 @@
 #include <QThread>
 #include <QByteArray>
 #include <QString>
+#include <QStringList>
 #include <QImage>
 #include <QSettings>
 
@@ -43,20 +44,20 @@
 const char *TagReaderClient::kWorkerExecutableName = "strawberry-tagreader";
 TagReaderClient *TagReaderClient::sInstance = nullptr;
 
-TagReaderClient::TagReaderClient(QObject *parent) : QObject(parent), worker_pool_(new WorkerPool<HandlerType>(this)) {
+TagReaderClient::TagReaderClient(QObject *parent) : QObject(parent), worker_pool_(new WorkerPool<HandlerType>(this)), worker_count_(1) {
 
   sInstance = this;
   original_thread_ = thread();
 
   QSettings s;
   s.beginGroup(CollectionSettingsPage::kSettingsGroup);
-  int workers = s.value("tagreader_workers", qBound(1, QThread::idealThreadCount() / 2, 4)).toInt();
+  worker_count_ = qMax(1, s.value("tagreader_workers", qBound(1, QThread::idealThreadCount() / 2, 4)).toInt());
   s.endGroup();
 
-  qLog(Debug) << "Using" << workers << "tagreader workers.";
+  qLog(Debug) << "Using" << worker_count_ << "tagreader workers.";
 
   worker_pool_->SetExecutableName(kWorkerExecutableName);
-  worker_pool_->SetWorkerCount(workers);
+  worker_pool_->SetWorkerCount(worker_count_);
   QObject::connect(worker_pool_, &WorkerPool<HandlerType>::WorkerFailedToStart, this, &TagReaderClient::WorkerFailedToStart);
 
 }
@@ -90,6 +91,19 @@ TagReaderReply *TagReaderClient::IsMediaFile(const QString &filename) {
 
 }
 
+TagReaderReply *TagReaderClient::IsMediaFiles(const QStringList &filenames) {
+
+  spb::tagreader::Message message;
+  spb::tagreader::IsMediaFilesRequest *req = message.mutable_is_media_files_request();
+
+  for (const QString &filename : filenames) {
+    req->add_filenames(DataCommaSizeFromQString(filename));
+  }
+
+  return worker_pool_->SendMessageWithReply(&message);
+
+}
+
 TagReaderReply *TagReaderClient::ReadFile(const QString &filename) {
 
   spb::tagreader::Message message;
@@ -101,6 +115,19 @@ TagReaderReply *TagReaderClient::ReadFile(const QString &filename) {
 
 }
 
+TagReaderReply *TagReaderClient::ReadFiles(const QStringList &filenames) {
+
+  spb::tagreader::Message message;
+  spb::tagreader::ReadFilesRequest *req = message.mutable_read_files_request();
+
+  for (const QString &filename : filenames) {
+    req->add_filenames(DataCommaSizeFromQString(filename));
+  }
+
+  return worker_pool_->SendMessageWithReply(&message);
+
+}
+
 TagReaderReply *TagReaderClient::SaveFile(const QString &filename, const Song &metadata) {
 
   spb::tagreader::Message message;
@@ -208,6 +235,125 @@ void TagReaderClient::ReadFileBlocking(const QString &filename, Song *song) {
 
 }
 
+QList<bool> TagReaderClient::IsMediaFilesBlocking(const QStringList &filenames) {
+
+  Q_ASSERT(QThread::currentThread() != thread());
+
+  QList<bool> ret;
+  ret.reserve(filenames.count());
+
+  IsMediaFilesReply(IsMediaFiles(filenames), filenames.count(), &ret);
+
+  return ret;
+
+}
+
+QList<bool> TagReaderClient::IsMediaFilesParallelBlocking(const QStringList &filenames) {
+
+  Q_ASSERT(QThread::currentThread() != thread());
+
+  QList<bool> ret;
+  ret.reserve(filenames.count());
+
+  // Send all requests before waiting for any of them, the worker pool hands them out to the workers round-robin.
+  const QList<QStringList> batches = SplitForWorkers(filenames);
+  QList<TagReaderReply*> replies;
+  replies.reserve(batches.count());
+  for (const QStringList &batch : batches) {
+    replies << IsMediaFiles(batch);
+  }
+  for (int i = 0; i < replies.count(); ++i) {
+    IsMediaFilesReply(replies[i], batches[i].count(), &ret);
+  }
+
+  return ret;
+
+}
+
+SongList TagReaderClient::ReadFilesBlocking(const QStringList &filenames, const Song::Source source) {
+
+  Q_ASSERT(QThread::currentThread() != thread());
+
+  SongList songs;
+  songs.reserve(filenames.count());
+
+  ReadFilesReply(ReadFiles(filenames), filenames.count(), source, &songs);
+
+  return songs;
+
+}
+
+SongList TagReaderClient::ReadFilesParallelBlocking(const QStringList &filenames, const Song::Source source) {
+
+  Q_ASSERT(QThread::currentThread() != thread());
+
+  SongList songs;
+  songs.reserve(filenames.count());
+
+  const QList<QStringList> batches = SplitForWorkers(filenames);
+  QList<TagReaderReply*> replies;
+  replies.reserve(batches.count());
+  for (const QStringList &batch : batches) {
+    replies << ReadFiles(batch);
+  }
+  for (int i = 0; i < replies.count(); ++i) {
+    ReadFilesReply(replies[i], batches[i].count(), source, &songs);
+  }
+
+  return songs;
+
+}
+
+QList<QStringList> TagReaderClient::SplitForWorkers(const QStringList &filenames) const {
+
+  QList<QStringList> batches;
+
+  const int batch_size = qMax(1, (static_cast<int>(filenames.count()) + worker_count_ - 1) / worker_count_);
+  for (int i = 0; i < filenames.count(); i += batch_size) {
+    batches << filenames.mid(i, batch_size);
+  }
+
+  return batches;
+
+}
+
+void TagReaderClient::IsMediaFilesReply(TagReaderReply *reply, const int count, QList<bool> *ret) {
+
+  int received = 0;
+  if (reply->WaitForFinished()) {
+    const spb::tagreader::IsMediaFilesResponse &response = reply->message().is_media_files_response();
+    for (; received < response.success_size() && received < count; ++received) {
+      *ret << response.success(received);
+    }
+  }
+  QMetaObject::invokeMethod(reply, "deleteLater", Qt::QueuedConnection);
+
+  // Pad the result if the worker failed, so it always lines up with the filenames.
+  for (; received < count; ++received) {
+    *ret << false;
+  }
+
+}
+
+void TagReaderClient::ReadFilesReply(TagReaderReply *reply, const int count, const Song::Source source, SongList *songs) {
+
+  int received = 0;
+  if (reply->WaitForFinished()) {
+    const spb::tagreader::ReadFilesResponse &response = reply->message().read_files_response();
+    for (; received < response.metadata_size() && received < count; ++received) {
+      Song song(source);
+      song.InitFromProtobuf(response.metadata(received));
+      *songs << song;
+    }
+  }
+  QMetaObject::invokeMethod(reply, "deleteLater", Qt::QueuedConnection);
+
+  for (; received < count; ++received) {
+    *songs << Song(source);
+  }
+
+}
+
 bool TagReaderClient::SaveFileBlocking(const QString &filename, const Song &metadata) {
 
   Q_ASSERT(QThread::currentThread() != thread());
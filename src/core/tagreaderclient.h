@@ -27,6 +27,7 @@
 #include <QObject>
 #include <QList>
 #include <QString>
+#include <QStringList>
 #include <QImage>
 
 #include "core/messagehandler.h"
@@ -54,8 +55,10 @@ class TagReaderClient : public QObject {
   void ExitAsync();
 
   ReplyType *ReadFile(const QString &filename);
+  ReplyType *ReadFiles(const QStringList &filenames);
   ReplyType *SaveFile(const QString &filename, const Song &metadata);
   ReplyType *IsMediaFile(const QString &filename);
+  ReplyType *IsMediaFiles(const QStringList &filenames);
   ReplyType *LoadEmbeddedArt(const QString &filename);
   ReplyType *SaveEmbeddedArt(const QString &filename, const QByteArray &data);
   ReplyType *UpdateSongPlaycount(const Song &metadata);
@@ -64,14 +67,22 @@ class TagReaderClient : public QObject {
   // Convenience functions that call the above functions and wait for a response.
   // These block the calling thread with a semaphore, and must NOT be called from the TagReaderClient's thread.
   void ReadFileBlocking(const QString &filename, Song *song);
+  // Reads all files in one round-trip, the returned list has one song per filename in the same order.
+  SongList ReadFilesBlocking(const QStringList &filenames, const Song::Source source = Song::Source_Unknown);
   bool SaveFileBlocking(const QString &filename, const Song &metadata);
   bool IsMediaFileBlocking(const QString &filename);
+  QList<bool> IsMediaFilesBlocking(const QStringList &filenames);
+  // Same as above, but the files are split into one request per worker, so all workers handle them concurrently.
+  SongList ReadFilesParallelBlocking(const QStringList &filenames, const Song::Source source = Song::Source_Unknown);
+  QList<bool> IsMediaFilesParallelBlocking(const QStringList &filenames);
   QByteArray LoadEmbeddedArtBlocking(const QString &filename);
   QImage LoadEmbeddedArtAsImageBlocking(const QString &filename);
   bool SaveEmbeddedArtBlocking(const QString &filename, const QByteArray &data);
   bool UpdateSongPlaycountBlocking(const Song &metadata);
   bool UpdateSongRatingBlocking(const Song &metadata);
 
+  int worker_count() const { return worker_count_; }
+
   // TODO: Make this not a singleton
   static TagReaderClient *Instance() { return sInstance; }
 
@@ -86,10 +97,16 @@ class TagReaderClient : public QObject {
   void UpdateSongsPlaycount(const SongList &songs);
   void UpdateSongsRating(const SongList &songs);
 
+ private:
+  QList<QStringList> SplitForWorkers(const QStringList &filenames) const;
+  static void IsMediaFilesReply(ReplyType *reply, const int count, QList<bool> *ret);
+  static void ReadFilesReply(ReplyType *reply, const int count, const Song::Source source, SongList *songs);
+
  private:
   static TagReaderClient *sInstance;
 
   WorkerPool<HandlerType> *worker_pool_;
+  int worker_count_;
   QList<spb::tagreader::Message> message_queue_;
   QThread *original_thread_;
 };
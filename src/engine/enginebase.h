@@ -47,7 +47,8 @@ namespace Engine {
 
 struct SimpleMetaBundle;
 
-using Scope = std::vector<int16_t>;
+// Mono frames in the range -1.0..1.0, the newest frame last.
+using Scope = std::vector<float>;
 
 class Base : public QObject {
   Q_OBJECT
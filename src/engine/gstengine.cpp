@@ -77,7 +77,6 @@ GstEngine::GstEngine(TaskManager *task_manager, QObject *parent)
       gst_startup_(nullptr),
       discoverer_(nullptr),
       buffering_task_id_(-1),
-      latest_buffer_(nullptr),
       stereo_balancer_enabled_(false),
       stereo_balance_(0.0F),
       equalizer_enabled_(false),
@@ -88,9 +87,6 @@ GstEngine::GstEngine(TaskManager *task_manager, QObject *parent)
       timer_id_(-1),
       is_fading_out_to_pause_(false),
       has_faded_out_(false),
-      scope_chunk_(0),
-      have_new_buffer_(false),
-      scope_chunks_(0),
       discovery_finished_cb_id_(-1),
       discovery_discovered_cb_id_(-1) {
 
@@ -107,11 +103,6 @@ GstEngine::~GstEngine() {
   EnsureInitialized();
   current_pipeline_.reset();
 
-  if (latest_buffer_) {
-    gst_buffer_unref(latest_buffer_);
-    latest_buffer_ = nullptr;
-  }
-
   if (discoverer_) {
 
     if (discovery_discovered_cb_id_ != -1) {
@@ -371,23 +362,8 @@ qint64 GstEngine::length_nanosec() const {
 
 const Engine::Scope &GstEngine::scope(const int chunk_length) {
 
-  // The new buffer could have a different size
-  if (have_new_buffer_) {
-    if (latest_buffer_) {
-      scope_chunks_ = ceil((static_cast<double>(GST_BUFFER_DURATION(latest_buffer_) / static_cast<double>(chunk_length * kNsecPerMsec))));
-    }
-
-    // if the buffer is shorter than the chunk length
-    if (scope_chunks_ <= 0) {
-      scope_chunks_ = 1;
-    }
-
-    scope_chunk_ = 0;
-    have_new_buffer_ = false;
-  }
-
-  if (latest_buffer_) {
-    UpdateScope(chunk_length);
+  if (current_pipeline_) {
+    current_pipeline_->scope_buffer()->Read(&scope_, chunk_length);
   }
 
   return scope_;
@@ -443,16 +419,6 @@ void GstEngine::ReloadSettings() {
 
 }
 
-void GstEngine::ConsumeBuffer(GstBuffer *buffer, const int pipeline_id, const QString &format) {
-
-  // Schedule this to run in the GUI thread.  The buffer gets added to the queue and unreffed by UpdateScope.
-  if (!QMetaObject::invokeMethod(this, "AddBufferToScope", Q_ARG(GstBuffer*, buffer), Q_ARG(int, pipeline_id), Q_ARG(QString, format))) {
-    qLog(Warning) << "Failed to invoke AddBufferToScope on GstEngine";
-    gst_buffer_unref(buffer);
-  }
-
-}
-
 void GstEngine::SetStereoBalancerEnabled(const bool enabled) {
 
   stereo_balancer_enabled_ = enabled;
@@ -570,23 +536,6 @@ void GstEngine::NewMetaData(const int pipeline_id, const Engine::SimpleMetaBundl
 
 }
 
-void GstEngine::AddBufferToScope(GstBuffer *buf, const int pipeline_id, const QString &format) {
-
-  if (!current_pipeline_ || current_pipeline_->id() != pipeline_id) {
-    gst_buffer_unref(buf);
-    return;
-  }
-
-  if (latest_buffer_) {
-    gst_buffer_unref(latest_buffer_);
-  }
-
-  buffer_format_ = format;
-  latest_buffer_ = buf;
-  have_new_buffer_ = true;
-
-}
-
 void GstEngine::FadeoutFinished() {
   fadeout_pipeline_.reset();
   emit FadeoutFinishedSignal();
@@ -804,7 +753,6 @@ std::shared_ptr<GstEnginePipeline> GstEngine::CreatePipeline() {
   ret->set_bs2b_enabled(bs2b_enabled_);
   ret->set_fading_enabled(fadeout_enabled_ || autocrossfade_enabled_ || fadeout_pause_enabled_);
 
-  ret->AddBufferConsumer(this);
   for (GstBufferConsumer *consumer : buffer_consumers_) {
     ret->AddBufferConsumer(consumer);
   }
@@ -836,68 +784,6 @@ std::shared_ptr<GstEnginePipeline> GstEngine::CreatePipeline(const QByteArray &g
 
 }
 
-void GstEngine::UpdateScope(const int chunk_length) {
-
-  using sample_type = Engine::Scope::value_type;
-
-  // Prevent dbz or invalid chunk size
-  if (!GST_CLOCK_TIME_IS_VALID(GST_BUFFER_DURATION(latest_buffer_))) return;
-  if (GST_BUFFER_DURATION(latest_buffer_) == 0) return;
-
-  GstMapInfo map;
-  gst_buffer_map(latest_buffer_, &map, GST_MAP_READ);
-
-  // Determine where to split the buffer
-  int chunk_density = static_cast<int>((map.size * kNsecPerMsec) / GST_BUFFER_DURATION(latest_buffer_));
-
-  int chunk_size = chunk_length * chunk_density;
-
-  // In case a buffer doesn't arrive in time
-  if (scope_chunk_ >= scope_chunks_) {
-    scope_chunk_ = 0;
-    gst_buffer_unmap(latest_buffer_, &map);
-    return;
-  }
-
-  const sample_type *source = reinterpret_cast<sample_type*>(map.data);
-  sample_type *dest = scope_.data();
-  source += (chunk_size / sizeof(sample_type)) * scope_chunk_;
-
-  size_t bytes = 0;
-
-  // Make sure we don't go beyond the end of the buffer
-  if (scope_chunk_ == scope_chunks_ - 1) {
-    bytes = qMin(static_cast<Engine::Scope::size_type>(map.size - (chunk_size * scope_chunk_)), scope_.size() * sizeof(sample_type));
-  }
-  else {
-    bytes = qMin(static_cast<Engine::Scope::size_type>(chunk_size), scope_.size() * sizeof(sample_type));
-  }
-
-  scope_chunk_++;
-
-  if (buffer_format_.startsWith("S16LE") ||
-      buffer_format_.startsWith("U16LE") ||
-      buffer_format_.startsWith("S24LE") ||
-      buffer_format_.startsWith("S24_32LE") ||
-      buffer_format_.startsWith("S32LE") ||
-      buffer_format_.startsWith("F32LE")
-  ) {
-    memcpy(dest, source, bytes);
-  }
-  else {
-    memset(dest, 0, bytes);
-  }
-
-  gst_buffer_unmap(latest_buffer_, &map);
-
-  if (scope_chunk_ == scope_chunks_) {
-    gst_buffer_unref(latest_buffer_);
-    latest_buffer_ = nullptr;
-    buffer_format_.clear();
-  }
-
-}
-
 void GstEngine::StreamDiscovered(GstDiscoverer*, GstDiscovererInfo *info, GError*, gpointer self) {
 
   GstEngine *instance = reinterpret_cast<GstEngine*>(self);
@@ -54,7 +54,7 @@ class GstEnginePipeline;
  * @short GStreamer engine plugin
  * @author Mark Kretschmann <markey@web.de>
  */
-class GstEngine : public Engine::Base, public GstBufferConsumer {
+class GstEngine : public Engine::Base {
   Q_OBJECT
 
  public:
@@ -90,8 +90,6 @@ class GstEngine : public Engine::Base, public GstBufferConsumer {
   void SetStartup(GstStartup *gst_startup) { gst_startup_ = gst_startup; }
   void EnsureInitialized() { gst_startup_->EnsureInitialized(); }
 
-  void ConsumeBuffer(GstBuffer *buffer, const int pipeline_id, const QString &format) override;
-
  public slots:
   void ReloadSettings() override;
 
@@ -117,7 +115,6 @@ class GstEngine : public Engine::Base, public GstBufferConsumer {
   void EndOfStreamReached(const int pipeline_id, const bool has_next_track);
   void HandlePipelineError(const int pipeline_id, const int domain, const int error_code, const QString &message, const QString &debugstr);
   void NewMetaData(const int pipeline_id, const Engine::SimpleMetaBundle &bundle);
-  void AddBufferToScope(GstBuffer *buf, const int pipeline_id, const QString &format);
   void FadeoutFinished();
   void FadeoutPauseFinished();
   void SeekNow();
@@ -140,8 +137,6 @@ class GstEngine : public Engine::Base, public GstBufferConsumer {
   std::shared_ptr<GstEnginePipeline> CreatePipeline();
   std::shared_ptr<GstEnginePipeline> CreatePipeline(const QByteArray &gst_url, const QUrl &original_url, const qint64 end_nanosec);
 
-  void UpdateScope(int chunk_length);
-
   static void StreamDiscovered(GstDiscoverer*, GstDiscovererInfo *info, GError*, gpointer self);
   static void StreamDiscoveryFinished(GstDiscoverer*, gpointer);
   static QString GSTdiscovererErrorMessage(GstDiscovererResult result);
@@ -176,8 +171,6 @@ class GstEngine : public Engine::Base, public GstBufferConsumer {
 
   QList<GstBufferConsumer*> buffer_consumers_;
 
-  GstBuffer *latest_buffer_;
-
   bool stereo_balancer_enabled_;
   float stereo_balance_;
 
@@ -195,11 +188,6 @@ class GstEngine : public Engine::Base, public GstBufferConsumer {
   bool is_fading_out_to_pause_;
   bool has_faded_out_;
 
-  int scope_chunk_;
-  bool have_new_buffer_;
-  int scope_chunks_;
-  QString buffer_format_;
-
   int discovery_finished_cb_id_;
   int discovery_discovered_cb_id_;
 
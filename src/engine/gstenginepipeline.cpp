@@ -54,6 +54,7 @@
 #include "gstengine.h"
 #include "gstenginepipeline.h"
 #include "gstbufferconsumer.h"
+#include "sampleconverter.h"
 
 const int GstEnginePipeline::kGstStateTimeoutNanosecs = 10000000;
 const int GstEnginePipeline::kFaderFudgeMsec = 2000;
@@ -121,7 +122,9 @@ GstEnginePipeline::GstEnginePipeline(QObject *parent)
       notify_source_cb_id_(-1),
       about_to_finish_cb_id_(-1),
       notify_volume_cb_id_(-1),
-      logged_unsupported_analyzer_format_(false) {
+      logged_unsupported_analyzer_format_(false),
+      buffer16_pool_(nullptr),
+      buffer16_pool_size_(0) {
 
   eq_band_gains_.reserve(kEqBandCount);
   for (int i = 0; i < kEqBandCount; ++i) eq_band_gains_ << 0;
@@ -192,6 +195,12 @@ GstEnginePipeline::~GstEnginePipeline() {
 
   }
 
+  if (buffer16_pool_) {
+    gst_buffer_pool_set_active(buffer16_pool_, FALSE);
+    gst_object_unref(buffer16_pool_);
+    buffer16_pool_ = nullptr;
+  }
+
 }
 
 void GstEnginePipeline::set_output_device(const QString &output, const QVariant &device) {
@@ -982,102 +991,19 @@ GstPadProbeReturn GstEnginePipeline::BufferProbeCallback(GstPad *pad, GstPadProb
   quint64 duration = GST_BUFFER_DURATION(buf);
   qint64 end_time = static_cast<qint64>(start_time + duration);
 
-  if (format.startsWith("S16LE")) {
-    instance->logged_unsupported_analyzer_format_ = false;
-  }
-  else if (format.startsWith("S32LE")) {
-
+  if (channels > 0 && rate > 0) {
     GstMapInfo map_info;
     gst_buffer_map(buf, &map_info, GST_MAP_READ);
-
-    int32_t *s = reinterpret_cast<int32_t*>(map_info.data);
-    int samples = static_cast<int>((map_info.size / sizeof(int32_t)) / channels);
-    int buf16_size = samples * static_cast<int>(sizeof(int16_t)) * channels;
-    int16_t *d = static_cast<int16_t*>(g_malloc(buf16_size));
-    memset(d, 0, buf16_size);
-    for (int i = 0; i < (samples * channels); ++i) {
-      d[i] = static_cast<int16_t>((s[i] >> 16));
-    }
+    const bool supported = ConvertToMono(format, map_info, channels, &instance->scope_frames_);
     gst_buffer_unmap(buf, &map_info);
-    buf16 = gst_buffer_new_wrapped(d, buf16_size);
-    GST_BUFFER_DURATION(buf16) = GST_FRAMES_TO_CLOCK_TIME(samples * sizeof(int16_t) * channels, rate);
-    buf = buf16;
-
-    instance->logged_unsupported_analyzer_format_ = false;
-  }
-
-  else if (format.startsWith("F32LE")) {
-
-    GstMapInfo map_info;
-    gst_buffer_map(buf, &map_info, GST_MAP_READ);
-
-    float *s = reinterpret_cast<float*>(map_info.data);
-    int samples = static_cast<int>((map_info.size / sizeof(float)) / channels);
-    int buf16_size = samples * static_cast<int>(sizeof(int16_t)) * channels;
-    int16_t *d = static_cast<int16_t*>(g_malloc(buf16_size));
-    memset(d, 0, buf16_size);
-    for (int i = 0; i < (samples * channels); ++i) {
-      float sample_float = (s[i] * static_cast<float>(32768.0));
-      d[i] = static_cast<int16_t>(sample_float);
+    if (supported) {
+      instance->scope_buffer_.Write(instance->scope_frames_.data(), static_cast<int>(instance->scope_frames_.size()), rate);
+      instance->logged_unsupported_analyzer_format_ = false;
     }
-    gst_buffer_unmap(buf, &map_info);
-    buf16 = gst_buffer_new_wrapped(d, buf16_size);
-    GST_BUFFER_DURATION(buf16) = GST_FRAMES_TO_CLOCK_TIME(samples * sizeof(int16_t) * channels, rate);
-    buf = buf16;
-
-    instance->logged_unsupported_analyzer_format_ = false;
-  }
-  else if (format.startsWith("S24LE")) {
-
-    GstMapInfo map_info;
-    gst_buffer_map(buf, &map_info, GST_MAP_READ);
-
-    int8_t *s24 = reinterpret_cast<int8_t*>(map_info.data);
-    int8_t *s24e = s24 + map_info.size;
-    int samples = static_cast<int>((map_info.size / sizeof(int8_t)) / channels);
-    int buf16_size = samples * static_cast<int>(sizeof(int16_t)) * channels;
-    int16_t *s16 = static_cast<int16_t*>(g_malloc(buf16_size));
-    memset(s16, 0, buf16_size);
-    for (int i = 0; i < (samples * channels); ++i) {
-      s16[i] = *(reinterpret_cast<int16_t*>(s24 + 1));
-      s24 += 3;
-      if (s24 >= s24e) break;
+    else if (!instance->logged_unsupported_analyzer_format_) {
+      instance->logged_unsupported_analyzer_format_ = true;
+      qLog(Error) << "Unsupported audio format for the analyzer" << format;
     }
-    gst_buffer_unmap(buf, &map_info);
-    buf16 = gst_buffer_new_wrapped(s16, buf16_size);
-    GST_BUFFER_DURATION(buf16) = GST_FRAMES_TO_CLOCK_TIME(samples * sizeof(int16_t) * channels, rate);
-    buf = buf16;
-
-    instance->logged_unsupported_analyzer_format_ = false;
-  }
-  else if (format.startsWith("S24_32LE")) {
-
-    GstMapInfo map_info;
-    gst_buffer_map(buf, &map_info, GST_MAP_READ);
-
-    int32_t *s32 = reinterpret_cast<int32_t*>(map_info.data);
-    int32_t *s32e = s32 + map_info.size;
-    int32_t *s32p = s32;
-    int samples = static_cast<int>((map_info.size / sizeof(int32_t)) / channels);
-    int buf16_size = samples * static_cast<int>(sizeof(int16_t)) * channels;
-    int16_t *s16 = static_cast<int16_t*>(g_malloc(buf16_size));
-    memset(s16, 0, buf16_size);
-    for (int i = 0; i < (samples * channels); ++i) {
-      int8_t *s24 = reinterpret_cast<int8_t*>(s32p);
-      s16[i] = *(reinterpret_cast<int16_t*>(s24 + 1));
-      ++s32p;
-      if (s32p > s32e) break;
-    }
-    gst_buffer_unmap(buf, &map_info);
-    buf16 = gst_buffer_new_wrapped(s16, buf16_size);
-    GST_BUFFER_DURATION(buf16) = GST_FRAMES_TO_CLOCK_TIME(samples * sizeof(int16_t) * channels, rate);
-    buf = buf16;
-
-    instance->logged_unsupported_analyzer_format_ = false;
-  }
-  else if (!instance->logged_unsupported_analyzer_format_) {
-    instance->logged_unsupported_analyzer_format_ = true;
-    qLog(Error) << "Unsupported audio format for the analyzer" << format;
   }
 
   QList<GstBufferConsumer*> consumers;
@@ -1086,9 +1012,16 @@ GstPadProbeReturn GstEnginePipeline::BufferProbeCallback(GstPad *pad, GstPadProb
     consumers = instance->buffer_consumers_;
   }
 
-  for (GstBufferConsumer *consumer : consumers) {
-    gst_buffer_ref(buf);
-    consumer->ConsumeBuffer(buf, instance->id(), format);
+  // The buffer consumers expect 16 bit samples.
+  if (!consumers.isEmpty()) {
+    if (channels > 0 && rate > 0) {
+      buf16 = instance->ConvertToS16(buf, format, channels, rate);
+      if (buf16) buf = buf16;
+    }
+    for (GstBufferConsumer *consumer : consumers) {
+      gst_buffer_ref(buf);
+      consumer->ConsumeBuffer(buf, instance->id(), format);
+    }
   }
 
   if (buf16) {
@@ -1119,6 +1052,112 @@ GstPadProbeReturn GstEnginePipeline::BufferProbeCallback(GstPad *pad, GstPadProb
 
 }
 
+bool GstEnginePipeline::ConvertToMono(const QString &format, const GstMapInfo &map_info, const int channels, std::vector<float> *frames) {
+
+  int sample_size = 0;
+  if (format.startsWith("S16LE")) sample_size = sizeof(int16_t);
+  else if (format.startsWith("S24LE")) sample_size = 3;
+  else if (format.startsWith("S24_32LE") || format.startsWith("S32LE") || format.startsWith("F32LE")) sample_size = sizeof(int32_t);
+  else return false;
+
+  const int count = static_cast<int>(map_info.size / (sample_size * channels));
+  frames->resize(count);
+
+  if (format.startsWith("S16LE")) {
+    SampleConverter::S16ToMono(reinterpret_cast<const int16_t*>(map_info.data), frames->data(), count, channels);
+  }
+  else if (format.startsWith("S24LE")) {
+    SampleConverter::S24ToMono(map_info.data, frames->data(), count, channels);
+  }
+  else if (format.startsWith("S24_32LE")) {
+    SampleConverter::S24_32ToMono(reinterpret_cast<const int32_t*>(map_info.data), frames->data(), count, channels);
+  }
+  else if (format.startsWith("S32LE")) {
+    SampleConverter::S32ToMono(reinterpret_cast<const int32_t*>(map_info.data), frames->data(), count, channels);
+  }
+  else {
+    SampleConverter::F32ToMono(reinterpret_cast<const float*>(map_info.data), frames->data(), count, channels);
+  }
+
+  return true;
+
+}
+
+GstBuffer *GstEnginePipeline::ConvertToS16(GstBuffer *buf, const QString &format, const int channels, const int rate) {
+
+  int sample_size = 0;
+  if (format.startsWith("S24LE")) sample_size = 3;
+  else if (format.startsWith("S24_32LE") || format.startsWith("S32LE") || format.startsWith("F32LE")) sample_size = sizeof(int32_t);
+  else return nullptr;
+
+  GstMapInfo map_info;
+  gst_buffer_map(buf, &map_info, GST_MAP_READ);
+
+  const int samples = static_cast<int>(map_info.size / sample_size);
+  GstBuffer *buf16 = AcquireBuffer16(samples * sizeof(int16_t));
+  if (!buf16) {
+    gst_buffer_unmap(buf, &map_info);
+    return nullptr;
+  }
+
+  GstMapInfo map_info16;
+  gst_buffer_map(buf16, &map_info16, GST_MAP_WRITE);
+  int16_t *dest = reinterpret_cast<int16_t*>(map_info16.data);
+
+  if (format.startsWith("S24LE")) {
+    SampleConverter::S24ToS16(map_info.data, dest, samples);
+  }
+  else if (format.startsWith("S24_32LE")) {
+    SampleConverter::S24_32ToS16(reinterpret_cast<const int32_t*>(map_info.data), dest, samples);
+  }
+  else if (format.startsWith("S32LE")) {
+    SampleConverter::S32ToS16(reinterpret_cast<const int32_t*>(map_info.data), dest, samples);
+  }
+  else {
+    SampleConverter::F32ToS16(reinterpret_cast<const float*>(map_info.data), dest, samples);
+  }
+
+  gst_buffer_unmap(buf16, &map_info16);
+  gst_buffer_unmap(buf, &map_info);
+
+  GST_BUFFER_DURATION(buf16) = GST_FRAMES_TO_CLOCK_TIME(samples / channels, rate);
+
+  return buf16;
+
+}
+
+GstBuffer *GstEnginePipeline::AcquireBuffer16(const gsize size) {
+
+  // The buffers are returned to the pool when the consumers unref them, so playback doesn't allocate a new buffer for each one.
+  // The pool is recreated if a buffer doesn't fit, buffers still in use keep the old pool alive.
+  if (!buffer16_pool_ || size > buffer16_pool_size_) {
+    if (buffer16_pool_) {
+      gst_buffer_pool_set_active(buffer16_pool_, FALSE);
+      gst_object_unref(buffer16_pool_);
+    }
+    buffer16_pool_ = gst_buffer_pool_new();
+    buffer16_pool_size_ = size;
+    GstStructure *config = gst_buffer_pool_get_config(buffer16_pool_);
+    gst_buffer_pool_config_set_params(config, nullptr, static_cast<guint>(size), 0, 0);
+    if (!gst_buffer_pool_set_config(buffer16_pool_, config) || !gst_buffer_pool_set_active(buffer16_pool_, TRUE)) {
+      qLog(Error) << "Failed to activate the analyzer buffer pool";
+      gst_object_unref(buffer16_pool_);
+      buffer16_pool_ = nullptr;
+      buffer16_pool_size_ = 0;
+      return nullptr;
+    }
+  }
+
+  GstBuffer *buffer = nullptr;
+  if (gst_buffer_pool_acquire_buffer(buffer16_pool_, &buffer, nullptr) != GST_FLOW_OK) {
+    return nullptr;
+  }
+  gst_buffer_resize(buffer, 0, static_cast<gssize>(size));
+
+  return buffer;
+
+}
+
 void GstEnginePipeline::AboutToFinishCallback(GstPlayBin *playbin, gpointer self) {
 
   Q_UNUSED(playbin)
@@ -25,6 +25,7 @@
 #include "config.h"
 
 #include <memory>
+#include <vector>
 #include <glib.h>
 #include <glib-object.h>
 #include <glib/gtypes.h>
@@ -44,6 +45,8 @@
 #include <QString>
 #include <QUrl>
 
+#include "scoperingbuffer.h"
+
 class QTimerEvent;
 class GstBufferConsumer;
 
@@ -84,6 +87,9 @@ class GstEnginePipeline : public QObject {
   void RemoveBufferConsumer(GstBufferConsumer *consumer);
   void RemoveAllBufferConsumers();
 
+  // Mono frames for the analyzers, written by the streaming thread and read by the GUI thread.
+  ScopeRingBuffer *scope_buffer() { return &scope_buffer_; }
+
   // Control the music playback
   QFuture<GstStateChangeReturn> SetState(const GstState state);
   Q_INVOKABLE bool Seek(const qint64 nanosec);
@@ -148,6 +154,9 @@ class GstEnginePipeline : public QObject {
   // Static callbacks.  The GstEnginePipeline instance is passed in the last argument.
   static GstPadProbeReturn UpstreamEventsProbeCallback(GstPad *pad, GstPadProbeInfo *info, gpointer self);
   static GstPadProbeReturn BufferProbeCallback(GstPad *pad, GstPadProbeInfo *info, gpointer self);
+  static bool ConvertToMono(const QString &format, const GstMapInfo &map_info, const int channels, std::vector<float> *frames);
+  GstBuffer *ConvertToS16(GstBuffer *buf, const QString &format, const int channels, const int rate);
+  GstBuffer *AcquireBuffer16(const gsize size);
   static GstPadProbeReturn PlaybinProbeCallback(GstPad *pad, GstPadProbeInfo *info, gpointer self);
   static void ElementAddedCallback(GstBin *bin, GstBin*, GstElement *element, gpointer self);
   static void PadAddedCallback(GstElement *element, GstPad *pad, gpointer self);
@@ -233,6 +242,8 @@ class GstEnginePipeline : public QObject {
   // These get called when there is a new audio buffer available
   QList<GstBufferConsumer*> buffer_consumers_;
   QMutex buffer_consumers_mutex_;
+  ScopeRingBuffer scope_buffer_;
+  std::vector<float> scope_frames_;
   qint64 segment_start_;
   bool segment_start_received_;
 
@@ -310,6 +321,10 @@ class GstEnginePipeline : public QObject {
 
   bool logged_unsupported_analyzer_format_;
 
+  // Reused for the 16 bit buffers for the buffer consumers, only used by the streaming thread.
+  GstBufferPool *buffer16_pool_;
+  gsize buffer16_pool_size_;
+
 };
 
 #endif  // GSTENGINEPIPELINE_H
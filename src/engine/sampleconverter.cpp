@@ -0,0 +1,341 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2021, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <cstdint>
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define SAMPLECONVERTER_SSE2
+#  include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#  define SAMPLECONVERTER_NEON
+#  include <arm_neon.h>
+#endif
+
+#include "sampleconverter.h"
+
+namespace SampleConverter {
+
+namespace {
+
+constexpr float kS16Scale = 1.0F / 32768.0F;
+constexpr float kS24Scale = 1.0F / 8388608.0F;
+constexpr float kS32Scale = 1.0F / 2147483648.0F;
+
+inline int32_t ReadS24(const uint8_t *src) {
+  const uint32_t sample = static_cast<uint32_t>(src[0]) | (static_cast<uint32_t>(src[1]) << 8U) | (static_cast<uint32_t>(src[2]) << 16U);
+  return static_cast<int32_t>(sample << 8U) >> 8;
+}
+
+inline int32_t ReadS24_32(const int32_t sample) {
+  return static_cast<int32_t>(static_cast<uint32_t>(sample) << 8U) >> 8;
+}
+
+// Averages the channels of each frame, convert returns a single sample in the range -1.0..1.0.
+template <typename T, typename Converter>
+void MixToMono(const T *src, float *dest, const int count, const int channels, Converter convert) {
+
+  const float scale = 1.0F / static_cast<float>(channels);
+  for (int i = 0; i < count; ++i) {
+    float frame = 0.0F;
+    for (int c = 0; c < channels; ++c) {
+      frame += convert(src);
+      ++src;
+    }
+    dest[i] = frame * scale;
+  }
+
+}
+
+}  // namespace
+
+namespace Scalar {
+
+void S32ToS16(const int32_t *src, int16_t *dest, const int count) {
+  for (int i = 0; i < count; ++i) {
+    dest[i] = static_cast<int16_t>(src[i] >> 16);
+  }
+}
+
+void F32ToS16(const float *src, int16_t *dest, const int count) {
+  for (int i = 0; i < count; ++i) {
+    dest[i] = static_cast<int16_t>(std::min(std::max(src[i] * 32768.0F, -32768.0F), 32767.0F));
+  }
+}
+
+void S24ToS16(const uint8_t *src, int16_t *dest, const int count) {
+  for (int i = 0; i < count; ++i) {
+    dest[i] = static_cast<int16_t>(static_cast<uint16_t>(src[1]) | (static_cast<uint16_t>(src[2]) << 8U));
+    src += 3;
+  }
+}
+
+void S24_32ToS16(const int32_t *src, int16_t *dest, const int count) {
+  for (int i = 0; i < count; ++i) {
+    dest[i] = static_cast<int16_t>(ReadS24_32(src[i]) >> 8);
+  }
+}
+
+void S16ToMono(const int16_t *src, float *dest, const int count, const int channels) {
+  MixToMono(src, dest, count, channels, [](const int16_t *sample) { return static_cast<float>(*sample) * kS16Scale; });
+}
+
+void S32ToMono(const int32_t *src, float *dest, const int count, const int channels) {
+  MixToMono(src, dest, count, channels, [](const int32_t *sample) { return static_cast<float>(*sample) * kS32Scale; });
+}
+
+void F32ToMono(const float *src, float *dest, const int count, const int channels) {
+  MixToMono(src, dest, count, channels, [](const float *sample) { return *sample; });
+}
+
+void S24ToMono(const uint8_t *src, float *dest, const int count, const int channels) {
+
+  const float scale = 1.0F / static_cast<float>(channels);
+  for (int i = 0; i < count; ++i) {
+    float frame = 0.0F;
+    for (int c = 0; c < channels; ++c) {
+      frame += static_cast<float>(ReadS24(src)) * kS24Scale;
+      src += 3;
+    }
+    dest[i] = frame * scale;
+  }
+
+}
+
+void S24_32ToMono(const int32_t *src, float *dest, const int count, const int channels) {
+  MixToMono(src, dest, count, channels, [](const int32_t *sample) { return static_cast<float>(ReadS24_32(*sample)) * kS24Scale; });
+}
+
+}  // namespace Scalar
+
+const char *Implementation() {
+
+#if defined(SAMPLECONVERTER_SSE2)
+  return "SSE2";
+#elif defined(SAMPLECONVERTER_NEON)
+  return "NEON";
+#else
+  return "Scalar";
+#endif
+
+}
+
+// The vectorised loops handle 8 samples or 4 stereo frames at a time, the scalar versions do the rest.
+
+void S32ToS16(const int32_t *src, int16_t *dest, const int count) {
+
+  int i = 0;
+#if defined(SAMPLECONVERTER_SSE2)
+  for (; i + 8 <= count; i += 8) {
+    const __m128i a = _mm_srai_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)), 16);
+    const __m128i b = _mm_srai_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 4)), 16);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), _mm_packs_epi32(a, b));
+  }
+#elif defined(SAMPLECONVERTER_NEON)
+  for (; i + 8 <= count; i += 8) {
+    vst1q_s16(dest + i, vcombine_s16(vshrn_n_s32(vld1q_s32(src + i), 16), vshrn_n_s32(vld1q_s32(src + i + 4), 16)));
+  }
+#endif
+  Scalar::S32ToS16(src + i, dest + i, count - i);
+
+}
+
+void F32ToS16(const float *src, int16_t *dest, const int count) {
+
+  int i = 0;
+#if defined(SAMPLECONVERTER_SSE2)
+  const __m128 scale = _mm_set1_ps(32768.0F);
+  const __m128 min = _mm_set1_ps(-32768.0F);
+  const __m128 max = _mm_set1_ps(32767.0F);
+  for (; i + 8 <= count; i += 8) {
+    const __m128i a = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(src + i), scale), min), max));
+    const __m128i b = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(src + i + 4), scale), min), max));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), _mm_packs_epi32(a, b));
+  }
+#elif defined(SAMPLECONVERTER_NEON)
+  const float32x4_t min = vdupq_n_f32(-32768.0F);
+  const float32x4_t max = vdupq_n_f32(32767.0F);
+  for (; i + 8 <= count; i += 8) {
+    const int32x4_t a = vcvtq_s32_f32(vminq_f32(vmaxq_f32(vmulq_n_f32(vld1q_f32(src + i), 32768.0F), min), max));
+    const int32x4_t b = vcvtq_s32_f32(vminq_f32(vmaxq_f32(vmulq_n_f32(vld1q_f32(src + i + 4), 32768.0F), min), max));
+    vst1q_s16(dest + i, vcombine_s16(vmovn_s32(a), vmovn_s32(b)));
+  }
+#endif
+  Scalar::F32ToS16(src + i, dest + i, count - i);
+
+}
+
+void S24ToS16(const uint8_t *src, int16_t *dest, const int count) {
+
+  int i = 0;
+#if defined(SAMPLECONVERTER_NEON)
+  // Deinterleave the 3 bytes of 16 samples, and interleave the upper 2 bytes again.
+  for (; i + 16 <= count; i += 16) {
+    const uint8x16x3_t bytes = vld3q_u8(src + i * 3);
+    const uint8x16x2_t samples = vzipq_u8(bytes.val[1], bytes.val[2]);
+    vst1q_u8(reinterpret_cast<uint8_t*>(dest + i), samples.val[0]);
+    vst1q_u8(reinterpret_cast<uint8_t*>(dest + i + 8), samples.val[1]);
+  }
+#endif
+  // SSE2 has no byte shuffle, so packed 24 bit is always converted by the scalar version on x86.
+  Scalar::S24ToS16(src + i * 3, dest + i, count - i);
+
+}
+
+void S24_32ToS16(const int32_t *src, int16_t *dest, const int count) {
+
+  int i = 0;
+#if defined(SAMPLECONVERTER_SSE2)
+  for (; i + 8 <= count; i += 8) {
+    const __m128i a = _mm_srai_epi32(_mm_slli_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)), 8), 16);
+    const __m128i b = _mm_srai_epi32(_mm_slli_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 4)), 8), 16);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), _mm_packs_epi32(a, b));
+  }
+#elif defined(SAMPLECONVERTER_NEON)
+  for (; i + 8 <= count; i += 8) {
+    const int16x4_t a = vshrn_n_s32(vshlq_n_s32(vld1q_s32(src + i), 8), 16);
+    const int16x4_t b = vshrn_n_s32(vshlq_n_s32(vld1q_s32(src + i + 4), 8), 16);
+    vst1q_s16(dest + i, vcombine_s16(a, b));
+  }
+#endif
+  Scalar::S24_32ToS16(src + i, dest + i, count - i);
+
+}
+
+void S16ToMono(const int16_t *src, float *dest, const int count, const int channels) {
+
+  int i = 0;
+  if (channels == 2) {
+#if defined(SAMPLECONVERTER_SSE2)
+    const __m128i ones = _mm_set1_epi16(1);
+    const __m128 scale = _mm_set1_ps(kS16Scale * 0.5F);
+    for (; i + 4 <= count; i += 4) {
+      // Multiply by one and add the pairs, that's left + right as 32 bit.
+      const __m128i sums = _mm_madd_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 2)), ones);
+      _mm_storeu_ps(dest + i, _mm_mul_ps(_mm_cvtepi32_ps(sums), scale));
+    }
+#elif defined(SAMPLECONVERTER_NEON)
+    for (; i + 8 <= count; i += 8) {
+      const int16x8x2_t frames = vld2q_s16(src + i * 2);
+      const int32x4_t low = vaddl_s16(vget_low_s16(frames.val[0]), vget_low_s16(frames.val[1]));
+      const int32x4_t high = vaddl_s16(vget_high_s16(frames.val[0]), vget_high_s16(frames.val[1]));
+      vst1q_f32(dest + i, vmulq_n_f32(vcvtq_f32_s32(low), kS16Scale * 0.5F));
+      vst1q_f32(dest + i + 4, vmulq_n_f32(vcvtq_f32_s32(high), kS16Scale * 0.5F));
+    }
+#endif
+  }
+  Scalar::S16ToMono(src + i * channels, dest + i, count - i, channels);
+
+}
+
+#if defined(SAMPLECONVERTER_SSE2)
+namespace {
+
+// Averages the 4 stereo frames in a and b, which are scaled to -1.0..1.0 first.
+inline __m128 StereoToMono(const __m128 a, const __m128 b, const __m128 scale) {
+
+  const __m128 sa = _mm_mul_ps(a, scale);
+  const __m128 sb = _mm_mul_ps(b, scale);
+  const __m128 left = _mm_shuffle_ps(sa, sb, _MM_SHUFFLE(2, 0, 2, 0));
+  const __m128 right = _mm_shuffle_ps(sa, sb, _MM_SHUFFLE(3, 1, 3, 1));
+  return _mm_mul_ps(_mm_add_ps(left, right), _mm_set1_ps(0.5F));
+
+}
+
+}  // namespace
+#endif
+
+void S32ToMono(const int32_t *src, float *dest, const int count, const int channels) {
+
+  int i = 0;
+  if (channels == 2) {
+#if defined(SAMPLECONVERTER_SSE2)
+    const __m128 scale = _mm_set1_ps(kS32Scale);
+    for (; i + 4 <= count; i += 4) {
+      const __m128 a = _mm_cvtepi32_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 2)));
+      const __m128 b = _mm_cvtepi32_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 2 + 4)));
+      _mm_storeu_ps(dest + i, StereoToMono(a, b, scale));
+    }
+#elif defined(SAMPLECONVERTER_NEON)
+    for (; i + 4 <= count; i += 4) {
+      const int32x4x2_t frames = vld2q_s32(src + i * 2);
+      const float32x4_t left = vmulq_n_f32(vcvtq_f32_s32(frames.val[0]), kS32Scale);
+      const float32x4_t right = vmulq_n_f32(vcvtq_f32_s32(frames.val[1]), kS32Scale);
+      vst1q_f32(dest + i, vmulq_n_f32(vaddq_f32(left, right), 0.5F));
+    }
+#endif
+  }
+  Scalar::S32ToMono(src + i * channels, dest + i, count - i, channels);
+
+}
+
+void F32ToMono(const float *src, float *dest, const int count, const int channels) {
+
+  int i = 0;
+  if (channels == 2) {
+#if defined(SAMPLECONVERTER_SSE2)
+    const __m128 scale = _mm_set1_ps(1.0F);
+    for (; i + 4 <= count; i += 4) {
+      _mm_storeu_ps(dest + i, StereoToMono(_mm_loadu_ps(src + i * 2), _mm_loadu_ps(src + i * 2 + 4), scale));
+    }
+#elif defined(SAMPLECONVERTER_NEON)
+    for (; i + 4 <= count; i += 4) {
+      const float32x4x2_t frames = vld2q_f32(src + i * 2);
+      vst1q_f32(dest + i, vmulq_n_f32(vaddq_f32(frames.val[0], frames.val[1]), 0.5F));
+    }
+#endif
+  }
+  Scalar::F32ToMono(src + i * channels, dest + i, count - i, channels);
+
+}
+
+void S24ToMono(const uint8_t *src, float *dest, const int count, const int channels) {
+
+  // Packed 24 bit doesn't line up with the vector registers, the scalar version is used on all architectures.
+  Scalar::S24ToMono(src, dest, count, channels);
+
+}
+
+void S24_32ToMono(const int32_t *src, float *dest, const int count, const int channels) {
+
+  int i = 0;
+  if (channels == 2) {
+#if defined(SAMPLECONVERTER_SSE2)
+    const __m128 scale = _mm_set1_ps(kS24Scale);
+    for (; i + 4 <= count; i += 4) {
+      const __m128i a = _mm_srai_epi32(_mm_slli_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 2)), 8), 8);
+      const __m128i b = _mm_srai_epi32(_mm_slli_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 2 + 4)), 8), 8);
+      _mm_storeu_ps(dest + i, StereoToMono(_mm_cvtepi32_ps(a), _mm_cvtepi32_ps(b), scale));
+    }
+#elif defined(SAMPLECONVERTER_NEON)
+    for (; i + 4 <= count; i += 4) {
+      const int32x4x2_t frames = vld2q_s32(src + i * 2);
+      const float32x4_t left = vmulq_n_f32(vcvtq_f32_s32(vshrq_n_s32(vshlq_n_s32(frames.val[0], 8), 8)), kS24Scale);
+      const float32x4_t right = vmulq_n_f32(vcvtq_f32_s32(vshrq_n_s32(vshlq_n_s32(frames.val[1], 8), 8)), kS24Scale);
+      vst1q_f32(dest + i, vmulq_n_f32(vaddq_f32(left, right), 0.5F));
+    }
+#endif
+  }
+  Scalar::S24_32ToMono(src + i * channels, dest + i, count - i, channels);
+
+}
+
+}  // namespace SampleConverter
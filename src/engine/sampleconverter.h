@@ -0,0 +1,66 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2021, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef SAMPLECONVERTER_H
+#define SAMPLECONVERTER_H
+
+#include "config.h"
+
+#include <cstdint>
+
+// Sample format conversion for the analyzer and the buffer consumers.
+// Uses SSE2 or NEON when the compiler targets them, otherwise the scalar versions.
+// All formats are little endian, S24 is packed in 3 bytes, S24_32 is 24 bits in the lower 3 bytes of 32.
+namespace SampleConverter {
+
+// Returns "SSE2", "NEON" or "Scalar".
+const char *Implementation();
+
+// Interleaved samples to interleaved 16 bit samples, count is the number of samples.
+void S32ToS16(const int32_t *src, int16_t *dest, const int count);
+void F32ToS16(const float *src, int16_t *dest, const int count);
+void S24ToS16(const uint8_t *src, int16_t *dest, const int count);
+void S24_32ToS16(const int32_t *src, int16_t *dest, const int count);
+
+// Interleaved samples to mono frames in the range -1.0..1.0, count is the number of frames.
+void S16ToMono(const int16_t *src, float *dest, const int count, const int channels);
+void S32ToMono(const int32_t *src, float *dest, const int count, const int channels);
+void F32ToMono(const float *src, float *dest, const int count, const int channels);
+void S24ToMono(const uint8_t *src, float *dest, const int count, const int channels);
+void S24_32ToMono(const int32_t *src, float *dest, const int count, const int channels);
+
+// Plain C++ versions, used for the remainders and to test the vectorised versions against.
+namespace Scalar {
+
+void S32ToS16(const int32_t *src, int16_t *dest, const int count);
+void F32ToS16(const float *src, int16_t *dest, const int count);
+void S24ToS16(const uint8_t *src, int16_t *dest, const int count);
+void S24_32ToS16(const int32_t *src, int16_t *dest, const int count);
+
+void S16ToMono(const int16_t *src, float *dest, const int count, const int channels);
+void S32ToMono(const int32_t *src, float *dest, const int count, const int channels);
+void F32ToMono(const float *src, float *dest, const int count, const int channels);
+void S24ToMono(const uint8_t *src, float *dest, const int count, const int channels);
+void S24_32ToMono(const int32_t *src, float *dest, const int count, const int channels);
+
+}  // namespace Scalar
+
+}  // namespace SampleConverter
+
+#endif  // SAMPLECONVERTER_H
@@ -0,0 +1,113 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2021, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "scoperingbuffer.h"
+
+const int ScopeRingBuffer::kDefaultCapacity = 65536;
+
+namespace {
+
+uint64_t NextPowerOfTwo(const uint64_t value) {
+
+  uint64_t ret = 1;
+  while (ret < value) ret <<= 1;
+  return ret;
+
+}
+
+}  // namespace
+
+ScopeRingBuffer::ScopeRingBuffer(const int capacity)
+    : frames_(NextPowerOfTwo(capacity > 0 ? static_cast<uint64_t>(capacity) : 1)),
+      mask_(frames_.size() - 1),
+      write_pos_(0),
+      rate_(0),
+      read_pos_(0) {
+
+  for (std::atomic<float> &frame : frames_) {
+    frame.store(0.0F, std::memory_order_relaxed);
+  }
+
+}
+
+void ScopeRingBuffer::Write(const float *frames, const int count, const int rate) {
+
+  if (count <= 0) return;
+
+  const uint64_t capacity = frames_.size();
+  uint64_t pos = write_pos_.load(std::memory_order_relaxed);
+
+  // Only the newest frames fit.
+  uint64_t skip = 0;
+  if (static_cast<uint64_t>(count) > capacity) {
+    skip = count - capacity;
+    pos += skip;
+  }
+
+  for (uint64_t i = skip; i < static_cast<uint64_t>(count); ++i) {
+    frames_[pos & mask_].store(frames[i], std::memory_order_relaxed);
+    ++pos;
+  }
+
+  rate_.store(rate, std::memory_order_relaxed);
+  write_pos_.store(pos, std::memory_order_release);
+
+}
+
+bool ScopeRingBuffer::Read(std::vector<float> *scope, const int elapsed_msec) {
+
+  const uint64_t write_pos = write_pos_.load(std::memory_order_acquire);
+  if (write_pos == 0) return false;
+
+  const uint64_t capacity = frames_.size();
+  const uint64_t count = scope->size();
+  if (count == 0 || count > capacity / 2) return false;
+
+  if (read_pos_ == 0) {
+    read_pos_ = write_pos;
+  }
+  else if (elapsed_msec > 0) {
+    read_pos_ += static_cast<uint64_t>(elapsed_msec) * static_cast<uint64_t>(rate_.load(std::memory_order_relaxed)) / 1000;
+  }
+
+  // If the next buffer didn't arrive in time, keep showing the newest frames instead of silence.
+  if (read_pos_ > write_pos) read_pos_ = write_pos;
+
+  // If we fell behind, skip ahead, leaving the writer room to keep writing while we copy.
+  const uint64_t max_lag = capacity - count - capacity / 4;
+  if (write_pos - read_pos_ > max_lag) read_pos_ = write_pos - max_lag;
+
+  const uint64_t start = read_pos_ >= count ? read_pos_ - count : 0;
+  const uint64_t silence = count - (read_pos_ - start);
+  for (uint64_t i = 0; i < silence; ++i) {
+    (*scope)[i] = 0.0F;
+  }
+  for (uint64_t i = silence, pos = start; i < count; ++i, ++pos) {
+    (*scope)[i] = frames_[pos & mask_].load(std::memory_order_relaxed);
+  }
+
+  return true;
+
+}
@@ -0,0 +1,61 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2021, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef SCOPERINGBUFFER_H
+#define SCOPERINGBUFFER_H
+
+#include "config.h"
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+// Single producer, single consumer ring of mono float frames in the range -1.0..1.0 for the analyzers.
+// Write() is only called from the GStreamer streaming thread, and Read() only from the GUI thread.
+// The writer never waits for the reader, if the reader falls too far behind it skips ahead to the newest frames.
+class ScopeRingBuffer {
+
+ public:
+  explicit ScopeRingBuffer(const int capacity = kDefaultCapacity);
+
+  static const int kDefaultCapacity;
+
+  int capacity() const { return static_cast<int>(frames_.size()); }
+
+  void Write(const float *frames, const int count, const int rate);
+
+  // Advances the read position by the frames played during elapsed_msec,
+  // and fills scope with the frames just before it.
+  // Returns false if nothing has been written yet.
+  bool Read(std::vector<float> *scope, const int elapsed_msec);
+
+ private:
+  std::vector<std::atomic<float>> frames_;
+  uint64_t mask_;
+
+  // Written by the producer.
+  std::atomic<uint64_t> write_pos_;
+  std::atomic<int> rate_;
+
+  // Only used by the consumer.
+  uint64_t read_pos_;
+
+};
+
+#endif  // SCOPERINGBUFFER_H
@@ -0,0 +1,169 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2021, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <functional>
+
+#include <QtGlobal>
+#include <QtConcurrent>
+#include <QCoreApplication>
+#include <QObject>
+#include <QThread>
+#include <QFuture>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QMap>
+#include <QString>
+#include <QStringList>
+#include <QDateTime>
+#include <QSettings>
+#include <QJsonObject>
+#include <QJsonValue>
+
+#include "core/logging.h"
+#include "core/song.h"
+#include "core/database.h"
+#include "collection/collectionbackend.h"
+#include "internetcollectionsync.h"
+
+const char *InternetCollectionSync::kSettingsGroup = "InternetCollectionSync";
+const int InternetCollectionSync::kFullSyncIntervalDays = 7;
+
+InternetCollectionSync::InternetCollectionSync(CollectionBackend *backend) : backend_(backend), load_id_(0) {}
+
+QString InternetCollectionSync::AlbumSignature(const QJsonObject &json_obj, const QStringList &keys) {
+
+  QStringList values;
+  bool found = false;
+  for (const QString &key : keys) {
+    if (json_obj.contains(key)) {
+      values << json_obj[key].toVariant().toString();
+      found = true;
+    }
+    else {
+      values << QString();
+    }
+  }
+
+  return found ? values.join('|') : QString();
+
+}
+
+void InternetCollectionSync::Load(QObject *context, const std::function<void()> &ready) {
+
+  previous_albums_.clear();
+  previous_songs_.clear();
+  synced_albums_.clear();
+
+  const quint64 load_id = ++load_id_;
+
+  if (!backend_) {
+    ready();
+    return;
+  }
+
+  // Changes to the songs of an album which don't show in the album list are only picked up by a full sync.
+  QSettings s;
+  s.beginGroup(kSettingsGroup);
+  const qint64 last_full_sync = s.value(backend_->songs_table(), 0).toLongLong();
+  s.endGroup();
+  if (QDateTime::fromSecsSinceEpoch(last_full_sync).daysTo(QDateTime::currentDateTime()) >= kFullSyncIntervalDays) {
+    ready();
+    return;
+  }
+
+  // All songs of the collection are read, so this is kept off the thread of the caller.
+  QFuture<PreviousSync> future = QtConcurrent::run(&InternetCollectionSync::LoadPreviousSync, backend_);
+  QFutureWatcher<PreviousSync> *watcher = new QFutureWatcher<PreviousSync>(context);
+  QObject::connect(watcher, &QFutureWatcher<PreviousSync>::finished, context, [this, watcher, load_id, ready]() {
+    const PreviousSync previous_sync = watcher->result();
+    watcher->deleteLater();
+    if (load_id != load_id_) return;
+    if (!previous_sync.albums.isEmpty()) {
+      SetPreviousSync(previous_sync.albums, previous_sync.songs);
+      qLog(Debug) << "Incremental sync of" << backend_->songs_table() << "with" << previous_albums_.count() << "known albums";
+    }
+    ready();
+  });
+  watcher->setFuture(future);
+
+}
+
+InternetCollectionSync::PreviousSync InternetCollectionSync::LoadPreviousSync(CollectionBackend *backend) {
+
+  PreviousSync previous_sync;
+  previous_sync.albums = backend->GetSyncedAlbums();
+  if (!previous_sync.albums.isEmpty()) {
+    previous_sync.songs = backend->GetAllSongs();
+  }
+
+  if (QThread::currentThread() != backend->thread() && QThread::currentThread() != qApp->thread()) {
+    backend->db()->Close();
+  }
+
+  return previous_sync;
+
+}
+
+void InternetCollectionSync::SetPreviousSync(const QMap<QString, QString> &albums, const SongList &songs) {
+
+  previous_albums_ = albums;
+  previous_songs_.clear();
+  for (const Song &song : songs) {
+    if (!song.album_id().isEmpty() && previous_albums_.contains(song.album_id())) {
+      previous_songs_[song.album_id()] << song;
+    }
+  }
+
+}
+
+SongList InternetCollectionSync::UnchangedAlbumSongs(const QString &album_id, const QString &signature) const {
+
+  if (album_id.isEmpty() || signature.isEmpty()) return SongList();
+
+  QMap<QString, QString>::const_iterator it = previous_albums_.constFind(album_id);
+  if (it == previous_albums_.constEnd() || it.value() != signature) return SongList();
+
+  return previous_songs_.value(album_id);
+
+}
+
+void InternetCollectionSync::AlbumSynced(const QString &album_id, const QString &signature) {
+
+  if (album_id.isEmpty() || signature.isEmpty()) return;
+
+  synced_albums_.insert(album_id, signature);
+
+}
+
+void InternetCollectionSync::Save() {
+
+  if (!backend_) return;
+
+  backend_->SetSyncedAlbumsAsync(synced_albums_);
+
+  if (full_sync()) {
+    QSettings s;
+    s.beginGroup(kSettingsGroup);
+    s.setValue(backend_->songs_table(), QDateTime::currentDateTime().toSecsSinceEpoch());
+    s.endGroup();
+  }
+
+}
@@ -0,0 +1,84 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2021, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef INTERNETCOLLECTIONSYNC_H
+#define INTERNETCOLLECTIONSYNC_H
+
+#include "config.h"
+
+#include <functional>
+
+#include <QtGlobal>
+#include <QHash>
+#include <QMap>
+#include <QString>
+#include <QStringList>
+#include <QJsonObject>
+
+#include "core/song.h"
+
+class QObject;
+class CollectionBackend;
+
+// Remembers which albums the last sync of an internet service collection received.
+// The album lists are cheap to download, so a sync still gets them all, but only requests the songs of albums which are new or changed.
+// The songs of the other albums are taken from the collection, so the backend only sees the differences.
+class InternetCollectionSync {
+ public:
+  explicit InternetCollectionSync(CollectionBackend *backend = nullptr);
+
+  static const char *kSettingsGroup;
+  static const int kFullSyncIntervalDays;
+
+  // Returns the values of the keys in the album object, or an empty string if none of them are there.
+  static QString AlbumSignature(const QJsonObject &json_obj, const QStringList &keys);
+
+  // Loads the albums of the previous sync in the thread pool, unless it's time for a full sync, and calls ready when they are in.
+  // Ready is not called if the context is deleted first, or if Load() is called again in the meantime.
+  void Load(QObject *context, const std::function<void()> &ready);
+  void SetPreviousSync(const QMap<QString, QString> &albums, const SongList &songs);
+
+  bool full_sync() const { return previous_albums_.isEmpty(); }
+
+  // Returns the songs from the previous sync if the album didn't change since, otherwise an empty list.
+  SongList UnchangedAlbumSongs(const QString &album_id, const QString &signature) const;
+
+  // Remembers an album for the next sync, call it when the songs for the album were received.
+  void AlbumSynced(const QString &album_id, const QString &signature);
+  const QMap<QString, QString> &synced_albums() const { return synced_albums_; }
+
+  void Save();
+
+ private:
+  struct PreviousSync {
+    QMap<QString, QString> albums;
+    SongList songs;
+  };
+
+  static PreviousSync LoadPreviousSync(CollectionBackend *backend);
+
+ private:
+  CollectionBackend *backend_;
+  quint64 load_id_;
+  QMap<QString, QString> previous_albums_;
+  QHash<QString, SongList> previous_songs_;
+  QMap<QString, QString> synced_albums_;
+};
+
+#endif  // INTERNETCOLLECTIONSYNC_H
@@ -92,9 +92,10 @@ void AuddLyricsProvider::HandleSearchReply(QNetworkReply *reply, const int id, c
   QObject::disconnect(reply, nullptr, this, nullptr);
   reply->deleteLater();
 
-  QJsonArray json_result = ExtractResult(reply, artist, title);
+  bool success = false;
+  QJsonArray json_result = ExtractResult(reply, artist, title, &success);
   if (json_result.isEmpty()) {
-    emit SearchFinished(id, LyricsSearchResults());
+    emit SearchFinished(id, LyricsSearchResults(), success);
     return;
   }
 
@@ -137,7 +138,7 @@ void AuddLyricsProvider::HandleSearchReply(QNetworkReply *reply, const int id, c
 
 }
 
-QJsonArray AuddLyricsProvider::ExtractResult(QNetworkReply *reply, const QString &artist, const QString &title) {
+QJsonArray AuddLyricsProvider::ExtractResult(QNetworkReply *reply, const QString &artist, const QString &title, bool *success) {
 
   QJsonObject json_obj = ExtractJsonObj(reply);
   if (json_obj.isEmpty()) return QJsonArray();
@@ -167,6 +168,8 @@ QJsonArray AuddLyricsProvider::ExtractResult(QNetworkReply *reply, const QString
     return QJsonArray();
   }
 
+  *success = true;
+
   QJsonArray json_result = json_obj["result"].toArray();
   if (json_result.isEmpty()) {
     Error(QString("No lyrics for %1 %2").arg(artist, title));
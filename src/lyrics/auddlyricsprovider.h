@@ -47,7 +47,8 @@ class AuddLyricsProvider : public JsonLyricsProvider {
 
  private:
   void Error(const QString &error, const QVariant &debug = QVariant()) override;
-  QJsonArray ExtractResult(QNetworkReply *reply, const QString &artist, const QString &title);
+  // Success is set when the server replied with a result, which can be empty.
+  QJsonArray ExtractResult(QNetworkReply *reply, const QString &artist, const QString &title, bool *success);
 
  private slots:
   void HandleSearchReply(QNetworkReply *reply, const int id, const QString &artist, const QString &title);
@@ -86,13 +86,13 @@ void ChartLyricsProvider::HandleSearchReply(QNetworkReply *reply, const int id,
 
   if (reply->error() != QNetworkReply::NoError) {
     Error(QString("%1 (%2)").arg(reply->errorString()).arg(reply->error()));
-    emit SearchFinished(id, LyricsSearchResults());
+    emit SearchFinished(id, LyricsSearchResults(), reply->error() == QNetworkReply::ContentNotFoundError);
     return;
   }
 
   if (reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() != 200) {
     Error(QString("Received HTTP code %1").arg(reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt()));
-    emit SearchFinished(id, LyricsSearchResults());
+    emit SearchFinished(id, LyricsSearchResults(), false);
     return;
   }
 
@@ -131,7 +131,7 @@ void ChartLyricsProvider::HandleSearchReply(QNetworkReply *reply, const int id,
   if (results.isEmpty()) qLog(Debug) << "ChartLyrics: No lyrics for" << artist << title;
   else qLog(Debug) << "ChartLyrics: Got lyrics for" << artist << title;
 
-  emit SearchFinished(id, results);
+  emit SearchFinished(id, results, !reader.hasError());
 
 }
 
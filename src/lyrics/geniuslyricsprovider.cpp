@@ -343,23 +343,27 @@ void GeniusLyricsProvider::HandleSearchReply(QNetworkReply *reply, const int id)
 
   QJsonObject json_obj = ExtractJsonObj(reply);
   if (json_obj.isEmpty()) {
+    search->failed = true;
     EndSearch(search);
     return;
   }
 
   if (!json_obj.contains("meta")) {
     Error("Json reply is missing meta object.", json_obj);
+    search->failed = true;
     EndSearch(search);
     return;
   }
   if (!json_obj["meta"].isObject()) {
     Error("Json reply meta is not an object.", json_obj);
+    search->failed = true;
     EndSearch(search);
     return;
   }
   QJsonObject obj_meta = json_obj["meta"].toObject();
   if (!obj_meta.contains("status")) {
     Error("Json reply meta object is missing status.", obj_meta);
+    search->failed = true;
     EndSearch(search);
     return;
   }
@@ -371,28 +375,33 @@ void GeniusLyricsProvider::HandleSearchReply(QNetworkReply *reply, const int id)
     else {
       Error(QString("Received error %1.").arg(status));
     }
+    search->failed = true;
     EndSearch(search);
     return;
   }
 
   if (!json_obj.contains("response")) {
     Error("Json reply is missing response.", json_obj);
+    search->failed = true;
     EndSearch(search);
     return;
   }
   if (!json_obj["response"].isObject()) {
     Error("Json response is not an object.", json_obj);
+    search->failed = true;
     EndSearch(search);
     return;
   }
   QJsonObject obj_response = json_obj["response"].toObject();
   if (!obj_response.contains("hits")) {
     Error("Json response is missing hits.", obj_response);
+    search->failed = true;
     EndSearch(search);
     return;
   }
   if (!obj_response["hits"].isArray()) {
     Error("Json hits is not an array.", obj_response);
+    search->failed = true;
     EndSearch(search);
     return;
   }
@@ -464,11 +473,13 @@ void GeniusLyricsProvider::HandleLyricReply(QNetworkReply *reply, const int sear
 
   if (reply->error() != QNetworkReply::NoError) {
     Error(QString("%1 (%2)").arg(reply->errorString()).arg(reply->error()));
+    search->failed = true;
     EndSearch(search, lyric);
     return;
   }
   else if (reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() != 200) {
     Error(QString("Received HTTP code %1").arg(reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt()));
+    search->failed = true;
     EndSearch(search, lyric);
     return;
   }
@@ -476,6 +487,7 @@ void GeniusLyricsProvider::HandleLyricReply(QNetworkReply *reply, const int sear
   QByteArray data = reply->readAll();
   if (data.isEmpty()) {
     Error("Empty reply received from server.");
+    search->failed = true;
     EndSearch(search, lyric);
     return;
   }
@@ -532,7 +544,7 @@ void GeniusLyricsProvider::EndSearch(std::shared_ptr<GeniusLyricsSearchContext>
     else {
       qLog(Debug) << "GeniusLyrics: Got lyrics for" << search->artist << search->title;
     }
-    emit SearchFinished(search->id, search->results);
+    emit SearchFinished(search->id, search->results, !search->failed);
   }
 
 }
@@ -64,12 +64,13 @@ class GeniusLyricsProvider : public JsonLyricsProvider {
     QUrl url;
   };
   struct GeniusLyricsSearchContext {
-    explicit GeniusLyricsSearchContext() : id(-1) {}
+    explicit GeniusLyricsSearchContext() : id(-1), failed(false) {}
     int id;
     QString artist;
     QString title;
     QMap<QUrl, GeniusLyricsLyricContext> requests_lyric_;
     LyricsSearchResults results;
+    bool failed;
   };
 
  private:
@@ -88,16 +88,20 @@ void LoloLyricsProvider::HandleSearchReply(QNetworkReply *reply, const int id, c
   reply->deleteLater();
 
   QString failure_reason;
+  // A reply without lyrics only means there are none when the server answered the request.
+  bool success = true;
   if (reply->error() != QNetworkReply::NoError) {
+    success = reply->error() == QNetworkReply::ContentNotFoundError;
     failure_reason = QString("%1 (%2)").arg(reply->errorString()).arg(reply->error());
     if (reply->error() < 200) {
       Error(failure_reason);
-      emit SearchFinished(id, LyricsSearchResults());
+      emit SearchFinished(id, LyricsSearchResults(), false);
       return;
     }
   }
   else if (reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() != 200) {
     failure_reason = QString("Received HTTP code %1").arg(reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt());
+    success = false;
   }
 
   QByteArray data = reply->readAll();
@@ -138,12 +142,13 @@ void LoloLyricsProvider::HandleSearchReply(QNetworkReply *reply, const int id, c
         }
       }
     }
+    if (reader.hasError()) success = false;
   }
 
   if (results.isEmpty()) qLog(Debug) << "LoloLyrics: No lyrics for" << artist << title << failure_reason;
   else qLog(Debug) << "LoloLyrics: Got lyrics for" << artist << title;
 
-  emit SearchFinished(id, results);
+  emit SearchFinished(id, results, success);
 
 }
 
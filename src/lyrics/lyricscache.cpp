@@ -0,0 +1,131 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2021, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <QtGlobal>
+#include <QThread>
+#include <QMutexLocker>
+#include <QDateTime>
+#include <QString>
+#include <QSqlDatabase>
+
+#include "core/database.h"
+#include "core/sqlquery.h"
+#include "lyricscache.h"
+
+const char *LyricsCache::kTable = "lyrics";
+const qint64 LyricsCache::kDefaultMissExpirySecs = 7 * 24 * 60 * 60;
+
+LyricsCache::LyricsCache(Database *db) : db_(db), miss_expiry_(kDefaultMissExpirySecs) {}
+
+QString LyricsCache::Normalize(const QString &text) {
+
+  return text.toLower().simplified();
+
+}
+
+LyricsCache::Entry LyricsCache::Get(const QString &artist, const QString &album, const QString &title) const {
+
+  Entry entry;
+
+  {
+    QMutexLocker l(db_->ReadMutex());
+    QSqlDatabase db(db_->Connect());
+
+    SqlQuery q(db);
+    q.prepare(QString("SELECT provider, lyrics, time FROM %1 WHERE artist = :artist AND album = :album AND title = :title").arg(kTable));
+    q.BindStringValue(":artist", Normalize(artist));
+    q.BindStringValue(":album", Normalize(album));
+    q.BindStringValue(":title", Normalize(title));
+    if (!q.Exec()) {
+      db_->ReportErrors(q);
+    }
+    else if (q.next()) {
+      entry.provider = q.value(0).toString();
+      entry.lyrics = q.value(1).toString();
+      entry.time = q.value(2).toLongLong();
+
+      if (!entry.provider.isEmpty()) {
+        entry.status = Status_Found;
+      }
+      else if (entry.time >= QDateTime::currentDateTime().toSecsSinceEpoch() - miss_expiry_) {
+        entry.status = Status_Missing;
+      }
+    }
+  }
+
+  // Lookups run in the thread pool, so the connection of the pool thread is closed again.
+  if (QThread::currentThread() != db_->thread()) {
+    db_->Close();
+  }
+
+  return entry;
+
+}
+
+void LyricsCache::Add(const QString &artist, const QString &album, const QString &title, const QString &provider, const QString &lyrics) {
+
+  Store(artist, album, title, provider, lyrics);
+
+}
+
+void LyricsCache::AddMissing(const QString &artist, const QString &album, const QString &title) {
+
+  Store(artist, album, title, QString(), QString());
+
+}
+
+void LyricsCache::Store(const QString &artist, const QString &album, const QString &title, const QString &provider, const QString &lyrics) {
+
+  {
+    QMutexLocker l(db_->Mutex());
+    QSqlDatabase db(db_->Connect());
+
+    SqlQuery q(db);
+    q.prepare(QString("INSERT OR REPLACE INTO %1 (artist, album, title, provider, lyrics, time) VALUES (:artist, :album, :title, :provider, :lyrics, :time)").arg(kTable));
+    q.BindStringValue(":artist", Normalize(artist));
+    q.BindStringValue(":album", Normalize(album));
+    q.BindStringValue(":title", Normalize(title));
+    q.BindStringValue(":provider", provider);
+    q.BindStringValue(":lyrics", lyrics);
+    q.BindValue(":time", QDateTime::currentDateTime().toSecsSinceEpoch());
+    if (!q.Exec()) {
+      db_->ReportErrors(q);
+    }
+  }
+
+  if (QThread::currentThread() != db_->thread()) {
+    db_->Close();
+  }
+
+}
+
+void LyricsCache::Clear() {
+
+  QMutexLocker l(db_->Mutex());
+  QSqlDatabase db(db_->Connect());
+
+  SqlQuery q(db);
+  q.prepare(QString("DELETE FROM %1").arg(kTable));
+  if (!q.Exec()) {
+    db_->ReportErrors(q);
+  }
+
+}
@@ -0,0 +1,73 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2021, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef LYRICSCACHE_H
+#define LYRICSCACHE_H
+
+#include "config.h"
+
+#include <QtGlobal>
+#include <QString>
+
+class Database;
+
+// Lyrics found by the lyrics providers, stored in the main database by normalised artist, album and title.
+// Searches which found nothing are stored as well, so they're not repeated every time the song is played until they expire.
+// Can be used from any thread.
+class LyricsCache {
+ public:
+  explicit LyricsCache(Database *db);
+
+  static const char *kTable;
+  static const qint64 kDefaultMissExpirySecs;
+
+  enum Status {
+    Status_None,
+    Status_Found,
+    Status_Missing
+  };
+
+  struct Entry {
+    Entry() : status(Status_None), time(0) {}
+    Status status;
+    QString provider;
+    QString lyrics;
+    qint64 time;
+  };
+
+  static QString Normalize(const QString &text);
+
+  // Seconds until a search which found nothing is tried again.
+  qint64 miss_expiry() const { return miss_expiry_; }
+  void set_miss_expiry(const qint64 seconds) { miss_expiry_ = seconds; }
+
+  Entry Get(const QString &artist, const QString &album, const QString &title) const;
+  void Add(const QString &artist, const QString &album, const QString &title, const QString &provider, const QString &lyrics);
+  void AddMissing(const QString &artist, const QString &album, const QString &title);
+  void Clear();
+
+ private:
+  void Store(const QString &artist, const QString &album, const QString &title, const QString &provider, const QString &lyrics);
+
+ private:
+  Database *db_;
+  qint64 miss_expiry_;
+};
+
+#endif  // LYRICSCACHE_H
@@ -23,26 +23,46 @@
 
 #include <QtGlobal>
 #include <QObject>
+#include <QtConcurrent>
+#include <QFuture>
+#include <QFutureWatcher>
 #include <QTimer>
 #include <QString>
+#include <QSettings>
 
 #include "core/song.h"
 #include "lyricsfetcher.h"
 #include "lyricsfetchersearch.h"
+#include "lyricscache.h"
+#include "settings/lyricssettingspage.h"
 
 using namespace std::chrono_literals;
 
 const int LyricsFetcher::kMaxConcurrentRequests = 5;
 
-LyricsFetcher::LyricsFetcher(LyricsProviders *lyrics_providers, QObject *parent)
+LyricsFetcher::LyricsFetcher(LyricsProviders *lyrics_providers, Database *db, QObject *parent)
     : QObject(parent),
       lyrics_providers_(lyrics_providers),
+      offline_(false),
       next_id_(0),
       request_starter_(new QTimer(this)) {
 
+  if (db) cache_ = std::make_shared<LyricsCache>(db);
+
   request_starter_->setInterval(500ms);
   QObject::connect(request_starter_, &QTimer::timeout, this, &LyricsFetcher::StartRequests);
 
+  ReloadSettings();
+
+}
+
+void LyricsFetcher::ReloadSettings() {
+
+  QSettings s;
+  s.beginGroup(LyricsSettingsPage::kSettingsGroup);
+  offline_ = s.value("offline", false).toBool();
+  s.endGroup();
+
 }
 
 quint64 LyricsFetcher::Search(const QString &artist, const QString &album, const QString &title) {
@@ -54,12 +74,52 @@ quint64 LyricsFetcher::Search(const QString &artist, const QString &album, const
   request.title = title;
   request.title.remove(Song::kTitleRemoveMisc);
   request.id = ++next_id_;
-  AddRequest(request);
+
+  if (!cache_) {
+    AddRequest(request);
+    return request.id;
+  }
+
+  // Look in the cache first, the providers are only searched if the lyrics or a recent failed search aren't cached.
+  cache_lookups_.insert(request.id);
+  std::shared_ptr<LyricsCache> cache = cache_;
+  QFuture<LyricsCache::Entry> future = QtConcurrent::run([cache, request]() { return cache->Get(request.artist, request.album, request.title); });
+  QFutureWatcher<LyricsCache::Entry> *watcher = new QFutureWatcher<LyricsCache::Entry>();
+  QObject::connect(watcher, &QFutureWatcher<LyricsCache::Entry>::finished, this, [this, watcher, request]() {
+    const LyricsCache::Entry entry = watcher->result();
+    watcher->deleteLater();
+    CacheLookupFinished(request, entry);
+  });
+  watcher->setFuture(future);
 
   return request.id;
 
 }
 
+void LyricsFetcher::CacheLookupFinished(const LyricsSearchRequest &request, const LyricsCache::Entry &entry) {
+
+  // Cleared while looking it up.
+  if (!cache_lookups_.remove(request.id)) return;
+
+  switch (entry.status) {
+    case LyricsCache::Status_Found:
+      emit LyricsFetched(request.id, entry.provider, entry.lyrics);
+      break;
+    case LyricsCache::Status_Missing:
+      emit SearchFinished(request.id, LyricsSearchResults());
+      break;
+    case LyricsCache::Status_None:
+      if (offline_) {
+        emit SearchFinished(request.id, LyricsSearchResults());
+      }
+      else {
+        AddRequest(request);
+      }
+      break;
+  }
+
+}
+
 void LyricsFetcher::AddRequest(const LyricsSearchRequest &req) {
 
   queued_requests_.enqueue(req);
@@ -73,6 +133,7 @@ void LyricsFetcher::AddRequest(const LyricsSearchRequest &req) {
 void LyricsFetcher::Clear() {
 
   queued_requests_.clear();
+  cache_lookups_.clear();
 
   QList<LyricsFetcherSearch*> searches = active_requests_.values();
   for (LyricsFetcherSearch *search : searches) {
@@ -111,6 +172,14 @@ void LyricsFetcher::SingleSearchFinished(const quint64 request_id, const LyricsS
 
   LyricsFetcherSearch *search = active_requests_.take(request_id);
   search->deleteLater();
+
+  // Remember that nothing was found, unless some of the providers didn't reply in time or failed.
+  if (cache_ && results.isEmpty() && search->all_providers_finished() && !search->providers_failed()) {
+    std::shared_ptr<LyricsCache> cache = cache_;
+    const LyricsSearchRequest request = search->request();
+    (void)QtConcurrent::run([cache, request]() { cache->AddMissing(request.artist, request.album, request.title); });
+  }
+
   emit SearchFinished(request_id, results);
 
 }
@@ -121,6 +190,13 @@ void LyricsFetcher::SingleLyricsFetched(const quint64 request_id, const QString
 
   LyricsFetcherSearch *search = active_requests_.take(request_id);
   search->deleteLater();
+
+  if (cache_) {
+    std::shared_ptr<LyricsCache> cache = cache_;
+    const LyricsSearchRequest request = search->request();
+    (void)QtConcurrent::run([cache, request, provider, lyrics]() { cache->Add(request.artist, request.album, request.title, provider, lyrics); });
+  }
+
   emit LyricsFetched(request_id, provider, lyrics);
 
 }
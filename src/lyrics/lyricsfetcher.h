@@ -22,6 +22,8 @@
 
 #include "config.h"
 
+#include <memory>
+
 #include <QtGlobal>
 #include <QObject>
 #include <QMetaType>
@@ -32,7 +34,10 @@
 #include <QString>
 #include <QUrl>
 
+#include "lyricscache.h"
+
 class QTimer;
+class Database;
 class LyricsProviders;
 class LyricsFetcherSearch;
 
@@ -62,14 +67,17 @@ class LyricsFetcher : public QObject {
   Q_OBJECT
 
  public:
-  explicit LyricsFetcher(LyricsProviders *lyrics_providers, QObject *parent = nullptr);
+  explicit LyricsFetcher(LyricsProviders *lyrics_providers, Database *db = nullptr, QObject *parent = nullptr);
   ~LyricsFetcher() override {}
 
+  void ReloadSettings();
+
   quint64 Search(const QString &artist, const QString &album, const QString &title);
   void Clear();
 
  private:
   void AddRequest(const LyricsSearchRequest &req);
+  void CacheLookupFinished(const LyricsSearchRequest &request, const LyricsCache::Entry &entry);
 
  signals:
   void LyricsFetched(quint64 request_id, QString provider, QString lyrics);
@@ -84,8 +92,13 @@ class LyricsFetcher : public QObject {
   static const int kMaxConcurrentRequests;
 
   LyricsProviders *lyrics_providers_;
+  // Shared with the threads looking up and storing lyrics, which can outlive the fetcher.
+  std::shared_ptr<LyricsCache> cache_;
+  bool offline_;
   quint64 next_id_;
 
+  QSet<quint64> cache_lookups_;
+
   QQueue<LyricsSearchRequest> queued_requests_;
   QHash<quint64, LyricsFetcherSearch*> active_requests_;
 
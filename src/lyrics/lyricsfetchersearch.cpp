@@ -38,7 +38,9 @@ const float LyricsFetcherSearch::kHighScore = 2.5;
 LyricsFetcherSearch::LyricsFetcherSearch(const LyricsSearchRequest &request, QObject *parent)
     : QObject(parent),
       request_(request),
-      cancel_requested_(false) {
+      cancel_requested_(false),
+      all_providers_finished_(false),
+      providers_failed_(false) {
 
   QTimer::singleShot(kSearchTimeoutMs, this, &LyricsFetcherSearch::TerminateSearch);
 
@@ -77,11 +79,13 @@ void LyricsFetcherSearch::Start(LyricsProviders *lyrics_providers) {
 
 }
 
-void LyricsFetcherSearch::ProviderSearchFinished(const int id, const LyricsSearchResults &results) {
+void LyricsFetcherSearch::ProviderSearchFinished(const int id, const LyricsSearchResults &results, const bool success) {
 
   if (!pending_requests_.contains(id)) return;
   LyricsProvider *provider = pending_requests_.take(id);
 
+  if (!success) providers_failed_ = true;
+
   LyricsSearchResults results_copy(results);
   float higest_score = 0.0;
   for (int i = 0; i < results_copy.count(); ++i) {
@@ -117,6 +121,7 @@ void LyricsFetcherSearch::ProviderSearchFinished(const int id, const LyricsSearc
     return;
   }
 
+  all_providers_finished_ = true;
   AllProvidersFinished();
 
 }
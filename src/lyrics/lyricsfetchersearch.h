@@ -41,12 +41,18 @@ class LyricsFetcherSearch : public QObject {
   void Start(LyricsProviders *lyrics_providers);
   void Cancel();
 
+  const LyricsSearchRequest &request() const { return request_; }
+  // Whether every provider that was searched replied before the search finished.
+  bool all_providers_finished() const { return all_providers_finished_; }
+  // Whether any provider failed with a network or server error instead of replying.
+  bool providers_failed() const { return providers_failed_; }
+
  signals:
   void SearchFinished(quint64, LyricsSearchResults results);
   void LyricsFetched(quint64, QString provider, QString lyrics);
 
  private slots:
-  void ProviderSearchFinished(const int id, const LyricsSearchResults &results);
+  void ProviderSearchFinished(const int id, const LyricsSearchResults &results, const bool success);
   void TerminateSearch();
 
  private:
@@ -63,6 +69,8 @@ class LyricsFetcherSearch : public QObject {
   LyricsSearchResults results_;
   QMap<int, LyricsProvider*> pending_requests_;
   bool cancel_requested_;
+  bool all_providers_finished_;
+  bool providers_failed_;
 
 };
 
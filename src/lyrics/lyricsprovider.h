@@ -63,7 +63,8 @@ class LyricsProvider : public QObject {
   void AuthenticationComplete(bool, QStringList = QStringList());
   void AuthenticationSuccess();
   void AuthenticationFailure(QStringList);
-  void SearchFinished(int id, LyricsSearchResults results);
+  // Success is false when the search failed because of a network or server error, rather than there being no lyrics.
+  void SearchFinished(int id, LyricsSearchResults results, bool success = true);
 
  protected:
   using Param = QPair<QString, QString>;
@@ -114,6 +114,7 @@ void MusixmatchLyricsProvider::HandleSearchReply(QNetworkReply *reply, LyricsSea
       CreateLyricsRequest(search);
       return;
     }
+    search->failed = true;
     EndSearch(search);
     return;
   }
@@ -125,6 +126,7 @@ void MusixmatchLyricsProvider::HandleSearchReply(QNetworkReply *reply, LyricsSea
       CreateLyricsRequest(search);
       return;
     }
+    search->failed = true;
     EndSearch(search);
     return;
   }
@@ -132,17 +134,20 @@ void MusixmatchLyricsProvider::HandleSearchReply(QNetworkReply *reply, LyricsSea
   QByteArray data = reply->readAll();
   QJsonObject json_obj = ExtractJsonObj(data);
   if (json_obj.isEmpty()) {
+    search->failed = true;
     EndSearch(search);
     return;
   }
 
   if (!json_obj.contains("message")) {
     Error("Json reply is missing message object.", json_obj);
+    search->failed = true;
     EndSearch(search);
     return;
   }
   if (!json_obj["message"].isObject()) {
     Error("Json reply message is not an object.", json_obj);
+    search->failed = true;
     EndSearch(search);
     return;
   }
@@ -150,11 +155,13 @@ void MusixmatchLyricsProvider::HandleSearchReply(QNetworkReply *reply, LyricsSea
 
   if (!obj_message.contains("header")) {
     Error("Json reply message object is missing header.", obj_message);
+    search->failed = true;
     EndSearch(search);
     return;
   }
   if (!obj_message["header"].isObject()) {
     Error("Json reply message header is not an object.", obj_message);
+    search->failed = true;
     EndSearch(search);
     return;
   }
@@ -168,17 +175,20 @@ void MusixmatchLyricsProvider::HandleSearchReply(QNetworkReply *reply, LyricsSea
       CreateLyricsRequest(search);
       return;
     }
+    search->failed = true;
     EndSearch(search);
     return;
   }
 
   if (!obj_message.contains("body")) {
     Error("Json reply is missing body.", json_obj);
+    search->failed = true;
     EndSearch(search);
     return;
   }
   if (!obj_message["body"].isObject()) {
     Error("Json body is not an object.", json_obj);
+    search->failed = true;
     EndSearch(search);
     return;
   }
@@ -186,11 +196,13 @@ void MusixmatchLyricsProvider::HandleSearchReply(QNetworkReply *reply, LyricsSea
 
   if (!obj_body.contains("track_list")) {
     Error("Json response is missing body.", obj_body);
+    search->failed = true;
     EndSearch(search);
     return;
   }
   if (!obj_body["track_list"].isArray()) {
     Error("Json hits is not an array.", obj_body);
+    search->failed = true;
     EndSearch(search);
     return;
   }
@@ -283,11 +295,14 @@ void MusixmatchLyricsProvider::HandleLyricsReply(QNetworkReply *reply, LyricsSea
 
   if (reply->error() != QNetworkReply::NoError) {
     Error(QString("%1 (%2)").arg(reply->errorString()).arg(reply->error()));
+    // The lyrics page is guessed from the artist and title, so it not existing means there are no lyrics.
+    if (reply->error() != QNetworkReply::ContentNotFoundError) search->failed = true;
     EndSearch(search, url);
     return;
   }
   else if (reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() != 200) {
     Error(QString("Received HTTP code %1").arg(reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt()));
+    search->failed = true;
     EndSearch(search, url);
     return;
   }
@@ -295,6 +310,7 @@ void MusixmatchLyricsProvider::HandleLyricsReply(QNetworkReply *reply, LyricsSea
   QByteArray data = reply->readAll();
   if (data.isEmpty()) {
     Error("Empty reply received from server.");
+    search->failed = true;
     EndSearch(search, url);
     return;
   }
@@ -313,23 +329,27 @@ void MusixmatchLyricsProvider::HandleLyricsReply(QNetworkReply *reply, LyricsSea
   }
 
   if (content_json.isEmpty()) {
+    search->failed = true;
     EndSearch(search, url);
     return;
   }
 
   if (content_json.contains(QRegularExpression("<[^>]*>"))) {  // Make sure it's not HTML code.
+    search->failed = true;
     EndSearch(search, url);
     return;
   }
 
   QJsonObject json_obj = ExtractJsonObj(content_json.toUtf8());
   if (json_obj.isEmpty()) {
+    search->failed = true;
     EndSearch(search, url);
     return;
   }
 
   if (!json_obj.contains("page") || !json_obj["page"].isObject()) {
     Error("Json reply is missing page.", json_obj);
+    search->failed = true;
     EndSearch(search, url);
     return;
   }
@@ -337,6 +357,7 @@ void MusixmatchLyricsProvider::HandleLyricsReply(QNetworkReply *reply, LyricsSea
 
   if (!json_obj.contains("track") || !json_obj["track"].isObject()) {
     Error("Json reply is missing track.", json_obj);
+    search->failed = true;
     EndSearch(search, url);
     return;
   }
@@ -344,12 +365,14 @@ void MusixmatchLyricsProvider::HandleLyricsReply(QNetworkReply *reply, LyricsSea
 
   if (!obj_track.contains("artistName") || !obj_track.contains("albumName") || !obj_track.contains("name")) {
     Error("Json track is missing artistName, albumName or name.", json_obj);
+    search->failed = true;
     EndSearch(search, url);
     return;
   }
 
   if (!json_obj.contains("lyrics") || !json_obj["lyrics"].isObject()) {
     Error("Json reply is missing lyrics.", json_obj);
+    search->failed = true;
     EndSearch(search, url);
     return;
   }
@@ -357,6 +380,7 @@ void MusixmatchLyricsProvider::HandleLyricsReply(QNetworkReply *reply, LyricsSea
 
   if (!obj_lyrics.contains("lyrics") || !obj_lyrics["lyrics"].isObject()) {
     Error("Json reply is missing lyrics.", obj_lyrics);
+    search->failed = true;
     EndSearch(search, url);
     return;
   }
@@ -398,7 +422,7 @@ void MusixmatchLyricsProvider::EndSearch(LyricsSearchContextPtr search, const QU
     else {
       qLog(Debug) << "Musixmatch: Got lyrics for" << search->artist << search->title;
     }
-    emit SearchFinished(search->id, search->results);
+    emit SearchFinished(search->id, search->results, !search->failed);
   }
 
 }
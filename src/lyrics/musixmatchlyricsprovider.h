@@ -50,13 +50,14 @@ class MusixmatchLyricsProvider : public JsonLyricsProvider, public MusixmatchPro
 
  private:
   struct LyricsSearchContext {
-    explicit LyricsSearchContext() : id(-1) {}
+    explicit LyricsSearchContext() : id(-1), failed(false) {}
     int id;
     QString artist;
     QString album;
     QString title;
     QList<QUrl> requests_lyrics_;
     LyricsSearchResults results;
+    bool failed;
   };
 
   using LyricsSearchContextPtr = std::shared_ptr<LyricsSearchContext>;
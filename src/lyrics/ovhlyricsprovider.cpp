@@ -77,19 +77,20 @@ void OVHLyricsProvider::HandleSearchReply(QNetworkReply *reply, const int id, co
 
   QJsonObject json_obj = ExtractJsonObj(reply);
   if (json_obj.isEmpty()) {
-    emit SearchFinished(id, LyricsSearchResults());
+    emit SearchFinished(id, LyricsSearchResults(), false);
     return;
   }
 
   if (json_obj.contains("error")) {
     Error(json_obj["error"].toString());
     qLog(Debug) << "OVHLyrics: No lyrics for" << artist << title;
-    emit SearchFinished(id, LyricsSearchResults());
+    // The server replies with an error and HTTP code 404 when there are no lyrics.
+    emit SearchFinished(id, LyricsSearchResults(), reply->error() == QNetworkReply::NoError || reply->error() == QNetworkReply::ContentNotFoundError);
     return;
   }
 
   if (!json_obj.contains("lyrics")) {
-    emit SearchFinished(id, LyricsSearchResults());
+    emit SearchFinished(id, LyricsSearchResults(), false);
     return;
   }
 
@@ -76,19 +76,19 @@ void Stands4LyricsProvider::HandleSearchReply(QNetworkReply *reply, const int id
 
   if (reply->error() != QNetworkReply::NoError) {
     Error(QString("%1 (%2)").arg(reply->errorString()).arg(reply->error()));
-    emit SearchFinished(id, LyricsSearchResults());
+    emit SearchFinished(id, LyricsSearchResults(), reply->error() == QNetworkReply::ContentNotFoundError);
     return;
   }
   else if (reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() != 200) {
     Error(QString("Received HTTP code %1").arg(reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt()));
-    emit SearchFinished(id, LyricsSearchResults());
+    emit SearchFinished(id, LyricsSearchResults(), false);
     return;
   }
 
   const QByteArray data = reply->readAll();
   if (data.isEmpty()) {
     Error("Empty reply received from server.");
-    emit SearchFinished(id, LyricsSearchResults());
+    emit SearchFinished(id, LyricsSearchResults(), false);
     return;
   }
 
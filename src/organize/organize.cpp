@@ -20,10 +20,15 @@
  */
 
 #include <functional>
+#include <utility>
 #include <chrono>
 
 #include <QtGlobal>
+#include <QtConcurrent>
 #include <QThread>
+#include <QThreadPool>
+#include <QFuture>
+#include <QFutureWatcher>
 #include <QFile>
 #include <QFileInfo>
 #include <QTimer>
@@ -49,6 +54,7 @@ using namespace std::chrono_literals;
 class OrganizeFormat;
 
 const int Organize::kBatchSize = 10;
+const int Organize::kDefaultCopyThreads = 4;
 #ifdef HAVE_GSTREAMER
 const int Organize::kTranscodeProgressInterval = 500;
 #endif
@@ -61,6 +67,7 @@ Organize::Organize(TaskManager *task_manager, std::shared_ptr<MusicStorage> dest
       transcoder_(new Transcoder(this)),
 #endif
       process_files_timer_(new QTimer(this)),
+      copy_thread_pool_(new QThreadPool(this)),
       destination_(destination),
       format_(format),
       copy_(copy),
@@ -70,6 +77,8 @@ Organize::Organize(TaskManager *task_manager, std::shared_ptr<MusicStorage> dest
       task_count_(songs_info.count()),
       playlist_(playlist),
       tasks_complete_(0),
+      copy_threads_(kDefaultCopyThreads),
+      copies_running_(0),
       started_(false),
       task_id_(0),
       current_copy_progress_(0),
@@ -81,6 +90,8 @@ Organize::Organize(TaskManager *task_manager, std::shared_ptr<MusicStorage> dest
   process_files_timer_->setInterval(100ms);
   QObject::connect(process_files_timer_, &QTimer::timeout, this, &Organize::ProcessSomeFiles);
 
+  copy_thread_pool_->setMaxThreadCount(copy_threads_);
+
   tasks_pending_.reserve(songs_info.count());
   for (const NewSongInfo &song_info : songs_info) {
     tasks_pending_ << Task(song_info);
@@ -97,6 +108,23 @@ Organize::~Organize() {
 
 }
 
+void Organize::set_transcode_threads(const int count) {
+
+#ifdef HAVE_GSTREAMER
+  transcoder_->set_max_threads(qMax(1, count));
+#else
+  Q_UNUSED(count)
+#endif
+
+}
+
+void Organize::set_copy_threads(const int count) {
+
+  copy_threads_ = qMax(1, count);
+  copy_thread_pool_->setMaxThreadCount(copy_threads_);
+
+}
+
 void Organize::Start() {
 
   if (thread_) return;
@@ -133,6 +161,10 @@ void Organize::ProcessSomeFiles() {
 
   // None left?
   if (tasks_pending_.isEmpty()) {
+    if (copies_running_ > 0) {
+      // FileCopyFinished will start us off again when the last file is copied
+      return;
+    }
 #ifdef HAVE_GSTREAMER
     if (!tasks_transcoding_.isEmpty()) {
       // Just wait - FileTranscoded will start us off again in a little while
@@ -161,12 +193,18 @@ void Organize::ProcessSomeFiles() {
     return;
   }
 
+  // Files are copied at the same time when the destination supports it, the transcoder runs its jobs in its own threads.
+  const bool concurrent_copies = copy_ && copy_threads_ > 1 && destination_->SupportsConcurrentCopies();
+
   // We process files in batches so we can be cancelled part-way through.
   for (int i = 0; i < kBatchSize; ++i) {
     SetSongProgress(0);
 
     if (tasks_pending_.isEmpty()) break;
 
+    // All copy threads are busy, FileCopyFinished will start us off again.
+    if (concurrent_copies && copies_running_ >= copy_threads_) break;
+
     Task task = tasks_pending_.takeFirst();
     qLog(Info) << "Processing" << task.song_info_.song_.url().toLocalFile();
 
@@ -213,59 +251,7 @@ void Organize::ProcessSomeFiles() {
     }
 #endif
 
-    MusicStorage::CopyJob job;
-    job.source_ = task.transcoded_filename_.isEmpty() ? task.song_info_.song_.url().toLocalFile() : task.transcoded_filename_;
-    job.destination_ = task.song_info_.new_filename_;
-    job.metadata_ = song;
-    job.overwrite_ = overwrite_;
-    job.albumcover_ = albumcover_;
-    job.remove_original_ = !copy_;
-    job.playlist_ = playlist_;
-
-    if (task.song_info_.song_.art_manual_is_valid() && !task.song_info_.song_.has_manually_unset_cover()) {
-      if (task.song_info_.song_.art_manual().isLocalFile() && QFile::exists(task.song_info_.song_.art_manual().toLocalFile())) {
-        job.cover_source_ = task.song_info_.song_.art_manual().toLocalFile();
-      }
-      else if (task.song_info_.song_.art_manual().scheme().isEmpty() && QFile::exists(task.song_info_.song_.art_manual().path())) {
-        job.cover_source_ = task.song_info_.song_.art_manual().path();
-      }
-    }
-    else if (task.song_info_.song_.art_automatic_is_valid() && !task.song_info_.song_.has_embedded_cover()) {
-      if (task.song_info_.song_.art_automatic().isLocalFile() && QFile::exists(task.song_info_.song_.art_automatic().toLocalFile())) {
-        job.cover_source_ = task.song_info_.song_.art_automatic().toLocalFile();
-      }
-      else if (task.song_info_.song_.art_automatic().scheme().isEmpty() && QFile::exists(task.song_info_.song_.art_automatic().path())) {
-        job.cover_source_ = task.song_info_.song_.art_automatic().path();
-      }
-    }
-    else if (destination_->source() == Song::Source_Device) {
-      job.cover_image_ = TagReaderClient::Instance()->LoadEmbeddedArtAsImageBlocking(task.song_info_.song_.url().toLocalFile());
-    }
-
-    if (!job.cover_source_.isEmpty()) {
-      job.cover_dest_ = QFileInfo(job.destination_).path() + "/" + QFileInfo(job.cover_source_).fileName();
-    }
-
-    job.progress_ = std::bind(&Organize::SetSongProgress, this, std::placeholders::_1, !task.transcoded_filename_.isEmpty());
-
-    if (destination_->CopyToStorage(job)) {
-      if (job.remove_original_ && (destination_->source() == Song::Source_Collection || destination_->source() == Song::Source_Device)) {
-        // Notify other aspects of system that song has been invalidated
-        QString root = destination_->LocalPath();
-        QFileInfo new_file = QFileInfo(root + "/" + task.song_info_.new_filename_);
-        emit SongPathChanged(song, new_file, destination_->collection_directory_id());
-      }
-    }
-    else {
-      files_with_errors_ << task.song_info_.song_.basefilename();
-    }
-
-    // Clean up the temporary transcoded file
-    if (!task.transcoded_filename_.isEmpty()) {
-      QFile::remove(task.transcoded_filename_);
-    }
-
-    tasks_complete_++;
+    CopyTask(task, song);
   }
   SetSongProgress(0);
 
@@ -313,6 +299,17 @@ void Organize::SetSongProgress(float progress, bool transcoded) {
 
 }
 
+void Organize::SetCopyProgress(const QString &source, const float progress, const bool transcoded) {
+
+  // The copy has finished already.
+  if (!copies_progress_.contains(source)) return;
+
+  const int max = transcoded ? 50 : 100;
+  copies_progress_[source] = (transcoded ? 50 : 0) + qBound(0, static_cast<int>(progress * static_cast<float>(max)), max - 1);
+  UpdateProgress();
+
+}
+
 void Organize::UpdateProgress() {
 
   const quint64 total = task_count_ * 100;
@@ -341,8 +338,11 @@ void Organize::UpdateProgress() {
   }
 #endif
 
-  // Add the progress of the track that's currently copying
+  // Add the progress of the tracks that are currently copying
   progress += current_copy_progress_;
+  for (const int copy_progress : std::as_const(copies_progress_)) {
+    progress += copy_progress;
+  }
 
   task_manager_->SetTaskProgress(task_id_, progress, total);
 
@@ -369,6 +369,104 @@ void Organize::FileTranscoded(const QString &input, const QString &output, bool
 
 }
 
+MusicStorage::CopyJob Organize::CreateCopyJob(const Task &task, const Song &song) const {
+
+  MusicStorage::CopyJob job;
+  job.source_ = task.transcoded_filename_.isEmpty() ? task.song_info_.song_.url().toLocalFile() : task.transcoded_filename_;
+  job.destination_ = task.song_info_.new_filename_;
+  job.metadata_ = song;
+  job.overwrite_ = overwrite_;
+  job.albumcover_ = albumcover_;
+  job.remove_original_ = !copy_;
+  job.playlist_ = playlist_;
+
+  if (task.song_info_.song_.art_manual_is_valid() && !task.song_info_.song_.has_manually_unset_cover()) {
+    if (task.song_info_.song_.art_manual().isLocalFile() && QFile::exists(task.song_info_.song_.art_manual().toLocalFile())) {
+      job.cover_source_ = task.song_info_.song_.art_manual().toLocalFile();
+    }
+    else if (task.song_info_.song_.art_manual().scheme().isEmpty() && QFile::exists(task.song_info_.song_.art_manual().path())) {
+      job.cover_source_ = task.song_info_.song_.art_manual().path();
+    }
+  }
+  else if (task.song_info_.song_.art_automatic_is_valid() && !task.song_info_.song_.has_embedded_cover()) {
+    if (task.song_info_.song_.art_automatic().isLocalFile() && QFile::exists(task.song_info_.song_.art_automatic().toLocalFile())) {
+      job.cover_source_ = task.song_info_.song_.art_automatic().toLocalFile();
+    }
+    else if (task.song_info_.song_.art_automatic().scheme().isEmpty() && QFile::exists(task.song_info_.song_.art_automatic().path())) {
+      job.cover_source_ = task.song_info_.song_.art_automatic().path();
+    }
+  }
+  else if (destination_->source() == Song::Source_Device) {
+    job.cover_image_ = TagReaderClient::Instance()->LoadEmbeddedArtAsImageBlocking(task.song_info_.song_.url().toLocalFile());
+  }
+
+  if (!job.cover_source_.isEmpty()) {
+    job.cover_dest_ = QFileInfo(job.destination_).path() + "/" + QFileInfo(job.cover_source_).fileName();
+  }
+
+  return job;
+
+}
+
+void Organize::CopyTask(const Task &task, const Song &song) {
+
+  MusicStorage::CopyJob job = CreateCopyJob(task, song);
+
+  if (copy_ && copy_threads_ > 1 && destination_->SupportsConcurrentCopies()) {
+    // The copy runs in the copy thread pool while we carry on with the next files.
+    // Moves are kept sequential since removing the original directories could race with creating the new ones.
+    ++copies_running_;
+    // The progress is reported from the copy thread, so it's passed on to this thread.
+    const QString source = job.source_;
+    const bool transcoded = !task.transcoded_filename_.isEmpty();
+    copies_progress_.insert(source, transcoded ? 50 : 0);
+    job.progress_ = [this, source, transcoded](const float progress) {
+      QMetaObject::invokeMethod(this, "SetCopyProgress", Qt::QueuedConnection, Q_ARG(QString, source), Q_ARG(float, progress), Q_ARG(bool, transcoded));
+    };
+    QFuture<bool> future = QtConcurrent::run(copy_thread_pool_, [destination = destination_, job]() { return destination->CopyToStorage(job); });
+    QFutureWatcher<bool> *watcher = new QFutureWatcher<bool>();
+    QObject::connect(watcher, &QFutureWatcher<bool>::finished, this, [this, watcher, task, song, source]() {
+      const bool success = watcher->result();
+      watcher->deleteLater();
+      --copies_running_;
+      copies_progress_.remove(source);
+      FileCopyFinished(task, song, success);
+      if (!process_files_timer_->isActive()) {
+        process_files_timer_->start();
+      }
+    });
+    watcher->setFuture(future);
+  }
+  else {
+    job.progress_ = std::bind(&Organize::SetSongProgress, this, std::placeholders::_1, !task.transcoded_filename_.isEmpty());
+    FileCopyFinished(task, song, destination_->CopyToStorage(job));
+  }
+
+}
+
+void Organize::FileCopyFinished(const Task &task, const Song &song, const bool success) {
+
+  if (success) {
+    if (!copy_ && (destination_->source() == Song::Source_Collection || destination_->source() == Song::Source_Device)) {
+      // Notify other aspects of system that song has been invalidated
+      QString root = destination_->LocalPath();
+      QFileInfo new_file = QFileInfo(root + "/" + task.song_info_.new_filename_);
+      emit SongPathChanged(song, new_file, destination_->collection_directory_id());
+    }
+  }
+  else {
+    files_with_errors_ << task.song_info_.song_.basefilename();
+  }
+
+  // Clean up the temporary transcoded file
+  if (!task.transcoded_filename_.isEmpty()) {
+    QFile::remove(task.transcoded_filename_);
+  }
+
+  tasks_complete_++;
+
+}
+
 void Organize::timerEvent(QTimerEvent *e) {
 
   QObject::timerEvent(e);
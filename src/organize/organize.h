@@ -38,13 +38,14 @@
 #include <QStringList>
 
 #include "core/song.h"
+#include "core/musicstorage.h"
 #include "organizeformat.h"
 
 class QThread;
+class QThreadPool;
 class QTimer;
 class QTimerEvent;
 
-class MusicStorage;
 class TaskManager;
 #ifdef HAVE_GSTREAMER
 class Transcoder;
@@ -67,10 +68,17 @@ class Organize : public QObject {
   ~Organize() override;
 
   static const int kBatchSize;
+  static const int kDefaultCopyThreads;
 #ifdef HAVE_GSTREAMER
   static const int kTranscodeProgressInterval;
 #endif
 
+  // Call before Start()
+  // Number of files transcoded at the same time.
+  void set_transcode_threads(const int count);
+  // Number of files copied at the same time when the destination supports it, files are only moved one at a time.
+  void set_copy_threads(const int count);
+
   void Start();
 
  signals:
@@ -85,6 +93,7 @@ class Organize : public QObject {
   void ProcessSomeFiles();
   void FileTranscoded(const QString &input, const QString &output, bool success);
   void LogLine(const QString &message);
+  void SetCopyProgress(const QString &source, const float progress, const bool transcoded);
 
  private:
   void SetSongProgress(float progress, bool transcoded = false);
@@ -106,6 +115,10 @@ class Organize : public QObject {
     Song::FileType new_filetype_;
   };
 
+  MusicStorage::CopyJob CreateCopyJob(const Task &task, const Song &song) const;
+  void CopyTask(const Task &task, const Song &song);
+  void FileCopyFinished(const Task &task, const Song &song, const bool success);
+
   QThread *thread_;
   QThread *original_thread_;
   TaskManager *task_manager_;
@@ -113,6 +126,7 @@ class Organize : public QObject {
   Transcoder *transcoder_;
 #endif
   QTimer *process_files_timer_;
+  QThreadPool *copy_thread_pool_;
   std::shared_ptr<MusicStorage> destination_;
   QList<Song::FileType> supported_filetypes_;
 
@@ -128,6 +142,9 @@ class Organize : public QObject {
   QVector<Task> tasks_pending_;
   QMap<QString, Task> tasks_transcoding_;
   int tasks_complete_;
+  int copy_threads_;
+  int copies_running_;
+  QMap<QString, int> copies_progress_;
 
   bool started_;
 
@@ -33,6 +33,7 @@
 #include <QAbstractItemModel>
 #include <QDialog>
 #include <QScreen>
+#include <QThread>
 #include <QWindow>
 #include <QHash>
 #include <QMap>
@@ -50,6 +51,7 @@
 #include <QGroupBox>
 #include <QListWidget>
 #include <QPushButton>
+#include <QSpinBox>
 #include <QStackedWidget>
 #include <QToolButton>
 #include <QShowEvent>
@@ -192,6 +194,8 @@ void OrganizeDialog::accept() {
     QObject::connect(organize, &Organize::SongPathChanged, backend_, &CollectionBackend::SongPathChanged);
   }
 
+  organize->set_transcode_threads(ui_->transcode_threads->value());
+  organize->set_copy_threads(ui_->copy_threads->value());
   organize->Start();
 
   QDialog::accept();
@@ -309,6 +313,8 @@ void OrganizeDialog::LoadSettings() {
   ui_->overwrite->setChecked(s.value("overwrite", false).toBool());
   ui_->albumcover->setChecked(s.value("albumcover", true).toBool());
   ui_->eject_after->setChecked(s.value("eject_after", false).toBool());
+  ui_->transcode_threads->setValue(s.value("transcode_threads", QThread::idealThreadCount()).toInt());
+  ui_->copy_threads->setValue(s.value("copy_threads", Organize::kDefaultCopyThreads).toInt());
 
   QString destination = s.value("destination").toString();
   int index = ui_->destination->findText(destination);
@@ -336,6 +342,8 @@ void OrganizeDialog::SaveSettings() {
   s.setValue("albumcover", ui_->albumcover->isChecked());
   s.setValue("destination", ui_->destination->currentText());
   s.setValue("eject_after", ui_->eject_after->isChecked());
+  s.setValue("transcode_threads", ui_->transcode_threads->value());
+  s.setValue("copy_threads", ui_->copy_threads->value());
   s.endGroup();
 
 }
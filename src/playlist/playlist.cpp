@@ -29,6 +29,7 @@
 #include <unordered_map>
 #include <random>
 #include <chrono>
+#include <vector>
 
 #include <QObject>
 #include <QCoreApplication>
@@ -40,6 +41,7 @@
 #include <QBuffer>
 #include <QFile>
 #include <QList>
+#include <QVector>
 #include <QMap>
 #include <QHash>
 #include <QSet>
@@ -57,6 +59,8 @@
 #include <QFlags>
 #include <QSettings>
 #include <QTimer>
+#include <QCollator>
+#include <QCollatorSortKey>
 
 #include "core/application.h"
 #include "core/logging.h"
@@ -108,9 +112,26 @@ const char *Playlist::kSettingsGroup = "Playlist";
 const int Playlist::kUndoStackSize = 20;
 const int Playlist::kUndoItemLimit = 500;
 
+const int Playlist::kRestorePageSize = 1000;
+
 const qint64 Playlist::kMinScrobblePointNsecs = 31LL * kNsecPerSec;
 const qint64 Playlist::kMaxScrobblePointNsecs = 240LL * kNsecPerSec;
 
+const qint64 Playlist::kPositionStep = 1024;
+
+namespace {
+
+// An item with everything it's sorted by.
+struct SortEntry {
+  SortEntry() : depth(0) {}
+  PlaylistItemPtr item;
+  Song metadata;
+  std::vector<QCollatorSortKey> keys;
+  qint64 depth;
+};
+
+}  // namespace
+
 Playlist::Playlist(PlaylistBackend *backend, TaskManager *task_manager, CollectionBackend *collection, const int id, const QString &special_type, const bool favorite, QObject *parent)
     : QAbstractListModel(parent),
       is_loading_(false),
@@ -122,6 +143,8 @@ Playlist::Playlist(PlaylistBackend *backend, TaskManager *task_manager, Collecti
       collection_(collection),
       id_(id),
       favorite_(favorite),
+      save_in_progress_(false),
+      save_again_(false),
       current_is_paused_(false),
       current_virtual_index_(-1),
       is_shuffled_(false),
@@ -130,6 +153,9 @@ Playlist::Playlist(PlaylistBackend *backend, TaskManager *task_manager, Collecti
       undo_stack_(new QUndoStack(this)),
       special_type_(special_type),
       cancel_restore_(false),
+      restore_last_played_(-1),
+      restore_last_played_set_(false),
+      restore_count_(0),
       scrobbled_(false),
       scrobble_point_(-1),
       editing_(-1),
@@ -155,6 +181,10 @@ Playlist::Playlist(PlaylistBackend *backend, TaskManager *task_manager, Collecti
   QObject::connect(queue_, &Queue::layoutChanged, this, &Playlist::QueueLayoutChanged);
 
   QObject::connect(timer_save_, &QTimer::timeout, this, &Playlist::Save);
+  if (backend_) {
+    QObject::connect(backend_, &PlaylistBackend::PlaylistSaved, this, &Playlist::PlaylistSaved);
+    QObject::connect(backend_, &PlaylistBackend::PlaylistSaveFailed, this, &Playlist::PlaylistSaveFailed);
+  }
 
   column_alignments_ = PlaylistView::DefaultColumnAlignment();
 
@@ -288,7 +318,7 @@ QVariant Playlist::data(const QModelIndex &idx, int role) const {
       PlaylistItemPtr item = items_[idx.row()];
       Song song = item->Metadata();
 
-      // Don't forget to change Playlist::CompareItems when adding new columns
+      // Don't forget to change Playlist::SortText or Playlist::CompareItems when adding new columns
       switch (idx.column()) {
         case Column_Title:              return song.PrettyTitle();
         case Column_Artist:             return song.artist();
@@ -603,6 +633,37 @@ int Playlist::next_row(const bool ignore_repeat_track) const {
 
 }
 
+QList<int> Playlist::next_rows(const int count) const {
+
+  QList<int> rows;
+
+  for (int i = 0; i < queue_->ItemCount() && rows.count() < count; ++i) {
+    const int row = queue_->mapToSource(queue_->index(i, 0)).row();
+    if (row != -1 && !rows.contains(row)) rows << row;
+  }
+
+  const PlaylistSequence::RepeatMode repeat_mode = playlist_sequence_->repeat_mode();
+  if (repeat_mode == PlaylistSequence::Repeat_Track) return rows;
+
+  const int current = current_row();
+  int virtual_index = current_virtual_index_;
+  for (int i = 0; i < virtual_items_.count() && rows.count() < count; ++i) {
+    virtual_index = NextVirtualIndex(virtual_index, true);
+    if (virtual_index >= virtual_items_.count()) {
+      // We've gone off the end of the playlist, same as in next_row().
+      if (repeat_mode == PlaylistSequence::Repeat_Off || repeat_mode == PlaylistSequence::Repeat_Intro) break;
+      virtual_index = NextVirtualIndex(-1, true);
+      if (virtual_index < 0 || virtual_index >= virtual_items_.count()) break;
+    }
+    const int row = virtual_items_[virtual_index];
+    if (row == current) break;
+    if (!rows.contains(row)) rows << row;
+  }
+
+  return rows;
+
+}
+
 int Playlist::previous_row(const bool ignore_repeat_track) const {
 
   int prev_virtual_index = PreviousVirtualIndex(current_virtual_index_, ignore_repeat_track);
@@ -1259,29 +1320,55 @@ QMimeData *Playlist::mimeData(const QModelIndexList &indexes) const {
 
 }
 
-bool Playlist::CompareItems(const int column, const Qt::SortOrder order, std::shared_ptr<PlaylistItem> _a, std::shared_ptr<PlaylistItem> _b) {
+bool Playlist::column_sorts_by_text(const int column) {
+
+  switch (column) {
+    case Column_Title:
+    case Column_Artist:
+    case Column_Album:
+    case Column_Genre:
+    case Column_AlbumArtist:
+    case Column_Composer:
+    case Column_Performer:
+    case Column_Grouping:
+    case Column_Filename:
+    case Column_Comment:
+      return true;
+    default:
+      return false;
+  }
+
+}
+
+QString Playlist::SortText(const int column, PlaylistItemPtr item, const Song &metadata) {
+
+  switch (column) {
+    case Column_Title:        return metadata.title_sortable();
+    case Column_Artist:       return metadata.artist_sortable();
+    case Column_Album:        return metadata.album_sortable();
+    case Column_Genre:        return metadata.genre();
+    case Column_AlbumArtist:  return metadata.playlist_albumartist_sortable();
+    case Column_Composer:     return metadata.composer();
+    case Column_Performer:    return metadata.performer();
+    case Column_Grouping:     return metadata.grouping();
+    case Column_Filename:     return item->Url().path();
+    case Column_Comment:      return metadata.comment();
+    default:                  return QString();
+  }
+
+}
 
-  std::shared_ptr<PlaylistItem> a = order == Qt::AscendingOrder ? _a : _b;
-  std::shared_ptr<PlaylistItem> b = order == Qt::AscendingOrder ? _b : _a;
+int Playlist::CompareItems(const int column, const Song &a, const Song &b) {
 
-#define cmp(field) return a->Metadata().field() < b->Metadata().field()
-#define strcmp(field) return QString::localeAwareCompare(a->Metadata().field().toLower(), b->Metadata().field().toLower()) < 0;
+#define cmp(field) return a.field() < b.field() ? -1 : (b.field() < a.field() ? 1 : 0)
 
   switch (column) {
 
-    case Column_Title:        strcmp(title_sortable);
-    case Column_Artist:       strcmp(artist_sortable);
-    case Column_Album:        strcmp(album_sortable);
     case Column_Length:       cmp(length_nanosec);
     case Column_Track:        cmp(track);
     case Column_Disc:         cmp(disc);
     case Column_Year:         cmp(year);
     case Column_OriginalYear: cmp(originalyear);
-    case Column_Genre:        strcmp(genre);
-    case Column_AlbumArtist:  strcmp(playlist_albumartist_sortable);
-    case Column_Composer:     strcmp(composer);
-    case Column_Performer:    strcmp(performer);
-    case Column_Grouping:     strcmp(grouping);
 
     case Column_PlayCount:    cmp(playcount);
     case Column_SkipCount:    cmp(skipcount);
@@ -1290,15 +1377,12 @@ bool Playlist::CompareItems(const int column, const Qt::SortOrder order, std::sh
     case Column_Bitrate:      cmp(bitrate);
     case Column_Samplerate:   cmp(samplerate);
     case Column_Bitdepth:     cmp(bitdepth);
-    case Column_Filename:
-      return (QString::localeAwareCompare(a->Url().path().toLower(), b->Url().path().toLower()) < 0);
     case Column_BaseFilename: cmp(basefilename);
     case Column_Filesize:     cmp(filesize);
     case Column_Filetype:     cmp(filetype);
     case Column_DateModified: cmp(mtime);
     case Column_DateCreated:  cmp(ctime);
 
-    case Column_Comment:      strcmp(comment);
     case Column_Source:       cmp(source);
 
     case Column_Rating:       cmp(rating);
@@ -1309,21 +1393,8 @@ bool Playlist::CompareItems(const int column, const Qt::SortOrder order, std::sh
   }
 
 #undef cmp
-#undef strcmp
 
-  return false;
-
-}
-
-bool Playlist::ComparePathDepths(const Qt::SortOrder order, std::shared_ptr<PlaylistItem> _a, std::shared_ptr<PlaylistItem> _b) {
-
-  std::shared_ptr<PlaylistItem> a = order == Qt::AscendingOrder ? _a : _b;
-  std::shared_ptr<PlaylistItem> b = order == Qt::AscendingOrder ? _b : _a;
-
-  qint64 a_dir_level = a->Url().path().count('/');
-  qint64 b_dir_level = b->Url().path().count('/');
-
-  return a_dir_level < b_dir_level;
+  return 0;
 
 }
 
@@ -1400,19 +1471,59 @@ void Playlist::sort(int column, Qt::SortOrder order) {
   if (dynamic_playlist_ && current_item_index_.isValid())
     begin += current_item_index_.row() + 1;
 
+  QList<int> columns;
   if (column == Column_Album) {
     // When sorting by album, also take into account discs and tracks.
-    std::stable_sort(begin, new_items.end(), std::bind(&Playlist::CompareItems, Column_Track, order, std::placeholders::_1, std::placeholders::_2));
-    std::stable_sort(begin, new_items.end(), std::bind(&Playlist::CompareItems, Column_Disc, order, std::placeholders::_1, std::placeholders::_2));
-    std::stable_sort(begin, new_items.end(), std::bind(&Playlist::CompareItems, Column_Album, order, std::placeholders::_1, std::placeholders::_2));
-  }
-  else if (column == Column_Filename) {
-    // When sorting by full paths we also expect a hierarchical order. This returns a breath-first ordering of paths.
-    std::stable_sort(begin, new_items.end(), std::bind(&Playlist::CompareItems, Column_Filename, order, std::placeholders::_1, std::placeholders::_2));
-    std::stable_sort(begin, new_items.end(), std::bind(&Playlist::ComparePathDepths, order, std::placeholders::_1, std::placeholders::_2));
+    columns << Column_Album << Column_Disc << Column_Track;
   }
   else {
-    std::stable_sort(begin, new_items.end(), std::bind(&Playlist::CompareItems, column, order, std::placeholders::_1, std::placeholders::_2));
+    columns << column;
+  }
+
+  // When sorting by full paths we also expect a hierarchical order. This returns a breath-first ordering of paths.
+  const bool sort_by_depth = column == Column_Filename;
+
+  // Get the metadata and collation keys once per item instead of for each comparison.
+  QCollator collator;
+  std::vector<SortEntry> entries;
+  entries.reserve(static_cast<size_t>(std::distance(begin, new_items.end())));
+  for (PlaylistItemList::iterator it = begin; it != new_items.end(); ++it) {
+    SortEntry entry;
+    entry.item = *it;
+    entry.metadata = entry.item->Metadata();
+    entry.depth = sort_by_depth ? entry.item->Url().path().count('/') : 0;
+    for (const int sort_column : std::as_const(columns)) {
+      if (column_sorts_by_text(sort_column)) {
+        entry.keys.push_back(entry.item->SortKey(sort_column, SortText(sort_column, entry.item, entry.metadata), collator));
+      }
+    }
+    entries.push_back(entry);
+  }
+
+  const int direction = order == Qt::AscendingOrder ? 1 : -1;
+  std::stable_sort(entries.begin(), entries.end(), [&columns, sort_by_depth, direction](const SortEntry &a, const SortEntry &b) {
+    if (sort_by_depth && a.depth != b.depth) {
+      return (a.depth < b.depth ? -1 : 1) * direction < 0;
+    }
+    size_t key = 0;
+    for (const int sort_column : columns) {
+      int result = 0;
+      if (column_sorts_by_text(sort_column)) {
+        result = a.keys[key].compare(b.keys[key]);
+        ++key;
+      }
+      else {
+        result = CompareItems(sort_column, a.metadata, b.metadata);
+      }
+      if (result != 0) return result * direction < 0;
+    }
+    return false;
+  });
+
+  PlaylistItemList::iterator it = begin;
+  for (SortEntry &entry : entries) {
+    *it = std::move(entry.item);
+    ++it;
   }
 
   undo_stack_->push(new PlaylistUndoCommands::SortItems(this, column, order, new_items));
@@ -1487,7 +1598,180 @@ void Playlist::Save() {
 
   if (!backend_ || is_loading_) return;
 
-  backend_->SavePlaylistAsync(id_, items_, last_played_row(), dynamic_playlist_);
+  // The saved rows are not known until the save in progress is finished.
+  if (save_in_progress_) {
+    save_again_ = true;
+    return;
+  }
+
+  // Only write the rows of the items which were added, changed or moved since the playlist was last saved.
+  // Without saved rows, the playlist was never saved or the last save failed, so it's written from scratch.
+  PlaylistBackend::PlaylistItemChanges changes;
+  changes.rewrite = saved_items_.isEmpty();
+  pending_new_rows_.clear();
+  QHash<const PlaylistItem*, SavedItem> saved_items;
+  saved_items.reserve(items_.count());
+  QList<int> ids;
+  QList<qint64> saved_positions;
+  QList<bool> changed;
+  ids.reserve(items_.count());
+  saved_positions.reserve(items_.count());
+  changed.reserve(items_.count());
+
+  for (const PlaylistItemPtr &item : std::as_const(items_)) {
+    SavedItem &saved_item = saved_items[item.get()];
+    if (saved_item.item.expired()) {
+      saved_item.item = item;
+      saved_item.metadata = item->DatabaseMetadata();
+    }
+    const int occurrence = static_cast<int>(saved_item.ids.count());
+    saved_item.ids << -1;
+
+    QHash<const PlaylistItem*, SavedItem>::const_iterator previous = saved_items_.constFind(item.get());
+    if (previous != saved_items_.constEnd() && previous->item.lock() == item && occurrence < previous->ids.count()) {
+      ids << previous->ids[occurrence];
+      saved_positions << previous->positions[occurrence];
+      changed << !previous->metadata.IsSameData(saved_item.metadata);
+    }
+    else {
+      ids << -1;
+      saved_positions << -1;
+      changed << true;
+    }
+  }
+
+  // Rows of items which are no longer in the playlist, or not as many times as before.
+  for (QHash<const PlaylistItem*, SavedItem>::const_iterator it = saved_items_.constBegin(); it != saved_items_.constEnd(); ++it) {
+    qint64 kept = 0;
+    if (!it->item.expired() && saved_items.contains(it.key())) {
+      kept = saved_items[it.key()].ids.count();
+    }
+    for (qint64 i = kept; i < it->ids.count(); ++i) {
+      changes.removed_ids << it->ids[i];
+    }
+  }
+
+  for (SavedItem &saved_item : saved_items) {
+    saved_item.ids.clear();
+  }
+
+  const QList<qint64> positions = ItemPositions(saved_positions);
+  for (int row = 0; row < items_.count(); ++row) {
+    const PlaylistItemPtr &item = items_[row];
+    const int id = ids[row];
+    SavedItem &saved_item = saved_items[item.get()];
+    if (id == -1) {
+      pending_new_rows_ << qMakePair(static_cast<const PlaylistItem*>(item.get()), static_cast<int>(saved_item.ids.count()));
+    }
+    if (changed[row]) {
+      changes.rows << PlaylistBackend::PlaylistItemRow(id, positions[row], item);
+    }
+    else if (positions[row] != saved_positions[row]) {
+      changes.rows << PlaylistBackend::PlaylistItemRow(id, positions[row]);
+    }
+    saved_item.ids << id;
+    saved_item.positions << positions[row];
+  }
+
+  pending_saved_items_.swap(saved_items);
+  save_in_progress_ = true;
+
+  backend_->SavePlaylistAsync(id_, changes, last_played_row(), dynamic_playlist_);
+
+}
+
+void Playlist::PlaylistSaved(const int playlist, const QList<int> &new_ids) {
+
+  if (playlist != id_ || !save_in_progress_) return;
+
+  for (int i = 0; i < pending_new_rows_.count() && i < new_ids.count(); ++i) {
+    const QPair<const PlaylistItem*, int> &new_row = pending_new_rows_[i];
+    pending_saved_items_[new_row.first].ids[new_row.second] = new_ids[i];
+  }
+
+  saved_items_.swap(pending_saved_items_);
+  pending_saved_items_.clear();
+  pending_new_rows_.clear();
+  save_in_progress_ = false;
+
+  if (save_again_) {
+    save_again_ = false;
+    ScheduleSave();
+  }
+
+}
+
+void Playlist::PlaylistSaveFailed(const int playlist) {
+
+  if (playlist != id_ || !save_in_progress_) return;
+
+  // The rows in the database are unknown now, the next save writes the whole playlist again.
+  saved_items_.clear();
+  pending_saved_items_.clear();
+  pending_new_rows_.clear();
+  save_in_progress_ = false;
+
+  if (save_again_) {
+    save_again_ = false;
+    ScheduleSave();
+  }
+
+}
+
+QList<qint64> Playlist::ItemPositions(const QList<qint64> &saved_positions) {
+
+  const int count = static_cast<int>(saved_positions.count());
+
+  // Find the longest sequence of saved items which are still in order.
+  // tails holds the index of the last item of the best sequence found so far for each length.
+  QVector<int> tails;
+  QVector<int> previous(count, -1);
+  for (int i = 0; i < count; ++i) {
+    if (saved_positions[i] <= 0) continue;
+    QVector<int>::iterator it = std::lower_bound(tails.begin(), tails.end(), saved_positions[i], [&saved_positions](const int j, const qint64 position) { return saved_positions[j] < position; });
+    if (it != tails.begin()) previous[i] = *(it - 1);
+    if (it == tails.end()) {
+      tails << i;
+    }
+    else {
+      *it = i;
+    }
+  }
+
+  QVector<bool> keep(count, false);
+  for (int i = tails.isEmpty() ? -1 : tails.last(); i != -1; i = previous[i]) {
+    keep[i] = true;
+  }
+
+  // Spread the other items out between the ones that are kept.
+  QList<qint64> positions = saved_positions;
+  int first = 0;
+  while (first < count) {
+    if (keep[first]) {
+      ++first;
+      continue;
+    }
+    int last = first;
+    while (last < count && !keep[last]) ++last;
+    const qint64 low = first == 0 ? 0 : positions[first - 1];
+    qint64 step = kPositionStep;
+    if (last < count) {
+      step = (positions[last] - low) / (last - first + 1);
+      if (step == 0) {
+        // No room left between the items, renumber the whole playlist.
+        for (int i = 0; i < count; ++i) {
+          positions[i] = (i + 1) * kPositionStep;
+        }
+        return positions;
+      }
+    }
+    for (int i = first; i < last; ++i) {
+      positions[i] = low + (i - first + 1) * step;
+    }
+    first = last;
+  }
+
+  return positions;
 
 }
 
@@ -1498,45 +1782,130 @@ void Playlist::Restore() {
   items_.clear();
   virtual_items_.clear();
   collection_items_by_id_.clear();
+  saved_items_.clear();
+  pending_saved_items_.clear();
+  pending_new_rows_.clear();
+  save_in_progress_ = false;
+  save_again_ = false;
 
   cancel_restore_ = false;
+
+  // Nothing is saved until all pages are loaded.
+  is_loading_ = true;
+  restore_last_played_ = backend_->GetPlaylist(id_).last_played;
+  restore_last_played_set_ = false;
+  restore_count_ = 0;
+  restore_last_items_.clear();
+
+  RestorePage(-1, -1);
+
+}
+
+void Playlist::RestorePage(const qint64 after_position, const int after_id) {
+
 #if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
-  QFuture<PlaylistItemList> future = QtConcurrent::run(&PlaylistBackend::GetPlaylistItems, backend_, id_);
+  QFuture<PlaylistBackend::PlaylistItemPage> future = QtConcurrent::run(&PlaylistBackend::GetPlaylistItems, backend_, id_, after_position, after_id, kRestorePageSize);
 #else
-  QFuture<PlaylistItemList> future = QtConcurrent::run(backend_, &PlaylistBackend::GetPlaylistItems, id_);
+  QFuture<PlaylistBackend::PlaylistItemPage> future = QtConcurrent::run(backend_, &PlaylistBackend::GetPlaylistItems, id_, after_position, after_id, kRestorePageSize);
 #endif
-  QFutureWatcher<PlaylistItemList> *watcher = new QFutureWatcher<PlaylistItemList>();
-  QObject::connect(watcher, &QFutureWatcher<PlaylistItemList>::finished, this, &Playlist::ItemsLoaded);
+  QFutureWatcher<PlaylistBackend::PlaylistItemPage> *watcher = new QFutureWatcher<PlaylistBackend::PlaylistItemPage>();
+  QObject::connect(watcher, &QFutureWatcher<PlaylistBackend::PlaylistItemPage>::finished, this, &Playlist::ItemsLoaded);
   watcher->setFuture(future);
 
 }
 
 void Playlist::ItemsLoaded() {
 
-  QFutureWatcher<PlaylistItemList> *watcher = static_cast<QFutureWatcher<PlaylistItemList>*>(sender());
-  PlaylistItemList items = watcher->result();
+  QFutureWatcher<PlaylistBackend::PlaylistItemPage> *watcher = static_cast<QFutureWatcher<PlaylistBackend::PlaylistItemPage>*>(sender());
+  const PlaylistBackend::PlaylistItemPage page = watcher->result();
   watcher->deleteLater();
 
-  if (cancel_restore_) return;
+  PlaylistItemList items;
+  items.reserve(page.rows.count());
+  for (const PlaylistBackend::PlaylistItemRow &row : page.rows) {
+    // Remember the rows, also of the items that are not added, so they are removed by the next save.
+    SavedItem &saved_item = saved_items_[row.item.get()];
+    saved_item.item = row.item;
+    saved_item.metadata = row.metadata;
+    saved_item.ids << row.id;
+    saved_item.positions << row.position;
+
+    // The rest of the pages are still loaded after the restore is cancelled, so all their rows are removed.
+    if (cancel_restore_) continue;
+
+    // Backend returns empty elements for collection items which it couldn't match (because they got deleted); we don't need those
+    if (row.item->IsLocalCollectionItem() && row.item->Metadata().url().isEmpty()) continue;
+
+    items << row.item;
+  }
+
+  if (!items.isEmpty()) {
+    InsertRestoredItems(items);
+  }
+
+  if (page.rows_read == kRestorePageSize) {
+    RestorePage(page.last_position, page.last_id);
+  }
+  else {
+    AllItemsLoaded();
+  }
+
+}
 
-  // Backend returns empty elements for collection items which it couldn't match (because they got deleted); we don't need those
-  QMutableListIterator<PlaylistItemPtr> it(items);
-  while (it.hasNext()) {
-    PlaylistItemPtr item = it.next();
+void Playlist::InsertRestoredItems(const PlaylistItemList &items) {
 
-    if (item->IsLocalCollectionItem() && item->Metadata().url().isEmpty()) {
-      it.remove();
+  // Items might have been added, moved or removed while the playlist is restored.
+  // The page goes after the last item of the previous page which is still in the playlist, so added items stay after the restored ones.
+  int row = static_cast<int>(qMin(static_cast<qint64>(restore_count_), items_.count()));
+  if (!restore_last_items_.isEmpty()) {
+    QHash<const PlaylistItem*, int> rows;
+    rows.reserve(items_.count());
+    for (int i = 0; i < items_.count(); ++i) {
+      rows.insert(items_[i].get(), i);
+    }
+    for (int i = static_cast<int>(restore_last_items_.count()) - 1; i >= 0; --i) {
+      QHash<const PlaylistItem*, int>::const_iterator it = rows.constFind(restore_last_items_[i].get());
+      if (it != rows.constEnd()) {
+        row = it.value() + 1;
+        break;
+      }
     }
   }
 
-  is_loading_ = true;
-  InsertItems(items, 0);
+  const bool at_end = row == items_.count();
+  InsertItemsWithoutUndo(items, row);
+
+  // The undo commands of the changes made meanwhile refer to rows which were moved by this page.
+  if (!at_end) undo_stack_->clear();
+
+  // The last played row is counted in the saved playlist.
+  if (!restore_last_played_set_ && restore_last_played_ >= restore_count_ && restore_last_played_ < restore_count_ + items.count()) {
+    last_played_item_index_ = index(row + restore_last_played_ - restore_count_);
+    restore_last_played_set_ = true;
+  }
+
+  restore_count_ += static_cast<int>(items.count());
+  restore_last_items_ = items;
+
+}
+
+void Playlist::AllItemsLoaded() {
+
   is_loading_ = false;
+  restore_last_items_.clear();
 
-  PlaylistBackend::Playlist p = backend_->GetPlaylist(id_);
+  // Save the changes made while loading, and remove the rows of the items which were not added.
+  ScheduleSave();
 
-  // The newly loaded list of items might be shorter than it was before so look out for a bad last_played index
-  last_played_item_index_ = p.last_played == -1 || p.last_played >= rowCount() ? QModelIndex() : index(p.last_played);
+  if (cancel_restore_) return;
+
+  if (!restore_last_played_set_) {
+    // The newly loaded list of items might be shorter than it was before
+    last_played_item_index_ = QModelIndex();
+  }
+  emit RestoreFinished();
+
+  PlaylistBackend::Playlist p = backend_->GetPlaylist(id_);
 
   if (p.dynamic_type == PlaylistGenerator::Type_Query) {
     PlaylistGeneratorPtr gen = PlaylistGenerator::Create(p.dynamic_type);
@@ -1554,8 +1923,6 @@ void Playlist::ItemsLoaded() {
     }
   }
 
-  emit RestoreFinished();
-
   QSettings s;
   s.beginGroup(kSettingsGroup);
   bool greyout = s.value("greyout_songs_startup", true).toBool();
@@ -1570,10 +1937,70 @@ void Playlist::ItemsLoaded() {
 #endif
   }
 
+  // Reading the CUE sheets is left for last, until then the items have the metadata they were saved with.
+  // The worker only gets copies of the metadata, the items can be changed here meanwhile.
+  PlaylistItemList cue_items;
+  SongList cue_songs;
+  for (const PlaylistItemPtr &item : std::as_const(items_)) {
+    if (item->source() == Song::Source_LocalFile && item->Metadata().has_cue()) {
+      cue_items << item;
+      cue_songs << item->OriginalMetadata();
+    }
+  }
+  if (!cue_items.isEmpty()) {
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    QFuture<PlaylistItemList> future = QtConcurrent::run(&PlaylistBackend::RestoreItemsCueData, backend_, cue_songs);
+#else
+    QFuture<PlaylistItemList> future = QtConcurrent::run(backend_, &PlaylistBackend::RestoreItemsCueData, cue_songs);
+#endif
+    QFutureWatcher<PlaylistItemList> *watcher = new QFutureWatcher<PlaylistItemList>();
+    QObject::connect(watcher, &QFutureWatcher<PlaylistItemList>::finished, this, [this, watcher, cue_items]() {
+      CueDataRestored(cue_items, watcher->result());
+      watcher->deleteLater();
+    });
+    watcher->setFuture(future);
+  }
+
   emit PlaylistLoaded();
 
 }
 
+void Playlist::CueDataRestored(const PlaylistItemList &items, const PlaylistItemList &restored_items) {
+
+  QHash<const PlaylistItem*, PlaylistItemPtr> new_items;
+  for (int i = 0; i < items.count() && i < restored_items.count(); ++i) {
+    if (restored_items[i]) {
+      new_items.insert(items[i].get(), restored_items[i]);
+    }
+  }
+  if (new_items.isEmpty()) return;
+
+  // The items might have been moved or removed in the meantime
+  for (int row = 0; row < items_.count(); ++row) {
+    PlaylistItemPtr new_item = new_items.value(items_[row].get());
+    if (!new_item) continue;
+    // Keep the saved rows, so the new item is written to the same rows
+    if (saved_items_.contains(items_[row].get())) {
+      SavedItem saved_item = saved_items_.take(items_[row].get());
+      saved_item.item = new_item;
+      saved_items_.insert(new_item.get(), saved_item);
+    }
+    if (pending_saved_items_.contains(items_[row].get())) {
+      SavedItem saved_item = pending_saved_items_.take(items_[row].get());
+      saved_item.item = new_item;
+      pending_saved_items_.insert(new_item.get(), saved_item);
+      for (QPair<const PlaylistItem*, int> &new_row : pending_new_rows_) {
+        if (new_row.first == items_[row].get()) new_row.first = new_item.get();
+      }
+    }
+    items_[row] = new_item;
+    emit dataChanged(index(row, 0), index(row, ColumnCount - 1));
+  }
+
+  ScheduleSave();
+
+}
+
 static bool DescendingIntLessThan(int a, int b) { return a > b; }
 
 void Playlist::RemoveItemsWithoutUndo(const QList<int> &indicesIn) {
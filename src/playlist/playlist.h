@@ -24,6 +24,8 @@
 
 #include "config.h"
 
+#include <memory>
+
 #include <QtGlobal>
 #include <QObject>
 #include <QAbstractItemModel>
@@ -32,6 +34,8 @@
 #include <QFuture>
 #include <QList>
 #include <QMap>
+#include <QHash>
+#include <QPair>
 #include <QMultiMap>
 #include <QMetaType>
 #include <QVariant>
@@ -163,10 +167,18 @@ class Playlist : public QAbstractListModel {
   static const int kUndoStackSize;
   static const int kUndoItemLimit;
 
+  static const int kRestorePageSize;
+
   static const qint64 kMinScrobblePointNsecs;
   static const qint64 kMaxScrobblePointNsecs;
 
-  static bool CompareItems(const int column, const Qt::SortOrder order, PlaylistItemPtr a, PlaylistItemPtr b);
+  static const qint64 kPositionStep;
+
+  // Text columns are sorted by collation keys of the text, the other columns are compared by value.
+  static bool column_sorts_by_text(const int column);
+  static QString SortText(const int column, PlaylistItemPtr item, const Song &metadata);
+  // Compares a column which is not sorted by text, returns a negative value, 0 or a positive value.
+  static int CompareItems(const int column, const Song &a, const Song &b);
 
   static QString column_name(Column column);
   static QString abbreviated_column_name(Column column);
@@ -174,6 +186,10 @@ class Playlist : public QAbstractListModel {
   static bool column_is_editable(Playlist::Column column);
   static bool set_column_value(Song &song, Column column, const QVariant &value);
 
+  // Returns the positions to save the items with, given the positions they were saved with, or -1 for new items.
+  // The positions of the items which are still in order are kept, so only the new and moved items get a new position.
+  static QList<qint64> ItemPositions(const QList<qint64> &saved_positions);
+
   // Persistence
   void Restore();
   void ScheduleSaveAsync();
@@ -192,6 +208,8 @@ class Playlist : public QAbstractListModel {
   int last_played_row() const;
   void reset_last_played() { last_played_item_index_ = QPersistentModelIndex(); }
   int next_row(const bool ignore_repeat_track = false) const;
+  // The rows which will probably be played after the current one, queued items first.
+  QList<int> next_rows(const int count) const;
   int previous_row(const bool ignore_repeat_track = false) const;
 
   const QModelIndex current_index() const;
@@ -279,8 +297,6 @@ class Playlist : public QAbstractListModel {
   void sort(int column, Qt::SortOrder order) override;
   bool removeRows(int row, int count, const QModelIndex &parent = QModelIndex()) override;
 
-  static bool ComparePathDepths(Qt::SortOrder, PlaylistItemPtr, PlaylistItemPtr);
-
   void ItemChanged(PlaylistItemPtr item);
   void ItemChanged(const int row);
 
@@ -365,6 +381,11 @@ class Playlist : public QAbstractListModel {
   void TurnOnDynamicPlaylist(PlaylistGeneratorPtr gen);
   void InsertDynamicItems(const int count);
 
+  void RestorePage(const qint64 after_position, const int after_id);
+  void InsertRestoredItems(const PlaylistItemList &items);
+  void AllItemsLoaded();
+  void CueDataRestored(const PlaylistItemList &items, const PlaylistItemList &restored_items);
+
  private slots:
   void TracksAboutToBeDequeued(const QModelIndex&, const int begin, const int end);
   void TracksDequeued();
@@ -376,6 +397,8 @@ class Playlist : public QAbstractListModel {
   void SongInsertVetoListenerDestroyed();
   void ScheduleSave();
   void Save();
+  void PlaylistSaved(const int playlist, const QList<int> &new_ids);
+  void PlaylistSaveFailed(const int playlist);
 
  private:
   bool is_loading_;
@@ -394,6 +417,21 @@ class Playlist : public QAbstractListModel {
 
   PlaylistItemList items_;
 
+  // The rows of an item in the playlist_items table as they were last saved, one for each time the item is in the playlist.
+  struct SavedItem {
+    std::weak_ptr<PlaylistItem> item;
+    Song metadata;
+    QList<int> ids;
+    QList<qint64> positions;
+  };
+  QHash<const PlaylistItem*, SavedItem> saved_items_;
+  // The saved rows once the save in progress is written, they only replace saved_items_ when the backend reports success.
+  QHash<const PlaylistItem*, SavedItem> pending_saved_items_;
+  // Where the IDs of the new rows go in pending_saved_items_, in the order of the new rows in the save.
+  QList<QPair<const PlaylistItem*, int>> pending_new_rows_;
+  bool save_in_progress_;
+  bool save_again_;
+
   // Contains the indices into items_ in the order that they will be played.
   QList<int> virtual_items_;
 
@@ -423,6 +461,12 @@ class Playlist : public QAbstractListModel {
 
   // Cancel async restore if songs are already replaced
   bool cancel_restore_;
+  // The playlist is restored in pages, the last played item is set once its page is loaded.
+  int restore_last_played_;
+  bool restore_last_played_set_;
+  // The number of restored items, and the items of the last restored page.
+  int restore_count_;
+  PlaylistItemList restore_last_items_;
 
   bool scrobbled_;
   qint64 scrobble_point_;
@@ -27,6 +27,7 @@
 #include <QApplication>
 #include <QThread>
 #include <QMutex>
+#include <QVariant>
 #include <QIODevice>
 #include <QDir>
 #include <QFile>
@@ -63,6 +64,16 @@ PlaylistBackend::PlaylistBackend(Application *app, QObject *parent)
 
 }
 
+PlaylistBackend::PlaylistBackend(Database *db, QObject *parent)
+    : QObject(parent),
+      app_(nullptr),
+      db_(db),
+      original_thread_(nullptr) {
+
+  original_thread_ = thread();
+
+}
+
 void PlaylistBackend::Close() {
 
   if (db_) {
@@ -172,30 +183,45 @@ PlaylistBackend::Playlist PlaylistBackend::GetPlaylist(const int id) {
 
 }
 
-PlaylistItemList PlaylistBackend::GetPlaylistItems(const int playlist) {
+PlaylistBackend::PlaylistItemPage PlaylistBackend::GetPlaylistItems(const int playlist, const qint64 after_position, const int after_id, const int limit) {
 
-  PlaylistItemList playlistitems;
+  PlaylistItemPage page;
 
   {
 
     QMutexLocker l(db_->Mutex());
     QSqlDatabase db(db_->Connect());
 
-    QString query = "SELECT songs.ROWID, " + Song::JoinSpec("songs") + ", p.ROWID, " + Song::JoinSpec("p") + ", p.type FROM playlist_items AS p LEFT JOIN songs ON p.collection_id = songs.ROWID WHERE p.playlist = :playlist";
+    QString query = "SELECT songs.ROWID, " + Song::JoinSpec("songs") + ", p.ROWID, " + Song::JoinSpec("p") + ", p.type, p.position FROM playlist_items AS p LEFT JOIN songs ON p.collection_id = songs.ROWID WHERE p.playlist = :playlist AND (p.position > :after_position OR (p.position = :same_position AND p.ROWID > :after_id)) ORDER BY p.position, p.ROWID LIMIT :limit";
     SqlQuery q(db);
     // Forward iterations only may be faster
     q.setForwardOnly(true);
     q.prepare(query);
     q.BindValue(":playlist", playlist);
+    q.BindValue(":after_position", after_position);
+    q.BindValue(":same_position", after_position);
+    q.BindValue(":after_id", after_id);
+    q.BindValue(":limit", limit);
     if (!q.Exec()) {
       db_->ReportErrors(q);
-      return PlaylistItemList();
+      return PlaylistItemPage();
     }
 
-    // it's probable that we'll have a few songs associated with the same CUE, so we're caching results of parsing CUEs
-    std::shared_ptr<NewSongFromQueryState> state_ptr = std::make_shared<NewSongFromQueryState>();
+    // The song tables get joined first, plus one each for the song ROWIDs
+    const int id_row = static_cast<int>(Song::kColumns.count() + 1);
+    const int playlist_row = static_cast<int>(Song::kColumns.count() + 1) * kSongTableJoins;
+
     while (q.next()) {
-      playlistitems << NewPlaylistItemFromQuery(SqlRow(q), state_ptr);
+      SqlRow row(q);
+      PlaylistItemRow item_row(row.value(id_row).toInt(), row.value(playlist_row + 1).toLongLong());
+      ++page.rows_read;
+      page.last_position = item_row.position;
+      page.last_id = item_row.id;
+      item_row.item = PlaylistItem::NewFromSource(static_cast<Song::Source>(row.value(playlist_row).toInt()));
+      if (!item_row.item) continue;
+      item_row.item->InitFromQuery(row);
+      item_row.metadata = item_row.item->DatabaseMetadata();
+      page.rows << item_row;
     }
 
   }
@@ -204,7 +230,32 @@ PlaylistItemList PlaylistBackend::GetPlaylistItems(const int playlist) {
     Close();
   }
 
-  return playlistitems;
+  return page;
+
+}
+
+PlaylistItemList PlaylistBackend::RestoreItemsCueData(const SongList &songs) {
+
+  PlaylistItemList restored_items;
+  restored_items.reserve(songs.count());
+
+  // it's probable that we'll have a few songs associated with the same CUE, so we're caching results of parsing CUEs
+  std::shared_ptr<NewSongFromQueryState> state_ptr = std::make_shared<NewSongFromQueryState>();
+  for (const Song &song : songs) {
+    if (song.source() == Song::Source_LocalFile && song.has_cue()) {
+      PlaylistItemPtr restored_item = RestoreCueData(std::make_shared<SongPlaylistItem>(song), state_ptr);
+      restored_items << (restored_item->OriginalMetadata().IsSameData(song) ? PlaylistItemPtr() : restored_item);
+    }
+    else {
+      restored_items << PlaylistItemPtr();
+    }
+  }
+
+  if (QThread::currentThread() != thread() && QThread::currentThread() != qApp->thread()) {
+    Close();
+  }
+
+  return restored_items;
 
 }
 
@@ -216,7 +267,7 @@ SongList PlaylistBackend::GetPlaylistSongs(const int playlist) {
     QMutexLocker l(db_->Mutex());
     QSqlDatabase db(db_->Connect());
 
-    QString query = "SELECT songs.ROWID, " + Song::JoinSpec("songs") + ", p.ROWID, " + Song::JoinSpec("p") + ", p.type FROM playlist_items AS p LEFT JOIN songs ON p.collection_id = songs.ROWID WHERE p.playlist = :playlist";
+    QString query = "SELECT songs.ROWID, " + Song::JoinSpec("songs") + ", p.ROWID, " + Song::JoinSpec("p") + ", p.type FROM playlist_items AS p LEFT JOIN songs ON p.collection_id = songs.ROWID WHERE p.playlist = :playlist ORDER BY p.position, p.ROWID";
     SqlQuery q(db);
     // Forward iterations only may be faster
     q.setForwardOnly(true);
@@ -272,7 +323,7 @@ PlaylistItemPtr PlaylistBackend::RestoreCueData(PlaylistItemPtr item, std::share
   // We need collection to run a CueParser; also, this method applies only to file-type PlaylistItems
   if (item->source() != Song::Source_LocalFile) return item;
 
-  CueParser cue_parser(app_->collection_backend());
+  CueParser cue_parser(app_ ? app_->collection_backend() : nullptr);
 
   Song song = item->Metadata();
   // We're only interested in .cue songs here
@@ -316,42 +367,69 @@ PlaylistItemPtr PlaylistBackend::RestoreCueData(PlaylistItemPtr item, std::share
 
 }
 
-void PlaylistBackend::SavePlaylistAsync(int playlist, const PlaylistItemList &items, int last_played, PlaylistGeneratorPtr dynamic) {
+void PlaylistBackend::SavePlaylistAsync(int playlist, const PlaylistItemChanges &changes, int last_played, PlaylistGeneratorPtr dynamic) {
 
-  QMetaObject::invokeMethod(this, "SavePlaylist", Qt::QueuedConnection, Q_ARG(int, playlist), Q_ARG(PlaylistItemList, items), Q_ARG(int, last_played), Q_ARG(PlaylistGeneratorPtr, dynamic));
+  QMetaObject::invokeMethod(this, "SavePlaylist", Qt::QueuedConnection, Q_ARG(int, playlist), Q_ARG(PlaylistBackend::PlaylistItemChanges, changes), Q_ARG(int, last_played), Q_ARG(PlaylistGeneratorPtr, dynamic));
 
 }
 
-void PlaylistBackend::SavePlaylist(int playlist, const PlaylistItemList &items, int last_played, PlaylistGeneratorPtr dynamic) {
+void PlaylistBackend::SavePlaylist(int playlist, const PlaylistItemChanges &changes, int last_played, PlaylistGeneratorPtr dynamic) {
 
   QMutexLocker l(db_->Mutex());
   QSqlDatabase db(db_->Connect());
 
-  qLog(Debug) << "Saving playlist" << playlist;
+  qLog(Debug) << "Saving playlist" << playlist << "-" << changes.rows.count() << "changed and" << changes.removed_ids.count() << "removed items";
 
   ScopedTransaction transaction(&db);
 
-  // Clear the existing items in the playlist
-  {
+  // Remove all items when the playlist is written again from scratch
+  if (changes.rewrite) {
     SqlQuery q(db);
     q.prepare("DELETE FROM playlist_items WHERE playlist = :playlist");
     q.BindValue(":playlist", playlist);
     if (!q.Exec()) {
       db_->ReportErrors(q);
+      emit PlaylistSaveFailed(playlist);
       return;
     }
   }
 
-  // Save the new ones
-  for (PlaylistItemPtr item : items) {  // clazy:exclude=range-loop-reference
+  // Remove the items that are no longer in the playlist
+  if (!changes.removed_ids.isEmpty()) {
     SqlQuery q(db);
-    q.prepare("INSERT INTO playlist_items (playlist, type, collection_id, " + Song::kColumnSpec + ") VALUES (:playlist, :type, :collection_id, " + Song::kBindSpec + ")");
-    q.BindValue(":playlist", playlist);
-    item->BindToQuery(&q);
+    q.prepare("DELETE FROM playlist_items WHERE ROWID = :id");
+    for (const int id : changes.removed_ids) {
+      q.BindValue(":id", id);
+      if (!q.Exec()) {
+        db_->ReportErrors(q);
+        emit PlaylistSaveFailed(playlist);
+        return;
+      }
+    }
+  }
 
-    if (!q.Exec()) {
-      db_->ReportErrors(q);
-      return;
+  // Write new and changed items, and the new positions of moved items
+  QList<int> new_ids;
+  if (!changes.rows.isEmpty()) {
+    SqlQuery write_item(db);
+    write_item.prepare("INSERT OR REPLACE INTO playlist_items (ROWID, playlist, position, type, collection_id, " + Song::kColumnSpec + ") VALUES (:id, :playlist, :position, :type, :collection_id, " + Song::kBindSpec + ")");
+    SqlQuery move_item(db);
+    move_item.prepare("UPDATE playlist_items SET position = :position WHERE ROWID = :id");
+    for (const PlaylistItemRow &row : changes.rows) {
+      SqlQuery *q = row.item ? &write_item : &move_item;
+      // New rows get their ID from SQLite
+      q->BindValue(":id", row.id == -1 ? QVariant() : QVariant(row.id));
+      q->BindValue(":position", row.position);
+      if (row.item) {
+        q->BindValue(":playlist", playlist);
+        row.item->BindToQuery(q);
+      }
+      if (!q->Exec()) {
+        db_->ReportErrors(*q);
+        emit PlaylistSaveFailed(playlist);
+        return;
+      }
+      if (row.id == -1) new_ids << q->lastInsertId().toInt();
     }
   }
 
@@ -373,12 +451,15 @@ void PlaylistBackend::SavePlaylist(int playlist, const PlaylistItemList &items,
     q.BindValue(":playlist", playlist);
     if (!q.Exec()) {
       db_->ReportErrors(q);
+      emit PlaylistSaveFailed(playlist);
       return;
     }
   }
 
   transaction.Commit();
 
+  emit PlaylistSaved(playlist, new_ids);
+
 }
 
 int PlaylistBackend::CreatePlaylist(const QString &name, const QString &special_type) {
@@ -49,6 +49,7 @@ class PlaylistBackend : public QObject {
 
  public:
   Q_INVOKABLE explicit PlaylistBackend(Application *app, QObject *parent = nullptr);
+  explicit PlaylistBackend(Database *db, QObject *parent = nullptr);
 
   struct Playlist {
     Playlist() : id(-1), favorite(false), last_played(0) {}
@@ -65,6 +66,41 @@ class PlaylistBackend : public QObject {
   };
   using PlaylistList = QList<Playlist>;
 
+  // A playlist item and its row in the playlist_items table.
+  // Rows are ordered by position within a playlist, positions are spaced out so items can be moved without renumbering the others.
+  struct PlaylistItemRow {
+    PlaylistItemRow() : id(-1), position(0) {}
+    PlaylistItemRow(const int _id, const qint64 _position, PlaylistItemPtr _item = PlaylistItemPtr()) : id(_id), position(_position), item(_item) {}
+
+    int id;
+    qint64 position;
+    PlaylistItemPtr item;
+    // The metadata the row was loaded with, used to find out if the item needs to be saved again.
+    Song metadata;
+  };
+  using PlaylistItemRowList = QList<PlaylistItemRow>;
+
+  // A page of rows from the playlist_items table.
+  // rows_read and the position and ROWID of the last row also count the rows which could not be turned into an item, the next page starts after them.
+  struct PlaylistItemPage {
+    PlaylistItemPage() : rows_read(0), last_position(-1), last_id(-1) {}
+    PlaylistItemRowList rows;
+    int rows_read;
+    qint64 last_position;
+    int last_id;
+  };
+
+  // Changes to the rows of a playlist since it was last saved.
+  // Rows with an item are written with all columns, rows without an item only get a new position.
+  // Rows with ID -1 are new, their IDs are assigned when they are written and returned with PlaylistSaved().
+  // When rewrite is set, all rows of the playlist are deleted first.
+  struct PlaylistItemChanges {
+    PlaylistItemChanges() : rewrite(false) {}
+    bool rewrite;
+    QList<int> removed_ids;
+    PlaylistItemRowList rows;
+  };
+
   static const int kSongTableJoins;
 
   void Close();
@@ -75,14 +111,18 @@ class PlaylistBackend : public QObject {
   PlaylistList GetAllFavoritePlaylists();
   PlaylistBackend::Playlist GetPlaylist(const int id);
 
-  PlaylistItemList GetPlaylistItems(const int playlist);
+  // Returns at most limit items of a playlist which come after the given position and ROWID, or all items when limit is -1.
+  // CUE sheets are not read here, use RestoreCueData() for that.
+  PlaylistItemPage GetPlaylistItems(const int playlist, const qint64 after_position, const int after_id, const int limit);
+  // Returns new items with the metadata from the CUE sheets of the songs, or a null item where the metadata did not change.
+  PlaylistItemList RestoreItemsCueData(const SongList &songs);
   SongList GetPlaylistSongs(const int playlist);
 
   void SetPlaylistOrder(const QList<int> &ids);
   void SetPlaylistUiPath(const int id, const QString &path);
 
   int CreatePlaylist(const QString &name, const QString &special_type);
-  void SavePlaylistAsync(const int playlist, const PlaylistItemList &items, const int last_played, PlaylistGeneratorPtr dynamic);
+  void SavePlaylistAsync(const int playlist, const PlaylistItemChanges &changes, const int last_played, PlaylistGeneratorPtr dynamic);
   void RenamePlaylist(const int id, const QString &new_name);
   void FavoritePlaylist(const int id, bool is_favorite);
   void RemovePlaylist(const int id);
@@ -91,10 +131,13 @@ class PlaylistBackend : public QObject {
 
  public slots:
   void Exit();
-  void SavePlaylist(const int playlist, const PlaylistItemList &items, const int last_played, PlaylistGeneratorPtr dynamic);
+  void SavePlaylist(const int playlist, const PlaylistBackend::PlaylistItemChanges &changes, const int last_played, PlaylistGeneratorPtr dynamic);
 
  signals:
   void ExitFinished();
+  // The IDs of the new rows, in the order they were in the changes.
+  void PlaylistSaved(const int playlist, const QList<int> &new_ids);
+  void PlaylistSaveFailed(const int playlist);
 
  private:
   struct NewSongFromQueryState {
@@ -118,4 +161,6 @@ class PlaylistBackend : public QObject {
   QThread *original_thread_;
 };
 
+Q_DECLARE_METATYPE(PlaylistBackend::PlaylistItemChanges)
+
 #endif  // PLAYLISTBACKEND_H
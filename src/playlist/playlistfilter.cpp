@@ -21,7 +21,15 @@
 
 #include "config.h"
 
+#include <algorithm>
+#include <utility>
+#include <vector>
+
 #include <QObject>
+#include <QtConcurrentMap>
+#include <QList>
+#include <QVector>
+#include <QPair>
 #include <QString>
 #include <QAbstractItemModel>
 #include <QSortFilterProxyModel>
@@ -30,6 +38,8 @@
 #include "playlistfilter.h"
 #include "playlistfilterparser.h"
 
+const int PlaylistFilter::kChunkSize = 4096;
+
 PlaylistFilter::PlaylistFilter(QObject *parent)
     : QSortFilterProxyModel(parent),
       filter_tree_(new NopFilter),
@@ -66,38 +76,187 @@ PlaylistFilter::PlaylistFilter(QObject *parent)
                      << Playlist::Column_Bitdepth
                      << Playlist::Column_Bitrate;
 
+  const QList<int> columns = column_names_.values();
+  for (const int column : columns) {
+    if (!filter_columns_.contains(column)) filter_columns_ << column;
+  }
+
 }
 
 PlaylistFilter::~PlaylistFilter() = default;
 
+void PlaylistFilter::setSourceModel(QAbstractItemModel *source_model) {
+
+  if (sourceModel()) {
+    QObject::disconnect(sourceModel(), &QAbstractItemModel::rowsInserted, this, &PlaylistFilter::SourceRowsInserted);
+    QObject::disconnect(sourceModel(), &QAbstractItemModel::rowsRemoved, this, &PlaylistFilter::SourceRowsRemoved);
+    QObject::disconnect(sourceModel(), &QAbstractItemModel::dataChanged, this, &PlaylistFilter::SourceDataChanged);
+    QObject::disconnect(sourceModel(), &QAbstractItemModel::rowsMoved, this, &PlaylistFilter::SourceReset);
+    QObject::disconnect(sourceModel(), &QAbstractItemModel::layoutChanged, this, &PlaylistFilter::SourceReset);
+    QObject::disconnect(sourceModel(), &QAbstractItemModel::modelReset, this, &PlaylistFilter::SourceReset);
+  }
+
+  // Connect before QSortFilterProxyModel does, so the cached rows are updated before it filters the changed rows.
+  if (source_model) {
+    QObject::connect(source_model, &QAbstractItemModel::rowsInserted, this, &PlaylistFilter::SourceRowsInserted);
+    QObject::connect(source_model, &QAbstractItemModel::rowsRemoved, this, &PlaylistFilter::SourceRowsRemoved);
+    QObject::connect(source_model, &QAbstractItemModel::dataChanged, this, &PlaylistFilter::SourceDataChanged);
+    QObject::connect(source_model, &QAbstractItemModel::rowsMoved, this, &PlaylistFilter::SourceReset);
+    QObject::connect(source_model, &QAbstractItemModel::layoutChanged, this, &PlaylistFilter::SourceReset);
+    QObject::connect(source_model, &QAbstractItemModel::modelReset, this, &PlaylistFilter::SourceReset);
+  }
+
+  QSortFilterProxyModel::setSourceModel(source_model);
+
+  SourceReset();
+
+}
+
 void PlaylistFilter::sort(int column, Qt::SortOrder order) {
   // Pass this through to the Playlist, it does sorting itself
   sourceModel()->sort(column, order);
 }
 
-bool PlaylistFilter::filterAcceptsRow(int row, const QModelIndex &parent) const {
+void PlaylistFilter::UpdateFilterTree() const {
 
 #if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
   size_t hash = qHash(filter_text_);
 #else
   uint hash = qHash(filter_text_);
 #endif
-  if (hash != query_hash_) {
+  if (hash != query_hash_ || !filter_program_) {
     // Parse the query
     FilterParser p(filter_text_, column_names_, numerical_columns_);
     filter_tree_.reset(p.parse());
 
+    // And flatten it
+    filter_program_.reset(new FilterProgram(filter_columns_));
+    filter_tree_->compile(filter_program_.data());
+
     query_hash_ = hash;
+    accepted_rows_.clear();
+  }
+
+}
+
+bool PlaylistFilter::filterAcceptsRow(int row, const QModelIndex &parent) const {
+
+  Q_UNUSED(parent);
+
+  UpdateFilterTree();
+
+  if (filter_program_->accepts_all()) return true;
+
+  if (row >= 0 && static_cast<size_t>(row) < accepted_rows_.size()) {
+    return accepted_rows_[row] != 0;
   }
 
   // Test the row
-  return filter_tree_->accept(row, parent, sourceModel());
+  return filter_program_->Evaluate(CachedRow(row));
+
+}
+
+const FilterRow &PlaylistFilter::CachedRow(const int row) const {
+
+  if (row >= rows_.count()) {
+    rows_.resize(std::max(row + 1, sourceModel()->rowCount()));
+  }
+
+  FilterRow &values = rows_[row];
+  if (values.isEmpty()) {
+    values = FilterProgram::ReadRow(sourceModel(), row, QModelIndex(), filter_columns_);
+  }
+
+  return values;
+
+}
+
+void PlaylistFilter::FilterAllRows() {
+
+  accepted_rows_.clear();
+
+  if (!sourceModel() || filter_program_->accepts_all()) return;
+
+  const int row_count = sourceModel()->rowCount();
+
+  // Read the rows which are not cached yet first, the model can only be used from this thread.
+  for (int row = 0; row < row_count; ++row) {
+    CachedRow(row);
+  }
+
+  accepted_rows_.resize(static_cast<size_t>(row_count));
+
+  QList<QPair<int, int>> chunks;
+  for (int first = 0; first < row_count; first += kChunkSize) {
+    chunks << qMakePair(first, std::min(first + kChunkSize, row_count));
+  }
+
+  const FilterProgram *program = filter_program_.data();
+  const QVector<FilterRow> &rows = rows_;
+  std::vector<char> &accepted_rows = accepted_rows_;
+  auto filter_chunk = [program, &rows, &accepted_rows](const QPair<int, int> &chunk) {
+    for (int row = chunk.first; row < chunk.second; ++row) {
+      accepted_rows[static_cast<size_t>(row)] = program->Evaluate(rows[row]) ? 1 : 0;
+    }
+  };
+
+  if (chunks.count() > 1) {
+    QtConcurrent::blockingMap(chunks, filter_chunk);
+  }
+  else {
+    for (const QPair<int, int> &chunk : std::as_const(chunks)) {
+      filter_chunk(chunk);
+    }
+  }
 
 }
 
 void PlaylistFilter::SetFilterText(const QString &filter_text) {
 
   filter_text_ = filter_text;
+
+  UpdateFilterTree();
+  FilterAllRows();
+
   setFilterFixedString(filter_text);
 
 }
+
+void PlaylistFilter::SourceRowsInserted(const QModelIndex &parent, const int first, const int last) {
+
+  if (parent.isValid()) return;
+
+  if (first <= rows_.count()) {
+    rows_.insert(first, last - first + 1, FilterRow());
+  }
+  accepted_rows_.clear();
+
+}
+
+void PlaylistFilter::SourceRowsRemoved(const QModelIndex &parent, const int first, const int last) {
+
+  if (parent.isValid()) return;
+
+  if (first < rows_.count()) {
+    rows_.remove(first, std::min(last, static_cast<int>(rows_.count()) - 1) - first + 1);
+  }
+  accepted_rows_.clear();
+
+}
+
+void PlaylistFilter::SourceDataChanged(const QModelIndex &top_left, const QModelIndex &bottom_right) {
+
+  for (int row = top_left.row(); row <= bottom_right.row() && row < rows_.count(); ++row) {
+    rows_[row].clear();
+  }
+  accepted_rows_.clear();
+
+}
+
+void PlaylistFilter::SourceReset() {
+
+  rows_.clear();
+  if (sourceModel()) rows_.resize(sourceModel()->rowCount());
+  accepted_rows_.clear();
+
+}
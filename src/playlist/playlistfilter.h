@@ -24,15 +24,19 @@
 
 #include "config.h"
 
+#include <vector>
+
 #include <QtGlobal>
 #include <QObject>
+#include <QList>
+#include <QVector>
 #include <QMap>
 #include <QSet>
 #include <QScopedPointer>
 #include <QString>
 #include <QSortFilterProxyModel>
 
-class FilterTree;
+#include "playlistfilterparser.h"
 
 class PlaylistFilter : public QSortFilterProxyModel {
   Q_OBJECT
@@ -41,6 +45,11 @@ class PlaylistFilter : public QSortFilterProxyModel {
   explicit PlaylistFilter(QObject *parent = nullptr);
   ~PlaylistFilter() override;
 
+  static const int kChunkSize;
+
+  // QAbstractProxyModel
+  void setSourceModel(QAbstractItemModel *source_model) override;
+
   // QAbstractItemModel
   void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
 
@@ -52,9 +61,21 @@ class PlaylistFilter : public QSortFilterProxyModel {
 
   QString filter_text() const { return filter_text_; }
 
+ private slots:
+  void SourceRowsInserted(const QModelIndex &parent, const int first, const int last);
+  void SourceRowsRemoved(const QModelIndex &parent, const int first, const int last);
+  void SourceDataChanged(const QModelIndex &top_left, const QModelIndex &bottom_right);
+  void SourceReset();
+
+ private:
+  void UpdateFilterTree() const;
+  const FilterRow &CachedRow(const int row) const;
+  void FilterAllRows();
+
  private:
   // Mutable because they're modified from filterAcceptsRow() const
   mutable QScopedPointer<FilterTree> filter_tree_;
+  mutable QScopedPointer<FilterProgram> filter_program_;
 #if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
   mutable size_t query_hash_;
 #else
@@ -64,6 +85,15 @@ class PlaylistFilter : public QSortFilterProxyModel {
   QMap<QString, int> column_names_;
   QSet<int> numerical_columns_;
   QString filter_text_;
+
+  // The values of the filtered columns for each source row, read from the model the first time a row is filtered.
+  // Kept in sync with the source model, an empty row is not read yet.
+  QList<int> filter_columns_;
+  mutable QVector<FilterRow> rows_;
+
+  // Result for each source row from FilterAllRows(), until the rows change.
+  // Not std::vector<bool>, the rows are written from several threads.
+  mutable std::vector<char> accepted_rows_;
 };
 
 #endif  // PLAYLISTFILTER_H
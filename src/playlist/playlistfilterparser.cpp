@@ -24,6 +24,8 @@
 #include <cmath>
 
 #include <QList>
+#include <QVector>
+#include <QVarLengthArray>
 #include <QMap>
 #include <QSet>
 #include <QChar>
@@ -40,6 +42,8 @@ class SearchTermComparator {
   SearchTermComparator() = default;
   virtual ~SearchTermComparator() = default;
   virtual bool Matches(const QString &element) const = 0;
+  // Used by FilterProgram, the numerical comparators use the number instead of parsing the text again.
+  virtual bool MatchesValue(const FilterValue &value) const { return Matches(value.text); }
  private:
   Q_DISABLE_COPY(SearchTermComparator)
 };
@@ -123,6 +127,9 @@ class GtComparator : public SearchTermComparator {
   bool Matches(const QString &element) const override {
     return element.toInt() > search_term_;
   }
+  bool MatchesValue(const FilterValue &value) const override {
+    return value.number > search_term_;
+  }
  private:
   int search_term_;
 };
@@ -133,6 +140,9 @@ class GeComparator : public SearchTermComparator {
   bool Matches(const QString &element) const override {
     return element.toInt() >= search_term_;
   }
+  bool MatchesValue(const FilterValue &value) const override {
+    return value.number >= search_term_;
+  }
  private:
   int search_term_;
 };
@@ -143,6 +153,9 @@ class LtComparator : public SearchTermComparator {
   bool Matches(const QString &element) const override {
     return element.toInt() < search_term_;
   }
+  bool MatchesValue(const FilterValue &value) const override {
+    return value.number < search_term_;
+  }
  private:
   int search_term_;
 };
@@ -153,6 +166,9 @@ class LeComparator : public SearchTermComparator {
   bool Matches(const QString &element) const override {
     return element.toInt() <= search_term_;
   }
+  bool MatchesValue(const FilterValue &value) const override {
+    return value.number <= search_term_;
+  }
  private:
   int search_term_;
 };
@@ -172,6 +188,17 @@ class DropTailComparatorDecorator : public SearchTermComparator {
       return cmp_->Matches(element);
     }
   }
+  bool MatchesValue(const FilterValue &value) const override {
+    if (value.text.length() > 9) {
+      FilterValue tail_value;
+      tail_value.text = value.text.left(value.text.length() - 9);
+      tail_value.number = tail_value.text.toInt();
+      return cmp_->MatchesValue(tail_value);
+    }
+    else {
+      return cmp_->MatchesValue(value);
+    }
+  }
  private:
   QScopedPointer<SearchTermComparator> cmp_;
 };
@@ -182,6 +209,12 @@ class RatingComparatorDecorator : public SearchTermComparator {
   bool Matches(const QString &element) const override {
     return cmp_->Matches(QString::number(lround(element.toDouble() * 10.0)));
   }
+  bool MatchesValue(const FilterValue &value) const override {
+    FilterValue rating_value;
+    rating_value.text = QString::number(lround(value.text.toDouble() * 10.0));
+    rating_value.number = rating_value.text.toInt();
+    return cmp_->MatchesValue(rating_value);
+  }
  private:
   QScopedPointer<SearchTermComparator> cmp_;
 };
@@ -198,6 +231,7 @@ class FilterTerm : public FilterTree {
     }
     return false;
   }
+  void compile(FilterProgram *program) const override { program->AddTerm(columns_, cmp_.data()); }
   FilterType type() override { return Term; }
  private:
   QScopedPointer<SearchTermComparator> cmp_;
@@ -213,6 +247,7 @@ class FilterColumnTerm : public FilterTree {
     QModelIndex idx(model->index(row, col, parent));
     return cmp_->Matches(idx.data().toString().toLower());
   }
+  void compile(FilterProgram *program) const override { program->AddColumn(col, cmp_.data()); }
   FilterType type() override { return Column; }
  private:
   int col;
@@ -226,6 +261,10 @@ class NotFilter : public FilterTree {
   bool accept(int row, const QModelIndex &parent, const QAbstractItemModel *const model) const override {
     return !child_->accept(row, parent, model);
   }
+  void compile(FilterProgram *program) const override {
+    child_->compile(program);
+    program->AddNot();
+  }
   FilterType type() override { return Not; }
  private:
   QScopedPointer<const FilterTree> child_;
@@ -238,6 +277,12 @@ class OrFilter : public FilterTree {
   bool accept(int row, const QModelIndex &parent, const QAbstractItemModel *const model) const override {
     return std::any_of(children_.begin(), children_.end(), [row, parent, model](FilterTree *child) { return child->accept(row, parent, model); });
   }
+  void compile(FilterProgram *program) const override {
+    for (FilterTree *child : children_) {
+      child->compile(program);
+    }
+    program->AddOr(static_cast<int>(children_.count()));
+  }
   FilterType type() override { return Or; }
  private:
   QList<FilterTree*> children_;
@@ -250,11 +295,148 @@ class AndFilter : public FilterTree {
   bool accept(int row, const QModelIndex &parent, const QAbstractItemModel *const model) const override {
     return !std::any_of(children_.begin(), children_.end(), [row, parent, model](FilterTree *child) { return !child->accept(row, parent, model); });
   }
+  void compile(FilterProgram *program) const override {
+    for (FilterTree *child : children_) {
+      child->compile(program);
+    }
+    program->AddAnd(static_cast<int>(children_.count()));
+  }
   FilterType type() override { return And; }
  private:
   QList<FilterTree*> children_;
 };
 
+void NopFilter::compile(FilterProgram *program) const {
+  program->AddTrue();
+}
+
+FilterProgram::FilterProgram(const QList<int> &columns) : columns_(columns), max_depth_(0), depth_(0) {}
+
+void FilterProgram::Add(const Opcode opcode, const int argument, const int count, const SearchTermComparator *comparator) {
+
+  Instruction instruction;
+  instruction.opcode = opcode;
+  instruction.argument = argument;
+  instruction.count = count;
+  instruction.comparator = comparator;
+  instructions_ << instruction;
+
+  switch (opcode) {
+    case Op_True:
+    case Op_Column:
+    case Op_Term:
+      ++depth_;
+      break;
+    case Op_Not:
+      break;
+    case Op_And:
+    case Op_Or:
+      depth_ -= count - 1;
+      break;
+  }
+  max_depth_ = std::max(max_depth_, depth_);
+
+}
+
+void FilterProgram::AddTrue() {
+  Add(Op_True, 0);
+}
+
+void FilterProgram::AddColumn(const int column, const SearchTermComparator *comparator) {
+  Add(Op_Column, static_cast<int>(columns_.indexOf(column)), 0, comparator);
+}
+
+void FilterProgram::AddTerm(const QList<int> &columns, const SearchTermComparator *comparator) {
+
+  const int first = static_cast<int>(term_columns_.count());
+  QSet<int> added_columns;
+  for (const int column : columns) {
+    const int index = static_cast<int>(columns_.indexOf(column));
+    if (added_columns.contains(index)) continue;
+    added_columns << index;
+    term_columns_ << index;
+  }
+  Add(Op_Term, first, static_cast<int>(term_columns_.count()) - first, comparator);
+
+}
+
+void FilterProgram::AddNot() {
+  Add(Op_Not, 0);
+}
+
+void FilterProgram::AddAnd(const int count) {
+  Add(Op_And, 0, count);
+}
+
+void FilterProgram::AddOr(const int count) {
+  Add(Op_Or, 0, count);
+}
+
+bool FilterProgram::Evaluate(const FilterRow &row) const {
+
+  // Columns which are not in the row compare as empty.
+  const FilterValue empty_value;
+  auto value = [&row, &empty_value](const int index) -> const FilterValue& { return index >= 0 && index < row.count() ? row[index] : empty_value; };
+
+  QVarLengthArray<bool, 32> stack(std::max(max_depth_, 1));
+  int top = 0;
+  for (const Instruction &instruction : instructions_) {
+    switch (instruction.opcode) {
+      case Op_True:
+        stack[top++] = true;
+        break;
+      case Op_Column:
+        stack[top++] = instruction.comparator->MatchesValue(value(instruction.argument));
+        break;
+      case Op_Term:{
+        bool match = false;
+        for (int i = instruction.argument; i < instruction.argument + instruction.count && !match; ++i) {
+          match = instruction.comparator->MatchesValue(value(term_columns_[i]));
+        }
+        stack[top++] = match;
+        break;
+      }
+      case Op_Not:
+        stack[top - 1] = !stack[top - 1];
+        break;
+      case Op_And:{
+        bool match = true;
+        for (int i = top - instruction.count; i < top; ++i) {
+          match = match && stack[i];
+        }
+        top -= instruction.count;
+        stack[top++] = match;
+        break;
+      }
+      case Op_Or:{
+        bool match = false;
+        for (int i = top - instruction.count; i < top; ++i) {
+          match = match || stack[i];
+        }
+        top -= instruction.count;
+        stack[top++] = match;
+        break;
+      }
+    }
+  }
+
+  return top == 0 || stack[top - 1];
+
+}
+
+FilterRow FilterProgram::ReadRow(const QAbstractItemModel *model, const int row, const QModelIndex &parent, const QList<int> &columns) {
+
+  FilterRow values(static_cast<int>(columns.count()));
+  for (int i = 0; i < columns.count(); ++i) {
+    FilterValue &value = values[i];
+    value.text = model->index(row, columns[i], parent).data().toString().toLower();
+    value.number = value.text.toInt();
+  }
+
+  return values;
+
+}
+
 FilterParser::FilterParser(const QString &filter, const QMap<QString, int> &columns, const QSet<int> &numerical_cols) : iter_{}, end_{}, filterstring_(filter), columns_(columns), numerical_columns_(numerical_cols) {}
 
 FilterTree *FilterParser::parse() {
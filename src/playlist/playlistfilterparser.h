@@ -23,6 +23,8 @@
 
 #include "config.h"
 
+#include <QList>
+#include <QVector>
 #include <QSet>
 #include <QMap>
 #include <QString>
@@ -30,12 +32,27 @@
 class QAbstractItemModel;
 class QModelIndex;
 
+class SearchTermComparator;
+class FilterProgram;
+
+// A column value as the filter compares it, the lowered display text and the text as a number.
+struct FilterValue {
+  FilterValue() : number(0) {}
+  QString text;
+  int number;
+};
+
+// The values of the filtered columns of a row, in the order of the columns given to FilterProgram.
+using FilterRow = QVector<FilterValue>;
+
 // Structure for filter parse tree
 class FilterTree {
  public:
   FilterTree() = default;
   virtual ~FilterTree() {}
   virtual bool accept(int row, const QModelIndex &parent, const QAbstractItemModel *const model) const = 0;
+  // Appends the instructions for this node to the program.
+  virtual void compile(FilterProgram *program) const = 0;
   enum FilterType {
     Nop = 0,
     Or,
@@ -53,9 +70,64 @@ class FilterTree {
 class NopFilter : public FilterTree {
  public:
   bool accept(int row, const QModelIndex &parent, const QAbstractItemModel *const model) const override { Q_UNUSED(row); Q_UNUSED(parent); Q_UNUSED(model); return true; }
+  void compile(FilterProgram *program) const override;
   FilterType type() override { return Nop; }
 };
 
+// The filter tree flattened to a list of instructions in postfix order,
+// evaluated over the cached values of a row instead of the model data.
+// The program points to the comparators of the tree, so the tree must outlive it.
+// Evaluate() doesn't modify anything, so rows can be evaluated from several threads.
+class FilterProgram {
+ public:
+  explicit FilterProgram(const QList<int> &columns);
+
+  enum Opcode {
+    Op_True,
+    Op_Column,
+    Op_Term,
+    Op_Not,
+    Op_And,
+    Op_Or
+  };
+
+  const QList<int> &columns() const { return columns_; }
+
+  // True if the program accepts any row, ie.: for an empty filter.
+  bool accepts_all() const { return instructions_.count() == 1 && instructions_.first().opcode == Op_True; }
+
+  void AddTrue();
+  void AddColumn(const int column, const SearchTermComparator *comparator);
+  void AddTerm(const QList<int> &columns, const SearchTermComparator *comparator);
+  void AddNot();
+  void AddAnd(const int count);
+  void AddOr(const int count);
+
+  bool Evaluate(const FilterRow &row) const;
+
+  // Reads the values of the columns of a row from the model.
+  static FilterRow ReadRow(const QAbstractItemModel *model, const int row, const QModelIndex &parent, const QList<int> &columns);
+
+ private:
+  struct Instruction {
+    Opcode opcode;
+    // Index in the row for Op_Column, first index in term_columns_ for Op_Term.
+    int argument;
+    // Number of operands for Op_And and Op_Or, number of columns for Op_Term.
+    int count;
+    const SearchTermComparator *comparator;
+  };
+
+  void Add(const Opcode opcode, const int argument, const int count = 0, const SearchTermComparator *comparator = nullptr);
+
+  QList<int> columns_;
+  QVector<Instruction> instructions_;
+  // Indexes in the row of the columns of the Op_Term instructions.
+  QVector<int> term_columns_;
+  int max_depth_;
+  int depth_;
+};
+
 
 // A utility class to parse search filter strings into a decision tree
 // that can decide whether a playlist entry matches the filter.
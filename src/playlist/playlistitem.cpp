@@ -26,6 +26,9 @@
 #include <QtConcurrentRun>
 #include <QFuture>
 #include <QColor>
+#include <QString>
+#include <QCollator>
+#include <QCollatorSortKey>
 
 #include "core/sqlquery.h"
 #include "core/song.h"
@@ -174,3 +177,17 @@ bool PlaylistItem::HasCurrentForegroundColor() const {
 }
 void PlaylistItem::SetShouldSkip(const bool val) { should_skip_ = val; }
 bool PlaylistItem::GetShouldSkip() const { return should_skip_; }
+
+QCollatorSortKey PlaylistItem::SortKey(const int column, const QString &text, const QCollator &collator) {
+
+  QMap<int, CachedSortKey>::const_iterator it = sort_keys_.constFind(column);
+  if (it != sort_keys_.constEnd() && it.value().text == text) {
+    return it.value().key;
+  }
+
+  const QCollatorSortKey key = collator.sortKey(text.toLower());
+  sort_keys_.insert(column, CachedSortKey{ text, key });
+
+  return key;
+
+}
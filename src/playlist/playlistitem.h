@@ -35,6 +35,8 @@
 #include <QString>
 #include <QUrl>
 #include <QColor>
+#include <QCollator>
+#include <QCollatorSortKey>
 
 #include "core/song.h"
 
@@ -70,6 +72,10 @@ class PlaylistItem : public std::enable_shared_from_this<PlaylistItem> {
 
   virtual bool InitFromQuery(const SqlRow &query) = 0;
   void BindToQuery(SqlQuery *query) const;
+
+  // The metadata written to the database by BindToQuery().
+  // Any change to the metadata returns a song which no longer shares the data with a previous copy, see Song::IsSameData().
+  Song DatabaseMetadata() const { return DatabaseSongMetadata(); }
   virtual void Reload() {}
   QFuture<void> BackgroundReload();
 
@@ -112,6 +118,10 @@ class PlaylistItem : public std::enable_shared_from_this<PlaylistItem> {
   void SetShouldSkip(const bool val);
   bool GetShouldSkip() const;
 
+  // Collation key of the text for sorting a column.
+  // The key is kept until the item is sorted by the column with a different text, ie.: after the metadata changed.
+  QCollatorSortKey SortKey(const int column, const QString &text, const QCollator &collator);
+
  protected:
   bool should_skip_;
 
@@ -129,6 +139,13 @@ class PlaylistItem : public std::enable_shared_from_this<PlaylistItem> {
   QMap<short, QColor> background_colors_;
   QMap<short, QColor> foreground_colors_;
 
+ private:
+  struct CachedSortKey {
+    QString text;
+    QCollatorSortKey key;
+  };
+  QMap<int, CachedSortKey> sort_keys_;
+
   Q_DISABLE_COPY(PlaylistItem)
 };
 using PlaylistItemPtr = std::shared_ptr<PlaylistItem>;
@@ -38,6 +38,7 @@
 #include "core/application.h"
 #include "utilities/imageutils.h"
 #include "utilities/timeconstants.h"
+#include "internet/internetcollectionsync.h"
 #include "qobuzservice.h"
 #include "qobuzurlhandler.h"
 #include "qobuzbaserequest.h"
@@ -61,6 +62,7 @@ QobuzRequest::QobuzRequest(QobuzService *service, QobuzUrlHandler *url_handler,
       type_(type),
       query_id_(-1),
       finished_(false),
+      sync_(type == QueryType_Artists ? service->artists_collection_backend() : type == QueryType_Albums ? service->albums_collection_backend() : nullptr),
       artists_requests_total_(0),
       artists_requests_active_(0),
       artists_requests_received_(0),
@@ -196,7 +198,7 @@ void QobuzRequest::GetArtists() {
 
   emit UpdateStatus(query_id_, tr("Receiving artists..."));
   emit UpdateProgress(query_id_, 0);
-  AddArtistsRequest();
+  sync_.Load(this, [this]() { AddArtistsRequest(); });
 
 }
 
@@ -248,7 +250,7 @@ void QobuzRequest::GetAlbums() {
 
   emit UpdateStatus(query_id_, tr("Receiving albums..."));
   emit UpdateProgress(query_id_, 0);
-  AddAlbumsRequest();
+  sync_.Load(this, [this]() { AddAlbumsRequest(); });
 
 }
 
@@ -714,6 +716,7 @@ void QobuzRequest::AlbumsReceived(QNetworkReply *reply, const Artist &artist_req
       album.album_id = QString::number(obj_item["id"].toInt());
     }
     album.album = obj_item["title"].toString();
+    album.signature = InternetCollectionSync::AlbumSignature(obj_item, QStringList() << "title" << "tracks_count" << "media_count" << "duration" << "released_at");
 
     if (album_songs_requests_pending_.contains(album.album_id)) continue;
 
@@ -795,7 +798,15 @@ void QobuzRequest::AlbumsFinishCheck(const Artist &artist, const int limit, cons
 
     for (QHash<QString, AlbumSongsRequest>::iterator it = album_songs_requests_pending_.begin(); it != album_songs_requests_pending_.end(); ++it) {
       const AlbumSongsRequest &request = it.value();
-      AddAlbumSongsRequest(request.artist, request.album);
+      const SongList songs = sync_.UnchangedAlbumSongs(request.album.album_id, request.album.signature);
+      if (songs.isEmpty()) {
+        AddAlbumSongsRequest(request.artist, request.album);
+        continue;
+      }
+      for (const Song &song : songs) {
+        songs_.insert(song.song_id(), song);
+      }
+      sync_.AlbumSynced(request.album.album_id, request.album.signature);
     }
     album_songs_requests_pending_.clear();
 
@@ -1017,6 +1028,10 @@ void QobuzRequest::SongsReceived(QNetworkReply *reply, const Artist &artist_requ
     emit UpdateProgress(query_id_, GetProgress(songs_received_, songs_total_));
   }
 
+  if (!album_requested.album_id.isEmpty() && offset_requested + songs_received >= songs_total) {
+    sync_.AlbumSynced(album_requested.album_id, album_requested.signature);
+  }
+
   SongsFinishCheck(album_artist, album, limit_requested, offset_requested, songs_total, songs_received);
 
 }
@@ -1255,7 +1270,8 @@ void QobuzRequest::GetAlbumCovers() {
 void QobuzRequest::AddAlbumCoverRequest(const Song &song) {
 
   QUrl cover_url = song.art_automatic();
-  if (!cover_url.isValid()) return;
+  // Songs of unchanged albums have the cover from the previous sync.
+  if (!cover_url.isValid() || cover_url.isLocalFile()) return;
 
   if (album_covers_requests_sent_.contains(cover_url)) {
     album_covers_requests_sent_.insert(cover_url, song.song_id());
@@ -1409,6 +1425,8 @@ void QobuzRequest::FinishCheck() {
       timer_flush_requests_->stop();
     }
     finished_ = true;
+    // Only a complete sync is remembered, otherwise the next sync compares against the previous one again.
+    if (IsQuery() && errors_.isEmpty()) sync_.Save();
     if (no_results_ && songs_.isEmpty()) {
       if (IsSearch())
         emit Results(query_id_, SongMap(), tr("No match."));
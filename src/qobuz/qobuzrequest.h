@@ -38,6 +38,7 @@
 #include <QJsonObject>
 
 #include "core/song.h"
+#include "internet/internetcollectionsync.h"
 #include "qobuzbaserequest.h"
 
 class QNetworkReply;
@@ -71,6 +72,7 @@ class QobuzRequest : public QobuzBaseRequest {
     QString album;
     QUrl cover_url;
     bool album_explicit;
+    QString signature;
   };
   struct Request {
     Request() : offset(0), limit(0) {}
@@ -190,6 +192,8 @@ class QobuzRequest : public QobuzBaseRequest {
 
   bool finished_;
 
+  InternetCollectionSync sync_;
+
   QQueue<Request> artists_requests_queue_;
   QQueue<Request> albums_requests_queue_;
   QQueue<Request> songs_requests_queue_;
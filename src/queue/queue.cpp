@@ -28,6 +28,7 @@
 #include <QDataStream>
 #include <QBuffer>
 #include <QList>
+#include <QHash>
 #include <QVariant>
 #include <QString>
 #include <QStringList>
@@ -41,7 +42,7 @@
 
 const char *Queue::kRowsMimetype = "application/x-strawberry-queue-rows";
 
-Queue::Queue(Playlist *playlist, QObject *parent) : QAbstractProxyModel(parent), playlist_(playlist), total_length_ns_(0) {
+Queue::Queue(Playlist *playlist, QObject *parent) : QAbstractProxyModel(parent), source_row_positions_dirty_(false), playlist_(playlist), total_length_ns_(0) {
 
   signal_item_count_changed_ = QObject::connect(this, &Queue::ItemCountChanged, this, &Queue::UpdateTotalLength);
   QObject::connect(this, &Queue::TotalLengthChanged, this, &Queue::UpdateSummaryText);
@@ -54,23 +55,51 @@ QModelIndex Queue::mapFromSource(const QModelIndex &source_index) const {
 
   if (!source_index.isValid()) return QModelIndex();
 
-  const int source_row = source_index.row();
-  for (int i = 0; i < source_indexes_.count(); ++i) {
-    if (source_indexes_[i].row() == source_row) {
-      return index(i, source_index.column());
-    }
-  }
-  return QModelIndex();
+  const int position = SourceRowPosition(source_index.row());
+  if (position == -1) return QModelIndex();
+
+  return index(position, source_index.column());
 
 }
 
 bool Queue::ContainsSourceRow(const int source_row) const {
 
+  return SourceRowPosition(source_row) != -1;
+
+}
+
+int Queue::SourceRowPosition(const int source_row) const {
+
+  if (source_row_positions_dirty_) UpdateSourceRowPositions();
+
+  int position = source_row_positions_.value(source_row, -1);
+
+  // The source model moves the persistent indexes before we're told, so check it's still there.
+  if (position != -1 && (position >= source_indexes_.count() || source_indexes_[position].row() != source_row)) {
+    UpdateSourceRowPositions();
+    position = source_row_positions_.value(source_row, -1);
+  }
+
+  return position;
+
+}
+
+void Queue::UpdateSourceRowPositions() const {
+
+  source_row_positions_.clear();
+  source_row_positions_.reserve(static_cast<int>(source_indexes_.count()));
   for (int i = 0; i < source_indexes_.count(); ++i) {
-    if (source_indexes_[i].row() == source_row) return true;
+    const int source_row = source_indexes_[i].row();
+    if (source_row != -1 && !source_row_positions_.contains(source_row)) {
+      source_row_positions_.insert(source_row, i);
+    }
   }
-  return false;
+  source_row_positions_dirty_ = false;
+
+}
 
+void Queue::InvalidateSourceRowPositions() {
+  source_row_positions_dirty_ = true;
 }
 
 QModelIndex Queue::mapToSource(const QModelIndex &proxy_index) const {
@@ -87,6 +116,9 @@ void Queue::setSourceModel(QAbstractItemModel *source_model) {
     QObject::disconnect(sourceModel(), &QAbstractItemModel::dataChanged, this, &Queue::SourceDataChanged);
     QObject::disconnect(sourceModel(), &QAbstractItemModel::rowsRemoved, this, &Queue::SourceLayoutChanged);
     QObject::disconnect(sourceModel(), &QAbstractItemModel::layoutChanged, this, &Queue::SourceLayoutChanged);
+    QObject::disconnect(sourceModel(), &QAbstractItemModel::rowsInserted, this, &Queue::InvalidateSourceRowPositions);
+    QObject::disconnect(sourceModel(), &QAbstractItemModel::rowsMoved, this, &Queue::InvalidateSourceRowPositions);
+    QObject::disconnect(sourceModel(), &QAbstractItemModel::modelReset, this, &Queue::InvalidateSourceRowPositions);
   }
 
   QAbstractProxyModel::setSourceModel(source_model);
@@ -94,6 +126,11 @@ void Queue::setSourceModel(QAbstractItemModel *source_model) {
   QObject::connect(sourceModel(), &QAbstractItemModel::dataChanged, this, &Queue::SourceDataChanged);
   QObject::connect(sourceModel(), &QAbstractItemModel::rowsRemoved, this, &Queue::SourceLayoutChanged);
   QObject::connect(sourceModel(), &QAbstractItemModel::layoutChanged, this, &Queue::SourceLayoutChanged);
+  QObject::connect(sourceModel(), &QAbstractItemModel::rowsInserted, this, &Queue::InvalidateSourceRowPositions);
+  QObject::connect(sourceModel(), &QAbstractItemModel::rowsMoved, this, &Queue::InvalidateSourceRowPositions);
+  QObject::connect(sourceModel(), &QAbstractItemModel::modelReset, this, &Queue::InvalidateSourceRowPositions);
+
+  InvalidateSourceRowPositions();
 
 }
 
@@ -111,6 +148,8 @@ void Queue::SourceDataChanged(const QModelIndex &top_left, const QModelIndex &bo
 
 void Queue::SourceLayoutChanged() {
 
+  InvalidateSourceRowPositions();
+
   QObject::disconnect(signal_item_count_changed_);
 
   for (int i = 0; i < source_indexes_.count(); ++i) {
@@ -176,6 +215,7 @@ void Queue::ToggleTracks(const QModelIndexList &source_indexes) {
       const int row = proxy_index.row();
       beginRemoveRows(QModelIndex(), row, row);
       source_indexes_.removeAt(row);
+      InvalidateSourceRowPositions();
       endRemoveRows();
     }
     else {
@@ -183,6 +223,7 @@ void Queue::ToggleTracks(const QModelIndexList &source_indexes) {
       const int row = static_cast<int>(source_indexes_.count());
       beginInsertRows(QModelIndex(), row, row);
       source_indexes_ << QPersistentModelIndex(source_index);
+      if (!source_row_positions_dirty_ && !source_row_positions_.contains(source_index.row())) source_row_positions_.insert(source_index.row(), row);
       endInsertRows();
     }
   }
@@ -198,6 +239,7 @@ void Queue::InsertFirst(const QModelIndexList &source_indexes) {
       const int row = proxy_index.row();
       beginRemoveRows(QModelIndex(), row, row);
       source_indexes_.removeAt(row);
+      InvalidateSourceRowPositions();
       endRemoveRows();
     }
   }
@@ -210,6 +252,7 @@ void Queue::InsertFirst(const QModelIndexList &source_indexes) {
     source_indexes_.insert(offset, QPersistentModelIndex(source_index));
     offset++;
   }
+  InvalidateSourceRowPositions();
   endInsertRows();
 
 }
@@ -265,6 +308,7 @@ void Queue::Clear() {
 
   beginRemoveRows(QModelIndex(), 0, static_cast<int>(source_indexes_.count() - 1));
   source_indexes_.clear();
+  InvalidateSourceRowPositions();
   endRemoveRows();
 
 }
@@ -288,6 +332,7 @@ void Queue::Move(const QList<int> &proxy_rows, int pos) {
   for (int i = start; i < start + moved_items.count(); ++i) {
     source_indexes_.insert(i, moved_items[i - start]);
   }
+  InvalidateSourceRowPositions();
 
   // Update persistent indexes
   for (const QModelIndex &pidx : persistentIndexList()) {
@@ -394,6 +439,7 @@ bool Queue::dropMimeData(const QMimeData *data, Qt::DropAction action, int row,
       for (int i = 0; i < source_indexes.count(); ++i) {
         source_indexes_.insert(insert_point + i, source_indexes[i]);
       }
+      InvalidateSourceRowPositions();
       endInsertRows();
     }
   }
@@ -430,6 +476,7 @@ int Queue::TakeNext() {
 
   beginRemoveRows(QModelIndex(), 0, 0);
   int ret = source_indexes_.takeFirst().row();
+  InvalidateSourceRowPositions();
   endRemoveRows();
 
   return ret;
@@ -457,6 +504,7 @@ void Queue::Remove(QList<int> &proxy_rows) {
     const int real_row = row - removed_rows;
     beginRemoveRows(QModelIndex(), real_row, real_row);
     source_indexes_.removeAt(real_row);
+    InvalidateSourceRowPositions();
     endRemoveRows();
     removed_rows++;
   }
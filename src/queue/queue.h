@@ -28,6 +28,7 @@
 #include <QAbstractItemModel>
 #include <QAbstractProxyModel>
 #include <QList>
+#include <QHash>
 #include <QVariant>
 #include <QString>
 #include <QStringList>
@@ -91,9 +92,17 @@ class Queue : public QAbstractProxyModel {
   void SourceDataChanged(const QModelIndex &top_left, const QModelIndex &bottom_right);
   void SourceLayoutChanged();
   void UpdateTotalLength();
+  void InvalidateSourceRowPositions();
+
+ private:
+  int SourceRowPosition(const int source_row) const;
+  void UpdateSourceRowPositions() const;
 
  private:
   QList<QPersistentModelIndex> source_indexes_;
+  // Source row to queue position, rebuilt on the next lookup after the queue or the source rows changed.
+  mutable QHash<int, int> source_row_positions_;
+  mutable bool source_row_positions_dirty_;
   const Playlist *playlist_;
   quint64 total_length_ns_;
   QMetaObject::Connection signal_item_count_changed_;
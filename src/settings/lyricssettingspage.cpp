@@ -28,6 +28,7 @@
 #include <QStringList>
 #include <QPalette>
 #include <QSettings>
+#include <QCheckBox>
 #include <QGroupBox>
 #include <QPushButton>
 #include <QListWidget>
@@ -87,6 +88,11 @@ void LyricsSettingsPage::Load() {
     item->setForeground(provider->is_enabled() ? palette().color(QPalette::Active, QPalette::Text) : palette().color(QPalette::Disabled, QPalette::Text));
   }
 
+  QSettings s;
+  s.beginGroup(kSettingsGroup);
+  ui_->offline->setChecked(s.value("offline", false).toBool());
+  s.endGroup();
+
   Init(ui_->layout_lyricssettingspage->parentWidget());
 
   if (!QSettings().childGroups().contains(kSettingsGroup)) set_changed();
@@ -104,6 +110,7 @@ void LyricsSettingsPage::Save() {
   QSettings s;
   s.beginGroup(kSettingsGroup);
   s.setValue("providers", providers);
+  s.setValue("offline", ui_->offline->isChecked());
   s.endGroup();
 
 }
@@ -52,7 +52,7 @@ class PlaylistGenerator : public QObject, public std::enable_shared_from_this<Pl
   static std::shared_ptr<PlaylistGenerator> Create(const Type type = Type_Query);
 
   // Should be called before Load on a new PlaylistGenerator
-  void set_collection(CollectionBackend *backend) { backend_ = backend; }
+  virtual void set_collection(CollectionBackend *backend) { backend_ = backend; }
   void set_name(const QString &name) { name_ = name; }
   CollectionBackend *collection() const { return backend_; }
   QString name() const { return name_; }
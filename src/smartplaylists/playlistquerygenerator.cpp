@@ -20,6 +20,9 @@
 
 #include "config.h"
 
+#include <QList>
+#include <QHash>
+#include <QSet>
 #include <QIODevice>
 #include <QDataStream>
 #include <QByteArray>
@@ -28,23 +31,57 @@
 #include "playlistquerygenerator.h"
 #include "collection/collectionbackend.h"
 
-PlaylistQueryGenerator::PlaylistQueryGenerator(QObject *parent) : PlaylistGenerator(parent), dynamic_(false), current_pos_(0) {}
+PlaylistQueryGenerator::PlaylistQueryGenerator(QObject *parent) : PlaylistGenerator(parent), dynamic_(false), current_pos_(0), sampler_dirty_(true) {}
 
 PlaylistQueryGenerator::PlaylistQueryGenerator(const QString &name, const SmartPlaylistSearch &search, const bool dynamic, QObject *parent)
     : PlaylistGenerator(parent),
       search_(search),
       dynamic_(dynamic),
-      current_pos_(0) {
+      current_pos_(0),
+      sampler_dirty_(true) {
 
   set_name(name);
 
 }
 
+void PlaylistQueryGenerator::set_collection(CollectionBackend *backend) {
+
+  if (backend_) {
+    QObject::disconnect(backend_, nullptr, this, nullptr);
+  }
+
+  PlaylistGenerator::set_collection(backend);
+  sampler_dirty_ = true;
+
+  if (backend_) {
+    QObject::connect(backend_, &CollectionBackend::SongsDiscovered, this, &PlaylistQueryGenerator::CollectionChanged);
+    QObject::connect(backend_, &CollectionBackend::SongsDeleted, this, &PlaylistQueryGenerator::CollectionChanged);
+    QObject::connect(backend_, &CollectionBackend::DatabaseReset, this, &PlaylistQueryGenerator::CollectionChanged);
+    QObject::connect(backend_, &CollectionBackend::SongsStatisticsChanged, this, &PlaylistQueryGenerator::StatisticsChanged);
+    QObject::connect(backend_, &CollectionBackend::SongsRatingChanged, this, &PlaylistQueryGenerator::StatisticsChanged);
+  }
+
+}
+
+void PlaylistQueryGenerator::CollectionChanged() {
+  sampler_dirty_ = true;
+}
+
+void PlaylistQueryGenerator::StatisticsChanged() {
+
+  // The weights of weighted random playlists are allowed to get a bit out of date, reloading them on every played song would defeat the point of the sampler.
+  if (search_.uses_statistics()) {
+    sampler_dirty_ = true;
+  }
+
+}
+
 void PlaylistQueryGenerator::Load(const SmartPlaylistSearch &search) {
 
   search_ = search;
   dynamic_ = false;
   current_pos_ = 0;
+  sampler_dirty_ = true;
 
 }
 
@@ -53,6 +90,7 @@ void PlaylistQueryGenerator::Load(const QByteArray &data) {
   QDataStream s(data);
   s >> search_;
   s >> dynamic_;
+  sampler_dirty_ = true;
 
 }
 
@@ -83,12 +121,20 @@ PlaylistItemList PlaylistQueryGenerator::GenerateMore(const int count) {
     search_copy.limit_ = count;
   }
 
-  if (search_copy.sort_type_ != SmartPlaylistSearch::Sort_Random) {
+  if (!search_copy.is_random()) {
     search_copy.first_item_ = current_pos_;
     current_pos_ += search_copy.limit_;
   }
 
-  SongList songs = backend_->SmartPlaylistsFindSongs(search_copy);
+  // Random songs are drawn from the cached matching songs instead of sorting all of them in the database every time.
+  // Without a limit, all matching songs are loaded anyway so the database sorts them unless they're weighted.
+  SongList songs;
+  if (search_copy.is_random() && (search_copy.limit_ != -1 || search_copy.sort_type_ == SmartPlaylistSearch::Sort_WeightedRandom)) {
+    songs = SampleSongs(search_copy.limit_);
+  }
+  else {
+    songs = backend_->SmartPlaylistsFindSongs(search_copy);
+  }
   PlaylistItemList items;
   items.reserve(songs.count());
   for (const Song &song : songs) {
@@ -103,3 +149,35 @@ PlaylistItemList PlaylistQueryGenerator::GenerateMore(const int count) {
   return items;
 
 }
+
+SongList PlaylistQueryGenerator::SampleSongs(const int count) {
+
+  if (sampler_dirty_.exchange(false)) {
+    sampler_.SetCandidates(backend_->SmartPlaylistsFindCandidates(search_), search_.sort_type_ == SmartPlaylistSearch::Sort_WeightedRandom);
+  }
+
+  QSet<int> excluded_ids;
+  excluded_ids.reserve(previous_ids_.count());
+  for (const int id : previous_ids_) {
+    excluded_ids.insert(id);
+  }
+
+  const QList<int> ids = sampler_.Sample(count == -1 ? sampler_.count() : count, excluded_ids);
+  if (ids.isEmpty()) return SongList();
+
+  // Keep the songs in the order they were drawn.
+  QHash<int, Song> songs_by_id;
+  const SongList songs = backend_->GetSongsById(ids);
+  for (const Song &song : songs) {
+    songs_by_id.insert(song.id(), song);
+  }
+
+  SongList ret;
+  ret.reserve(ids.count());
+  for (const int id : ids) {
+    if (songs_by_id.contains(id)) ret << songs_by_id[id];
+  }
+
+  return ret;
+
+}
@@ -23,12 +23,16 @@
 
 #include "config.h"
 
+#include <atomic>
+
 #include <QList>
 #include <QByteArray>
 #include <QString>
 
+#include "core/song.h"
 #include "playlistgenerator.h"
 #include "smartplaylistsearch.h"
+#include "smartplaylistsampler.h"
 
 class PlaylistQueryGenerator : public PlaylistGenerator {
   Q_OBJECT
@@ -39,6 +43,8 @@ class PlaylistQueryGenerator : public PlaylistGenerator {
 
   Type type() const override { return Type_Query; }
 
+  void set_collection(CollectionBackend *backend) override;
+
   void Load(const SmartPlaylistSearch &search);
   void Load(const QByteArray &data) override;
   QByteArray Save() const override;
@@ -51,6 +57,13 @@ class PlaylistQueryGenerator : public PlaylistGenerator {
   SmartPlaylistSearch search() const { return search_; }
   int GetDynamicFuture() override { return search_.limit_; }
 
+ private:
+  SongList SampleSongs(const int count);
+
+ private slots:
+  void CollectionChanged();
+  void StatisticsChanged();
+
  private:
   SmartPlaylistSearch search_;
   bool dynamic_;
@@ -58,6 +71,10 @@ class PlaylistQueryGenerator : public PlaylistGenerator {
   QList<int> previous_ids_;
   int current_pos_;
 
+  // Songs matching the search for random playlists, reloaded when the collection changes.
+  SmartPlaylistSampler sampler_;
+  std::atomic<bool> sampler_dirty_;
+
 };
 
 #endif  // PLAYLISTQUERYGENERATOR_H
@@ -151,6 +151,7 @@ int SmartPlaylistQueryWizardPlugin::CreatePages(QWizard *wizard, int finish_page
   QObject::connect(sort_ui_->limit_value, QOverload<int>::of(&QSpinBox::valueChanged), this, &SmartPlaylistQueryWizardPlugin::UpdateSortPreview);
   QObject::connect(sort_ui_->order, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &SmartPlaylistQueryWizardPlugin::UpdateSortPreview);
   QObject::connect(sort_ui_->random, &QRadioButton::toggled, this, &SmartPlaylistQueryWizardPlugin::UpdateSortPreview);
+  QObject::connect(sort_ui_->weighted_random, &QRadioButton::toggled, this, &SmartPlaylistQueryWizardPlugin::UpdateSortPreview);
 
   // Configure the page text
   search_page_->setTitle(tr("Search terms"));
@@ -187,6 +188,9 @@ void SmartPlaylistQueryWizardPlugin::SetGenerator(PlaylistGeneratorPtr g) {
   if (search.sort_type_ == SmartPlaylistSearch::Sort_Random) {
     sort_ui_->random->setChecked(true);
   }
+  else if (search.sort_type_ == SmartPlaylistSearch::Sort_WeightedRandom) {
+    sort_ui_->weighted_random->setChecked(true);
+  }
   else {
     sort_ui_->field->setChecked(true);
     sort_ui_->order->setCurrentIndex(search.sort_type_ == SmartPlaylistSearch::Sort_FieldAsc ? 0 : 1);
@@ -294,6 +298,9 @@ SmartPlaylistSearch SmartPlaylistQueryWizardPlugin::MakeSearch() const {
   if (sort_ui_->random->isChecked()) {
     ret.sort_type_ = SmartPlaylistSearch::Sort_Random;
   }
+  else if (sort_ui_->weighted_random->isChecked()) {
+    ret.sort_type_ = SmartPlaylistSearch::Sort_WeightedRandom;
+  }
   else {
     const bool ascending = sort_ui_->order->currentIndex() == 0;
     ret.sort_type_ = ascending ? SmartPlaylistSearch::Sort_FieldAsc : SmartPlaylistSearch::Sort_FieldDesc;
@@ -0,0 +1,184 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2021, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <cmath>
+#include <random>
+#include <algorithm>
+#include <utility>
+
+#include <QtGlobal>
+#include <QList>
+#include <QVector>
+#include <QSet>
+
+#include "smartplaylistsampler.h"
+
+SmartPlaylistSampler::SmartPlaylistSampler() : weighted_(false), generator_(std::random_device()()) {}
+
+double SmartPlaylistSampler::Weight(const Candidate &candidate) {
+
+  // Unrated songs count as 0 stars, a 5 star song is picked 5 times as often as a song without rating or plays.
+  return 1.0 + 4.0 * qBound(0.0, static_cast<double>(candidate.rating), 1.0) + std::log1p(static_cast<double>(qMax(0, candidate.playcount)));
+
+}
+
+void SmartPlaylistSampler::SetCandidates(const CandidateList &candidates, const bool weighted) {
+
+  Clear();
+
+  weighted_ = weighted;
+  ids_.reserve(candidates.count());
+  for (const Candidate &candidate : candidates) {
+    ids_ << candidate.id;
+  }
+  if (!weighted_ || ids_.isEmpty()) return;
+
+  weights_.reserve(candidates.count());
+  double total = 0.0;
+  for (const Candidate &candidate : candidates) {
+    const double weight = Weight(candidate);
+    weights_ << weight;
+    total += weight;
+  }
+
+  // Build the alias table with Vose's method.
+  const int n = static_cast<int>(ids_.count());
+  probability_.resize(n);
+  alias_.resize(n);
+  QVector<double> scaled(n);
+  QVector<int> small;
+  QVector<int> large;
+  for (int i = 0; i < n; ++i) {
+    scaled[i] = weights_[i] * n / total;
+    if (scaled[i] < 1.0) small << i;
+    else large << i;
+  }
+  while (!small.isEmpty() && !large.isEmpty()) {
+    const int s = small.takeLast();
+    const int l = large.last();
+    probability_[s] = scaled[s];
+    alias_[s] = l;
+    scaled[l] = (scaled[l] + scaled[s]) - 1.0;
+    if (scaled[l] < 1.0) {
+      large.removeLast();
+      small << l;
+    }
+  }
+  // The rest are only off by rounding errors.
+  for (const int i : large) {
+    probability_[i] = 1.0;
+    alias_[i] = i;
+  }
+  for (const int i : small) {
+    probability_[i] = 1.0;
+    alias_[i] = i;
+  }
+
+}
+
+void SmartPlaylistSampler::Clear() {
+
+  ids_.clear();
+  weights_.clear();
+  probability_.clear();
+  alias_.clear();
+  weighted_ = false;
+
+}
+
+int SmartPlaylistSampler::DrawIndex() {
+
+  std::uniform_int_distribution<int> index_distribution(0, static_cast<int>(ids_.count()) - 1);
+  const int index = index_distribution(generator_);
+  if (!weighted_) return index;
+
+  std::uniform_real_distribution<double> distribution(0.0, 1.0);
+  return distribution(generator_) < probability_[index] ? index : alias_[index];
+
+}
+
+QList<int> SmartPlaylistSampler::Sample(const int count, const QSet<int> &excluded_ids) {
+
+  QList<int> ret;
+  if (count <= 0 || ids_.isEmpty()) return ret;
+
+  // When most of the candidates are needed anyway, drawing at random would mostly hit songs which are already taken.
+  if (count * 2 >= ids_.count() - excluded_ids.count()) {
+    return SampleRemaining(count, excluded_ids, QSet<int>());
+  }
+
+  ret.reserve(count);
+  QSet<int> sampled_ids;
+  sampled_ids.reserve(count);
+  const int max_draws = count * 20;
+  for (int i = 0; i < max_draws && ret.count() < count; ++i) {
+    const int id = ids_[DrawIndex()];
+    if (excluded_ids.contains(id) || sampled_ids.contains(id)) continue;
+    sampled_ids.insert(id);
+    ret << id;
+  }
+
+  if (ret.count() < count) {
+    ret << SampleRemaining(count - static_cast<int>(ret.count()), excluded_ids, sampled_ids);
+  }
+
+  return ret;
+
+}
+
+QList<int> SmartPlaylistSampler::SampleRemaining(const int count, const QSet<int> &excluded_ids, const QSet<int> &sampled_ids) {
+
+  QVector<int> indexes;
+  indexes.reserve(ids_.count());
+  for (int i = 0; i < ids_.count(); ++i) {
+    if (!excluded_ids.contains(ids_[i]) && !sampled_ids.contains(ids_[i])) indexes << i;
+  }
+  const int take = qMin(count, static_cast<int>(indexes.count()));
+
+  if (weighted_) {
+    // Weighted random order without replacement, keep the songs with the largest log(u) / weight.
+    std::uniform_real_distribution<double> distribution(0.0, 1.0);
+    QVector<std::pair<double, int>> keys;
+    keys.reserve(indexes.count());
+    for (const int index : indexes) {
+      keys << std::make_pair(std::log(1.0 - distribution(generator_)) / weights_[index], index);
+    }
+    std::partial_sort(keys.begin(), keys.begin() + take, keys.end(), [](const std::pair<double, int> &a, const std::pair<double, int> &b) { return a.first > b.first; });
+    for (int i = 0; i < take; ++i) {
+      indexes[i] = keys[i].second;
+    }
+  }
+  else {
+    for (int i = 0; i < take; ++i) {
+      std::uniform_int_distribution<int> distribution(i, static_cast<int>(indexes.count()) - 1);
+      std::swap(indexes[i], indexes[distribution(generator_)]);
+    }
+  }
+
+  QList<int> ret;
+  ret.reserve(take);
+  for (int i = 0; i < take; ++i) {
+    ret << ids_[indexes[i]];
+  }
+
+  return ret;
+
+}
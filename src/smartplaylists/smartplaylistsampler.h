@@ -0,0 +1,72 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2021, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef SMARTPLAYLISTSAMPLER_H
+#define SMARTPLAYLISTSAMPLER_H
+
+#include "config.h"
+
+#include <random>
+
+#include <QList>
+#include <QVector>
+#include <QSet>
+
+// Draws random songs from the songs matching a smart playlist search.
+// The matching song IDs are loaded once, after that drawing k songs takes O(k) time instead of sorting all matching songs in the database.
+// Weighted draws use an alias table, so higher rated and more played songs are picked more often.
+class SmartPlaylistSampler {
+ public:
+  explicit SmartPlaylistSampler();
+
+  struct Candidate {
+    Candidate() : id(-1), rating(-1.0F), playcount(0) {}
+    Candidate(const int _id, const float _rating, const int _playcount) : id(_id), rating(_rating), playcount(_playcount) {}
+    int id;
+    float rating;
+    int playcount;
+  };
+  using CandidateList = QList<Candidate>;
+
+  static double Weight(const Candidate &candidate);
+
+  void SetCandidates(const CandidateList &candidates, const bool weighted);
+  void Clear();
+
+  int count() const { return static_cast<int>(ids_.count()); }
+  bool weighted() const { return weighted_; }
+
+  // Returns up to count song IDs in random order, none of them in excluded_ids.
+  QList<int> Sample(const int count, const QSet<int> &excluded_ids = QSet<int>());
+
+ private:
+  int DrawIndex();
+  QList<int> SampleRemaining(const int count, const QSet<int> &excluded_ids, const QSet<int> &sampled_ids);
+
+ private:
+  QVector<int> ids_;
+  QVector<double> weights_;
+  // Alias table, the probability of keeping index i, otherwise alias_[i] is picked.
+  QVector<double> probability_;
+  QVector<int> alias_;
+  bool weighted_;
+  std::mt19937 generator_;
+};
+
+#endif  // SMARTPLAYLISTSAMPLER_H
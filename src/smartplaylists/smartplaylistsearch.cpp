@@ -51,7 +51,36 @@ void SmartPlaylistSearch::Reset() {
 
 QString SmartPlaylistSearch::ToSql(const QString &songs_table) const {
 
-  QString sql = "SELECT ROWID," + Song::kColumnSpec + " FROM " + songs_table;
+  QString sql = "SELECT ROWID," + Song::kColumnSpec + " FROM " + songs_table + WhereSql();
+
+  // Add sort by
+  if (is_random()) {
+    sql += " ORDER BY random()";
+  }
+  else {
+    sql += " ORDER BY " + SmartPlaylistSearchTerm::FieldColumnName(sort_field_) + (sort_type_ == Sort_FieldAsc ? " ASC" : " DESC");
+  }
+
+  // Add limit
+  if (first_item_ > 0) {
+    sql += QString(" LIMIT %1 OFFSET %2").arg(limit_).arg(first_item_);
+  }
+  else if (limit_ != -1) {
+    sql += " LIMIT " + QString::number(limit_);
+  }
+  //qLog(Debug) << sql;
+
+  return sql;
+
+}
+
+QString SmartPlaylistSearch::ToCandidatesSql(const QString &songs_table) const {
+
+  return "SELECT ROWID, rating, playcount FROM " + songs_table + WhereSql();
+
+}
+
+QString SmartPlaylistSearch::WhereSql() const {
 
   // Add search terms
   QStringList where_clauses;
@@ -79,28 +108,7 @@ QString SmartPlaylistSearch::ToSql(const QString &songs_table) const {
   // but are still kept in the database in case the directory containing them has just been unmounted.
   where_clauses << "unavailable = 0";
 
-  if (!where_clauses.isEmpty()) {
-    sql += " WHERE " + where_clauses.join(" AND ");
-  }
-
-  // Add sort by
-  if (sort_type_ == Sort_Random) {
-    sql += " ORDER BY random()";
-  }
-  else {
-    sql += " ORDER BY " + SmartPlaylistSearchTerm::FieldColumnName(sort_field_) + (sort_type_ == Sort_FieldAsc ? " ASC" : " DESC");
-  }
-
-  // Add limit
-  if (first_item_ > 0) {
-    sql += QString(" LIMIT %1 OFFSET %2").arg(limit_).arg(first_item_);
-  }
-  else if (limit_ != -1) {
-    sql += " LIMIT " + QString::number(limit_);
-  }
-  //qLog(Debug) << sql;
-
-  return sql;
+  return " WHERE " + where_clauses.join(" AND ");
 
 }
 
@@ -111,6 +119,26 @@ bool SmartPlaylistSearch::is_valid() const {
 
 }
 
+bool SmartPlaylistSearch::uses_statistics() const {
+
+  if (search_type_ == Type_All) return false;
+
+  for (const SmartPlaylistSearchTerm &term : terms_) {
+    switch (term.field_) {
+      case SmartPlaylistSearchTerm::Field_PlayCount:
+      case SmartPlaylistSearchTerm::Field_SkipCount:
+      case SmartPlaylistSearchTerm::Field_LastPlayed:
+      case SmartPlaylistSearchTerm::Field_Rating:
+        return true;
+      default:
+        break;
+    }
+  }
+
+  return false;
+
+}
+
 bool SmartPlaylistSearch::operator==(const SmartPlaylistSearch &other) const {
 
   return search_type_ == other.search_type_ &&
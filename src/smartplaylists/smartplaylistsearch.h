@@ -39,12 +39,15 @@ class SmartPlaylistSearch {
   enum SearchType { Type_And = 0, Type_Or, Type_All, };
 
   // These values are persisted, so add to the end of the enum only
-  enum SortType { Sort_Random = 0, Sort_FieldAsc, Sort_FieldDesc, };
+  enum SortType { Sort_Random = 0, Sort_FieldAsc, Sort_FieldDesc, Sort_WeightedRandom, };
 
   explicit SmartPlaylistSearch();
   explicit SmartPlaylistSearch(const SearchType type, const TermList &terms, const SortType sort_type, const SmartPlaylistSearchTerm::Field sort_field, const int limit = PlaylistGenerator::kDefaultLimit);
 
   bool is_valid() const;
+  bool is_random() const { return sort_type_ == Sort_Random || sort_type_ == Sort_WeightedRandom; }
+  // Whether the search terms depend on the play statistics or rating, which change while playing.
+  bool uses_statistics() const;
   bool operator==(const SmartPlaylistSearch &other) const;
   bool operator!=(const SmartPlaylistSearch &other) const { return !(*this == other); }
 
@@ -60,6 +63,11 @@ class SmartPlaylistSearch {
 
   void Reset();
   QString ToSql(const QString &songs_table) const;
+  // Selects the ID, rating and play count of all matching songs, without sorting or limit.
+  QString ToCandidatesSql(const QString &songs_table) const;
+
+ private:
+  QString WhereSql() const;
 
 };
 
@@ -44,6 +44,8 @@
 #include "core/networktimeouts.h"
 #include "utilities/imageutils.h"
 #include "utilities/timeconstants.h"
+#include "collection/collectionbackend.h"
+#include "internet/internetcollectionsync.h"
 #include "subsonicservice.h"
 #include "subsonicurlhandler.h"
 #include "subsonicbaserequest.h"
@@ -61,6 +63,7 @@ SubsonicRequest::SubsonicRequest(SubsonicService *service, SubsonicUrlHandler *u
       network_(new QNetworkAccessManager(this)),
       timeouts_(new NetworkTimeouts(30000, this)),
       finished_(false),
+      sync_(service->collection_backend()),
       albums_requests_active_(0),
       album_songs_requests_active_(0),
       album_songs_requested_(0),
@@ -123,7 +126,8 @@ void SubsonicRequest::GetAlbums() {
 
   emit UpdateStatus(tr("Retrieving albums..."));
   emit UpdateProgress(0);
-  AddAlbumsRequest();
+  // The album requests start once the previous sync is loaded.
+  sync_.Load(this, [this]() { AddAlbumsRequest(); });
 
 }
 
@@ -280,6 +284,7 @@ void SubsonicRequest::AlbumsReplyReceived(QNetworkReply *reply, const int offset
     Request request;
     request.album_id = album_id;
     request.album_artist = artist;
+    request.signature = InternetCollectionSync::AlbumSignature(obj_album, QStringList() << "name" << "songCount" << "duration" << "created" << "year" << "coverArt");
     album_songs_requests_pending_.insert(album_id, request);
 
   }
@@ -303,12 +308,26 @@ void SubsonicRequest::AlbumsFinishCheck(const int offset, const int size, const
 
   if (albums_requests_queue_.isEmpty() && albums_requests_active_ <= 0) { // Albums list is finished, get songs for all albums.
 
+    int albums_unchanged = 0;
     for (QHash<QString, Request> ::iterator it = album_songs_requests_pending_.begin(); it != album_songs_requests_pending_.end(); ++it) {
       Request request = it.value();
-      AddAlbumSongsRequest(request.artist_id, request.album_id, request.album_artist);
+      const SongList songs = sync_.UnchangedAlbumSongs(request.album_id, request.signature);
+      if (songs.isEmpty()) {
+        AddAlbumSongsRequest(request.artist_id, request.album_id, request.album_artist, request.signature);
+        continue;
+      }
+      for (const Song &song : songs) {
+        songs_.insert(song.song_id(), song);
+      }
+      sync_.AlbumSynced(request.album_id, request.signature);
+      ++albums_unchanged;
     }
     album_songs_requests_pending_.clear();
 
+    if (albums_unchanged > 0) {
+      qLog(Debug) << "Subsonic:" << albums_unchanged << "albums did not change since the last sync";
+    }
+
     if (album_songs_requested_ > 0) {
       if (album_songs_requested_ == 1) emit UpdateStatus(tr("Retrieving songs for %1 album...").arg(album_songs_requested_));
       else emit UpdateStatus(tr("Retrieving songs for %1 albums...").arg(album_songs_requested_));
@@ -321,12 +340,13 @@ void SubsonicRequest::AlbumsFinishCheck(const int offset, const int size, const
 
 }
 
-void SubsonicRequest::AddAlbumSongsRequest(const QString &artist_id, const QString &album_id, const QString &album_artist, const int offset) {
+void SubsonicRequest::AddAlbumSongsRequest(const QString &artist_id, const QString &album_id, const QString &album_artist, const QString &signature, const int offset) {
 
   Request request;
   request.artist_id = artist_id;
   request.album_id = album_id;
   request.album_artist = album_artist;
+  request.signature = signature;
   request.offset = offset;
   album_songs_requests_queue_.enqueue(request);
   ++album_songs_requested_;
@@ -342,14 +362,14 @@ void SubsonicRequest::FlushAlbumSongsRequests() {
     ++album_songs_requests_active_;
     QNetworkReply *reply = CreateGetRequest(QString("getAlbum"), ParamList() << Param("id", request.album_id));
     replies_ << reply;
-    QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, request]() { AlbumSongsReplyReceived(reply, request.artist_id, request.album_id, request.album_artist); });
+    QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, request]() { AlbumSongsReplyReceived(reply, request.artist_id, request.album_id, request.album_artist, request.signature); });
     timeouts_->AddReply(reply);
 
   }
 
 }
 
-void SubsonicRequest::AlbumSongsReplyReceived(QNetworkReply *reply, const QString &artist_id, const QString &album_id, const QString &album_artist) {
+void SubsonicRequest::AlbumSongsReplyReceived(QNetworkReply *reply, const QString &artist_id, const QString &album_id, const QString &album_artist, const QString &signature) {
 
   if (!replies_.contains(reply)) return;
   replies_.removeAll(reply);
@@ -458,6 +478,8 @@ void SubsonicRequest::AlbumSongsReplyReceived(QNetworkReply *reply, const QStrin
     songs_.insert(song.song_id(), song);
   }
 
+  sync_.AlbumSynced(album_id, signature);
+
   SongsFinishCheck();
 
 }
@@ -874,6 +896,8 @@ void SubsonicRequest::FinishCheck() {
       album_covers_received_ >= album_covers_requested_
   ) {
     finished_ = true;
+    // Only a complete sync is remembered, otherwise the next sync compares against the previous one again.
+    if (errors_.isEmpty()) sync_.Save();
     if (no_results_ && songs_.isEmpty()) {
       emit Results(SongMap(), QString());
     }
@@ -38,6 +38,7 @@
 #include <QJsonObject>
 
 #include "core/song.h"
+#include "internet/internetcollectionsync.h"
 #include "subsonicbaserequest.h"
 
 class QNetworkAccessManager;
@@ -68,6 +69,7 @@ class SubsonicRequest : public SubsonicBaseRequest {
     int offset;
     int size;
     QString album_artist;
+    QString signature;
   };
   struct AlbumCoverRequest {
     QString artist_id;
@@ -85,7 +87,7 @@ class SubsonicRequest : public SubsonicBaseRequest {
 
  private slots:
   void AlbumsReplyReceived(QNetworkReply *reply, const int offset_requested, const int size_requested);
-  void AlbumSongsReplyReceived(QNetworkReply *reply, const QString &artist_id, const QString &album_id, const QString &album_artist);
+  void AlbumSongsReplyReceived(QNetworkReply *reply, const QString &artist_id, const QString &album_id, const QString &album_artist, const QString &signature);
   void AlbumCoverReceived(QNetworkReply *reply, const AlbumCoverRequest &request);
 
  private:
@@ -96,7 +98,7 @@ class SubsonicRequest : public SubsonicBaseRequest {
   void AlbumsFinishCheck(const int offset = 0, const int size = 0, const int albums_received = 0);
   void SongsFinishCheck();
 
-  void AddAlbumSongsRequest(const QString &artist_id, const QString &album_id, const QString &album_artist, const int offset = 0);
+  void AddAlbumSongsRequest(const QString &artist_id, const QString &album_id, const QString &album_artist, const QString &signature, const int offset = 0);
   void FlushAlbumSongsRequests();
 
   QString ParseSong(Song &song, const QJsonObject &json_obj, const QString &artist_id_requested = QString(), const QString &album_id_requested = QString(), const QString &album_artist = QString(), const qint64 album_created = 0);
@@ -123,6 +125,8 @@ class SubsonicRequest : public SubsonicBaseRequest {
 
   bool finished_;
 
+  InternetCollectionSync sync_;
+
   QQueue<Request> albums_requests_queue_;
   QQueue<Request> album_songs_requests_queue_;
   QQueue<AlbumCoverRequest> album_cover_requests_queue_;
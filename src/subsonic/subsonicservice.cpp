@@ -65,7 +65,9 @@ const char *SubsonicService::kSongsTable = "subsonic_songs";
 const char *SubsonicService::kSongsFtsTable = "subsonic_songs_fts";
 const int SubsonicService::kMaxRedirects = 3;
 
-SubsonicService::SubsonicService(Application *app, QObject *parent)
+SubsonicService::SubsonicService(Application *app, QObject *parent) : SubsonicService(app, app->database(), parent) {}
+
+SubsonicService::SubsonicService(Application *app, Database *database, QObject *parent)
     : InternetService(Song::Source_Subsonic, "Subsonic", "subsonic", SubsonicSettingsPage::kSettingsGroup, SettingsDialog::Page_Subsonic, app, parent),
       app_(app),
       url_handler_(new SubsonicUrlHandler(app, this)),
@@ -78,13 +80,13 @@ SubsonicService::SubsonicService(Application *app, QObject *parent)
       auth_method_(SubsonicSettingsPage::AuthMethod_MD5),
       ping_redirects_(0) {
 
-  app->player()->RegisterUrlHandler(url_handler_);
+  if (app) app->player()->RegisterUrlHandler(url_handler_);
 
   // Backend
 
   collection_backend_ = new CollectionBackend();
-  collection_backend_->moveToThread(app_->database()->thread());
-  collection_backend_->Init(app_->database(), app->task_manager(), Song::Source_Subsonic, kSongsTable, kSongsFtsTable);
+  collection_backend_->moveToThread(database->thread());
+  collection_backend_->Init(database, app ? app->task_manager() : nullptr, Song::Source_Subsonic, kSongsTable, kSongsFtsTable);
 
   // Model
 
@@ -46,6 +46,7 @@ class QSortFilterProxyModel;
 class QNetworkReply;
 
 class Application;
+class Database;
 class SubsonicUrlHandler;
 class SubsonicRequest;
 class SubsonicScrobbleRequest;
@@ -57,6 +58,8 @@ class SubsonicService : public InternetService {
 
  public:
   explicit SubsonicService(Application *app, QObject *parent);
+  // Without an application the service only has its collection backend on the given database, this is used by the tests.
+  explicit SubsonicService(Application *app, Database *database, QObject *parent);
   ~SubsonicService() override;
 
   static const Song::Source kSource;
@@ -38,6 +38,7 @@
 #include "core/application.h"
 #include "utilities/timeconstants.h"
 #include "utilities/imageutils.h"
+#include "internet/internetcollectionsync.h"
 #include "tidalservice.h"
 #include "tidalurlhandler.h"
 #include "tidalbaserequest.h"
@@ -64,6 +65,7 @@ TidalRequest::TidalRequest(TidalService *service, TidalUrlHandler *url_handler,
       coversize_(service->coversize()),
       query_id_(-1),
       finished_(false),
+      sync_(type == QueryType_Artists ? service->artists_collection_backend() : type == QueryType_Albums ? service->albums_collection_backend() : nullptr),
       artists_requests_total_(0),
       artists_requests_active_(0),
       artists_requests_received_(0),
@@ -220,7 +222,7 @@ void TidalRequest::GetArtists() {
 
   emit UpdateStatus(query_id_, tr("Receiving artists..."));
   emit UpdateProgress(query_id_, 0);
-  AddArtistsRequest();
+  sync_.Load(this, [this]() { AddArtistsRequest(); });
 
 }
 
@@ -268,7 +270,7 @@ void TidalRequest::GetAlbums() {
 
   emit UpdateStatus(query_id_, tr("Receiving albums..."));
   emit UpdateProgress(query_id_, 0);
-  AddAlbumsRequest();
+  sync_.Load(this, [this]() { AddAlbumsRequest(); });
 
 }
 
@@ -691,6 +693,7 @@ void TidalRequest::AlbumsReceived(QNetworkReply *reply, const Artist &artist_req
           album.album.append(" (Explicit)");
         }
       }
+      album.signature = InternetCollectionSync::AlbumSignature(obj_item, QStringList() << "title" << "numberOfTracks" << "numberOfVolumes" << "duration" << "releaseDate" << "cover");
     }
     else if (obj_item.contains("album")) {  // This was a tracks request or search
       QJsonValue value_album = obj_item["album"];
@@ -806,7 +809,15 @@ void TidalRequest::AlbumsFinishCheck(const Artist &artist, const int limit, cons
 
     for (QHash<QString, AlbumSongsRequest>::iterator it = album_songs_requests_pending_.begin(); it != album_songs_requests_pending_.end(); ++it) {
       const AlbumSongsRequest &request = it.value();
-      AddAlbumSongsRequest(request.artist, request.album);
+      const SongList songs = sync_.UnchangedAlbumSongs(request.album.album_id, request.album.signature);
+      if (songs.isEmpty()) {
+        AddAlbumSongsRequest(request.artist, request.album);
+        continue;
+      }
+      for (const Song &song : songs) {
+        songs_.insert(song.song_id(), song);
+      }
+      sync_.AlbumSynced(request.album.album_id, request.album.signature);
     }
     album_songs_requests_pending_.clear();
 
@@ -971,6 +982,10 @@ void TidalRequest::SongsReceived(QNetworkReply *reply, const Artist &artist, con
     emit UpdateProgress(query_id_, GetProgress(songs_received_, songs_total_));
   }
 
+  if (!album.album_id.isEmpty() && offset_requested + songs_received >= songs_total) {
+    sync_.AlbumSynced(album.album_id, album.signature);
+  }
+
   SongsFinishCheck(artist, album, limit_requested, offset_requested, songs_total, songs_received);
 
 }
@@ -1198,6 +1213,9 @@ void TidalRequest::GetAlbumCovers() {
 
 void TidalRequest::AddAlbumCoverRequest(const Song &song) {
 
+  // Songs of unchanged albums have the cover from the previous sync.
+  if (song.art_automatic().isLocalFile()) return;
+
   if (album_covers_requests_sent_.contains(song.album_id())) {
     album_covers_requests_sent_.insert(song.album_id(), song.song_id());
     return;
@@ -1352,6 +1370,8 @@ void TidalRequest::FinishCheck() {
       timer_flush_requests_->stop();
     }
     finished_ = true;
+    // Only a complete sync is remembered, otherwise the next sync compares against the previous one again.
+    if (IsQuery() && errors_.isEmpty()) sync_.Save();
     if (songs_.isEmpty()) {
       if (errors_.isEmpty()) {
         if (IsSearch()) {
@@ -38,6 +38,7 @@
 #include <QJsonObject>
 
 #include "core/song.h"
+#include "internet/internetcollectionsync.h"
 #include "tidalbaserequest.h"
 
 class QNetworkReply;
@@ -71,6 +72,7 @@ class TidalRequest : public TidalBaseRequest {
     QString album;
     QUrl cover_url;
     bool album_explicit;
+    QString signature;
   };
   struct Request {
     Request() : offset(0), limit(0) {}
@@ -194,6 +196,8 @@ class TidalRequest : public TidalBaseRequest {
 
   bool finished_;
 
+  InternetCollectionSync sync_;
+
   QQueue<Request> artists_requests_queue_;
   QQueue<Request> albums_requests_queue_;
   QQueue<Request> songs_requests_queue_;
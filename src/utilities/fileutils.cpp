@@ -19,6 +19,7 @@
  */
 
 #include <memory>
+#include <functional>
 
 #include <QtGlobal>
 
@@ -27,6 +28,23 @@
 #include <QIODevice>
 #include <QDir>
 #include <QFile>
+#include <QCryptographicHash>
+
+#ifdef Q_OS_UNIX
+#  include <sys/stat.h>
+#endif
+
+#ifdef Q_OS_LINUX
+#  include <cerrno>
+#  include <fcntl.h>
+#  include <unistd.h>
+#  include <sys/sendfile.h>
+#  if defined(__GLIBC__)
+#    if __GLIBC_PREREQ(2, 27)
+#      define HAVE_COPY_FILE_RANGE
+#    endif
+#  endif
+#endif
 
 #include "core/logging.h"
 
@@ -105,6 +123,99 @@ bool CopyRecursive(const QString &source, const QString &destination) {
 
 }
 
+bool CopyFile(const QString &source, const QString &destination, const std::function<void(float progress)> &progress) {
+
+#ifdef Q_OS_LINUX
+
+  // The data is copied in chunks, so the progress can be reported.
+  constexpr qint64 kChunkSize = 8388608;
+
+  // Files which can't be opened here, like Qt resources, are left to QFile::copy().
+  const int source_fd = open(QFile::encodeName(source).constData(), O_RDONLY | O_CLOEXEC);
+  if (source_fd == -1) return CopyFileFallback(source, destination, progress);
+
+  struct stat source_stat {};
+  if (fstat(source_fd, &source_stat) != 0 || !S_ISREG(source_stat.st_mode)) {
+    close(source_fd);
+    return CopyFileFallback(source, destination, progress);
+  }
+
+  // Like QFile::copy(), this fails if the destination exists.
+  const int destination_fd = open(QFile::encodeName(destination).constData(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, source_stat.st_mode & 0777);
+  if (destination_fd == -1) {
+    close(source_fd);
+    return false;
+  }
+
+  // Let the kernel copy the data, copy_file_range() can also clone the file or copy it on the server for network filesystems.
+  // Not all filesystems support it, and before Linux 5.3 it only works within one filesystem, so sendfile() is used instead.
+  const qint64 size = source_stat.st_size;
+  qint64 remaining = size;
+  qint64 copied_total = 0;
+#ifdef HAVE_COPY_FILE_RANGE
+  bool use_copy_file_range = true;
+#endif
+  bool fallback = false;
+  bool success = true;
+  while (remaining > 0) {
+    const size_t chunk_size = static_cast<size_t>(qMin(remaining, kChunkSize));
+    ssize_t copied = -1;
+#ifdef HAVE_COPY_FILE_RANGE
+    if (use_copy_file_range) {
+      copied = copy_file_range(source_fd, nullptr, destination_fd, nullptr, chunk_size, 0);
+      if (copied == -1 && copied_total == 0 && (errno == EXDEV || errno == ENOSYS || errno == EINVAL || errno == EOPNOTSUPP)) {
+        use_copy_file_range = false;
+        continue;
+      }
+    }
+    else
+#endif
+    {
+      copied = sendfile(destination_fd, source_fd, nullptr, chunk_size);
+      if (copied == -1 && copied_total == 0 && (errno == ENOSYS || errno == EINVAL)) {
+        fallback = true;
+        break;
+      }
+    }
+    if (copied == -1 && errno == EINTR) continue;
+    if (copied == -1) {
+      success = false;
+      break;
+    }
+    // The file was truncated while copying.
+    if (copied == 0) break;
+    remaining -= copied;
+    copied_total += copied;
+    if (progress) progress(static_cast<float>(copied_total) / static_cast<float>(size));
+  }
+
+  close(source_fd);
+  if (close(destination_fd) != 0) success = false;
+
+  if (fallback || !success) {
+    QFile::remove(destination);
+    if (fallback) return CopyFileFallback(source, destination, progress);
+    qLog(Error) << "Failed to copy" << source << "to" << destination;
+  }
+
+  return success;
+
+#else
+
+  return CopyFileFallback(source, destination, progress);
+
+#endif
+
+}
+
+bool CopyFileFallback(const QString &source, const QString &destination, const std::function<void(float progress)> &progress) {
+
+  const bool success = QFile::copy(source, destination);
+  if (success && progress) progress(1.0F);
+  return success;
+
+}
+
 bool RemoveRecursive(const QString &path) {
 
   QDir dir(path);
@@ -124,4 +235,81 @@ bool RemoveRecursive(const QString &path) {
 
 }
 
+quint64 FileInode(const QString &filename) {
+
+#ifdef Q_OS_UNIX
+  struct stat s {};
+  if (stat(QFile::encodeName(filename).constData(), &s) == 0) {
+    return static_cast<quint64>(s.st_ino);
+  }
+#else
+  Q_UNUSED(filename)
+#endif
+
+  return 0;
+
+}
+
+QByteArray AudioDataHash(const QString &filename) {
+
+  constexpr qint64 kChunkSize = 1048576;
+
+  QFile file(filename);
+  if (!file.open(QIODevice::ReadOnly)) return QByteArray();
+
+  qint64 begin = 0;
+  qint64 end = file.size();
+
+  const QByteArray id3v2_header = file.read(10);
+  if (id3v2_header.size() == 10 && id3v2_header.startsWith("ID3")) {
+    const unsigned char *h = reinterpret_cast<const unsigned char*>(id3v2_header.constData());
+    begin = 10 + (((h[6] & 0x7F) << 21) | ((h[7] & 0x7F) << 14) | ((h[8] & 0x7F) << 7) | (h[9] & 0x7F));
+    if (h[5] & 0x10) begin += 10;  // Footer present
+  }
+
+  if (file.seek(begin) && file.read(4) == "fLaC") {
+    begin += 4;
+    bool last_block = false;
+    while (!last_block) {
+      const QByteArray block_header = file.read(4);
+      if (block_header.size() != 4) return QByteArray();
+      const unsigned char *h = reinterpret_cast<const unsigned char*>(block_header.constData());
+      last_block = h[0] & 0x80;
+      begin += 4 + ((h[1] << 16) | (h[2] << 8) | h[3]);
+      if (begin >= end || !file.seek(begin)) return QByteArray();
+    }
+  }
+
+  if (end - begin >= 128 && file.seek(end - 128) && file.read(3) == "TAG") {
+    end -= 128;
+  }
+
+  if (end - begin >= 32 && file.seek(end - 32) && file.read(8) == "APETAGEX") {
+    const QByteArray ape_footer = file.read(24);
+    if (ape_footer.size() == 24) {
+      const unsigned char *f = reinterpret_cast<const unsigned char*>(ape_footer.constData());
+      const qint64 tag_size = (f[4]) | (f[5] << 8) | (f[6] << 16) | (static_cast<qint64>(f[7]) << 24);
+      const bool has_header = f[15] & 0x80;
+      end -= tag_size + (has_header ? 32 : 0);
+    }
+  }
+
+  if (end <= begin) return QByteArray();
+
+  // All of the audio data is hashed, files which only differ in the middle (padded rips) must not share a fingerprint.
+  QCryptographicHash hash(QCryptographicHash::Sha1);
+  if (!file.seek(begin)) return QByteArray();
+  for (qint64 pos = begin; pos < end;) {
+    const QByteArray data = file.read(qMin(end - pos, kChunkSize));
+    if (data.isEmpty()) return QByteArray();
+    hash.addData(data);
+    pos += data.size();
+  }
+
+  file.close();
+
+  return hash.result().toHex();
+
+}
+
 }  // namespace Utilities
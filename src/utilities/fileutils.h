@@ -21,6 +21,10 @@
 #ifndef FILEUTILS_H
 #define FILEUTILS_H
 
+#include <functional>
+
+#include <QtGlobal>
+#include <QByteArray>
 #include <QString>
 
 class QIODevice;
@@ -30,8 +34,21 @@ namespace Utilities {
 QByteArray ReadDataFromFile(const QString &filename);
 bool Copy(QIODevice *source, QIODevice *destination);
 bool CopyRecursive(const QString &source, const QString &destination);
+
+// Copies a file without passing the data through user space where it's supported, otherwise with QFile::copy().
+// Fails if the destination exists. The progress function is called with the fraction of the file copied so far.
+bool CopyFile(const QString &source, const QString &destination, const std::function<void(float progress)> &progress = nullptr);
+// Copies a file with QFile::copy(), this is what CopyFile() uses when the kernel can't copy the file.
+bool CopyFileFallback(const QString &source, const QString &destination, const std::function<void(float progress)> &progress = nullptr);
 bool RemoveRecursive(const QString &path);
 
+// Returns the inode number of the file, or 0 if it's not available on this platform.
+quint64 FileInode(const QString &filename);
+
+// Returns a hash of the audio data of the file.
+// Leading ID3v2 tags and FLAC metadata blocks, and trailing APEv2 and ID3v1 tags are left out, so the hash stays the same when only these tags are changed.
+QByteArray AudioDataHash(const QString &filename);
+
 }  // namespace Utilities
 
 #endif  // FILEUTILS_H
@@ -33,4 +33,63 @@ QString MimeTypeFromData(const QByteArray &data) {
 
 }
 
+bool IsAudioMagic(const QByteArray &data) {
+
+  if (data.size() < 4) return false;
+
+  const unsigned char *d = reinterpret_cast<const unsigned char*>(data.constData());
+
+  if (data.startsWith("ID3") ||    // MP3 (and others) with ID3v2 tag
+      data.startsWith("fLaC") ||   // FLAC
+      data.startsWith("OggS") ||   // Ogg Vorbis, Ogg FLAC, Opus, Speex
+      data.startsWith("wvpk") ||   // WavPack
+      data.startsWith("MAC ") ||   // Monkey's Audio
+      data.startsWith("MPCK") ||   // Musepack SV8
+      data.startsWith("MP+") ||    // Musepack SV7
+      data.startsWith("TTA1") ||   // TrueAudio
+      data.startsWith("DSD ") ||   // DSF
+      data.startsWith("Vgm ") ||   // VGM
+      data.startsWith("SNES-SPC700")) {
+    return true;
+  }
+
+  // WAV and AIFF
+  if (data.size() >= 12 && ((data.startsWith("RIFF") && data.mid(8, 4) == "WAVE") || (data.startsWith("FORM") && (data.mid(8, 4) == "AIFF" || data.mid(8, 4) == "AIFC")))) {
+    return true;
+  }
+
+  // DSDIFF
+  if (data.size() >= 16 && data.startsWith("FRM8") && data.mid(12, 4) == "DSD ") {
+    return true;
+  }
+
+  // MP4 / M4A
+  if (data.size() >= 8 && data.mid(4, 4) == "ftyp") {
+    return true;
+  }
+
+  // ASF / WMA
+  if (d[0] == 0x30 && d[1] == 0x26 && d[2] == 0xB2 && d[3] == 0x75) {
+    return true;
+  }
+
+  // Matroska
+  if (d[0] == 0x1A && d[1] == 0x45 && d[2] == 0xDF && d[3] == 0xA3) {
+    return true;
+  }
+
+  // AC3 and DTS
+  if ((d[0] == 0x0B && d[1] == 0x77) || (d[0] == 0x7F && d[1] == 0xFE && d[2] == 0x80 && d[3] == 0x01)) {
+    return true;
+  }
+
+  // MPEG audio or ADTS AAC frame sync without a tag in front.
+  if (d[0] == 0xFF && (d[1] & 0xE0) == 0xE0) {
+    return true;
+  }
+
+  return false;
+
+}
+
 }  // namespace Utilities
@@ -27,6 +27,11 @@ namespace Utilities {
 
 QString MimeTypeFromData(const QByteArray &data);
 
+// Returns true if the data starts with the magic bytes of an audio format we support.
+// Only the first kAudioMagicSize bytes of the file are needed.
+constexpr int kAudioMagicSize = 16;
+bool IsAudioMagic(const QByteArray &data);
+
 } //  namespace Utilities
 
 #endif  // MIMEUTILS_H
@@ -0,0 +1,153 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2021, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <memory>
+
+#include <gtest/gtest.h>
+
+#include <QTemporaryDir>
+#include <QFile>
+#include <QString>
+#include <QImage>
+#include <QColor>
+
+#include "test_utils.h"
+
+#include "collection/albumiconcache.h"
+
+// clazy:excludeall=returning-void-expression
+
+namespace {
+
+QImage Icon(const QColor &color) {
+
+  QImage image(32, 32, QImage::Format_RGB32);
+  image.fill(color);
+  return image;
+
+}
+
+class AlbumIconCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_TRUE(temp_dir_.isValid());
+    filename_ = temp_dir_.path() + "/albumicons.cache";
+    cache_ = std::make_unique<AlbumIconCache>(filename_);
+  }
+
+  void Reopen() {
+    cache_.reset();
+    cache_ = std::make_unique<AlbumIconCache>(filename_);
+  }
+
+  QTemporaryDir temp_dir_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+  QString filename_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+  std::unique_ptr<AlbumIconCache> cache_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+};
+
+TEST_F(AlbumIconCacheTest, Empty) {
+
+  EXPECT_EQ(0, cache_->count());
+  EXPECT_FALSE(cache_->Contains("Collection/Artist/Album"));
+  EXPECT_TRUE(cache_->Image("Collection/Artist/Album").isNull());
+
+}
+
+TEST_F(AlbumIconCacheTest, InsertAndLoad) {
+
+  ASSERT_TRUE(cache_->Insert("Collection/Artist/Album", Icon(Qt::red)));
+  EXPECT_TRUE(cache_->Contains("Collection/Artist/Album"));
+
+  const QImage image = cache_->Image("Collection/Artist/Album");
+  ASSERT_FALSE(image.isNull());
+  EXPECT_EQ(32, image.width());
+  EXPECT_EQ(32, image.height());
+  EXPECT_EQ(QColor(Qt::red).rgb(), image.pixel(16, 16));
+
+}
+
+TEST_F(AlbumIconCacheTest, PersistsAcrossReopen) {
+
+  cache_->Insert("Collection/Artist/Album 1", Icon(Qt::red));
+  cache_->Insert("Collection/Artist/Album 2", Icon(Qt::green));
+  cache_->Insert("Collection/Artist/Album 1", Icon(Qt::blue));
+  cache_->Remove("Collection/Artist/Album 2");
+
+  Reopen();
+
+  EXPECT_EQ(1, cache_->count());
+  EXPECT_FALSE(cache_->Contains("Collection/Artist/Album 2"));
+  EXPECT_EQ(QColor(Qt::blue).rgb(), cache_->Image("Collection/Artist/Album 1").pixel(0, 0));
+
+}
+
+TEST_F(AlbumIconCacheTest, TruncatedRecordIsDropped) {
+
+  cache_->Insert("Collection/Artist/Album 1", Icon(Qt::red));
+  cache_->Insert("Collection/Artist/Album 2", Icon(Qt::green));
+  const qint64 size = cache_->size();
+  cache_.reset();
+
+  QFile file(filename_);
+  ASSERT_TRUE(file.resize(size - 100));
+
+  Reopen();
+
+  EXPECT_EQ(1, cache_->count());
+  EXPECT_EQ(QColor(Qt::red).rgb(), cache_->Image("Collection/Artist/Album 1").pixel(0, 0));
+
+  // New icons are written after the last complete record.
+  cache_->Insert("Collection/Artist/Album 3", Icon(Qt::green));
+  Reopen();
+  EXPECT_EQ(2, cache_->count());
+
+}
+
+TEST_F(AlbumIconCacheTest, CompactKeepsNewest) {
+
+  const qint64 icon_size = 32 * 32 * 4;
+  cache_->set_maximum_size(icon_size * 10);
+  for (int i = 0; i < 20; ++i) {
+    ASSERT_TRUE(cache_->Insert(QString("Collection/Artist/Album %1").arg(i), Icon(Qt::red)));
+  }
+
+  EXPECT_LE(cache_->size(), icon_size * 10);
+  EXPECT_LT(cache_->count(), 10);
+  EXPECT_TRUE(cache_->Contains("Collection/Artist/Album 19"));
+  EXPECT_FALSE(cache_->Contains("Collection/Artist/Album 0"));
+  EXPECT_EQ(QColor(Qt::red).rgb(), cache_->Image("Collection/Artist/Album 19").pixel(0, 0));
+
+  const int count = cache_->count();
+  Reopen();
+  EXPECT_EQ(count, cache_->count());
+
+}
+
+TEST_F(AlbumIconCacheTest, Clear) {
+
+  cache_->Insert("Collection/Artist/Album", Icon(Qt::red));
+  cache_->Clear();
+  EXPECT_EQ(0, cache_->count());
+
+  Reopen();
+  EXPECT_EQ(0, cache_->count());
+
+}
+
+}  // namespace
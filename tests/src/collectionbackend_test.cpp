@@ -46,7 +46,7 @@ class CollectionBackendTest : public ::testing::Test {
   void SetUp() override {
     database_.reset(new MemoryDatabase(nullptr));
     backend_ = std::make_unique<CollectionBackend>();
-    backend_->Init(database_.get(), nullptr, Song::Source_Collection, SCollection::kSongsTable, SCollection::kFtsTable, SCollection::kDirsTable, SCollection::kSubdirsTable);
+    backend_->Init(database_.get(), nullptr, Song::Source_Collection, SCollection::kSongsTable, SCollection::kFtsTable, SCollection::kDirsTable, SCollection::kSubdirsTable, SCollection::kDuplicatesTable);
   }
 
   static Song MakeDummySong(int directory_id) {
@@ -283,6 +283,48 @@ TEST_F(SingleSong, UpdateSong) {
 
 }
 
+TEST_F(SingleSong, UpdateAndAddSongs) {
+
+  AddDummySong();
+  if (HasFatalFailure()) return;
+
+  Song updated_song(song_);
+  updated_song.set_id(1);
+  updated_song.set_title("A different title");
+
+  Song new_song = MakeDummySong(1);
+  new_song.set_title("New title");
+  new_song.set_url(QUrl::fromLocalFile("bar.flac"));
+
+  // This song's directory doesn't exist, so it should be skipped.
+  Song orphan_song = MakeDummySong(2);
+  orphan_song.set_title("Orphan");
+  orphan_song.set_url(QUrl::fromLocalFile("baz.flac"));
+
+  QSignalSpy deleted_spy(backend_.get(), &CollectionBackend::SongsDeleted);
+  QSignalSpy added_spy(backend_.get(), &CollectionBackend::SongsDiscovered);
+
+  backend_->AddOrUpdateSongs(SongList() << updated_song << orphan_song << new_song);
+
+  ASSERT_EQ(1, added_spy.size());
+  ASSERT_EQ(1, deleted_spy.size());
+
+  SongList songs_added = *(reinterpret_cast<SongList*>(added_spy[0][0].data()));
+  SongList songs_deleted = *(reinterpret_cast<SongList*>(deleted_spy[0][0].data()));
+  ASSERT_EQ(2, songs_added.size());
+  ASSERT_EQ(1, songs_deleted.size());
+  EXPECT_EQ("Title", songs_deleted[0].title());
+  EXPECT_EQ("A different title", songs_added[0].title());
+  EXPECT_EQ(1, songs_added[0].id());
+  EXPECT_EQ("New title", songs_added[1].title());
+  EXPECT_EQ(2, songs_added[1].id());
+
+  SongList songs = backend_->FindSongsInDirectory(1);
+  ASSERT_EQ(2, songs.size());
+  EXPECT_TRUE(backend_->FindSongsInDirectory(2).isEmpty());
+
+}
+
 TEST_F(SingleSong, DeleteSongs) {
 
   AddDummySong();
@@ -349,6 +391,66 @@ TEST_F(SingleSong, MarkSongsUnavailable) {
 
 }
 
+TEST_F(SingleSong, Duplicates) {
+
+  AddDummySong();
+  if (HasFatalFailure()) return;
+
+  Song duplicate_song(song_);
+  duplicate_song.set_url(QUrl::fromLocalFile("bar.flac"));
+  Song other_song(song_);
+  other_song.set_title("Other title");
+  other_song.set_url(QUrl::fromLocalFile("baz.flac"));
+  backend_->AddOrUpdateSongs(SongList() << duplicate_song << other_song);
+
+  CollectionFilterOptions opt;
+  opt.set_filter_mode(CollectionFilterOptions::FilterMode_Duplicates);
+  EXPECT_EQ(2, backend_->GetSongsByAlbum("Album", opt).count());
+
+  // Text filtering works together with the duplicates filter.
+  opt.set_filter_text("title");
+  EXPECT_EQ(2, backend_->GetSongsByAlbum("Album", opt).count());
+  opt.set_filter_text("other");
+  EXPECT_EQ(0, backend_->GetSongsByAlbum("Album", opt).count());
+
+  // Removing one of the duplicates removes the duplicate group.
+  opt.set_filter_text(QString());
+  Song deleted_song(song_);
+  deleted_song.set_id(1);
+  backend_->DeleteSongs(SongList() << deleted_song);
+  EXPECT_EQ(0, backend_->GetSongsByAlbum("Album", opt).count());
+
+}
+
+TEST_F(SingleSong, FingerprintCache) {
+
+  AddDummySong();
+  if (HasFatalFailure()) return;
+
+  const QUrl url = song_.url();
+  backend_->AddCachedFingerprint(url, 0, 100, 10, "hash1", "fingerprint1");
+  EXPECT_EQ("fingerprint1", backend_->GetCachedFingerprint(url, 0, 100, 10));
+  EXPECT_EQ("fingerprint1", backend_->GetCachedFingerprint("hash1"));
+
+  // A changed file is not a hit, even without an inode.
+  EXPECT_TRUE(backend_->GetCachedFingerprint(url, 0, 100, 11).isEmpty());
+  EXPECT_TRUE(backend_->GetCachedFingerprint(url, 0, 101, 10).isEmpty());
+  EXPECT_TRUE(backend_->GetCachedFingerprint(QUrl::fromLocalFile("bar.flac"), 0, 100, 10).isEmpty());
+
+  // Each file has one entry.
+  backend_->AddCachedFingerprint(url, 0, 100, 11, "hash2", "fingerprint2");
+  EXPECT_EQ("fingerprint2", backend_->GetCachedFingerprint(url, 0, 100, 11));
+  EXPECT_TRUE(backend_->GetCachedFingerprint("hash1").isEmpty());
+
+  // The entry is removed together with the song.
+  Song deleted_song(song_);
+  deleted_song.set_id(1);
+  backend_->DeleteSongs(SongList() << deleted_song);
+  EXPECT_TRUE(backend_->GetCachedFingerprint(url, 0, 100, 11).isEmpty());
+  EXPECT_TRUE(backend_->GetCachedFingerprint("hash2").isEmpty());
+
+}
+
 class TestUrls : public CollectionBackendTest {
  protected:
   void SetUp() override {
@@ -25,10 +25,18 @@
 
 #include <QMap>
 #include <QString>
+#include <QStringList>
 #include <QUrl>
+#include <QDateTime>
 #include <QThread>
+#include <QThreadPool>
+#include <QTemporaryDir>
+#include <QElapsedTimer>
+#include <QCoreApplication>
+#include <QPersistentModelIndex>
 #include <QSignalSpy>
 #include <QSortFilterProxyModel>
+#include <QSqlDatabase>
 #include <QtDebug>
 
 #include "test_utils.h"
@@ -36,6 +44,8 @@
 #include "core/logging.h"
 #include "core/database.h"
 #include "collection/collectionmodel.h"
+#include "collection/collectionitem.h"
+#include "collection/collectionquery.h"
 #include "collection/collectionbackend.h"
 #include "collection/collection.h"
 
@@ -50,8 +60,12 @@ class CollectionModelTest : public ::testing::Test {
  protected:
   void SetUp() override {
     database_ = std::make_shared<MemoryDatabase>(nullptr);
+    SetUpModel();
+  }
+
+  void SetUpModel() {
     backend_ = std::make_unique<CollectionBackend>();
-    backend_->Init(database_.get(), nullptr, Song::Source_Collection, SCollection::kSongsTable, SCollection::kFtsTable, SCollection::kDirsTable, SCollection::kSubdirsTable);
+    backend_->Init(database_.get(), nullptr, Song::Source_Collection, SCollection::kSongsTable, SCollection::kFtsTable, SCollection::kDirsTable, SCollection::kSubdirsTable, SCollection::kDuplicatesTable);
     model_ = std::make_unique<CollectionModel>(backend_.get(), nullptr);
 
     added_dir_ = false;
@@ -61,7 +75,6 @@ class CollectionModelTest : public ::testing::Test {
     model_sorted_->setSortRole(CollectionModel::Role_SortText);
     model_sorted_->setDynamicSortFilter(true);
     model_sorted_->sort(0);
-
   }
 
   Song AddSong(Song &song) {
@@ -96,6 +109,93 @@ class CollectionModelTest : public ::testing::Test {
   bool added_dir_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
 };
 
+// The async model runs its queries on other threads, so they need to see the same database.
+class CollectionModelAsyncTest : public CollectionModelTest {
+ protected:
+  void SetUp() override {
+    ASSERT_TRUE(temp_dir_.isValid());
+    database_ = std::make_shared<Database>(nullptr, nullptr, temp_dir_.path() + "/strawberry.db");
+    SetUpModel();
+  }
+
+  void TearDown() override {
+    QThreadPool::globalInstance()->waitForDone();
+    model_sorted_.reset();
+    model_.reset();
+    backend_.reset();
+    database_->Close();
+  }
+
+  bool HasLoadingIndicator(const QModelIndex &parent) const {
+    for (int row = 0; row < model_->rowCount(parent); ++row) {
+      const QModelIndex idx = model_->index(row, 0, parent);
+      if (idx.data(CollectionModel::Role_Type).toInt() == CollectionItem::Type_LoadingIndicator || HasLoadingIndicator(idx)) return true;
+    }
+    return false;
+  }
+
+  bool FetchAll(const QModelIndex &parent) {
+    bool fetched = false;
+    for (int row = 0; row < model_->rowCount(parent); ++row) {
+      const QModelIndex idx = model_->index(row, 0, parent);
+      if (model_->canFetchMore(idx)) {
+        model_->fetchMore(idx);
+        fetched = true;
+      }
+      else if (FetchAll(idx)) {
+        fetched = true;
+      }
+    }
+    return fetched;
+  }
+
+  void AddContents(const QModelIndex &parent, const QString &path, QStringList *contents) const {
+    for (int row = 0; row < model_->rowCount(parent); ++row) {
+      const QModelIndex idx = model_->index(row, 0, parent);
+      const QString item_path = path + "/" + idx.data().toString();
+      *contents << item_path;
+      AddContents(idx, item_path, contents);
+    }
+  }
+
+  // Processes events until the queries on other threads are done and their results are in the model.
+  bool WaitForQueries() {
+    QElapsedTimer timer;
+    timer.start();
+    do {
+      QThreadPool::globalInstance()->waitForDone();
+      QCoreApplication::processEvents();
+      if (timer.elapsed() > 10000) return false;
+    } while (QThreadPool::globalInstance()->activeThreadCount() > 0 || HasLoadingIndicator(QModelIndex()));
+    return true;
+  }
+
+  // Expands all items, and returns the text of each item in the tree together with the text of its parents.
+  QStringList ModelContents() {
+    bool fetched = false;
+    do {
+      fetched = FetchAll(QModelIndex());
+      if (fetched && !WaitForQueries()) return QStringList();
+    } while (fetched);
+
+    QStringList contents;
+    AddContents(QModelIndex(), QString(), &contents);
+    contents.sort();
+    return contents;
+  }
+
+  // Compares the model after the filter update with the model after a full reset with the same filter.
+  void ExpectSameAsReset() {
+    ASSERT_TRUE(WaitForQueries());
+    const QStringList contents = ModelContents();
+    model_->ResetAsync();
+    ASSERT_TRUE(WaitForQueries());
+    EXPECT_EQ(ModelContents(), contents);
+  }
+
+  QTemporaryDir temp_dir_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+};
+
 TEST_F(CollectionModelTest, Initialization) {
   EXPECT_EQ(0, model_->rowCount(QModelIndex()));
 }
@@ -346,6 +446,226 @@ TEST_F(CollectionModelTest, RemoveEmptyArtists) {
 
 }
 
+TEST_F(CollectionModelTest, UnionQuery) {
+
+  AddSong("Title 1", "Artist 1", "Album", 123);
+  AddSong("Title 2", "Artist 2", "Album", 123);
+
+  // The queries for a batch of nodes are combined, with the index of each query as the last column.
+  QSqlDatabase db(database_->Connect());
+  CollectionQuery query1(db, SCollection::kSongsTable, SCollection::kFtsTable);
+  query1.SetColumnSpec("title, 0");
+  query1.AddWhere("artist", "Artist 2");
+  CollectionQuery query2(db, SCollection::kSongsTable, SCollection::kFtsTable);
+  query2.SetColumnSpec("title, 1");
+  query2.AddWhere("artist", "Artist 1");
+  query1.AddUnion(query2);
+
+  ASSERT_TRUE(query1.Exec());
+  ASSERT_TRUE(query1.Next());
+  EXPECT_EQ("Title 2", query1.Value(0).toString());
+  EXPECT_EQ(0, query1.Value(1).toInt());
+  ASSERT_TRUE(query1.Next());
+  EXPECT_EQ("Title 1", query1.Value(0).toString());
+  EXPECT_EQ(1, query1.Value(1).toInt());
+  EXPECT_FALSE(query1.Next());
+
+}
+
+TEST_F(CollectionModelAsyncTest, LazyPopulateAsync) {
+
+  // More artists than there are queries in one batch.
+  const int count = CollectionModel::kPopulateBatchSize + 10;
+  SongList songs;
+  for (int i = 0; i < count; ++i) {
+    Song song;
+    song.Init(QString("Title %1").arg(i), QString("Artist %1").arg(i), QString("Album %1").arg(i), 123);
+    song.set_directory_id(1);
+    song.set_mtime(1);
+    song.set_ctime(1);
+    song.set_url(QUrl(QString("file:///tmp/foo%1").arg(i)));
+    song.set_filesize(1);
+    songs << song;
+  }
+  backend_->AddDirectory("/tmp");
+  backend_->AddOrUpdateSongs(songs);
+
+  model_->Init(true);
+  ASSERT_TRUE(WaitForQueries());
+
+  // Expand all artists at once, they are populated together.
+  QList<QPersistentModelIndex> artist_indexes;
+  for (int row = 0; row < model_->rowCount(QModelIndex()); ++row) {
+    const QModelIndex idx = model_->index(row, 0, QModelIndex());
+    if (idx.data(CollectionModel::Role_IsDivider).toBool()) continue;
+    artist_indexes << idx;
+    model_->fetchMore(idx);
+  }
+  ASSERT_EQ(count, artist_indexes.count());
+  EXPECT_TRUE(HasLoadingIndicator(QModelIndex()));
+
+  ASSERT_TRUE(WaitForQueries());
+
+  for (const QPersistentModelIndex &artist_index : std::as_const(artist_indexes)) {
+    ASSERT_TRUE(artist_index.isValid());
+    ASSERT_EQ(1, model_->rowCount(artist_index));
+    const QModelIndex album_index = model_->index(0, 0, artist_index);
+    EXPECT_EQ(CollectionItem::Type_Container, album_index.data(CollectionModel::Role_Type).toInt());
+    EXPECT_EQ(artist_index.data().toString().replace("Artist", "Album"), album_index.data().toString());
+  }
+
+}
+
+TEST_F(CollectionModelAsyncTest, SetFilterText) {
+
+  AddSong("Title 1", "Artist 1", "Album 1", 123);
+  AddSong("Title 2", "Artist 1", "Album 2", 123);
+  AddSong("Title 3", "Artist 2", "Album 3", 123);
+  AddSong("Title 4", "Other", "Album 4", 123);
+
+  model_->Init(true);
+  ASSERT_TRUE(WaitForQueries());
+
+  // The songs without a filter are known from the reset, so also the first filter updates the tree with the difference.
+  model_->SetFilterText("Artist");
+  ExpectSameAsReset();
+  if (HasFatalFailure()) return;
+  ASSERT_FALSE(ModelContents().isEmpty());
+
+  model_->SetFilterText("Album 2");
+  ExpectSameAsReset();
+  if (HasFatalFailure()) return;
+  EXPECT_FALSE(ModelContents().contains("/A/Artist 1/Album 1/Title 1"));
+
+  model_->SetFilterText("Title");
+  ExpectSameAsReset();
+  if (HasFatalFailure()) return;
+  EXPECT_TRUE(ModelContents().contains("/O/Other/Album 4/Title 4"));
+
+  model_->SetFilterText(QString());
+  ExpectSameAsReset();
+
+}
+
+TEST_F(CollectionModelAsyncTest, FilterKeepsExpandedItems) {
+
+  Song song1;
+  song1.Init("Title 1", "Artist 1", "Album 1", 123);
+  song1.set_url(QUrl("file:///tmp/foo1"));
+  AddSong(song1);
+  Song song2;
+  song2.Init("Title 2", "Artist 1", "Album 2", 123);
+  song2.set_url(QUrl("file:///tmp/foo2"));
+  AddSong(song2);
+
+  model_->Init(true);
+  ASSERT_TRUE(WaitForQueries());
+  ASSERT_TRUE(ModelContents().contains("/A/Artist 1/Album 1/Title 1"));
+
+  // Songs discovered without a filter are kept in the matching songs too.
+  Song song3;
+  song3.Init("Title 3", "Artist 1", "Album 1", 123);
+  song3.set_url(QUrl("file:///tmp/foo3"));
+  AddSong(song3);
+
+  // The items expanded before the filter stay expanded, without fetching them again.
+  model_->SetFilterText("Album 1");
+  ASSERT_TRUE(WaitForQueries());
+  QStringList contents;
+  AddContents(QModelIndex(), QString(), &contents);
+  EXPECT_TRUE(contents.contains("/A/Artist 1/Album 1/Title 1"));
+  EXPECT_TRUE(contents.contains("/A/Artist 1/Album 1/Title 3"));
+  EXPECT_FALSE(contents.contains("/A/Artist 1/Album 2"));
+
+  model_->SetFilterText(QString());
+  ASSERT_TRUE(WaitForQueries());
+  contents.clear();
+  AddContents(QModelIndex(), QString(), &contents);
+  EXPECT_TRUE(contents.contains("/A/Artist 1/Album 1/Title 1"));
+  EXPECT_TRUE(contents.contains("/A/Artist 1/Album 2"));
+
+  ExpectSameAsReset();
+
+}
+
+TEST_F(CollectionModelAsyncTest, SetFilterAge) {
+
+  const qint64 now = QDateTime::currentDateTime().toSecsSinceEpoch();
+  Song song1;
+  song1.Init("Title 1", "Artist 1", "Album 1", 123);
+  song1.set_ctime(now - 60);
+  song1.set_url(QUrl("file:///tmp/foo1"));
+  AddSong(song1);
+  Song song2;
+  song2.Init("Title 2", "Artist 1", "Album 2", 123);
+  song2.set_ctime(now - 7200);
+  song2.set_url(QUrl("file:///tmp/foo2"));
+  AddSong(song2);
+  Song song3;
+  song3.Init("Title 3", "Artist 2", "Album 3", 123);
+  song3.set_ctime(now - 7200);
+  song3.set_url(QUrl("file:///tmp/foo3"));
+  AddSong(song3);
+
+  model_->Init(true);
+  ASSERT_TRUE(WaitForQueries());
+
+  model_->SetFilterText("Title");
+  ASSERT_TRUE(WaitForQueries());
+  ASSERT_FALSE(ModelContents().isEmpty());
+
+  model_->SetFilterAge(3600);
+  ExpectSameAsReset();
+  if (HasFatalFailure()) return;
+  EXPECT_TRUE(ModelContents().contains("/A/Artist 1/Album 1/Title 1"));
+  EXPECT_FALSE(ModelContents().contains("/A/Artist 2"));
+
+  model_->SetFilterAge(-1);
+  ExpectSameAsReset();
+
+}
+
+TEST_F(CollectionModelAsyncTest, SetFilterMode) {
+
+  Song song1;
+  song1.Init("Title 1", "Artist 1", "Album 1", 123);
+  song1.set_url(QUrl("file:///tmp/foo1"));
+  AddSong(song1);
+  Song song2;
+  song2.Init("Title 1", "Artist 1", "Album 1", 123);
+  song2.set_url(QUrl("file:///tmp/foo2"));
+  AddSong(song2);
+  Song song3;
+  song3.Init("Title 3", "Artist 2", "Album 3", 123);
+  song3.set_url(QUrl("file:///tmp/foo3"));
+  AddSong(song3);
+  Song song4;
+  song4.Init("Title 4", "", "Album 4", 123);
+  song4.set_url(QUrl("file:///tmp/foo4"));
+  AddSong(song4);
+
+  model_->Init(true);
+  ASSERT_TRUE(WaitForQueries());
+
+  model_->SetFilterText("Title");
+  ASSERT_TRUE(WaitForQueries());
+  ASSERT_FALSE(ModelContents().isEmpty());
+
+  model_->SetFilterMode(CollectionFilterOptions::FilterMode_Duplicates);
+  ExpectSameAsReset();
+  if (HasFatalFailure()) return;
+  EXPECT_FALSE(ModelContents().contains("/A/Artist 2"));
+
+  model_->SetFilterMode(CollectionFilterOptions::FilterMode_Untagged);
+  ExpectSameAsReset();
+  if (HasFatalFailure()) return;
+  EXPECT_FALSE(ModelContents().contains("/A/Artist 1"));
+
+  model_->SetFilterMode(CollectionFilterOptions::FilterMode_All);
+  ExpectSameAsReset();
+
+}
+
 // Test to check that the container nodes are created identical and unique all through the model with all possible collection groupings.
 // model1 - Nodes are created from a complete reset done through lazy-loading.
 // model2 - Initial container nodes are created in SongsDiscovered.
@@ -0,0 +1,131 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2021, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <memory>
+
+#include <gtest/gtest.h>
+
+#include <QMap>
+#include <QString>
+#include <QStringList>
+#include <QJsonObject>
+
+#include "test_utils.h"
+
+#include "core/song.h"
+#include "core/database.h"
+#include "collection/collectionbackend.h"
+#include "internet/internetcollectionsync.h"
+
+// clazy:excludeall=returning-void-expression
+
+namespace {
+
+Song MakeSong(const QString &song_id, const QString &album_id) {
+
+  Song song(Song::Source_Subsonic);
+  song.set_song_id(song_id);
+  song.set_album_id(album_id);
+  song.set_title("Title " + song_id);
+  song.set_valid(true);
+  return song;
+
+}
+
+TEST(InternetCollectionSyncTest, AlbumSignature) {
+
+  QJsonObject obj;
+  obj["id"] = "1";
+  obj["songCount"] = 12;
+  obj["created"] = "2021-01-01T00:00:00Z";
+
+  const QStringList keys = QStringList() << "songCount" << "duration" << "created";
+  EXPECT_EQ("12||2021-01-01T00:00:00Z", InternetCollectionSync::AlbumSignature(obj, keys));
+
+  obj["songCount"] = 13;
+  EXPECT_EQ("13||2021-01-01T00:00:00Z", InternetCollectionSync::AlbumSignature(obj, keys));
+
+  EXPECT_TRUE(InternetCollectionSync::AlbumSignature(obj, QStringList() << "duration").isEmpty());
+
+}
+
+TEST(InternetCollectionSyncTest, UnchangedAlbumSongs) {
+
+  InternetCollectionSync sync;
+  EXPECT_TRUE(sync.full_sync());
+
+  QMap<QString, QString> albums;
+  albums.insert("album1", "12");
+  albums.insert("album2", "3");
+  sync.SetPreviousSync(albums, SongList() << MakeSong("song1", "album1") << MakeSong("song2", "album1") << MakeSong("song3", "album2") << MakeSong("song4", "album3"));
+  EXPECT_FALSE(sync.full_sync());
+
+  const SongList songs = sync.UnchangedAlbumSongs("album1", "12");
+  ASSERT_EQ(2, songs.count());
+  EXPECT_EQ("song1", songs[0].song_id());
+  EXPECT_EQ("song2", songs[1].song_id());
+
+  // Changed, new, or without a signature.
+  EXPECT_TRUE(sync.UnchangedAlbumSongs("album2", "4").isEmpty());
+  EXPECT_TRUE(sync.UnchangedAlbumSongs("album3", "1").isEmpty());
+  EXPECT_TRUE(sync.UnchangedAlbumSongs("album1", QString()).isEmpty());
+
+  sync.AlbumSynced("album1", "12");
+  sync.AlbumSynced("album2", "4");
+  sync.AlbumSynced("album4", QString());
+  EXPECT_EQ(2, sync.synced_albums().count());
+  EXPECT_EQ("4", sync.synced_albums().value("album2"));
+
+}
+
+class InternetCollectionSyncBackendTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    database_.reset(new MemoryDatabase(nullptr));
+    backend_ = std::make_unique<CollectionBackend>();
+    backend_->Init(database_.get(), nullptr, Song::Source_Subsonic, "subsonic_songs", "subsonic_songs_fts");
+  }
+
+  std::shared_ptr<Database> database_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+  std::unique_ptr<CollectionBackend> backend_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+};
+
+TEST_F(InternetCollectionSyncBackendTest, SyncedAlbums) {
+
+  EXPECT_TRUE(backend_->GetSyncedAlbums().isEmpty());
+
+  QMap<QString, QString> albums;
+  albums.insert("album1", "12");
+  albums.insert("album2", "3");
+  backend_->SetSyncedAlbums(albums);
+  EXPECT_EQ(albums, backend_->GetSyncedAlbums());
+
+  // The new state replaces the old one.
+  albums.remove("album1");
+  albums.insert("album3", "7");
+  backend_->SetSyncedAlbums(albums);
+  EXPECT_EQ(albums, backend_->GetSyncedAlbums());
+
+  // Clearing the collection forces a full sync.
+  backend_->DeleteAll();
+  EXPECT_TRUE(backend_->GetSyncedAlbums().isEmpty());
+
+}
+
+}  // namespace
@@ -0,0 +1,89 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2021, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <memory>
+
+#include <gtest/gtest.h>
+
+#include <QString>
+
+#include "test_utils.h"
+
+#include "core/database.h"
+#include "lyrics/lyricscache.h"
+
+// clazy:excludeall=returning-void-expression
+
+namespace {
+
+class LyricsCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    database_.reset(new MemoryDatabase(nullptr));
+    cache_ = std::make_unique<LyricsCache>(database_.get());
+  }
+
+  std::shared_ptr<Database> database_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+  std::unique_ptr<LyricsCache> cache_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+};
+
+TEST_F(LyricsCacheTest, Empty) {
+
+  EXPECT_EQ(LyricsCache::Status_None, cache_->Get("Artist", "Album", "Title").status);
+
+}
+
+TEST_F(LyricsCacheTest, Found) {
+
+  cache_->Add("Artist", "Album", "Title", "lyrics.ovh", "Some lyrics");
+
+  // Lookups ignore case and extra whitespace.
+  const LyricsCache::Entry entry = cache_->Get("artist", " Album ", "TITLE");
+  EXPECT_EQ(LyricsCache::Status_Found, entry.status);
+  EXPECT_EQ("lyrics.ovh", entry.provider);
+  EXPECT_EQ("Some lyrics", entry.lyrics);
+  EXPECT_GT(entry.time, 0);
+
+  EXPECT_EQ(LyricsCache::Status_None, cache_->Get("Artist", "Other album", "Title").status);
+
+}
+
+TEST_F(LyricsCacheTest, MissingExpires) {
+
+  cache_->AddMissing("Artist", QString(), "Title");
+  EXPECT_EQ(LyricsCache::Status_Missing, cache_->Get("Artist", QString(), "Title").status);
+
+  cache_->set_miss_expiry(-1);
+  EXPECT_EQ(LyricsCache::Status_None, cache_->Get("Artist", QString(), "Title").status);
+
+  // Lyrics found later replace the failed search.
+  cache_->Add("Artist", QString(), "Title", "lyrics.ovh", "Some lyrics");
+  EXPECT_EQ(LyricsCache::Status_Found, cache_->Get("Artist", QString(), "Title").status);
+
+}
+
+TEST_F(LyricsCacheTest, Clear) {
+
+  cache_->Add("Artist", "Album", "Title", "lyrics.ovh", "Some lyrics");
+  cache_->Clear();
+  EXPECT_EQ(LyricsCache::Status_None, cache_->Get("Artist", "Album", "Title").status);
+
+}
+
+}  // namespace
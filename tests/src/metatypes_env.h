@@ -29,6 +29,7 @@
 #include "core/song.h"
 #include "core/songloader.h"
 #include "collection/collectiondirectory.h"
+#include "collection/collectionbackend.h"
 
 class MetatypesEnvironment : public ::testing::Environment {
  public:
@@ -41,6 +42,7 @@ class MetatypesEnvironment : public ::testing::Environment {
     qRegisterMetaType<SongList>("SongList");
     qRegisterMetaType<QModelIndex>("QModelIndex");
     qRegisterMetaType<SongLoader::Result>("SongLoader::Result");
+    qRegisterMetaType<SyncedAlbumMap>("SyncedAlbumMap");
   }
  private:
   Q_DISABLE_COPY(MetatypesEnvironment)
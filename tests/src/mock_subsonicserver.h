@@ -0,0 +1,181 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2021, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MOCK_SUBSONICSERVER_H
+#define MOCK_SUBSONICSERVER_H
+
+#include <QtGlobal>
+#include <QObject>
+#include <QList>
+#include <QSet>
+#include <QByteArray>
+#include <QString>
+#include <QUrl>
+#include <QUrlQuery>
+#include <QTimer>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QHostAddress>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+
+// Minimal Subsonic server answering getAlbumList2 and getAlbum from a generated collection, credentials are not checked.
+// Every response is delayed by latency_msec to simulate a remote server.
+class MockSubsonicServer {
+ public:
+  explicit MockSubsonicServer(const int albums, const int songs_per_album, const int latency_msec)
+      : albums_(albums),
+        songs_per_album_(songs_per_album),
+        latency_msec_(latency_msec),
+        requests_(0) {
+
+    QObject::connect(&server_, &QTcpServer::newConnection, [this]() {
+      while (QTcpSocket *socket = server_.nextPendingConnection()) {
+        QObject::connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+        QObject::connect(socket, &QTcpSocket::readyRead, socket, [this, socket]() { ReadRequest(socket); });
+      }
+    });
+
+  }
+
+  bool Listen() { return server_.listen(QHostAddress::LocalHost); }
+  QUrl url() const { return QUrl(QString("http://127.0.0.1:%1").arg(server_.serverPort())); }
+
+  int albums() const { return albums_; }
+  int songs_per_album() const { return songs_per_album_; }
+  int requests() const { return requests_; }
+  void reset_requests() { requests_ = 0; }
+
+  // Adds a song to the album, which changes its songCount and duration in the album list.
+  void ChangeAlbum(const int album) { changed_albums_.insert(album); }
+
+ private:
+  int SongCount(const int album) const { return songs_per_album_ + (changed_albums_.contains(album) ? 1 : 0); }
+
+  QJsonObject Album(const int album) const {
+
+    QJsonObject obj;
+    obj["id"] = QString("al-%1").arg(album);
+    obj["name"] = QString("Album %1").arg(album);
+    obj["artist"] = QString("Artist %1").arg(album / 8);
+    obj["artistId"] = QString("ar-%1").arg(album / 8);
+    obj["coverArt"] = QString("al-%1").arg(album);
+    obj["songCount"] = SongCount(album);
+    obj["duration"] = SongCount(album) * 240;
+    obj["created"] = "2021-01-01T00:00:00.000Z";
+    obj["year"] = 1960 + album % 60;
+    return obj;
+
+  }
+
+  QByteArray AlbumList(const int offset, const int size) const {
+
+    QJsonArray array;
+    for (int album = offset; album < qMin(albums_, offset + size); ++album) {
+      array.append(Album(album));
+    }
+    QJsonObject album_list;
+    album_list["album"] = array;
+    QJsonObject response;
+    response["status"] = "ok";
+    response["albumList2"] = album_list;
+    return Response(response);
+
+  }
+
+  QByteArray AlbumSongs(const int album) const {
+
+    QJsonObject obj = Album(album);
+    QJsonArray songs;
+    for (int track = 0; track < SongCount(album); ++track) {
+      QJsonObject song;
+      song["id"] = QString("so-%1-%2").arg(album).arg(track);
+      song["albumId"] = obj["id"];
+      song["album"] = obj["name"];
+      song["artist"] = obj["artist"];
+      song["title"] = QString("Track %1").arg(track + 1);
+      song["track"] = track + 1;
+      song["duration"] = 240;
+      song["size"] = 24000000;
+      song["suffix"] = "flac";
+      song["contentType"] = "audio/flac";
+      song["type"] = "music";
+      songs.append(song);
+    }
+    obj["song"] = songs;
+    QJsonObject response;
+    response["status"] = "ok";
+    response["album"] = obj;
+    return Response(response);
+
+  }
+
+  static QByteArray Response(const QJsonObject &response) {
+
+    QJsonObject root;
+    root["subsonic-response"] = response;
+    return QJsonDocument(root).toJson(QJsonDocument::Compact);
+
+  }
+
+  void ReadRequest(QTcpSocket *socket) {
+
+    if (!socket->canReadLine()) return;
+    const QList<QByteArray> request_line = socket->readLine().trimmed().split(' ');
+    socket->readAll();
+    if (request_line.count() < 2) {
+      socket->disconnectFromHost();
+      return;
+    }
+
+    ++requests_;
+    const QUrl url(QString::fromLatin1(request_line[1]));
+    const QUrlQuery query(url);
+    QString path = url.path();
+    if (path.endsWith(".view")) path.chop(5);
+    QByteArray body;
+    QByteArray status = "200 OK";
+    if (path.endsWith("/getAlbumList2")) {
+      body = AlbumList(query.queryItemValue("offset").toInt(), query.queryItemValue("size").toInt());
+    }
+    else if (path.endsWith("/getAlbum")) {
+      body = AlbumSongs(query.queryItemValue("id").mid(3).toInt());
+    }
+    else {
+      status = "404 Not Found";
+    }
+
+    QTimer::singleShot(latency_msec_, socket, [socket, status, body]() {
+      socket->write("HTTP/1.1 " + status + "\r\nContent-Type: application/json\r\nContent-Length: " + QByteArray::number(body.size()) + "\r\nConnection: close\r\n\r\n" + body);
+      socket->disconnectFromHost();
+    });
+
+  }
+
+ private:
+  QTcpServer server_;
+  int albums_;
+  int songs_per_album_;
+  int latency_msec_;
+  int requests_;
+  QSet<int> changed_albums_;
+};
+
+#endif  // MOCK_SUBSONICSERVER_H
@@ -25,13 +25,31 @@
 
 #include "test_utils.h"
 
+#include "core/database.h"
+#include "core/sqlquery.h"
+#include "core/scopedtransaction.h"
 #include "collection/collectionplaylistitem.h"
 #include "playlist/playlist.h"
+#include "playlist/playlistbackend.h"
+#include "playlist/playlistfilter.h"
+#include "playlist/playlistundocommands.h"
+#include "queue/queue.h"
 #include "mock_settingsprovider.h"
 #include "mock_playlistitem.h"
 
 #include <QtDebug>
+#include <QCoreApplication>
+#include <QEventLoop>
+#include <QElapsedTimer>
 #include <QUndoStack>
+#include <QList>
+#include <QPair>
+#include <QUrl>
+#include <QStringList>
+#include <QSqlDatabase>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QThreadPool>
 
 using ::testing::Return;
 
@@ -543,5 +561,402 @@ TEST_F(PlaylistTest, CollectionIdMapMulti) {
 
 }
 
+TEST_F(PlaylistTest, SortByTitle) {
+
+  playlist_.InsertItems(PlaylistItemList() << MakeMockItemP("beta") << MakeMockItemP("Alpha") << MakeMockItemP("gamma") << MakeMockItemP("Beta"));
+
+  playlist_.sort(Playlist::Column_Title, Qt::AscendingOrder);
+  EXPECT_EQ("Alpha", playlist_.item_at(0)->Metadata().title());
+  EXPECT_EQ("beta", playlist_.item_at(1)->Metadata().title());
+  EXPECT_EQ("Beta", playlist_.item_at(2)->Metadata().title());
+  EXPECT_EQ("gamma", playlist_.item_at(3)->Metadata().title());
+
+  playlist_.sort(Playlist::Column_Title, Qt::DescendingOrder);
+  EXPECT_EQ("gamma", playlist_.item_at(0)->Metadata().title());
+  EXPECT_EQ("Alpha", playlist_.item_at(3)->Metadata().title());
+
+}
+
+TEST_F(PlaylistTest, SortByAlbumUsesDiscAndTrack) {
+
+  PlaylistItemList items;
+  const QList<QPair<int, int>> disc_tracks = QList<QPair<int, int>>() << qMakePair(2, 1) << qMakePair(1, 2) << qMakePair(1, 1);
+  for (const QPair<int, int> &disc_track : disc_tracks) {
+    Song song;
+    song.Init(QString("Title %1-%2").arg(disc_track.first).arg(disc_track.second), "Artist", "Album", 123);
+    song.set_disc(disc_track.first);
+    song.set_track(disc_track.second);
+    items << std::make_shared<CollectionPlaylistItem>(song);
+  }
+  items << MakeMockItemP("Title", "Artist", "Another album");
+  playlist_.InsertItems(items);
+
+  playlist_.sort(Playlist::Column_Album, Qt::AscendingOrder);
+  EXPECT_EQ("Another album", playlist_.item_at(0)->Metadata().album());
+  EXPECT_EQ("Title 1-1", playlist_.item_at(1)->Metadata().title());
+  EXPECT_EQ("Title 1-2", playlist_.item_at(2)->Metadata().title());
+  EXPECT_EQ("Title 2-1", playlist_.item_at(3)->Metadata().title());
+
+}
+
+TEST_F(PlaylistTest, SortAfterMetadataChange) {
+
+  Song one;
+  one.Init("A", "Artist", "Album", 123);
+  Song two;
+  two.Init("B", "Artist", "Album", 123);
+  PlaylistItemPtr item_one(std::make_shared<CollectionPlaylistItem>(one));
+  PlaylistItemPtr item_two(std::make_shared<CollectionPlaylistItem>(two));
+  playlist_.InsertItems(PlaylistItemList() << item_one << item_two);
+
+  playlist_.sort(Playlist::Column_Title, Qt::AscendingOrder);
+  EXPECT_EQ(item_one, playlist_.item_at(0));
+
+  one.set_title("C");
+  item_one->SetMetadata(one);
+  playlist_.sort(Playlist::Column_Title, Qt::AscendingOrder);
+  EXPECT_EQ(item_two, playlist_.item_at(0));
+
+}
+
+TEST_F(PlaylistTest, QueuePositions) {
+
+  playlist_.InsertItems(PlaylistItemList() << MakeMockItemP("One") << MakeMockItemP("Two") << MakeMockItemP("Three"));
+
+  Queue *queue = playlist_.queue();
+  queue->ToggleTracks(QModelIndexList() << playlist_.index(2, 0) << playlist_.index(0, 0));
+  EXPECT_EQ(0, queue->PositionOf(playlist_.index(2, 0)));
+  EXPECT_EQ(-1, queue->PositionOf(playlist_.index(1, 0)));
+  EXPECT_EQ(1, queue->PositionOf(playlist_.index(0, 0)));
+  EXPECT_TRUE(queue->ContainsSourceRow(2));
+  EXPECT_FALSE(queue->ContainsSourceRow(1));
+
+  // Inserting into the playlist moves the queued rows
+  playlist_.InsertItems(PlaylistItemList() << MakeMockItemP("Zero"), 0);
+  EXPECT_EQ(0, queue->PositionOf(playlist_.index(3, 0)));
+  EXPECT_EQ(1, queue->PositionOf(playlist_.index(1, 0)));
+  EXPECT_FALSE(queue->ContainsSourceRow(0));
+
+  // Taking the first one moves the rest up
+  EXPECT_EQ(3, queue->TakeNext());
+  EXPECT_EQ(-1, queue->PositionOf(playlist_.index(3, 0)));
+  EXPECT_EQ(0, queue->PositionOf(playlist_.index(1, 0)));
+
+  // Removing from the playlist removes it from the queue
+  playlist_.removeRow(1);
+  EXPECT_TRUE(queue->is_empty());
+  EXPECT_FALSE(queue->ContainsSourceRow(1));
+
+}
+
+TEST_F(PlaylistTest, NextRows) {
+
+  playlist_.InsertItems(PlaylistItemList() << MakeMockItemP("One") << MakeMockItemP("Two") << MakeMockItemP("Three") << MakeMockItemP("Four"));
+
+  playlist_.set_current_row(1);
+  EXPECT_EQ(QList<int>() << 2 << 3, playlist_.next_rows(5));
+  EXPECT_EQ(QList<int>() << 2, playlist_.next_rows(1));
+
+  // Queued items come first
+  playlist_.queue()->ToggleTracks(QModelIndexList() << playlist_.index(0, 0));
+  EXPECT_EQ(QList<int>() << 0 << 2, playlist_.next_rows(2));
+  playlist_.queue()->Clear();
+
+  // Wrap around, but stop at the current track
+  playlist_.sequence()->SetRepeatMode(PlaylistSequence::Repeat_Playlist);
+  EXPECT_EQ(QList<int>() << 2 << 3 << 0, playlist_.next_rows(5));
+
+  playlist_.sequence()->SetRepeatMode(PlaylistSequence::Repeat_Track);
+  EXPECT_TRUE(playlist_.next_rows(5).isEmpty());
+
+}
+
+TEST_F(PlaylistTest, FilterFollowsPlaylistChanges) {
+
+  playlist_.InsertItems(PlaylistItemList() << MakeMockItemP("One", "Artist") << MakeMockItemP("Two", "Another artist") << MakeMockItemP("Three", "Artist"));
+
+  PlaylistFilter *filter = playlist_.filter();
+  filter->SetFilterText("artist:=artist");
+  EXPECT_EQ(2, filter->rowCount());
+
+  // Rows inserted before the filtered rows
+  playlist_.InsertItems(PlaylistItemList() << MakeMockItemP("Zero", "Artist") << MakeMockItemP("Zero", "Someone else"), 0);
+  EXPECT_EQ(3, filter->rowCount());
+  EXPECT_TRUE(filter->filterAcceptsRow(0, QModelIndex()));
+  EXPECT_FALSE(filter->filterAcceptsRow(1, QModelIndex()));
+  EXPECT_TRUE(filter->filterAcceptsRow(2, QModelIndex()));
+  EXPECT_FALSE(filter->filterAcceptsRow(3, QModelIndex()));
+
+  // Rows removed
+  playlist_.removeRows(0, 2);
+  EXPECT_EQ(2, filter->rowCount());
+  EXPECT_TRUE(filter->filterAcceptsRow(0, QModelIndex()));
+  EXPECT_FALSE(filter->filterAcceptsRow(1, QModelIndex()));
+
+  filter->SetFilterText("");
+  EXPECT_EQ(3, filter->rowCount());
+
+}
+
+TEST_F(PlaylistTest, ItemPositionsKeepOrderedItems) {
+
+  // New items are spaced out after each other
+  QList<qint64> saved_positions;
+  for (int i = 0; i < 5; ++i) saved_positions << -1;
+  QList<qint64> positions = Playlist::ItemPositions(saved_positions);
+  ASSERT_EQ(5, positions.count());
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_EQ((i + 1) * Playlist::kPositionStep, positions[i]);
+  }
+
+  // Moving one item in a big playlist only changes the position of that item
+  saved_positions.clear();
+  for (int i = 0; i < 30000; ++i) saved_positions << (i + 1) * Playlist::kPositionStep;
+  saved_positions.move(10, 20000);
+  positions = Playlist::ItemPositions(saved_positions);
+  int changed = 0;
+  for (int i = 0; i < positions.count(); ++i) {
+    if (i > 0) EXPECT_LT(positions[i - 1], positions[i]);
+    if (positions[i] != saved_positions[i]) ++changed;
+  }
+  EXPECT_EQ(1, changed);
+  EXPECT_NE(saved_positions[20000], positions[20000]);
+
+  // Items inserted between others get a position in between
+  saved_positions = QList<qint64>() << 1024 << -1 << -1 << 2048;
+  positions = Playlist::ItemPositions(saved_positions);
+  EXPECT_EQ(QList<qint64>() << 1024 << 1365 << 1706 << 2048, positions);
+
+  // The playlist is renumbered when there's no room left
+  saved_positions = QList<qint64>() << 1 << -1 << 2;
+  positions = Playlist::ItemPositions(saved_positions);
+  EXPECT_EQ(QList<qint64>() << Playlist::kPositionStep << Playlist::kPositionStep * 2 << Playlist::kPositionStep * 3, positions);
+
+}
+
+class PlaylistRestoreTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_TRUE(temp_dir_.isValid());
+    // The pages are read on other threads, so they need to see the same database.
+    database_ = std::make_unique<Database>(nullptr, nullptr, temp_dir_.path() + "/strawberry.db");
+    backend_ = std::make_unique<PlaylistBackend>(database_.get());
+    playlist_id_ = backend_->CreatePlaylist("Test", QString());
+    ASSERT_NE(-1, playlist_id_);
+  }
+
+  void TearDown() override {
+    QThreadPool::globalInstance()->waitForDone();
+    backend_.reset();
+    database_->Close();
+  }
+
+  // Adds count stream items, the item at missing_row is a collection song which no longer exists.
+  void AddItems(const int count, const int missing_row) {
+
+    QSqlDatabase db(database_->Connect());
+    ScopedTransaction t(&db);
+    SqlQuery q(db);
+    q.prepare("INSERT INTO playlist_items (playlist, position, type, collection_id, url, title) VALUES (:playlist, :position, :type, :collection_id, :url, :title)");
+    for (int i = 0; i < count; ++i) {
+      const bool missing = i == missing_row;
+      q.BindValue(":playlist", playlist_id_);
+      q.BindValue(":position", (i + 1) * Playlist::kPositionStep);
+      q.BindValue(":type", missing ? Song::Source_Collection : Song::Source_Stream);
+      q.BindValue(":collection_id", missing ? 123456 : -1);
+      q.BindValue(":url", missing ? QString("file:///missing.flac") : QString("http://example.com/%1").arg(i));
+      q.BindValue(":title", QString("Title %1").arg(i));
+      ASSERT_TRUE(q.Exec());
+    }
+    t.Commit();
+
+  }
+
+  QTemporaryDir temp_dir_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+  std::unique_ptr<Database> database_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+  std::unique_ptr<PlaylistBackend> backend_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+  int playlist_id_ = -1;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+};
+
+TEST_F(PlaylistRestoreTest, GetPlaylistItemsPages) {
+
+  AddItems(Playlist::kRestorePageSize + 10, 5);
+  if (HasFatalFailure()) return;
+
+  const PlaylistBackend::PlaylistItemPage page1 = backend_->GetPlaylistItems(playlist_id_, -1, -1, Playlist::kRestorePageSize);
+  EXPECT_EQ(Playlist::kRestorePageSize, page1.rows_read);
+  EXPECT_EQ(Playlist::kRestorePageSize * Playlist::kPositionStep, page1.last_position);
+
+  const PlaylistBackend::PlaylistItemPage page2 = backend_->GetPlaylistItems(playlist_id_, page1.last_position, page1.last_id, Playlist::kRestorePageSize);
+  EXPECT_EQ(10, page2.rows_read);
+  ASSERT_EQ(10, page2.rows.count());
+  EXPECT_EQ(QString("Title %1").arg(Playlist::kRestorePageSize), page2.rows.first().item->Metadata().title());
+
+}
+
+TEST_F(PlaylistRestoreTest, RestoreAllPages) {
+
+  // The last row of the first page is not added to the playlist.
+  const int count = Playlist::kRestorePageSize * 2 + 10;
+  AddItems(count, Playlist::kRestorePageSize - 1);
+  if (HasFatalFailure()) return;
+
+  Playlist playlist(backend_.get(), nullptr, nullptr, playlist_id_);
+  QSignalSpy inserted_spy(&playlist, &Playlist::rowsInserted);
+  QSignalSpy loaded_spy(&playlist, &Playlist::PlaylistLoaded);
+
+  // Add an item once the first page is loaded, it stays after the restored items.
+  ASSERT_TRUE(inserted_spy.wait(10000));
+  Song song(Song::Source_Stream);
+  song.set_url(QUrl("http://example.com/added"));
+  song.set_title("Added");
+  playlist.InsertSongs(SongList() << song);
+
+  ASSERT_TRUE(loaded_spy.count() > 0 || loaded_spy.wait(10000));
+
+  ASSERT_EQ(count, playlist.rowCount());
+  int i = 0;
+  for (int row = 0; row < count - 1; ++row, ++i) {
+    if (i == Playlist::kRestorePageSize - 1) ++i;
+    EXPECT_EQ(QString("Title %1").arg(i), playlist.item_at(row)->Metadata().title());
+  }
+  EXPECT_EQ("Added", playlist.item_at(count - 1)->Metadata().title());
+
+  // The deleted songs are checked in the background.
+  QThreadPool::globalInstance()->waitForDone();
+
+}
+
+class PlaylistSaveTest : public PlaylistRestoreTest {
+ protected:
+  PlaylistSaveTest() : saves_(0) {}
+
+  void SetUp() override {
+    PlaylistRestoreTest::SetUp();
+    QObject::connect(backend_.get(), &PlaylistBackend::PlaylistSaved, backend_.get(), [this](const int, const QList<int> &new_ids) {
+      new_ids_ = new_ids;
+      ++saves_;
+    });
+  }
+
+  // Processes events until the playlist was saved count times.
+  bool WaitForSaves(const int count) {
+    QElapsedTimer timer;
+    timer.start();
+    while (saves_ < count) {
+      if (timer.elapsed() > 10000) return false;
+      QCoreApplication::processEvents(QEventLoop::WaitForMoreEvents, 100);
+    }
+    return true;
+  }
+
+  // Marks all rows in the database, the rows written by the next save lose the mark.
+  void MarkRows() {
+    QSqlDatabase db(database_->Connect());
+    SqlQuery q(db);
+    q.prepare("UPDATE playlist_items SET comment = 'Not written' WHERE playlist = :playlist");
+    q.BindValue(":playlist", playlist_id_);
+    ASSERT_TRUE(q.Exec());
+  }
+
+  // Returns the titles of the rows in the database in the order of their positions, or only of the rows still marked.
+  QStringList SavedTitles(const bool marked_only = false) {
+    QSqlDatabase db(database_->Connect());
+    SqlQuery q(db);
+    q.prepare(QString("SELECT title FROM playlist_items WHERE playlist = :playlist %1 ORDER BY position").arg(marked_only ? "AND comment = 'Not written'" : ""));
+    q.BindValue(":playlist", playlist_id_);
+    QStringList titles;
+    if (!q.Exec()) return titles;
+    while (q.next()) titles << q.value(0).toString();
+    return titles;
+  }
+
+  int saves_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+  QList<int> new_ids_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+};
+
+TEST_F(PlaylistSaveTest, SavePlaylistChanges) {
+
+  AddItems(4, -1);
+  if (HasFatalFailure()) return;
+
+  const PlaylistBackend::PlaylistItemPage page = backend_->GetPlaylistItems(playlist_id_, -1, -1, -1);
+  ASSERT_EQ(4, page.rows.count());
+  MarkRows();
+  if (HasFatalFailure()) return;
+
+  PlaylistBackend::PlaylistItemChanges changes;
+  changes.removed_ids << page.rows[0].id;
+  // A moved item only gets a new position.
+  changes.rows << PlaylistBackend::PlaylistItemRow(page.rows[3].id, Playlist::kPositionStep);
+  // A changed item is written with all columns.
+  Song changed_song = page.rows[2].item->Metadata();
+  changed_song.set_title("Changed");
+  changes.rows << PlaylistBackend::PlaylistItemRow(page.rows[2].id, page.rows[2].position, PlaylistItem::NewFromSong(changed_song));
+  Song added_song(Song::Source_Stream);
+  added_song.set_url(QUrl("http://example.com/added"));
+  added_song.set_title("Added");
+  changes.rows << PlaylistBackend::PlaylistItemRow(-1, Playlist::kPositionStep * 5, PlaylistItem::NewFromSong(added_song));
+
+  backend_->SavePlaylist(playlist_id_, changes, -1, PlaylistGeneratorPtr());
+  ASSERT_EQ(1, saves_);
+  ASSERT_EQ(1, new_ids_.count());
+  EXPECT_NE(-1, new_ids_.first());
+
+  EXPECT_EQ(QStringList() << "Title 3" << "Title 1" << "Changed" << "Added", SavedTitles());
+  EXPECT_EQ(QStringList() << "Title 3" << "Title 1", SavedTitles(true));
+
+  // A rewrite replaces all rows of the playlist.
+  changes = PlaylistBackend::PlaylistItemChanges();
+  changes.rewrite = true;
+  changes.rows << PlaylistBackend::PlaylistItemRow(-1, Playlist::kPositionStep, page.rows[1].item) << PlaylistBackend::PlaylistItemRow(-1, Playlist::kPositionStep * 2, page.rows[0].item);
+
+  backend_->SavePlaylist(playlist_id_, changes, -1, PlaylistGeneratorPtr());
+  ASSERT_EQ(2, saves_);
+  EXPECT_EQ(2, new_ids_.count());
+  EXPECT_EQ(QStringList() << "Title 1" << "Title 0", SavedTitles());
+
+}
+
+TEST_F(PlaylistSaveTest, SaveOnlyChangedItems) {
+
+  AddItems(5, -1);
+  if (HasFatalFailure()) return;
+
+  {
+    Playlist playlist(backend_.get(), nullptr, nullptr, playlist_id_);
+
+    // The playlist is saved once all pages are loaded, nothing changed so no rows are written.
+    ASSERT_TRUE(WaitForSaves(1));
+    ASSERT_EQ(5, playlist.rowCount());
+    EXPECT_TRUE(new_ids_.isEmpty());
+    MarkRows();
+    if (HasFatalFailure()) return;
+
+    playlist.RemoveItemsWithoutUndo(QList<int>() << 0);
+    playlist.undo_stack()->push(new PlaylistUndoCommands::MoveItems(&playlist, QList<int>() << 3, 0));
+    Song song(Song::Source_Stream);
+    song.set_url(QUrl("http://example.com/added"));
+    song.set_title("Added");
+    playlist.InsertSongs(SongList() << song);
+
+    ASSERT_TRUE(WaitForSaves(2));
+    EXPECT_EQ(1, new_ids_.count());
+  }
+
+  // The removed row is deleted, the moved row only got a new position and the other rows were not written.
+  const QStringList titles = SavedTitles();
+  EXPECT_EQ(QStringList() << "Title 4" << "Title 1" << "Title 2" << "Title 3" << "Added", titles);
+  EXPECT_EQ(QStringList() << "Title 4" << "Title 1" << "Title 2" << "Title 3", SavedTitles(true));
+
+  // Restoring the playlist again gives the same items.
+  Playlist playlist(backend_.get(), nullptr, nullptr, playlist_id_);
+  ASSERT_TRUE(WaitForSaves(3));
+  ASSERT_EQ(titles.count(), playlist.rowCount());
+  for (int row = 0; row < titles.count(); ++row) {
+    EXPECT_EQ(titles[row], playlist.item_at(row)->Metadata().title());
+  }
+
+}
 
 }  // namespace
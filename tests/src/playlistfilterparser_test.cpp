@@ -0,0 +1,133 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2021, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <memory>
+
+#include <gtest/gtest.h>
+
+#include <QList>
+#include <QMap>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QStandardItemModel>
+
+#include "test_utils.h"
+
+#include "playlist/playlist.h"
+#include "playlist/playlistfilterparser.h"
+
+// clazy:excludeall=non-pod-global-static,returning-void-expression
+
+namespace {
+
+class FilterParserTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+
+    column_names_["title"] = Playlist::Column_Title;
+    column_names_["artist"] = Playlist::Column_Artist;
+    column_names_["album"] = Playlist::Column_Album;
+    column_names_["year"] = Playlist::Column_Year;
+    column_names_["length"] = Playlist::Column_Length;
+    numerical_columns_ << Playlist::Column_Year << Playlist::Column_Length;
+
+    model_.setColumnCount(Playlist::ColumnCount);
+    AddRow("Help!", "The Beatles", "Help!", 1965, 138000000000LL);
+    AddRow("Yesterday", "The Beatles", "Help!", 1965, 125000000000LL);
+    AddRow("Paranoid Android", "Radiohead", "OK Computer", 1997, 383000000000LL);
+    AddRow("Airbag", "Radiohead", "OK Computer", 1997, 284000000000LL);
+    AddRow("Windowlicker", "Aphex Twin", "", 1999, 367000000000LL);
+
+  }
+
+  void AddRow(const QString &title, const QString &artist, const QString &album, const int year, const qint64 length) {
+
+    const int row = model_.rowCount();
+    model_.insertRow(row);
+    model_.setData(model_.index(row, Playlist::Column_Title), title);
+    model_.setData(model_.index(row, Playlist::Column_Artist), artist);
+    model_.setData(model_.index(row, Playlist::Column_Album), album);
+    model_.setData(model_.index(row, Playlist::Column_Year), year);
+    model_.setData(model_.index(row, Playlist::Column_Length), length);
+
+  }
+
+  // Returns the rows accepted by the filter tree, and checks that the compiled program accepts the same rows.
+  QList<int> AcceptedRows(const QString &filter) {
+
+    FilterParser parser(filter, column_names_, numerical_columns_);
+    std::unique_ptr<FilterTree> tree(parser.parse());
+
+    QList<int> columns;
+    for (const int column : column_names_) {
+      if (!columns.contains(column)) columns << column;
+    }
+    FilterProgram program(columns);
+    tree->compile(&program);
+
+    QList<int> rows;
+    for (int row = 0; row < model_.rowCount(); ++row) {
+      const bool accepted = tree->accept(row, QModelIndex(), &model_);
+      EXPECT_EQ(accepted, program.Evaluate(FilterProgram::ReadRow(&model_, row, QModelIndex(), columns))) << filter.toStdString() << " row " << row;
+      if (accepted) rows << row;
+    }
+
+    return rows;
+
+  }
+
+  QMap<QString, int> column_names_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+  QSet<int> numerical_columns_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+  QStandardItemModel model_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+};
+
+TEST_F(FilterParserTest, Empty) {
+  EXPECT_EQ(QList<int>() << 0 << 1 << 2 << 3 << 4, AcceptedRows(""));
+}
+
+TEST_F(FilterParserTest, Term) {
+  EXPECT_EQ(QList<int>() << 0 << 1, AcceptedRows("beatles"));
+  EXPECT_EQ(QList<int>() << 2 << 3, AcceptedRows("COMPUTER"));
+  EXPECT_EQ(QList<int>() << 2 << 3 << 4, AcceptedRows("199"));
+}
+
+TEST_F(FilterParserTest, Column) {
+  EXPECT_EQ(QList<int>() << 0 << 1, AcceptedRows("album:help"));
+  EXPECT_EQ(QList<int>() << 0, AcceptedRows("title:=help!"));
+  EXPECT_EQ(QList<int>() << 4, AcceptedRows("album:="));
+  EXPECT_EQ(QList<int>() << 2 << 3 << 4, AcceptedRows("artist:!=\"the beatles\""));
+}
+
+TEST_F(FilterParserTest, Numerical) {
+  EXPECT_EQ(QList<int>() << 2 << 3 << 4, AcceptedRows("year:>1970"));
+  EXPECT_EQ(QList<int>() << 0 << 1, AcceptedRows("year:<=1965"));
+  EXPECT_EQ(QList<int>() << 4, AcceptedRows("year:1999"));
+  EXPECT_EQ(QList<int>() << 0, AcceptedRows("length:2:18"));
+  EXPECT_EQ(QList<int>() << 2 << 4, AcceptedRows("length:>5:00"));
+}
+
+TEST_F(FilterParserTest, Groups) {
+  EXPECT_EQ(QList<int>() << 1 << 3, AcceptedRows("title:yesterday OR title:airbag"));
+  EXPECT_EQ(QList<int>() << 3, AcceptedRows("radiohead AND -paranoid"));
+  EXPECT_EQ(QList<int>() << 0 << 1 << 4, AcceptedRows("-(artist:radiohead OR year:1997)"));
+  EXPECT_EQ(QList<int>() << 0 << 2, AcceptedRows("(help OR android) -yesterday"));
+}
+
+}  // namespace
@@ -0,0 +1,96 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2021, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Microbenchmark for the sample format conversion, build with "make sampleconverter_benchmark".
+// Converts one minute of 24/192 stereo audio in 10 msec buffers, like the buffer probe does during playback.
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <vector>
+
+#include "engine/sampleconverter.h"
+
+namespace {
+
+constexpr int kRate = 192000;
+constexpr int kChannels = 2;
+constexpr int kBufferFrames = kRate / 100;
+constexpr int kBuffers = 6000;
+
+void Benchmark(const char *name, const std::function<void()> &vectorised, const std::function<void()> &scalar) {
+
+  using Clock = std::chrono::steady_clock;
+
+  // Warm up the caches, so the first one measured doesn't pay for it.
+  scalar();
+  vectorised();
+
+  Clock::time_point start = Clock::now();
+  for (int i = 0; i < kBuffers; ++i) scalar();
+  const std::chrono::duration<double, std::milli> scalar_msec = Clock::now() - start;
+
+  start = Clock::now();
+  for (int i = 0; i < kBuffers; ++i) vectorised();
+  const std::chrono::duration<double, std::milli> vectorised_msec = Clock::now() - start;
+
+  printf("%-16s %10.2f ms %10.2f ms %8.2fx\n", name, scalar_msec.count(), vectorised_msec.count(), scalar_msec.count() / vectorised_msec.count());
+
+}
+
+}  // namespace
+
+int main() {
+
+  constexpr int samples = kBufferFrames * kChannels;
+
+  std::vector<int32_t> s32(samples);
+  std::vector<float> f32(samples);
+  std::vector<uint8_t> s24(samples * 3);
+  std::vector<int16_t> s16(samples);
+  std::vector<float> mono(kBufferFrames);
+
+  for (int i = 0; i < samples; ++i) {
+    s32[i] = static_cast<int32_t>(static_cast<uint32_t>(i) * 2654435761U);
+    f32[i] = static_cast<float>(s32[i]) / 2147483648.0F;
+    s16[i] = static_cast<int16_t>(s32[i] >> 16);
+    s24[i * 3] = static_cast<uint8_t>(s32[i] >> 8);
+    s24[i * 3 + 1] = static_cast<uint8_t>(s32[i] >> 16);
+    s24[i * 3 + 2] = static_cast<uint8_t>(s32[i] >> 24);
+  }
+
+  std::vector<int16_t> dest(samples);
+
+  printf("Implementation: %s, %d buffers of %d frames\n", SampleConverter::Implementation(), kBuffers, kBufferFrames);
+  printf("%-16s %13s %13s %9s\n", "", "Scalar", "Vectorised", "Speedup");
+
+  Benchmark("S32ToS16", [&]() { SampleConverter::S32ToS16(s32.data(), dest.data(), samples); }, [&]() { SampleConverter::Scalar::S32ToS16(s32.data(), dest.data(), samples); });
+  Benchmark("F32ToS16", [&]() { SampleConverter::F32ToS16(f32.data(), dest.data(), samples); }, [&]() { SampleConverter::Scalar::F32ToS16(f32.data(), dest.data(), samples); });
+  Benchmark("S24ToS16", [&]() { SampleConverter::S24ToS16(s24.data(), dest.data(), samples); }, [&]() { SampleConverter::Scalar::S24ToS16(s24.data(), dest.data(), samples); });
+  Benchmark("S24_32ToS16", [&]() { SampleConverter::S24_32ToS16(s32.data(), dest.data(), samples); }, [&]() { SampleConverter::Scalar::S24_32ToS16(s32.data(), dest.data(), samples); });
+  Benchmark("S16ToMono", [&]() { SampleConverter::S16ToMono(s16.data(), mono.data(), kBufferFrames, kChannels); }, [&]() { SampleConverter::Scalar::S16ToMono(s16.data(), mono.data(), kBufferFrames, kChannels); });
+  Benchmark("S32ToMono", [&]() { SampleConverter::S32ToMono(s32.data(), mono.data(), kBufferFrames, kChannels); }, [&]() { SampleConverter::Scalar::S32ToMono(s32.data(), mono.data(), kBufferFrames, kChannels); });
+  Benchmark("F32ToMono", [&]() { SampleConverter::F32ToMono(f32.data(), mono.data(), kBufferFrames, kChannels); }, [&]() { SampleConverter::Scalar::F32ToMono(f32.data(), mono.data(), kBufferFrames, kChannels); });
+  Benchmark("S24ToMono", [&]() { SampleConverter::S24ToMono(s24.data(), mono.data(), kBufferFrames, kChannels); }, [&]() { SampleConverter::Scalar::S24ToMono(s24.data(), mono.data(), kBufferFrames, kChannels); });
+  Benchmark("S24_32ToMono", [&]() { SampleConverter::S24_32ToMono(s32.data(), mono.data(), kBufferFrames, kChannels); }, [&]() { SampleConverter::Scalar::S24_32ToMono(s32.data(), mono.data(), kBufferFrames, kChannels); });
+
+  return 0;
+
+}
@@ -0,0 +1,187 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2021, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "engine/sampleconverter.h"
+
+// clazy:excludeall=returning-void-expression
+
+namespace {
+
+// Odd, so the vectorised versions also have a remainder.
+constexpr int kCount = 1027;
+
+std::vector<int32_t> RandomS32(const int count) {
+
+  std::mt19937 generator(42);
+  std::uniform_int_distribution<int32_t> distribution(INT32_MIN, INT32_MAX);
+  std::vector<int32_t> samples(count);
+  for (int32_t &sample : samples) sample = distribution(generator);
+  return samples;
+
+}
+
+TEST(SampleConverterTest, S32ToS16) {
+
+  const std::vector<int32_t> src = RandomS32(kCount);
+  std::vector<int16_t> dest(kCount);
+  std::vector<int16_t> expected(kCount);
+  SampleConverter::S32ToS16(src.data(), dest.data(), kCount);
+  SampleConverter::Scalar::S32ToS16(src.data(), expected.data(), kCount);
+  EXPECT_EQ(expected, dest);
+  EXPECT_EQ(static_cast<int16_t>(src[0] >> 16), dest[0]);
+
+}
+
+TEST(SampleConverterTest, F32ToS16) {
+
+  std::vector<float> src = {0.0F, 0.5F, -0.5F, 1.0F, -1.0F, 1.5F, -1.5F, 0.25F, 0.999F};
+  std::mt19937 generator(42);
+  std::uniform_real_distribution<float> distribution(-1.0F, 1.0F);
+  while (src.size() < static_cast<size_t>(kCount)) src.push_back(distribution(generator));
+
+  std::vector<int16_t> dest(kCount);
+  std::vector<int16_t> expected(kCount);
+  SampleConverter::F32ToS16(src.data(), dest.data(), kCount);
+  SampleConverter::Scalar::F32ToS16(src.data(), expected.data(), kCount);
+  EXPECT_EQ(expected, dest);
+
+  // Clipped instead of wrapping around.
+  EXPECT_EQ(16384, dest[1]);
+  EXPECT_EQ(32767, dest[3]);
+  EXPECT_EQ(-32768, dest[4]);
+  EXPECT_EQ(32767, dest[5]);
+  EXPECT_EQ(-32768, dest[6]);
+
+}
+
+TEST(SampleConverterTest, S24ToS16) {
+
+  const std::vector<int32_t> random = RandomS32(kCount);
+  std::vector<uint8_t> src;
+  for (const int32_t sample : random) {
+    src.push_back(static_cast<uint8_t>(sample & 0xFF));
+    src.push_back(static_cast<uint8_t>((sample >> 8) & 0xFF));
+    src.push_back(static_cast<uint8_t>((sample >> 16) & 0xFF));
+  }
+
+  std::vector<int16_t> dest(kCount);
+  std::vector<int16_t> expected(kCount);
+  SampleConverter::S24ToS16(src.data(), dest.data(), kCount);
+  SampleConverter::Scalar::S24ToS16(src.data(), expected.data(), kCount);
+  EXPECT_EQ(expected, dest);
+  EXPECT_EQ(static_cast<int16_t>((random[0] >> 8) & 0xFFFF), dest[0]);
+
+}
+
+TEST(SampleConverterTest, S24_32ToS16) {
+
+  const std::vector<int32_t> src = RandomS32(kCount);
+  std::vector<int16_t> dest(kCount);
+  std::vector<int16_t> expected(kCount);
+  SampleConverter::S24_32ToS16(src.data(), dest.data(), kCount);
+  SampleConverter::Scalar::S24_32ToS16(src.data(), expected.data(), kCount);
+  EXPECT_EQ(expected, dest);
+
+}
+
+TEST(SampleConverterTest, S16ToMono) {
+
+  const std::vector<int32_t> random = RandomS32(kCount * 2);
+  std::vector<int16_t> src(random.begin(), random.end());
+  for (size_t i = 0; i < src.size(); ++i) src[i] = static_cast<int16_t>(random[i] >> 16);
+
+  std::vector<float> dest(kCount);
+  std::vector<float> expected(kCount);
+  SampleConverter::S16ToMono(src.data(), dest.data(), kCount, 2);
+  SampleConverter::Scalar::S16ToMono(src.data(), expected.data(), kCount, 2);
+  EXPECT_EQ(expected, dest);
+
+  const int16_t frame[] = { 32767, -32768, 16384, 16384 };
+  SampleConverter::S16ToMono(frame, dest.data(), 2, 2);
+  EXPECT_FLOAT_EQ(-0.5F / 32768.0F, dest[0]);
+  EXPECT_FLOAT_EQ(0.5F, dest[1]);
+
+}
+
+TEST(SampleConverterTest, S32ToMono) {
+
+  const std::vector<int32_t> src = RandomS32(kCount * 2);
+  std::vector<float> dest(kCount);
+  std::vector<float> expected(kCount);
+  SampleConverter::S32ToMono(src.data(), dest.data(), kCount, 2);
+  SampleConverter::Scalar::S32ToMono(src.data(), expected.data(), kCount, 2);
+  for (int i = 0; i < kCount; ++i) {
+    EXPECT_FLOAT_EQ(expected[i], dest[i]);
+  }
+
+}
+
+TEST(SampleConverterTest, F32ToMono) {
+
+  std::mt19937 generator(42);
+  std::uniform_real_distribution<float> distribution(-1.0F, 1.0F);
+  std::vector<float> src(kCount * 2);
+  for (float &sample : src) sample = distribution(generator);
+
+  std::vector<float> dest(kCount);
+  std::vector<float> expected(kCount);
+  SampleConverter::F32ToMono(src.data(), dest.data(), kCount, 2);
+  SampleConverter::Scalar::F32ToMono(src.data(), expected.data(), kCount, 2);
+  for (int i = 0; i < kCount; ++i) {
+    EXPECT_FLOAT_EQ(expected[i], dest[i]);
+  }
+
+}
+
+TEST(SampleConverterTest, S24_32ToMono) {
+
+  const std::vector<int32_t> src = RandomS32(kCount * 2);
+  std::vector<float> dest(kCount);
+  std::vector<float> expected(kCount);
+  SampleConverter::S24_32ToMono(src.data(), dest.data(), kCount, 2);
+  SampleConverter::Scalar::S24_32ToMono(src.data(), expected.data(), kCount, 2);
+  for (int i = 0; i < kCount; ++i) {
+    EXPECT_FLOAT_EQ(expected[i], dest[i]);
+  }
+
+}
+
+TEST(SampleConverterTest, MultiChannelToMono) {
+
+  // Channel counts other than stereo always use the scalar version.
+  const int16_t frames[] = { 8192, 8192, 8192, -8192, -8192, -8192 };
+  float dest[2] = {};
+  SampleConverter::S16ToMono(frames, dest, 2, 3);
+  EXPECT_FLOAT_EQ(0.25F, dest[0]);
+  EXPECT_FLOAT_EQ(-0.25F, dest[1]);
+
+  const uint8_t s24[] = { 0x00, 0x00, 0x40, 0x00, 0x00, 0xC0 };
+  SampleConverter::S24ToMono(s24, dest, 2, 1);
+  EXPECT_FLOAT_EQ(0.5F, dest[0]);
+  EXPECT_FLOAT_EQ(-0.5F, dest[1]);
+
+}
+
+}  // namespace
@@ -0,0 +1,133 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2021, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "engine/scoperingbuffer.h"
+
+// clazy:excludeall=returning-void-expression
+
+namespace {
+
+std::vector<float> Ramp(const int start, const int count) {
+
+  std::vector<float> frames(count);
+  for (int i = 0; i < count; ++i) {
+    frames[i] = static_cast<float>(start + i);
+  }
+  return frames;
+
+}
+
+TEST(ScopeRingBufferTest, Empty) {
+
+  ScopeRingBuffer buffer(64);
+  std::vector<float> scope(8);
+  EXPECT_FALSE(buffer.Read(&scope, 10));
+
+}
+
+TEST(ScopeRingBufferTest, CapacityIsPowerOfTwo) {
+
+  ScopeRingBuffer buffer(100);
+  EXPECT_EQ(128, buffer.capacity());
+
+}
+
+TEST(ScopeRingBufferTest, FirstReadReturnsNewestFrames) {
+
+  ScopeRingBuffer buffer(64);
+  const std::vector<float> frames = Ramp(0, 20);
+  buffer.Write(frames.data(), static_cast<int>(frames.size()), 1000);
+
+  std::vector<float> scope(8);
+  ASSERT_TRUE(buffer.Read(&scope, 10));
+  EXPECT_EQ(12.0F, scope.front());
+  EXPECT_EQ(19.0F, scope.back());
+
+}
+
+TEST(ScopeRingBufferTest, ShortBufferIsPaddedWithSilence) {
+
+  ScopeRingBuffer buffer(64);
+  const std::vector<float> frames = Ramp(1, 4);
+  buffer.Write(frames.data(), static_cast<int>(frames.size()), 1000);
+
+  std::vector<float> scope(8, -1.0F);
+  ASSERT_TRUE(buffer.Read(&scope, 10));
+  EXPECT_EQ(0.0F, scope[3]);
+  EXPECT_EQ(1.0F, scope[4]);
+  EXPECT_EQ(4.0F, scope[7]);
+
+}
+
+TEST(ScopeRingBufferTest, ReadIsPacedByElapsedTime) {
+
+  ScopeRingBuffer buffer(256);
+  const std::vector<float> first = Ramp(0, 16);
+  buffer.Write(first.data(), static_cast<int>(first.size()), 1000);
+
+  std::vector<float> scope(8);
+  ASSERT_TRUE(buffer.Read(&scope, 10));
+  EXPECT_EQ(15.0F, scope.back());
+
+  const std::vector<float> second = Ramp(16, 32);
+  buffer.Write(second.data(), static_cast<int>(second.size()), 1000);
+
+  // 10 msec at 1000 Hz is 10 frames.
+  ASSERT_TRUE(buffer.Read(&scope, 10));
+  EXPECT_EQ(18.0F, scope.front());
+  EXPECT_EQ(25.0F, scope.back());
+
+}
+
+TEST(ScopeRingBufferTest, LateBufferKeepsNewestFrames) {
+
+  ScopeRingBuffer buffer(64);
+  const std::vector<float> frames = Ramp(0, 16);
+  buffer.Write(frames.data(), static_cast<int>(frames.size()), 1000);
+
+  std::vector<float> scope(8);
+  ASSERT_TRUE(buffer.Read(&scope, 10));
+  ASSERT_TRUE(buffer.Read(&scope, 100));
+  EXPECT_EQ(8.0F, scope.front());
+  EXPECT_EQ(15.0F, scope.back());
+
+}
+
+TEST(ScopeRingBufferTest, SlowReaderSkipsAhead) {
+
+  ScopeRingBuffer buffer(64);
+  std::vector<float> scope(8);
+  const std::vector<float> first = Ramp(0, 8);
+  buffer.Write(first.data(), static_cast<int>(first.size()), 1000);
+  ASSERT_TRUE(buffer.Read(&scope, 0));
+
+  const std::vector<float> second = Ramp(8, 200);
+  buffer.Write(second.data(), static_cast<int>(second.size()), 1000);
+
+  // The reader is at most capacity - size - capacity / 4 frames behind the writer.
+  ASSERT_TRUE(buffer.Read(&scope, 0));
+  EXPECT_EQ(207.0F - 40.0F, scope.back());
+
+}
+
+}  // namespace
@@ -0,0 +1,103 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2021, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <algorithm>
+
+#include <gtest/gtest.h>
+
+#include <QList>
+#include <QSet>
+
+#include "smartplaylists/smartplaylistsampler.h"
+
+// clazy:excludeall=returning-void-expression
+
+namespace {
+
+SmartPlaylistSampler::CandidateList Candidates(const int count) {
+
+  SmartPlaylistSampler::CandidateList candidates;
+  for (int i = 1; i <= count; ++i) {
+    candidates << SmartPlaylistSampler::Candidate(i, -1.0F, 0);
+  }
+  return candidates;
+
+}
+
+TEST(SmartPlaylistSamplerTest, Empty) {
+
+  SmartPlaylistSampler sampler;
+  EXPECT_TRUE(sampler.Sample(10).isEmpty());
+
+}
+
+TEST(SmartPlaylistSamplerTest, UniqueAndNotExcluded) {
+
+  SmartPlaylistSampler sampler;
+  sampler.SetCandidates(Candidates(1000), false);
+
+  const QSet<int> excluded_ids = QSet<int>() << 1 << 2 << 3 << 500;
+  const QList<int> ids = sampler.Sample(50, excluded_ids);
+  ASSERT_EQ(50, ids.count());
+
+  QSet<int> unique_ids;
+  for (const int id : ids) {
+    EXPECT_GE(id, 1);
+    EXPECT_LE(id, 1000);
+    EXPECT_FALSE(excluded_ids.contains(id));
+    unique_ids.insert(id);
+  }
+  EXPECT_EQ(50, unique_ids.count());
+
+}
+
+TEST(SmartPlaylistSamplerTest, MostExcluded) {
+
+  SmartPlaylistSampler sampler;
+  sampler.SetCandidates(Candidates(100), true);
+
+  QSet<int> excluded_ids;
+  for (int i = 1; i <= 97; ++i) excluded_ids.insert(i);
+
+  QList<int> ids = sampler.Sample(10, excluded_ids);
+  std::sort(ids.begin(), ids.end());
+  EXPECT_EQ(QList<int>() << 98 << 99 << 100, ids);
+
+}
+
+TEST(SmartPlaylistSamplerTest, WeightedPrefersRatedSongs) {
+
+  SmartPlaylistSampler::CandidateList candidates = Candidates(100);
+  candidates[0].rating = 1.0F;
+  candidates[0].playcount = 100;
+
+  SmartPlaylistSampler sampler;
+  sampler.SetCandidates(candidates, true);
+
+  int count = 0;
+  for (int i = 0; i < 1000; ++i) {
+    if (sampler.Sample(1).value(0) == 1) ++count;
+  }
+
+  // The rated song has a weight of about 10 against 99 songs with a weight of 1, so it should be drawn about 9% of the time instead of 1%.
+  EXPECT_GT(count, 40);
+
+}
+
+}  // namespace
@@ -0,0 +1,121 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2021, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Memory benchmark of the collection songs with and without interned strings, build with "make song_benchmark".
+// Usage: song_benchmark [number of songs]
+
+#include <cstdio>
+#include <cstdlib>
+
+#if defined(__GLIBC__)
+#  include <malloc.h>
+#  if __GLIBC_PREREQ(2, 33)
+#    define HAVE_MALLINFO2
+#  endif
+#endif
+
+#include <QList>
+#include <QString>
+#include <QUrl>
+
+#include "core/song.h"
+#include "core/stringpool.h"
+
+namespace {
+
+constexpr int kTracksPerAlbum = 12;
+constexpr int kAlbumsPerArtist = 8;
+constexpr int kGenres = 40;
+
+qint64 HeapUsage() {
+
+#ifdef HAVE_MALLINFO2
+  const struct mallinfo2 info = mallinfo2();
+  return static_cast<qint64>(info.uordblks) + static_cast<qint64>(info.hblkhd);
+#else
+  return -1;
+#endif
+
+}
+
+// Creates songs the same way they are read from the database, every field has its own copy of the string.
+QList<Song> CreateSongs(const int count, const bool intern) {
+
+  QList<Song> songs;
+  songs.reserve(count);
+  for (int i = 0; i < count; ++i) {
+    const int album = i / kTracksPerAlbum;
+    const int artist = album / kAlbumsPerArtist;
+    const QString artist_name = QString("Artist %1").arg(artist);
+    const QString album_name = QString("Album %1 by %2").arg(album).arg(artist_name);
+    const QString path = QString("/home/user/Music/%1/%2").arg(artist_name, album_name);
+    Song song(Song::Source_Collection);
+    song.set_id(i);
+    song.set_title(QString("Track %1").arg(i));
+    song.set_artist(artist_name);
+    song.set_albumartist(artist_name);
+    song.set_album(album_name);
+    song.set_genre(QString("Genre %1").arg(artist % kGenres));
+    song.set_composer(QString("Composer %1").arg(artist));
+    song.set_track(i % kTracksPerAlbum + 1);
+    song.set_year(1960 + artist % 60);
+    song.set_url(QUrl::fromLocalFile(QString("%1/%2.flac").arg(path).arg(i)));
+    song.set_art_automatic(QUrl::fromLocalFile(path + "/cover.jpg"));
+    if (intern) song.InternStrings();
+    songs << song;
+  }
+
+  return songs;
+
+}
+
+void Benchmark(const int count, const bool intern) {
+
+  const qint64 before = HeapUsage();
+  const QList<Song> songs = CreateSongs(count, intern);
+  const qint64 after = HeapUsage();
+
+  if (before < 0 || after < 0) {
+    printf("%-12s %10d %14s %14s\n", intern ? "Interned" : "Plain", count, "n/a", "n/a");
+  }
+  else {
+    const qint64 bytes = after - before;
+    printf("%-12s %10d %12.1f MB %14lld\n", intern ? "Interned" : "Plain", count, static_cast<double>(bytes) / (1024.0 * 1024.0), bytes / count);
+  }
+
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+
+  const int count = argc > 1 ? atoi(argv[1]) : 500000;
+  if (count <= 0) {
+    fprintf(stderr, "Invalid number of songs.\n");
+    return 1;
+  }
+
+  printf("%-12s %10s %15s %14s\n", "Strings", "Songs", "Heap", "Bytes/song");
+  Benchmark(count, false);
+  Benchmark(count, true);
+  StringPool::Instance()->Prune();
+
+  return 0;
+
+}
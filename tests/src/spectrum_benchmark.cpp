@@ -0,0 +1,72 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2021, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Benchmark of the analyzer spectrum engines, build with "make spectrum_benchmark".
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "analyzer/spectrumengine.h"
+#include "analyzer/fht.h"
+#include "analyzer/fft.h"
+
+namespace {
+
+constexpr int kIterations = 20000;
+
+double Benchmark(SpectrumEngine *spectrum) {
+
+  std::vector<float> frames(spectrum->size());
+  std::vector<float> scope(spectrum->size());
+  for (int i = 0; i < spectrum->size(); ++i) {
+    frames[i] = static_cast<float>(sin(static_cast<double>(i) * 0.1) + sin(static_cast<double>(i) * 0.37));
+  }
+
+  const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for (int i = 0; i < kIterations; ++i) {
+    scope = frames;
+    spectrum->spectrum(scope.data());
+  }
+  const std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+
+  return elapsed.count() / kIterations;
+
+}
+
+}  // namespace
+
+int main() {
+
+  printf("%-6s %12s %12s %12s %9s\n", "Size", "FHT", "FFT", "FFT Hann", "Speedup");
+
+  for (int exp2 = 8; exp2 <= 13; ++exp2) {
+    FHT fht(exp2);
+    FFT fft(exp2);
+    FFT fft_hann(exp2, SpectrumEngine::Window::Hann);
+    const double fht_usec = Benchmark(&fht);
+    const double fft_usec = Benchmark(&fft);
+    const double fft_hann_usec = Benchmark(&fft_hann);
+    printf("%-6d %9.2f us %9.2f us %9.2f us %8.2fx\n", 1 << exp2, fht_usec, fft_usec, fft_hann_usec, fht_usec / fft_usec);
+  }
+
+  return 0;
+
+}
@@ -0,0 +1,108 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2021, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "analyzer/fht.h"
+#include "analyzer/fft.h"
+
+// clazy:excludeall=returning-void-expression
+
+namespace {
+
+std::vector<float> RandomFrames(const int count) {
+
+  std::mt19937 generator(static_cast<unsigned int>(count));
+  std::uniform_real_distribution<float> distribution(-1.0F, 1.0F);
+  std::vector<float> frames(count);
+  for (float &frame : frames) frame = distribution(generator);
+  return frames;
+
+}
+
+TEST(SpectrumTest, FFTMatchesFHT) {
+
+  for (int exp2 = 3; exp2 <= 13; ++exp2) {
+    FHT fht(exp2);
+    FFT fft(exp2);
+    ASSERT_EQ(fht.size(), fft.size());
+
+    const std::vector<float> frames = RandomFrames(fft.size());
+    std::vector<float> expected = frames;
+    std::vector<float> actual = frames;
+    fht.power2(expected.data());
+    fft.power2(actual.data());
+
+    float max = 0.0F;
+    for (int i = 0; i < fft.size() / 2; ++i) max = std::max(max, expected[i]);
+    for (int i = 0; i < fft.size() / 2; ++i) {
+      EXPECT_NEAR(expected[i], actual[i], max * 1e-4F) << "size " << fft.size() << " bin " << i;
+    }
+  }
+
+}
+
+TEST(SpectrumTest, SineIsInOneBin) {
+
+  FFT fft(8);
+  std::vector<float> frames(fft.size());
+  for (int i = 0; i < fft.size(); ++i) {
+    frames[i] = static_cast<float>(sin(2.0 * M_PI * 16.0 * i / fft.size()));
+  }
+  fft.power(frames.data());
+
+  // A sine with amplitude 1 has a power of (N / 2)^2 in its bin.
+  EXPECT_NEAR(128.0F * 128.0F, frames[16], 1.0F);
+  EXPECT_NEAR(0.0F, frames[15], 1e-3F);
+  EXPECT_NEAR(0.0F, frames[17], 1e-3F);
+
+}
+
+TEST(SpectrumTest, HannWindowReducesLeakage) {
+
+  // A frequency between two bins leaks into the other bins, less so with a window.
+  std::vector<float> frames(256);
+  for (int i = 0; i < 256; ++i) {
+    frames[i] = static_cast<float>(sin(2.0 * M_PI * 16.5 * i / 256.0));
+  }
+
+  std::vector<float> plain = frames;
+  std::vector<float> windowed = frames;
+  FFT(8).power(plain.data());
+  FFT(8, SpectrumEngine::Window::Hann).power(windowed.data());
+
+  EXPECT_LT(windowed[40] / windowed[16], plain[40] / plain[16]);
+
+}
+
+TEST(SpectrumTest, CreateReturnsFFT) {
+
+  std::unique_ptr<SpectrumEngine> spectrum(SpectrumEngine::Create(9));
+  EXPECT_NE(nullptr, dynamic_cast<FFT*>(spectrum.get()));
+  EXPECT_EQ(512, spectrum->size());
+  EXPECT_EQ(9, spectrum->sizeExp());
+
+}
+
+}  // namespace
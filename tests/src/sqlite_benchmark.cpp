@@ -0,0 +1,110 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2021, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Benchmark of the SQLite connection profile, build with "make sqlite_benchmark".
+// Inserts songs in batches while a second connection is reading, like the collection scanner and the collection model, with the default journal and with the options used by Database.
+// Usage: sqlite_benchmark [batches] [songs per batch]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+
+#include <sqlite3.h>
+
+namespace {
+
+void Benchmark(const char *name, const std::string &filename, const char *profile_sql, const int batches, const int batch_size) {
+
+  std::remove(filename.c_str());
+  std::remove((filename + "-wal").c_str());
+  std::remove((filename + "-shm").c_str());
+
+  sqlite3 *writer = nullptr;
+  sqlite3 *reader = nullptr;
+  sqlite3_open(filename.c_str(), &writer);
+  sqlite3_exec(writer, profile_sql, nullptr, nullptr, nullptr);
+  sqlite3_exec(writer, "CREATE TABLE songs (title TEXT, artist TEXT, album TEXT, mtime INTEGER)", nullptr, nullptr, nullptr);
+  sqlite3_open(filename.c_str(), &reader);
+  sqlite3_exec(reader, profile_sql, nullptr, nullptr, nullptr);
+
+  sqlite3_stmt *insert = nullptr;
+  sqlite3_prepare_v2(writer, "INSERT INTO songs (title, artist, album, mtime) VALUES (?, 'Artist', 'Album', ?)", -1, &insert, nullptr);
+
+  int commits_while_reading = 0;
+  const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for (int batch = 0; batch < batches; ++batch) {
+    sqlite3_exec(writer, "BEGIN IMMEDIATE", nullptr, nullptr, nullptr);
+    for (int i = 0; i < batch_size; ++i) {
+      const std::string title = "Title " + std::to_string(batch * batch_size + i);
+      sqlite3_bind_text(insert, 1, title.c_str(), -1, SQLITE_TRANSIENT);
+      sqlite3_bind_int(insert, 2, i);
+      sqlite3_step(insert);
+      sqlite3_reset(insert);
+    }
+    sqlite3_stmt *select = nullptr;
+    sqlite3_prepare_v2(reader, "SELECT title FROM songs", -1, &select, nullptr);
+    sqlite3_step(select);
+    if (sqlite3_exec(writer, "COMMIT", nullptr, nullptr, nullptr) == SQLITE_OK) {
+      ++commits_while_reading;
+    }
+    sqlite3_finalize(select);
+    // Without WAL the commit fails while the reader holds its lock, so it's retried after the read.
+    if (sqlite3_get_autocommit(writer) == 0) {
+      sqlite3_exec(writer, "COMMIT", nullptr, nullptr, nullptr);
+    }
+  }
+  const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+  sqlite3_finalize(insert);
+  sqlite3_close(reader);
+  sqlite3_close(writer);
+
+  std::remove(filename.c_str());
+  std::remove((filename + "-wal").c_str());
+  std::remove((filename + "-shm").c_str());
+
+  printf("%-10s %10.2f ms %10d %10d\n", name, elapsed.count(), commits_while_reading, batches);
+
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+
+  const int batches = argc > 1 ? atoi(argv[1]) : 20;
+  const int batch_size = argc > 2 ? atoi(argv[2]) : 500;
+  if (batches <= 0 || batch_size <= 0) {
+    fprintf(stderr, "Invalid arguments.\n");
+    return 1;
+  }
+
+  const std::string filename = (std::filesystem::temp_directory_path() / ("strawberry_sqlite_benchmark_" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()) + ".db")).string();
+
+  printf("%-10s %13s %10s %10s\n", "Profile", "Time", "Unblocked", "Batches");
+
+  Benchmark("Default", filename, "PRAGMA journal_mode = DELETE", batches, batch_size);
+
+  // Same options as Database::SetJournalMode() and Database::SetConnectionOptions().
+  Benchmark("Tuned", filename, "PRAGMA journal_mode = WAL; PRAGMA synchronous = NORMAL; PRAGMA cache_size = -16384; PRAGMA mmap_size = 268435456; PRAGMA temp_store = MEMORY", batches, batch_size);
+
+  return 0;
+
+}
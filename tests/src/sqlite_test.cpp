@@ -1,3 +1,8 @@
+#include <cstdio>
+#include <chrono>
+#include <filesystem>
+#include <string>
+
 #include <gtest/gtest.h>
 #include <sqlite3.h>
 
@@ -16,3 +21,69 @@ TEST(SqliteTest, FTS5SupportEnabled) {
   sqlite3_close(db);
 
 }
+
+namespace {
+
+// Inserts rows in batches while a second connection is reading, like the collection scanner and the collection model, and returns the number of batches committed while reading.
+int CommitsWhileReading(const std::string &filename, const char *profile_sql) {
+
+  std::remove(filename.c_str());
+  std::remove((filename + "-wal").c_str());
+  std::remove((filename + "-shm").c_str());
+
+  sqlite3 *writer = nullptr;
+  sqlite3 *reader = nullptr;
+  EXPECT_EQ(SQLITE_OK, sqlite3_open(filename.c_str(), &writer));
+  EXPECT_EQ(SQLITE_OK, sqlite3_exec(writer, profile_sql, nullptr, nullptr, nullptr));
+  EXPECT_EQ(SQLITE_OK, sqlite3_exec(writer, "CREATE TABLE songs (title TEXT, artist TEXT, album TEXT, mtime INTEGER)", nullptr, nullptr, nullptr));
+  EXPECT_EQ(SQLITE_OK, sqlite3_open(filename.c_str(), &reader));
+  EXPECT_EQ(SQLITE_OK, sqlite3_exec(reader, profile_sql, nullptr, nullptr, nullptr));
+
+  sqlite3_stmt *insert = nullptr;
+  EXPECT_EQ(SQLITE_OK, sqlite3_prepare_v2(writer, "INSERT INTO songs (title, artist, album, mtime) VALUES (?, 'Artist', 'Album', ?)", -1, &insert, nullptr));
+
+  int commits_while_reading = 0;
+  for (int batch = 0; batch < 20; ++batch) {
+    sqlite3_exec(writer, "BEGIN IMMEDIATE", nullptr, nullptr, nullptr);
+    for (int i = 0; i < 50; ++i) {
+      const std::string title = "Title " + std::to_string(batch * 50 + i);
+      sqlite3_bind_text(insert, 1, title.c_str(), -1, SQLITE_TRANSIENT);
+      sqlite3_bind_int(insert, 2, i);
+      sqlite3_step(insert);
+      sqlite3_reset(insert);
+    }
+    // The collection model is reading while the scanner commits, this only succeeds if the writer isn't blocked by the reader.
+    sqlite3_stmt *select = nullptr;
+    sqlite3_prepare_v2(reader, "SELECT title FROM songs", -1, &select, nullptr);
+    sqlite3_step(select);
+    if (sqlite3_exec(writer, "COMMIT", nullptr, nullptr, nullptr) == SQLITE_OK) {
+      ++commits_while_reading;
+    }
+    sqlite3_finalize(select);
+    if (sqlite3_get_autocommit(writer) == 0) {
+      EXPECT_EQ(SQLITE_OK, sqlite3_exec(writer, "COMMIT", nullptr, nullptr, nullptr));
+    }
+  }
+
+  sqlite3_finalize(insert);
+  sqlite3_close(reader);
+  sqlite3_close(writer);
+
+  std::remove(filename.c_str());
+  std::remove((filename + "-wal").c_str());
+  std::remove((filename + "-shm").c_str());
+
+  return commits_while_reading;
+
+}
+
+}  // namespace
+
+TEST(SqliteTest, WALWriterNotBlockedByReader) {
+
+  const std::string filename = (std::filesystem::temp_directory_path() / ("strawberry_sqlite_test_" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()) + ".db")).string();
+
+  // Same options as Database::SetJournalMode() and Database::SetConnectionOptions().
+  EXPECT_EQ(20, CommitsWhileReading(filename, "PRAGMA journal_mode = WAL; PRAGMA synchronous = NORMAL; PRAGMA cache_size = -16384; PRAGMA mmap_size = 268435456; PRAGMA temp_store = MEMORY"));
+
+}
@@ -0,0 +1,108 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2021, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <QUrl>
+
+#include "test_utils.h"
+
+#include "core/urlhandler.h"
+#include "core/streamurlcache.h"
+
+// clazy:excludeall=non-pod-global-static,returning-void-expression
+
+namespace {
+
+const QUrl kUrl("tidal://track/1");
+const QUrl kStreamUrl("https://example.com/track/1.flac");
+
+TEST(StreamUrlCacheTest, Empty) {
+
+  StreamUrlCache cache;
+  UrlHandler::LoadResult result;
+  EXPECT_FALSE(cache.Contains(kUrl));
+  EXPECT_FALSE(cache.IsLoading(kUrl));
+  EXPECT_FALSE(cache.Get(kUrl, &result));
+
+}
+
+TEST(StreamUrlCacheTest, LoadingThenAvailable) {
+
+  StreamUrlCache cache;
+  cache.SetLoading(kUrl);
+  EXPECT_TRUE(cache.IsLoading(kUrl));
+  EXPECT_TRUE(cache.Contains(kUrl));
+
+  cache.Add(UrlHandler::LoadResult(kUrl, UrlHandler::LoadResult::TrackAvailable, kStreamUrl, Song::FileType_FLAC), 60000);
+  EXPECT_FALSE(cache.IsLoading(kUrl));
+  EXPECT_EQ(1, cache.count());
+
+  // The result is kept, so preloading and playing use the same stream URL.
+  for (int i = 0; i < 2; ++i) {
+    UrlHandler::LoadResult result;
+    ASSERT_TRUE(cache.Get(kUrl, &result));
+    EXPECT_EQ(kStreamUrl, result.stream_url_);
+    EXPECT_EQ(Song::FileType_FLAC, result.filetype_);
+  }
+
+}
+
+TEST(StreamUrlCacheTest, ErrorIsNotCached) {
+
+  StreamUrlCache cache;
+  cache.SetLoading(kUrl);
+  cache.Add(UrlHandler::LoadResult(kUrl, UrlHandler::LoadResult::Error, QString("Not found")), 60000);
+
+  UrlHandler::LoadResult result;
+  EXPECT_FALSE(cache.IsLoading(kUrl));
+  EXPECT_FALSE(cache.Contains(kUrl));
+  EXPECT_FALSE(cache.Get(kUrl, &result));
+
+}
+
+TEST(StreamUrlCacheTest, Expired) {
+
+  StreamUrlCache cache;
+  cache.Add(UrlHandler::LoadResult(kUrl, UrlHandler::LoadResult::TrackAvailable, kStreamUrl), 0);
+
+  UrlHandler::LoadResult result;
+  EXPECT_FALSE(cache.Contains(kUrl));
+  EXPECT_FALSE(cache.Get(kUrl, &result));
+  EXPECT_EQ(1, cache.count());
+
+  cache.RemoveExpired();
+  EXPECT_EQ(0, cache.count());
+
+}
+
+TEST(StreamUrlCacheTest, Remove) {
+
+  StreamUrlCache cache;
+  cache.Add(UrlHandler::LoadResult(kUrl, UrlHandler::LoadResult::TrackAvailable, kStreamUrl), 60000);
+  cache.Remove(kUrl);
+  EXPECT_FALSE(cache.Contains(kUrl));
+
+  cache.SetLoading(kUrl);
+  cache.Remove(kUrl);
+  EXPECT_FALSE(cache.IsLoading(kUrl));
+
+}
+
+}  // namespace
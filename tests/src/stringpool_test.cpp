@@ -0,0 +1,100 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2021, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <QString>
+#include <QUrl>
+
+#include "test_utils.h"
+
+#include "core/song.h"
+#include "core/stringpool.h"
+
+// clazy:excludeall=returning-void-expression
+
+namespace {
+
+// Returns a string with its own copy of the data, like the strings read from the database.
+QString Copy(const QString &str) {
+  return QString(str.constData(), str.length());
+}
+
+TEST(StringPoolTest, InternSharesData) {
+
+  StringPool *pool = StringPool::Instance();
+
+  const QString a = pool->Intern(Copy("Pink Floyd"));
+  const QString b = pool->Intern(Copy("Pink Floyd"));
+  EXPECT_EQ(a, b);
+  EXPECT_EQ(a.constData(), b.constData());
+
+  const QString c = pool->Intern(Copy("Pink Floyd "));
+  EXPECT_NE(a.constData(), c.constData());
+
+  EXPECT_TRUE(pool->Intern(QString()).isNull());
+  EXPECT_TRUE(pool->Intern(QString("")).isEmpty());
+
+}
+
+TEST(StringPoolTest, PruneRemovesUnusedStrings) {
+
+  StringPool *pool = StringPool::Instance();
+  pool->Prune();
+  const int count = pool->string_count();
+
+  {
+    const QString str = pool->Intern(Copy("Only used here"));
+    pool->Prune();
+    EXPECT_EQ(count + 1, pool->string_count());
+  }
+
+  pool->Prune();
+  EXPECT_EQ(count, pool->string_count());
+
+}
+
+TEST(StringPoolTest, SongsShareStrings) {
+
+  Song song1;
+  song1.Init("Time", Copy("Pink Floyd"), Copy("The Dark Side of the Moon"), 413 * kNsecPerSec);
+  song1.set_genre(Copy("Progressive Rock"));
+  song1.set_art_automatic(QUrl::fromLocalFile(Copy("/music/Pink Floyd/The Dark Side of the Moon/cover.jpg")));
+  song1.InternStrings();
+
+  Song song2;
+  song2.Init("Money", Copy("Pink Floyd"), Copy("The Dark Side of the Moon"), 382 * kNsecPerSec);
+  song2.set_genre(Copy("Progressive Rock"));
+  song2.set_art_automatic(QUrl::fromLocalFile(Copy("/music/Pink Floyd/The Dark Side of the Moon/cover.jpg")));
+  song2.InternStrings();
+
+  EXPECT_EQ(song1.artist().constData(), song2.artist().constData());
+  EXPECT_EQ(song1.album().constData(), song2.album().constData());
+  EXPECT_EQ(song1.album_sortable().constData(), song2.album_sortable().constData());
+  EXPECT_EQ(song1.genre().constData(), song2.genre().constData());
+  EXPECT_EQ(song1.art_automatic(), song2.art_automatic());
+  EXPECT_NE(song1.title().constData(), song2.title().constData());
+
+  // Changing one song doesn't change the other
+  song2.set_artist("Roger Waters");
+  EXPECT_EQ("Pink Floyd", song1.artist());
+
+}
+
+}  // namespace
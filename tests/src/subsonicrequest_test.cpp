@@ -0,0 +1,154 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2021, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <memory>
+
+#include <gtest/gtest.h>
+
+#include <QCoreApplication>
+#include <QEventLoop>
+#include <QElapsedTimer>
+#include <QThreadPool>
+#include <QTemporaryDir>
+#include <QSettings>
+#include <QByteArray>
+#include <QString>
+
+#include "test_utils.h"
+#include "mock_subsonicserver.h"
+
+#include "core/song.h"
+#include "core/database.h"
+#include "collection/collectionbackend.h"
+#include "settings/subsonicsettingspage.h"
+#include "subsonic/subsonicservice.h"
+#include "subsonic/subsonicurlhandler.h"
+#include "subsonic/subsonicrequest.h"
+
+// clazy:excludeall=returning-void-expression
+
+namespace {
+
+class SubsonicRequestTest : public ::testing::Test {
+ protected:
+  SubsonicRequestTest() : server_(30, 4, 0), url_handler_(nullptr) {}
+
+  void SetUp() override {
+
+    ASSERT_TRUE(temp_dir_.isValid());
+    ASSERT_TRUE(server_.Listen());
+
+    QSettings::setPath(QSettings::NativeFormat, QSettings::UserScope, temp_dir_.path());
+    QSettings s;
+    s.beginGroup(SubsonicSettingsPage::kSettingsGroup);
+    s.setValue("url", server_.url());
+    s.setValue("username", "strawberry");
+    s.setValue("password", QByteArray("strawberry").toBase64());
+    s.setValue("downloadalbumcovers", false);
+    s.endGroup();
+
+    database_ = std::make_shared<Database>(nullptr, nullptr, temp_dir_.path() + "/strawberry.db");
+    service_ = std::make_unique<SubsonicService>(nullptr, database_.get(), nullptr);
+    url_handler_ = new SubsonicUrlHandler(nullptr, service_.get());
+
+  }
+
+  void TearDown() override {
+    QThreadPool::globalInstance()->waitForDone();
+    service_.reset();
+    QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+    database_->Close();
+  }
+
+  // Runs a sync with a new request, and stores the songs like the collection view does after the results.
+  SongMap Sync() {
+
+    server_.reset_requests();
+
+    SubsonicRequest request(service_.get(), url_handler_, nullptr);
+    SongMap songs;
+    QString error;
+    bool finished = false;
+    QObject::connect(&request, &SubsonicRequest::Results, [&songs, &error, &finished](const SongMap &results, const QString &results_error) {
+      songs = results;
+      error = results_error;
+      finished = true;
+    });
+    request.GetAlbums();
+
+    QElapsedTimer timer;
+    timer.start();
+    while (!finished && timer.elapsed() < 10000) {
+      QCoreApplication::processEvents(QEventLoop::WaitForMoreEvents, 100);
+    }
+    EXPECT_TRUE(finished);
+    EXPECT_TRUE(error.isEmpty()) << error.toStdString();
+
+    // The synced albums are stored through the backend thread.
+    QCoreApplication::processEvents();
+    service_->collection_backend()->UpdateSongsBySongID(songs);
+
+    return songs;
+
+  }
+
+  QTemporaryDir temp_dir_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+  MockSubsonicServer server_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+  std::shared_ptr<Database> database_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+  std::unique_ptr<SubsonicService> service_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+  SubsonicUrlHandler *url_handler_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+};
+
+TEST_F(SubsonicRequestTest, FullSync) {
+
+  const SongMap songs = Sync();
+  EXPECT_EQ(120, songs.count());
+  EXPECT_TRUE(songs.contains("so-0-0"));
+  EXPECT_TRUE(songs.contains("so-29-3"));
+
+  // One album list page and the songs of each album.
+  EXPECT_EQ(31, server_.requests());
+
+  EXPECT_EQ(30, service_->collection_backend()->GetSyncedAlbums().count());
+
+}
+
+TEST_F(SubsonicRequestTest, IncrementalSync) {
+
+  Sync();
+
+  server_.ChangeAlbum(3);
+  server_.ChangeAlbum(17);
+
+  const SongMap songs = Sync();
+  EXPECT_EQ(122, songs.count());
+  EXPECT_TRUE(songs.contains("so-3-4"));
+  EXPECT_TRUE(songs.contains("so-17-4"));
+  EXPECT_TRUE(songs.contains("so-29-3"));
+
+  // Only the songs of the changed albums are requested again.
+  EXPECT_EQ(3, server_.requests());
+
+  // Nothing changed since, so the album list is all that is requested.
+  EXPECT_EQ(122, Sync().count());
+  EXPECT_EQ(1, server_.requests());
+
+}
+
+}  // namespace
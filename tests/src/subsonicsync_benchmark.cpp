@@ -0,0 +1,135 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2021, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Benchmark of a full and an incremental Subsonic collection sync against a mock server, build with "make subsonicsync_benchmark".
+// Each sync runs SubsonicRequest with a service that only has its collection backend, the songs are stored in a temporary database between the syncs.
+// Usage: subsonicsync_benchmark [number of songs] [latency in msec] [changed albums]
+
+#include <cstdio>
+#include <cstdlib>
+
+#include <QtGlobal>
+#include <QCoreApplication>
+#include <QMetaType>
+#include <QEventLoop>
+#include <QElapsedTimer>
+#include <QTemporaryDir>
+#include <QSettings>
+#include <QByteArray>
+#include <QString>
+
+#include "core/song.h"
+#include "core/database.h"
+#include "collection/collectionbackend.h"
+#include "settings/subsonicsettingspage.h"
+#include "subsonic/subsonicservice.h"
+#include "subsonic/subsonicurlhandler.h"
+#include "subsonic/subsonicrequest.h"
+
+#include "mock_subsonicserver.h"
+
+namespace {
+
+constexpr int kSongsPerAlbum = 12;
+
+SongMap Benchmark(const char *name, MockSubsonicServer *server, SubsonicService *service, SubsonicUrlHandler *url_handler) {
+
+  server->reset_requests();
+  QElapsedTimer timer;
+  timer.start();
+
+  SubsonicRequest request(service, url_handler, nullptr);
+  SongMap songs;
+  QString error;
+  QEventLoop loop;
+  QObject::connect(&request, &SubsonicRequest::Results, &loop, [&songs, &error, &loop](const SongMap &results, const QString &results_error) {
+    songs = results;
+    error = results_error;
+    loop.quit();
+  });
+  request.GetAlbums();
+  loop.exec();
+
+  printf("%-12s %10lld %10d %12.2f s\n", name, static_cast<long long>(songs.count()), server->requests(), static_cast<double>(timer.elapsed()) / 1000.0);
+  if (!error.isEmpty()) fprintf(stderr, "%s\n", error.toUtf8().constData());
+
+  // Store the songs and the synced albums for the next sync.
+  QCoreApplication::processEvents();
+  service->collection_backend()->UpdateSongsBySongID(songs);
+
+  return songs;
+
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+
+  QCoreApplication a(argc, argv);
+  qRegisterMetaType<SyncedAlbumMap>("SyncedAlbumMap");
+
+  const int count = argc > 1 ? atoi(argv[1]) : 50000;
+  const int latency_msec = argc > 2 ? atoi(argv[2]) : 20;
+  const int changed = argc > 3 ? atoi(argv[3]) : 10;
+  if (count <= 0 || latency_msec < 0 || changed < 0) {
+    fprintf(stderr, "Invalid arguments.\n");
+    return 1;
+  }
+
+  const int albums = qMax(1, count / kSongsPerAlbum);
+  MockSubsonicServer server(albums, kSongsPerAlbum, latency_msec);
+  if (!server.Listen()) {
+    fprintf(stderr, "Could not start the mock server.\n");
+    return 1;
+  }
+
+  QTemporaryDir temp_dir;
+  if (!temp_dir.isValid()) {
+    fprintf(stderr, "Could not create a temporary directory.\n");
+    return 1;
+  }
+
+  QSettings::setPath(QSettings::NativeFormat, QSettings::UserScope, temp_dir.path());
+  {
+    QSettings s;
+    s.beginGroup(SubsonicSettingsPage::kSettingsGroup);
+    s.setValue("url", server.url());
+    s.setValue("username", "strawberry");
+    s.setValue("password", QByteArray("strawberry").toBase64());
+    s.setValue("downloadalbumcovers", false);
+    s.endGroup();
+  }
+
+  Database database(nullptr, nullptr, temp_dir.path() + "/strawberry.db");
+  SubsonicService service(nullptr, &database, nullptr);
+  SubsonicUrlHandler *url_handler = new SubsonicUrlHandler(nullptr, &service);
+
+  printf("%-12s %10s %10s %14s\n", "Sync", "Songs", "Requests", "Time");
+
+  Benchmark("Full", &server, &service, url_handler);
+
+  for (int i = 0; i < qMin(changed, albums); ++i) {
+    server.ChangeAlbum(i * albums / qMax(1, changed));
+  }
+
+  Benchmark("Incremental", &server, &service, url_handler);
+
+  return 0;
+
+}
@@ -19,11 +19,17 @@
  *
  */
 
+#include <algorithm>
+
 #include <gtest/gtest.h>
 
 #include <QByteArray>
+#include <QList>
 #include <QString>
 #include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
 #include <QtDebug>
 
 #include "test_utils.h"
@@ -34,6 +40,8 @@
 #include "utilities/cryptutils.h"
 #include "utilities/colorutils.h"
 #include "utilities/transliterate.h"
+#include "utilities/mimeutils.h"
+#include "utilities/fileutils.h"
 #include "core/logging.h"
 
 TEST(UtilitiesTest, PrettyTimeDelta) {
@@ -178,6 +186,103 @@ TEST(UtilitiesTest, Transliterate) {
 
 }
 
+TEST(UtilitiesTest, IsAudioMagic) {
+
+  ASSERT_TRUE(Utilities::IsAudioMagic(QByteArray("fLaC\x00\x00\x00\x22", 8)));
+  ASSERT_TRUE(Utilities::IsAudioMagic(QByteArray("ID3\x04\x00\x00\x00\x00", 8)));
+  ASSERT_TRUE(Utilities::IsAudioMagic(QByteArray("OggS\x00\x02\x00\x00", 8)));
+  ASSERT_TRUE(Utilities::IsAudioMagic(QByteArray("RIFF\x24\x08\x00\x00WAVEfmt ", 16)));
+  ASSERT_TRUE(Utilities::IsAudioMagic(QByteArray("\x00\x00\x00\x20" "ftypM4A ", 12)));
+  ASSERT_TRUE(Utilities::IsAudioMagic(QByteArray("\xFF\xFB\x90\x64", 4)));
+
+  ASSERT_FALSE(Utilities::IsAudioMagic(QByteArray()));
+  ASSERT_FALSE(Utilities::IsAudioMagic(QByteArray("RIFF\x24\x08\x00\x00" "AVI LIST", 16)));
+  ASSERT_FALSE(Utilities::IsAudioMagic(QByteArray("REM GENRE Rock\n", 15)));
+  ASSERT_FALSE(Utilities::IsAudioMagic(QByteArray("%PDF-1.4", 8)));
+
+}
+
+TEST(UtilitiesTest, AudioDataHash) {
+
+  QTemporaryDir temp_dir;
+  ASSERT_TRUE(temp_dir.isValid());
+
+  const auto write_file = [&temp_dir](const QString &name, const QByteArray &data) {
+    QFile file(temp_dir.path() + "/" + name);
+    EXPECT_TRUE(file.open(QIODevice::WriteOnly));
+    file.write(data);
+    file.close();
+    return file.fileName();
+  };
+
+  QByteArray audio(1024 * 1024, '\x01');
+  const QByteArray hash = Utilities::AudioDataHash(write_file("a.mp3", audio));
+  ASSERT_FALSE(hash.isEmpty());
+
+  // Only the ID3v1 tag is different.
+  QByteArray id3v1("TAG");
+  id3v1.append(125, 'x');
+  EXPECT_EQ(hash, Utilities::AudioDataHash(write_file("b.mp3", audio + id3v1)));
+
+  // Same size, beginning and end, but different audio in the middle.
+  audio[audio.size() / 2] = '\x02';
+  EXPECT_NE(hash, Utilities::AudioDataHash(write_file("c.mp3", audio)));
+
+}
+
+TEST(UtilitiesTest, CopyFile) {
+
+  QTemporaryDir temp_dir;
+  ASSERT_TRUE(temp_dir.isValid());
+
+  // Larger than one chunk, so the progress is reported more than once.
+  QByteArray data;
+  for (int i = 0; i < 10 * 1024 * 1024; ++i) data.append(static_cast<char>(i % 251));
+  const QString source = temp_dir.path() + "/source";
+  {
+    QFile file(source);
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    file.write(data);
+  }
+
+  QList<float> progress;
+  const auto progress_function = [&progress](const float p) { progress << p; };
+
+  const QString destination = temp_dir.path() + "/destination";
+  ASSERT_TRUE(Utilities::CopyFile(source, destination, progress_function));
+  EXPECT_EQ(data, Utilities::ReadDataFromFile(destination));
+  ASSERT_FALSE(progress.isEmpty());
+  EXPECT_FLOAT_EQ(1.0F, progress.last());
+  EXPECT_TRUE(std::is_sorted(progress.begin(), progress.end()));
+
+  // The destination exists already.
+  EXPECT_FALSE(Utilities::CopyFile(source, destination));
+  EXPECT_FALSE(Utilities::CopyFile(temp_dir.path() + "/missing", temp_dir.path() + "/missing_destination"));
+  EXPECT_FALSE(QFile::exists(temp_dir.path() + "/missing_destination"));
+
+  // An empty file.
+  {
+    QFile file(temp_dir.path() + "/empty");
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+  }
+  ASSERT_TRUE(Utilities::CopyFile(temp_dir.path() + "/empty", temp_dir.path() + "/empty_destination"));
+  EXPECT_EQ(0, QFileInfo(temp_dir.path() + "/empty_destination").size());
+
+  // Qt resources can't be opened by the kernel, so they are copied with QFile::copy().
+  progress.clear();
+  const QString resource_destination = temp_dir.path() + "/strawberry.flac";
+  ASSERT_TRUE(Utilities::CopyFile(":/audio/strawberry.flac", resource_destination, progress_function));
+  EXPECT_EQ(Utilities::ReadDataFromFile(":/audio/strawberry.flac"), Utilities::ReadDataFromFile(resource_destination));
+  ASSERT_EQ(1, progress.count());
+  EXPECT_FLOAT_EQ(1.0F, progress.first());
+
+  const QString fallback_destination = temp_dir.path() + "/fallback";
+  ASSERT_TRUE(Utilities::CopyFileFallback(source, fallback_destination));
+  EXPECT_EQ(data, Utilities::ReadDataFromFile(fallback_destination));
+  EXPECT_FALSE(Utilities::CopyFileFallback(source, fallback_destination));
+
+}
+
 TEST(UtilitiesTest, ReplaceVariable) {
 
   Song song;